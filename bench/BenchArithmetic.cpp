@@ -0,0 +1,126 @@
+/**
+ * \file BenchArithmetic.cpp
+ *
+ * Measure tight loops of signed arithmetic, which check for overflow, against
+ * the same loops using the unsigned forms, which do not.  The two should run
+ * at the same speed when no overflow occurs.  Division by a register is also
+ * compared against division by a constant, which uses a reciprocal.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/MachineState.h>
+
+#include "Benchmark.h"
+#include "BenchProgram.h"
+
+using namespace simex;
+using namespace simex::bench;
+using namespace std;
+
+namespace {
+
+    /**
+     * Number of instructions run per benchmark iteration.
+     */
+    const uint64_t STEPS = 1 << 16;
+
+    /**
+     * An endless loop of eight arithmetic instructions on small values.  The
+     * signed forms never overflow; $1 and $2 stay near their initial values.
+     */
+    vector<uint32_t> arithmeticLoop(Opcode add, Opcode sub, Opcode mul,
+                                    Opcode neg)
+    {
+        return {
+            tetra(Opcode::OP_SETL, 1, 0x00, 0x05),
+            tetra(Opcode::OP_SETL, 2, 0x00, 0x03),
+            tetra(add,             3, 1, 2),
+            tetra(sub,             4, 3, 2),
+            tetra(mul,             5, 4, 2),
+            tetra(neg,             6, 0, 5),
+            tetra(add,             3, 6, 5),
+            tetra(sub,             4, 3, 1),
+            tetra(mul,             5, 1, 2),
+            tetra(neg,             6, 1, 4),
+            tetra(Opcode::OP_JMPB, 0xFF, 0xFF, 0xF8) };
+    }
+
+    /**
+     * An endless loop of signed and unsigned division of a changing dividend
+     * by 10, with the divisor either in $9 or a constant.
+     */
+    vector<uint32_t> divideLoop(bool constant)
+    {
+        Opcode div = constant ? Opcode::OP_DIVI : Opcode::OP_DIV;
+        Opcode divu = constant ? Opcode::OP_DIVUI : Opcode::OP_DIVU;
+        uint8_t z = constant ? 10 : 9;
+
+        return {
+            tetra(Opcode::OP_SETL,  9, 0x00, 0x0A),
+            tetra(Opcode::OP_SETML, 1, 0x12, 0x34),
+            tetra(Opcode::OP_ADDUI, 1, 1, 77),
+            tetra(div,              2, 1, z),
+            tetra(divu,             3, 1, z),
+            tetra(div,              4, 2, z),
+            tetra(divu,             5, 3, z),
+            tetra(Opcode::OP_JMPB,  0xFF, 0xFF, 0xFB) };
+    }
+
+    /**
+     * Run an arithmetic loop.
+     */
+    void runArithmeticLoop(BenchmarkState& state,
+                           const vector<uint32_t>& program)
+    {
+        auto m = machine(program);
+
+        while (state.keepRunning())
+        {
+            m->run(STEPS);
+            state.addItems(STEPS);
+        }
+    }
+}
+
+/**
+ * ADD, SUB, MUL, and NEG, which raise a fault on overflow.
+ */
+SIMEX_BENCHMARK(arithmetic_signed)
+{
+    runArithmeticLoop(
+        state,
+        arithmeticLoop(Opcode::OP_ADD, Opcode::OP_SUB, Opcode::OP_MUL,
+                       Opcode::OP_NEG));
+}
+
+/**
+ * ADDU, SUBU, MULU, and NEGU, which never fault.
+ */
+SIMEX_BENCHMARK(arithmetic_unsigned)
+{
+    runArithmeticLoop(
+        state,
+        arithmeticLoop(Opcode::OP_ADDU, Opcode::OP_SUBU, Opcode::OP_MULU,
+                       Opcode::OP_NEGU));
+}
+
+/**
+ * DIV and DIVU by a register, which use the hardware divide.
+ */
+SIMEX_BENCHMARK(divide_register)
+{
+    runArithmeticLoop(state, divideLoop(false));
+}
+
+/**
+ * DIVI and DIVUI by a constant, which multiply by a reciprocal.
+ */
+SIMEX_BENCHMARK(divide_constant)
+{
+    runArithmeticLoop(state, divideLoop(true));
+}
@@ -0,0 +1,165 @@
+/**
+ * \file BenchByteOrder.cpp
+ *
+ * Measure copy, hash, and sort loops with big-endian guest memory, which
+ * swaps bytes on every load and store, and with memory which holds octas in
+ * the native byte order.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/MachineState.h>
+
+#include "Benchmark.h"
+#include "BenchProgram.h"
+
+using namespace simex;
+using namespace simex::bench;
+using namespace std;
+
+namespace {
+
+    /**
+     * Number of instructions run per benchmark iteration.
+     */
+    const uint64_t STEPS = 1 << 16;
+
+    /**
+     * An endless loop which copies the first half of the data segment to the
+     * second half, an octa at a time.
+     */
+    vector<uint32_t> copyLoop()
+    {
+        return {
+            tetra(Opcode::OP_SETML, 1, 0x00, 0x10),
+            tetra(Opcode::OP_SETML, 5, 0x00, 0x18),
+            tetra(Opcode::OP_SETML, 9, 0x00, 0x07),
+            tetra(Opcode::OP_ORL,   9, 0xFF, 0xF8),
+            tetra(Opcode::OP_LDO,   3, 1, 2),
+            tetra(Opcode::OP_STO,   3, 5, 2),
+            tetra(Opcode::OP_ADDUI, 2, 2, 8),
+            tetra(Opcode::OP_AND,   2, 2, 9),
+            tetra(Opcode::OP_JMPB,  0xFF, 0xFF, 0xFC) };
+    }
+
+    /**
+     * An endless loop which hashes the first half of the data segment a byte
+     * at a time, with 64-bit FNV-1a.
+     */
+    vector<uint32_t> hashLoop()
+    {
+        return {
+            tetra(Opcode::OP_SETML, 1, 0x00, 0x10),
+            tetra(Opcode::OP_SETML, 9, 0x00, 0x07),
+            tetra(Opcode::OP_ORL,   9, 0xFF, 0xFF),
+            tetra(Opcode::OP_SETMH, 8, 0x01, 0x00),
+            tetra(Opcode::OP_ORL,   8, 0x01, 0xB3),
+            tetra(Opcode::OP_LDBU,  3, 1, 2),
+            tetra(Opcode::OP_XOR,   0, 0, 3),
+            tetra(Opcode::OP_MULU,  0, 0, 8),
+            tetra(Opcode::OP_ADDUI, 2, 2, 1),
+            tetra(Opcode::OP_AND,   2, 2, 9),
+            tetra(Opcode::OP_JMPB,  0xFF, 0xFF, 0xFB) };
+    }
+
+    /**
+     * An endless loop of bubble sort passes over signed tetras in the first
+     * half of the data segment.
+     */
+    vector<uint32_t> sortLoop()
+    {
+        return {
+            tetra(Opcode::OP_SETML, 1, 0x00, 0x10),
+            tetra(Opcode::OP_SETML, 9, 0x00, 0x07),
+            tetra(Opcode::OP_ORL,   9, 0xFF, 0xFC),
+            tetra(Opcode::OP_LDT,   3, 1, 2),
+            tetra(Opcode::OP_ADDUI, 4, 2, 4),
+            tetra(Opcode::OP_LDT,   5, 1, 4),
+            tetra(Opcode::OP_CMP,   6, 3, 5),
+            tetra(Opcode::OP_BNP,   6, 0x00, 0x03),
+            tetra(Opcode::OP_STT,   5, 1, 2),
+            tetra(Opcode::OP_STT,   3, 1, 4),
+            tetra(Opcode::OP_ADDUI, 2, 2, 4),
+            tetra(Opcode::OP_AND,   2, 2, 9),
+            tetra(Opcode::OP_JMPB,  0xFF, 0xFF, 0xF7) };
+    }
+
+    /**
+     * Run a loop over pseudo-random data, with memory in the given byte
+     * order.
+     */
+    void runLoop(
+        BenchmarkState& state, const vector<uint32_t>& program,
+        ByteOrder order)
+    {
+        auto m = machine(program, false, order);
+        vector<uint8_t> data(DATA_SIZE / 2);
+        uint32_t seed = 1;
+
+        for (uint8_t& byte : data)
+        {
+            seed = seed * 1103515245 + 12345;
+            byte = static_cast<uint8_t>(seed >> 16);
+        }
+
+        m->addressSpace().write(DATA_BASE, data.data(), data.size());
+
+        while (state.keepRunning())
+        {
+            m->run(STEPS);
+            state.addItems(STEPS);
+        }
+    }
+}
+
+/**
+ * Copy octas in big-endian memory.
+ */
+SIMEX_BENCHMARK(byte_order_copy_big_endian)
+{
+    runLoop(state, copyLoop(), ByteOrder::BigEndian);
+}
+
+/**
+ * Copy octas in native memory.
+ */
+SIMEX_BENCHMARK(byte_order_copy_native)
+{
+    runLoop(state, copyLoop(), ByteOrder::Native);
+}
+
+/**
+ * Hash bytes in big-endian memory.
+ */
+SIMEX_BENCHMARK(byte_order_hash_big_endian)
+{
+    runLoop(state, hashLoop(), ByteOrder::BigEndian);
+}
+
+/**
+ * Hash bytes in native memory.
+ */
+SIMEX_BENCHMARK(byte_order_hash_native)
+{
+    runLoop(state, hashLoop(), ByteOrder::Native);
+}
+
+/**
+ * Sort tetras in big-endian memory.
+ */
+SIMEX_BENCHMARK(byte_order_sort_big_endian)
+{
+    runLoop(state, sortLoop(), ByteOrder::BigEndian);
+}
+
+/**
+ * Sort tetras in native memory.
+ */
+SIMEX_BENCHMARK(byte_order_sort_native)
+{
+    runLoop(state, sortLoop(), ByteOrder::Native);
+}
@@ -0,0 +1,120 @@
+/**
+ * \file BenchCalls.cpp
+ *
+ * Measure calls and returns with the register counts common in guest code,
+ * and with counts which don't have a specialized handler.  Each item is one
+ * call and its return, so items/s is the number of calls per second.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/MachineState.h>
+
+#include "Benchmark.h"
+#include "BenchProgram.h"
+
+using namespace simex;
+using namespace simex::bench;
+using namespace std;
+
+namespace {
+
+    /**
+     * Number of instructions run for each call.
+     */
+    const uint64_t CALL_INSTRUCTIONS = 5;
+
+    /**
+     * Number of calls made per benchmark iteration.
+     */
+    const uint64_t CALLS = 1 << 13;
+
+    /**
+     * Call a function which returns immediately, forever.  The caller hides x
+     * registers and passes two arguments, and the callee returns the given
+     * number of registers.  For PUSHGO, $0 holds the address of the callee,
+     * so x must be at least 1.
+     */
+    vector<uint32_t> callProgram(Opcode call, uint8_t x, uint8_t results)
+    {
+        return {
+            tetra(Opcode::OP_GETA,   0, 0x00, 0x05),
+            tetra(Opcode::OP_SETL,   x + 1, 0x00, 0x01),
+            tetra(Opcode::OP_SETL,   x + 2, 0x00, 0x02),
+            Opcode::OP_PUSHJ == call
+                ? tetra(Opcode::OP_PUSHJ,   x, 0x00, 0x02)
+                : tetra(Opcode::OP_PUSHGOI, x, 0, 0),
+            tetra(Opcode::OP_JMPB,   0xFF, 0xFF, 0xFD),
+            //callee: return immediately.
+            tetra(Opcode::OP_POP,    results, 0, 0) };
+    }
+
+    /**
+     * Run a call loop, counting calls.
+     */
+    void runCalls(BenchmarkState& state, const vector<uint32_t>& program)
+    {
+        auto m = machine(program);
+
+        //skip the GETA, so that every later step is part of a call.
+        m->run(1);
+
+        while (state.keepRunning())
+        {
+            m->run(CALLS * CALL_INSTRUCTIONS);
+            state.addItems(CALLS);
+        }
+    }
+}
+
+/**
+ * PUSHJ $0 and POP 0, 0, as for a procedure with no saved locals.
+ */
+SIMEX_BENCHMARK(call_pushj_0_pop_0)
+{
+    runCalls(state, callProgram(Opcode::OP_PUSHJ, 0, 0));
+}
+
+/**
+ * PUSHJ $2 and POP 1, 0.
+ */
+SIMEX_BENCHMARK(call_pushj_2_pop_1)
+{
+    runCalls(state, callProgram(Opcode::OP_PUSHJ, 2, 1));
+}
+
+/**
+ * PUSHJ $4 and POP 1, 0.
+ */
+SIMEX_BENCHMARK(call_pushj_4_pop_1)
+{
+    runCalls(state, callProgram(Opcode::OP_PUSHJ, 4, 1));
+}
+
+/**
+ * PUSHGO $2 through a register and POP 1, 0, as for an indirect call.
+ */
+SIMEX_BENCHMARK(call_pushgo_2_pop_1)
+{
+    runCalls(state, callProgram(Opcode::OP_PUSHGOI, 2, 1));
+}
+
+/**
+ * PUSHJ $8, which has no specialized handler.
+ */
+SIMEX_BENCHMARK(call_pushj_8_pop_1)
+{
+    runCalls(state, callProgram(Opcode::OP_PUSHJ, 8, 1));
+}
+
+/**
+ * POP 2, 0, which has no specialized handler.
+ */
+SIMEX_BENCHMARK(call_pushj_2_pop_2)
+{
+    runCalls(state, callProgram(Opcode::OP_PUSHJ, 2, 2));
+}
@@ -0,0 +1,114 @@
+/**
+ * \file BenchContext.cpp
+ *
+ * Measure a full register context switch, as a SAVE of one context followed
+ * by an UNSAVE of it, for different numbers of local and global registers.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/MachineState.h>
+
+#include "Benchmark.h"
+#include "BenchProgram.h"
+
+using namespace simex;
+using namespace simex::bench;
+using namespace std;
+
+namespace {
+
+    /**
+     * Number of context switches run per benchmark iteration.
+     */
+    const uint64_t SWITCHES = 1 << 12;
+
+    /**
+     * Number of instructions run per context switch.
+     */
+    const uint64_t SWITCH_INSTRUCTIONS = 3;
+
+    /**
+     * Save the context to DATA_BASE and restore it, forever.  $255 gets the
+     * size of the image, $254 holds DATA_BASE, and $253 holds 0.
+     */
+    const vector<uint32_t>& switchProgram()
+    {
+        static const vector<uint32_t> program = {
+            tetra(Opcode::OP_SAVE,   255, 254, 0),
+            tetra(Opcode::OP_UNSAVE,   0, 254, 253),
+            tetra(Opcode::OP_JMPB,   0xFF, 0xFF, 0xFE) };
+
+        return program;
+    }
+
+    /**
+     * Switch a context with the given register-stack depth, number of local
+     * registers, and number of global registers.
+     */
+    void runSwitches(
+        BenchmarkState& state, uint64_t rO, uint64_t rL, uint64_t rG)
+    {
+        auto m = machine(switchProgram());
+
+        m->setSReg(SReg::SR_RO, rO);
+        m->setSReg(SReg::SR_RL, rL);
+        m->setSReg(SReg::SR_RG, rG);
+
+        for (uint64_t r = 0; r < rL; ++r)
+            m->setReg(r, r);
+
+        m->setReg(254, DATA_BASE);
+        m->setReg(253, 0);
+
+        while (state.keepRunning())
+        {
+            m->run(SWITCH_INSTRUCTIONS * SWITCHES);
+            state.addItems(SWITCHES);
+        }
+    }
+}
+
+/**
+ * A leaf context with a few locals and globals.
+ */
+SIMEX_BENCHMARK(context_switch_l16_g32)
+{
+    runSwitches(state, 0, 16, 32);
+}
+
+/**
+ * A context with a typical frame.
+ */
+SIMEX_BENCHMARK(context_switch_l64_g64)
+{
+    runSwitches(state, 0, 64, 64);
+}
+
+/**
+ * A context which uses every register.
+ */
+SIMEX_BENCHMARK(context_switch_l128_g128)
+{
+    runSwitches(state, 0, 128, 128);
+}
+
+/**
+ * A context with nearly every register local.
+ */
+SIMEX_BENCHMARK(context_switch_l224_g32)
+{
+    runSwitches(state, 0, 224, 32);
+}
+
+/**
+ * A context with a deep register-stack, part of which is in the rS region.
+ */
+SIMEX_BENCHMARK(context_switch_deep_l64_g32)
+{
+    runSwitches(state, 1024, 64, 32);
+}
@@ -0,0 +1,159 @@
+/**
+ * \file BenchDecode.cpp
+ *
+ * Compare the allocating, allocation-free, and batch instruction decode paths.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <random>
+#include <simex/DecodeBatch.h>
+#include <simex/DecodedInstruction.h>
+#include <simex/Instruction.h>
+#include <vector>
+
+#include "Benchmark.h"
+
+using namespace simex;
+using namespace simex::bench;
+using namespace std;
+
+namespace {
+
+    /**
+     * Size of the simulated code segment, in bytes.
+     */
+    const size_t CODE_SEGMENT_SIZE = 1024 * 1024;
+
+    /**
+     * Create a code segment filled with random big-endian tetras.
+     */
+    const vector<uint8_t>& codeSegment()
+    {
+        static vector<uint8_t> code;
+
+        if (code.empty())
+        {
+            mt19937 rng(0x51BE);
+            code.resize(CODE_SEGMENT_SIZE);
+            for (auto& b : code)
+                b = static_cast<uint8_t>(rng());
+        }
+
+        return code;
+    }
+}
+
+/**
+ * Decode a 1 MB code segment through the shared_ptr factory.
+ */
+SIMEX_BENCHMARK(decode_shared_ptr_1MB)
+{
+    const auto& code = codeSegment();
+    uint64_t sink = 0;
+
+    while (state.keepRunning())
+    {
+        for (size_t i = 0; i < code.size(); i += 4)
+        {
+            auto ins =
+                Instruction::decode(
+                    static_cast<Opcode>(code[i]), code[i+1], code[i+2],
+                    code[i+3]);
+
+            sink += ins->z();
+        }
+
+        state.addItems(code.size() / 4);
+    }
+
+    state.addCounter(sink & 1);
+}
+
+/**
+ * Decode a 1 MB code segment into DecodedInstruction values.
+ */
+SIMEX_BENCHMARK(decode_value_1MB)
+{
+    const auto& code = codeSegment();
+    uint64_t sink = 0;
+
+    while (state.keepRunning())
+    {
+        for (size_t i = 0; i < code.size(); i += 4)
+        {
+            auto ins = DecodedInstruction::decode(&code[i]);
+
+            sink += ins.z() + ins.handler().name[0];
+        }
+
+        state.addItems(code.size() / 4);
+    }
+
+    state.addCounter(sink & 1);
+}
+
+namespace {
+
+    /**
+     * Decode the code segment in batches with the given strategy.
+     */
+    void decodeBatches(BenchmarkState& state, DecodeStrategy strategy)
+    {
+        const size_t BATCH = 1024;
+        const auto& code = codeSegment();
+        vector<Opcode> opcode(BATCH);
+        vector<uint8_t> x(BATCH), y(BATCH), z(BATCH);
+        vector<uint16_t> yz(BATCH);
+        vector<uint32_t> xyz(BATCH);
+        DecodedBatch out{
+            opcode.data(), x.data(), y.data(), z.data(), yz.data(),
+            xyz.data() };
+        uint64_t sink = 0;
+
+        if (!decodeStrategySupported(strategy))
+            return;
+
+        while (state.keepRunning())
+        {
+            for (size_t i = 0; i < code.size(); i += 4 * BATCH)
+            {
+                decodeBatch(&code[i], BATCH, out, strategy);
+                sink += z[BATCH - 1] + xyz[0];
+            }
+
+            state.addItems(code.size() / 4);
+        }
+
+        state.addCounter(sink & 1);
+    }
+}
+
+/**
+ * Decode a 1 MB code segment one instruction at a time into structure-of-
+ * arrays form.
+ */
+SIMEX_BENCHMARK(decode_batch_scalar_1MB)
+{
+    decodeBatches(state, DecodeStrategy::Scalar);
+}
+
+/**
+ * Decode a 1 MB code segment with SSSE3 byte shuffles.
+ */
+SIMEX_BENCHMARK(decode_batch_ssse3_1MB)
+{
+    decodeBatches(state, DecodeStrategy::SSSE3);
+}
+
+/**
+ * Decode a 1 MB code segment with AVX2 byte shuffles.
+ */
+SIMEX_BENCHMARK(decode_batch_avx2_1MB)
+{
+    decodeBatches(state, DecodeStrategy::AVX2);
+}
@@ -0,0 +1,86 @@
+/**
+ * \file BenchEmit.cpp
+ *
+ * Compare emitting a large section through ostream with emitting it into a
+ * CodeBuffer.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/CodeBuffer.h>
+#include <simex/DecodedInstruction.h>
+#include <sstream>
+
+#include "Benchmark.h"
+
+using namespace simex;
+using namespace simex::bench;
+using namespace std;
+
+namespace {
+
+    /**
+     * Number of instructions in the emitted section.
+     */
+    const size_t SECTION_INSTRUCTIONS = 256 * 1024;
+
+    /**
+     * Get the i-th instruction of the generated section.
+     */
+    inline DecodedInstruction generated(size_t i)
+    {
+        return
+            DecodedInstruction::decode(
+                Opcode::OP_ADDI, static_cast<uint8_t>(i),
+                static_cast<uint8_t>(i >> 8), static_cast<uint8_t>(i >> 16));
+    }
+}
+
+/**
+ * Emit a 1 MB section one instruction at a time to an ostream.
+ */
+SIMEX_BENCHMARK(emit_ostream_1MB)
+{
+    uint64_t sink = 0;
+
+    while (state.keepRunning())
+    {
+        stringstream out;
+
+        for (size_t i = 0; i < SECTION_INSTRUCTIONS; ++i)
+            generated(i).emit(out);
+
+        sink += out.tellp();
+        state.addItems(SECTION_INSTRUCTIONS);
+    }
+
+    state.addCounter(sink & 1);
+}
+
+/**
+ * Emit a 1 MB section into a reused CodeBuffer, then write it to an ostream.
+ */
+SIMEX_BENCHMARK(emit_code_buffer_1MB)
+{
+    CodeBuffer buffer;
+    uint64_t sink = 0;
+
+    while (state.keepRunning())
+    {
+        stringstream out;
+
+        buffer.clear();
+        for (size_t i = 0; i < SECTION_INSTRUCTIONS; ++i)
+            buffer.emit(generated(i));
+
+        buffer.write(out);
+        sink += out.tellp();
+        state.addItems(SECTION_INSTRUCTIONS);
+    }
+
+    state.addCounter(sink & 1);
+}
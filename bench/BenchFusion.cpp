@@ -0,0 +1,88 @@
+/**
+ * \file BenchFusion.cpp
+ *
+ * Measure the effect of superinstruction fusion on an instruction mix which
+ * uses each fused idiom.  The counter reports dispatches per instruction.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/MachineState.h>
+
+#include "Benchmark.h"
+#include "BenchProgram.h"
+
+using namespace simex;
+using namespace simex::bench;
+using namespace std;
+
+namespace {
+
+    /**
+     * Number of instructions run per benchmark iteration.
+     */
+    const uint64_t STEPS = 1 << 16;
+
+    /**
+     * A loop which builds a constant, indexes an array, calls a function
+     * through GETA and PUSHGO, and branches on a comparison.
+     */
+    const vector<uint32_t>& idiomLoop()
+    {
+        static const vector<uint32_t> program = {
+            tetra(Opcode::OP_SETML,   1, 0x00, 0x10),
+            tetra(Opcode::OP_ORL,     1, 0x00, 0x00),
+            tetra(Opcode::OP_SETL,    2, 0x01, 0x00),
+            tetra(Opcode::OP_8ADDU,   3, 2, 1),
+            tetra(Opcode::OP_LDOI,    4, 3, 0),
+            tetra(Opcode::OP_ADD,     0, 0, 4),
+            tetra(Opcode::OP_GETA,    5, 0x00, 0x06),
+            tetra(Opcode::OP_PUSHGOI, 6, 5, 0),
+            tetra(Opcode::OP_SUBI,    2, 2, 1),
+            tetra(Opcode::OP_CMPI,    7, 2, 0),
+            tetra(Opcode::OP_BNZB,    7, 0xFF, 0xF9),
+            tetra(Opcode::OP_JMPB,    0xFF, 0xFF, 0xF5),
+            tetra(Opcode::OP_SETL,    0, 0, 1),
+            tetra(Opcode::OP_POP,     1, 0, 0) };
+
+        return program;
+    }
+
+    /**
+     * Run the idiom loop with fusion enabled or disabled.
+     */
+    void runIdiomLoop(BenchmarkState& state, bool fusion)
+    {
+        auto m = machine(idiomLoop());
+        m->setFusion(fusion);
+
+        while (state.keepRunning())
+        {
+            uint64_t dispatches = m->dispatchCount();
+
+            m->run(STEPS);
+            state.addItems(STEPS);
+            state.addCounter(m->dispatchCount() - dispatches);
+        }
+    }
+}
+
+/**
+ * Run the idiom loop with superinstructions.
+ */
+SIMEX_BENCHMARK(fusion_enabled)
+{
+    runIdiomLoop(state, true);
+}
+
+/**
+ * Run the idiom loop without superinstructions.
+ */
+SIMEX_BENCHMARK(fusion_disabled)
+{
+    runIdiomLoop(state, false);
+}
@@ -0,0 +1,130 @@
+/**
+ * \file BenchInterpreter.cpp
+ *
+ * Compare the threaded interpreter loop with per-instruction dispatch.  Each
+ * variant fetches instructions from the address space.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/Instruction.h>
+#include <simex/MachineState.h>
+
+#include "Benchmark.h"
+#include "BenchProgram.h"
+
+using namespace simex;
+using namespace simex::bench;
+using namespace std;
+
+namespace {
+
+    /**
+     * Number of instructions run per benchmark iteration.
+     */
+    const uint64_t STEPS = 1 << 16;
+
+    /**
+     * A counting loop of ALU and branch instructions, which restarts forever.
+     */
+    const vector<uint32_t>& countingLoop()
+    {
+        static const vector<uint32_t> program = {
+            tetra(Opcode::OP_SETL,  0, 0, 0),
+            tetra(Opcode::OP_SETL,  1, 0x01, 0x00),
+            tetra(Opcode::OP_ADD,   0, 0, 1),
+            tetra(Opcode::OP_XORI,  2, 0, 0x55),
+            tetra(Opcode::OP_SUBI,  1, 1, 1),
+            tetra(Opcode::OP_BNZB,  1, 0xFF, 0xFD),
+            tetra(Opcode::OP_JMPB,  0xFF, 0xFF, 0xFA) };
+
+        return program;
+    }
+}
+
+/**
+ * Run the counting loop with the threaded interpreter.
+ */
+SIMEX_BENCHMARK(interpret_run_loop)
+{
+    auto m = machine(countingLoop());
+
+    while (state.keepRunning())
+    {
+        m->run(STEPS);
+        state.addItems(STEPS);
+    }
+
+    state.addCounter(m->reg(0) & 1);
+}
+
+/**
+ * Run the counting loop with the threaded interpreter, discarding the
+ * predecoded blocks before every short run.
+ */
+SIMEX_BENCHMARK(interpret_run_loop_invalidated)
+{
+    const uint64_t SHORT_STEPS = 256;
+    auto m = machine(countingLoop());
+
+    while (state.keepRunning())
+    {
+        m->addressSpace().changePolicy(
+            CODE_BASE, SEGMENT_READ | SEGMENT_EXECUTE);
+        m->run(SHORT_STEPS);
+        state.addItems(SHORT_STEPS);
+    }
+
+    state.addCounter(m->reg(0) & 1);
+}
+
+/**
+ * Run the counting loop one instruction at a time through DecodedInstruction
+ * values.
+ */
+SIMEX_BENCHMARK(interpret_decoded_step)
+{
+    auto m = machine(countingLoop());
+
+    while (state.keepRunning())
+    {
+        for (uint64_t i = 0; i < STEPS; ++i)
+        {
+            uint8_t t[4];
+            m->addressSpace().read(m->pc(), t, sizeof(t));
+            DecodedInstruction::decode(t).evaluate(m.get());
+        }
+        state.addItems(STEPS);
+    }
+
+    state.addCounter(m->reg(0) & 1);
+}
+
+/**
+ * Run the counting loop one instruction at a time through the virtual
+ * Instruction interface.
+ */
+SIMEX_BENCHMARK(interpret_virtual_step)
+{
+    auto m = machine(countingLoop());
+
+    while (state.keepRunning())
+    {
+        for (uint64_t i = 0; i < STEPS; ++i)
+        {
+            uint8_t t[4];
+            m->addressSpace().read(m->pc(), t, sizeof(t));
+            auto ins =
+                Instruction::decode(
+                    static_cast<Opcode>(t[0]), t[1], t[2], t[3]);
+            ins->evaluate(m.get());
+        }
+        state.addItems(STEPS);
+    }
+
+    state.addCounter(m->reg(0) & 1);
+}
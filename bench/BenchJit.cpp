@@ -0,0 +1,252 @@
+/**
+ * \file BenchJit.cpp
+ *
+ * Measure arithmetic, copy, and sort loops when interpreted and when
+ * translated to host machine code, and a short program with much more cold
+ * code than hot code when interpreted, translated up front, and tiered up.
+ * The counter reports dispatches per instruction.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/MachineState.h>
+
+#include "Benchmark.h"
+#include "BenchProgram.h"
+
+using namespace simex;
+using namespace simex::bench;
+using namespace std;
+
+namespace {
+
+    /**
+     * Number of instructions run per benchmark iteration.
+     */
+    const uint64_t STEPS = 1 << 16;
+
+    /**
+     * An endless loop which steps a linear congruential generator and mixes
+     * its output into an accumulator.
+     */
+    vector<uint32_t> arithmeticLoop()
+    {
+        return {
+            tetra(Opcode::OP_SETMH, 8, 0x58, 0x51),
+            tetra(Opcode::OP_ORML,  8, 0xF4, 0x2D),
+            tetra(Opcode::OP_ORL,   8, 0x4C, 0x95),
+            tetra(Opcode::OP_SETL,  1, 0x00, 0x01),
+            tetra(Opcode::OP_MULU,  1, 1, 8),
+            tetra(Opcode::OP_ADDUI, 1, 1, 11),
+            tetra(Opcode::OP_SRUI,  2, 1, 33),
+            tetra(Opcode::OP_XOR,   0, 0, 2),
+            tetra(Opcode::OP_SLUI,  3, 0, 3),
+            tetra(Opcode::OP_ADDU,  0, 0, 3),
+            tetra(Opcode::OP_CMPU,  4, 0, 1),
+            tetra(Opcode::OP_ZSN,   5, 4, 2),
+            tetra(Opcode::OP_ADDU,  0, 0, 5),
+            tetra(Opcode::OP_JMPB,  0xFF, 0xFF, 0xF7) };
+    }
+
+    /**
+     * An endless loop which copies the first half of the data segment to the
+     * second half, an octa at a time.
+     */
+    vector<uint32_t> copyLoop()
+    {
+        return {
+            tetra(Opcode::OP_SETML, 1, 0x00, 0x10),
+            tetra(Opcode::OP_SETML, 5, 0x00, 0x18),
+            tetra(Opcode::OP_SETML, 9, 0x00, 0x07),
+            tetra(Opcode::OP_ORL,   9, 0xFF, 0xF8),
+            tetra(Opcode::OP_LDO,   3, 1, 2),
+            tetra(Opcode::OP_STO,   3, 5, 2),
+            tetra(Opcode::OP_ADDUI, 2, 2, 8),
+            tetra(Opcode::OP_AND,   2, 2, 9),
+            tetra(Opcode::OP_JMPB,  0xFF, 0xFF, 0xFC) };
+    }
+
+    /**
+     * An endless loop of bubble sort passes over signed tetras in the first
+     * half of the data segment.
+     */
+    vector<uint32_t> sortLoop()
+    {
+        return {
+            tetra(Opcode::OP_SETML, 1, 0x00, 0x10),
+            tetra(Opcode::OP_SETML, 9, 0x00, 0x07),
+            tetra(Opcode::OP_ORL,   9, 0xFF, 0xFC),
+            tetra(Opcode::OP_LDT,   3, 1, 2),
+            tetra(Opcode::OP_ADDUI, 4, 2, 4),
+            tetra(Opcode::OP_LDT,   5, 1, 4),
+            tetra(Opcode::OP_CMP,   6, 3, 5),
+            tetra(Opcode::OP_BNP,   6, 0x00, 0x03),
+            tetra(Opcode::OP_STT,   5, 1, 2),
+            tetra(Opcode::OP_STT,   3, 1, 4),
+            tetra(Opcode::OP_ADDUI, 2, 2, 4),
+            tetra(Opcode::OP_AND,   2, 2, 9),
+            tetra(Opcode::OP_JMPB,  0xFF, 0xFF, 0xF7) };
+    }
+
+    /**
+     * The number of blocks of straight-line code which run once before the
+     * hot loop of the startup program.
+     */
+    const size_t COLD_BLOCKS = 400;
+
+    /**
+     * A program which runs through COLD_BLOCKS short blocks once, then a
+     * loop 20000 times, then halts.
+     */
+    vector<uint32_t> startupProgram()
+    {
+        vector<uint32_t> program;
+
+        for (size_t i = 0; i < COLD_BLOCKS; ++i)
+        {
+            program.push_back(tetra(Opcode::OP_ADDUI, 1, 1, i & 0xFF));
+            program.push_back(tetra(Opcode::OP_XOR,   2, 2, 1));
+            program.push_back(tetra(Opcode::OP_ADDU,  3, 3, 2));
+            program.push_back(tetra(Opcode::OP_BN,    3, 0x00, 0x01));
+        }
+
+        program.push_back(tetra(Opcode::OP_SETL,  4, 0x4E, 0x20));
+        program.push_back(tetra(Opcode::OP_ADDUI, 1, 1, 1));
+        program.push_back(tetra(Opcode::OP_XOR,   2, 2, 1));
+        program.push_back(tetra(Opcode::OP_ADDU,  3, 3, 2));
+        program.push_back(tetra(Opcode::OP_SUBI,  4, 4, 1));
+        program.push_back(tetra(Opcode::OP_BNZB,  4, 0xFF, 0xFC));
+        program.push_back(tetra(Opcode::OP_POP,   0, 0, 0));
+
+        return program;
+    }
+
+    /**
+     * Run the startup program to completion on a fresh machine each time,
+     * interpreted, with every block translated as it is predecoded, or with
+     * the default thresholds.
+     */
+    void runStartup(BenchmarkState& state, bool jit, bool eager)
+    {
+        vector<uint32_t> program = startupProgram();
+
+        while (state.keepRunning())
+        {
+            auto m = machine(program);
+
+            m->setJit(jit);
+            if (eager)
+                m->setJitThresholds(0, 0);
+
+            m->run();
+            state.addItems(m->instructionCount());
+            state.addCounter(m->dispatchCount());
+        }
+    }
+
+    /**
+     * Run a loop over pseudo-random data, interpreted or translated.
+     */
+    void runLoop(
+        BenchmarkState& state, const vector<uint32_t>& program, bool jit)
+    {
+        auto m = machine(program);
+        vector<uint8_t> data(DATA_SIZE / 2);
+        uint32_t seed = 1;
+
+        m->setJit(jit);
+
+        for (uint8_t& byte : data)
+        {
+            seed = seed * 1103515245 + 12345;
+            byte = static_cast<uint8_t>(seed >> 16);
+        }
+
+        m->addressSpace().write(DATA_BASE, data.data(), data.size());
+
+        while (state.keepRunning())
+        {
+            uint64_t dispatches = m->dispatchCount();
+
+            m->run(STEPS);
+            state.addItems(STEPS);
+            state.addCounter(m->dispatchCount() - dispatches);
+        }
+    }
+}
+
+/**
+ * Interpret the arithmetic loop.
+ */
+SIMEX_BENCHMARK(jit_arithmetic_interpreted)
+{
+    runLoop(state, arithmeticLoop(), false);
+}
+
+/**
+ * Translate the arithmetic loop.
+ */
+SIMEX_BENCHMARK(jit_arithmetic_compiled)
+{
+    runLoop(state, arithmeticLoop(), true);
+}
+
+/**
+ * Interpret the copy loop.
+ */
+SIMEX_BENCHMARK(jit_copy_interpreted)
+{
+    runLoop(state, copyLoop(), false);
+}
+
+/**
+ * Translate the copy loop.
+ */
+SIMEX_BENCHMARK(jit_copy_compiled)
+{
+    runLoop(state, copyLoop(), true);
+}
+
+/**
+ * Interpret the sort loop.
+ */
+SIMEX_BENCHMARK(jit_sort_interpreted)
+{
+    runLoop(state, sortLoop(), false);
+}
+
+/**
+ * Translate the sort loop.
+ */
+SIMEX_BENCHMARK(jit_sort_compiled)
+{
+    runLoop(state, sortLoop(), true);
+}
+
+/**
+ * Interpret the startup program.
+ */
+SIMEX_BENCHMARK(jit_startup_interpreted)
+{
+    runStartup(state, false, false);
+}
+
+/**
+ * Translate every block of the startup program as it is first run.
+ */
+SIMEX_BENCHMARK(jit_startup_eager)
+{
+    runStartup(state, true, true);
+}
+
+/**
+ * Translate the blocks of the startup program which get hot.
+ */
+SIMEX_BENCHMARK(jit_startup_tiered)
+{
+    runStartup(state, true, false);
+}
@@ -0,0 +1,92 @@
+/**
+ * \file BenchMemory.cpp
+ *
+ * Measure loads and stores which stride across the pages of a data segment,
+ * with few and with many segments mapped, and with policy enforced by the
+ * host MMU.  Translations are cached per page, so the cost of an access should
+ * not depend on the number of segments.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/MachineState.h>
+
+#include "Benchmark.h"
+#include "BenchProgram.h"
+
+using namespace simex;
+using namespace simex::bench;
+using namespace std;
+
+namespace {
+
+    /**
+     * Number of instructions run per benchmark iteration.
+     */
+    const uint64_t STEPS = 1 << 16;
+
+    /**
+     * An endless loop which increments octas of the first half of the data
+     * segment, striding across pages, with two loads and a store per pass.
+     */
+    vector<uint32_t> strideLoop()
+    {
+        return {
+            tetra(Opcode::OP_SETML, 1, 0x00, 0x10),
+            tetra(Opcode::OP_SETML, 9, 0x00, 0x07),
+            tetra(Opcode::OP_ORL,   9, 0xFF, 0xF8),
+            tetra(Opcode::OP_ADDUI, 2, 2, 0xF8),
+            tetra(Opcode::OP_AND,   2, 2, 9),
+            tetra(Opcode::OP_LDO,   3, 1, 2),
+            tetra(Opcode::OP_ADDUI, 3, 3, 1),
+            tetra(Opcode::OP_STO,   3, 1, 2),
+            tetra(Opcode::OP_LDO,   4, 1, 9),
+            tetra(Opcode::OP_JMPB,  0xFF, 0xFF, 0xFB) };
+    }
+
+    /**
+     * Run the stride loop, with the given number of extra segments mapped.
+     */
+    void runStrideLoop(
+        BenchmarkState& state, int segments, bool hostProtection = false)
+    {
+        auto m = machine(strideLoop(), hostProtection);
+
+        for (int k = 0; k < segments; ++k)
+            m->addressSpace().allocate(AddressSpace::PAGE_SIZE, SEGMENT_READ);
+
+        while (state.keepRunning())
+        {
+            m->run(STEPS);
+            state.addItems(STEPS);
+        }
+    }
+}
+
+/**
+ * Loads and stores with only the code and data segments mapped.
+ */
+SIMEX_BENCHMARK(memory_stride)
+{
+    runStrideLoop(state, 0);
+}
+
+/**
+ * Loads and stores with a thousand other segments mapped.
+ */
+SIMEX_BENCHMARK(memory_stride_many_segments)
+{
+    runStrideLoop(state, 1000);
+}
+
+/**
+ * Loads and stores which access the host arena directly.
+ */
+SIMEX_BENCHMARK(memory_stride_host_protection)
+{
+    runStrideLoop(state, 0, true);
+}
@@ -0,0 +1,171 @@
+/**
+ * \file BenchPageTable.cpp
+ *
+ * Measure the cost of finding the segment for a guest address, as on a TLB
+ * miss, with 10^5 small segments either packed together, as allocate() places
+ * them, or scattered across a 48-bit address space.  The ordered map of
+ * segments which find() used before the page table is measured for
+ * comparison.  The counter reports the bytes of page table per segment.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <map>
+#include <memory>
+#include <random>
+#include <simex/AddressSpace.h>
+#include <simex/PageTable.h>
+
+#include "Benchmark.h"
+
+using namespace simex;
+using namespace simex::bench;
+using namespace std;
+
+namespace {
+
+    /**
+     * Number of segments mapped.
+     */
+    const int SEGMENTS = 100000;
+
+    /**
+     * Number of lookups per benchmark iteration.
+     */
+    const int LOOKUPS = 4096;
+
+    /**
+     * Get the base address of each segment, packed or scattered.
+     */
+    vector<uint64_t> segmentBases(bool scattered)
+    {
+        mt19937_64 random(0x9A6E);
+        vector<uint64_t> bases;
+
+        for (int k = 0; k < SEGMENTS; ++k)
+        {
+            if (scattered)
+                bases.push_back(random() & 0x0000FFFFFFFFF000ULL);
+            else
+                bases.push_back(
+                    AddressSpace::ALLOCATION_BASE
+                        + k * AddressSpace::PAGE_SIZE);
+        }
+
+        return bases;
+    }
+
+    /**
+     * Get addresses to look up within random segments.
+     */
+    vector<uint64_t> lookupAddresses(const vector<uint64_t>& bases)
+    {
+        mt19937_64 random(0x10C4);
+        vector<uint64_t> addresses;
+
+        for (int k = 0; k < LOOKUPS; ++k)
+            addresses.push_back(bases[random() % bases.size()] + k % 8);
+
+        return addresses;
+    }
+
+    /**
+     * Look up random addresses in a page table of small segments.  The
+     * segments are a single octa, so that they need little host memory.
+     */
+    void runPageTable(BenchmarkState& state, bool scattered)
+    {
+        PageTable table;
+        auto bases = segmentBases(scattered);
+        auto addresses = lookupAddresses(bases);
+        vector<unique_ptr<Segment>> segments;
+        volatile uintptr_t sink = 0;
+
+        for (uint64_t base : bases)
+        {
+            segments.emplace_back(new Segment(base, 8, SEGMENT_READ));
+            table.insert(segments.back().get());
+        }
+
+        while (state.keepRunning())
+        {
+            uintptr_t sum = 0;
+            for (uint64_t addr : addresses)
+                sum += reinterpret_cast<uintptr_t>(table.find(addr));
+
+            sink = sum;
+            state.addItems(LOOKUPS);
+            state.addCounter(LOOKUPS * table.memoryUsage() / SEGMENTS);
+        }
+
+        (void)sink;
+    }
+
+    /**
+     * Look up random addresses in an ordered map of small segments.
+     */
+    void runSegmentMap(BenchmarkState& state, bool scattered)
+    {
+        Segment seg(0, 1, SEGMENT_READ);
+        map<uint64_t, Segment*> segments;
+        auto bases = segmentBases(scattered);
+        auto addresses = lookupAddresses(bases);
+        volatile uintptr_t sink = 0;
+
+        for (uint64_t base : bases)
+            segments.emplace(base, &seg);
+
+        while (state.keepRunning())
+        {
+            uintptr_t sum = 0;
+            for (uint64_t addr : addresses)
+            {
+                auto i = segments.upper_bound(addr);
+                --i;
+                if (addr - i->first < 8)
+                    sum += reinterpret_cast<uintptr_t>(i->second);
+            }
+
+            sink = sum;
+            state.addItems(LOOKUPS);
+        }
+
+        (void)sink;
+    }
+}
+
+/**
+ * The page table, with segments packed as allocate() places them.
+ */
+SIMEX_BENCHMARK(page_table_find_packed)
+{
+    runPageTable(state, false);
+}
+
+/**
+ * The page table, with segments scattered across the address space.
+ */
+SIMEX_BENCHMARK(page_table_find_scattered)
+{
+    runPageTable(state, true);
+}
+
+/**
+ * An ordered map, with segments packed as allocate() places them.
+ */
+SIMEX_BENCHMARK(segment_map_find_packed)
+{
+    runSegmentMap(state, false);
+}
+
+/**
+ * An ordered map, with segments scattered across the address space.
+ */
+SIMEX_BENCHMARK(segment_map_find_scattered)
+{
+    runSegmentMap(state, true);
+}
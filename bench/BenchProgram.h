@@ -0,0 +1,86 @@
+/**
+ * \file BenchProgram.h
+ *
+ * Helpers for building small guest programs to benchmark.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#ifndef  SIMEX_BENCH_BENCH_PROGRAM_HEADER_GUARD
+# define SIMEX_BENCH_BENCH_PROGRAM_HEADER_GUARD
+
+#include <cstdint>
+#include <memory>
+#include <simex/MachineState.h>
+#include <vector>
+
+//this header is C++ specific
+#ifdef __cplusplus
+
+namespace simex { namespace bench {
+
+/**
+ * The guest address at which benchmark programs are loaded.
+ */
+const std::uint64_t CODE_BASE = 0x10000;
+
+/**
+ * The guest address of the writable data segment for benchmark programs.
+ */
+const std::uint64_t DATA_BASE = 0x100000;
+
+/**
+ * The size of the writable data segment for benchmark programs.
+ */
+const std::uint64_t DATA_SIZE = 0x100000;
+
+/**
+ * Encode an instruction as a tetra.
+ */
+inline std::uint32_t
+tetra(Opcode op, std::uint8_t x, std::uint8_t y, std::uint8_t z)
+{
+    return DecodedInstruction(op, x, y, z).tetra();
+}
+
+/**
+ * Create a machine with the given program at CODE_BASE and a writable data
+ * segment at DATA_BASE, optionally enforcing policy with the host MMU or
+ * holding memory in the native byte order.
+ */
+inline std::unique_ptr<MachineState>
+machine(const std::vector<std::uint32_t>& program, bool hostProtection = false,
+        ByteOrder order = ByteOrder::BigEndian)
+{
+    auto space = std::make_shared<AddressSpace>(hostProtection, order);
+    std::uint64_t addr = CODE_BASE;
+
+    space->map(CODE_BASE, 4 * program.size(), SEGMENT_READ | SEGMENT_EXECUTE);
+    space->map(DATA_BASE, DATA_SIZE, SEGMENT_READ | SEGMENT_WRITE);
+
+    for (std::uint32_t t : program)
+    {
+        std::uint8_t bytes[4] = {
+            (std::uint8_t)(t >> 24), (std::uint8_t)(t >> 16),
+            (std::uint8_t)(t >> 8), (std::uint8_t)t };
+
+        space->write(addr, bytes, sizeof(bytes));
+        addr += 4;
+    }
+
+    std::unique_ptr<MachineState> state(new MachineState(space));
+    state->setPC(CODE_BASE);
+
+    return state;
+}
+
+/* namespace bench */ } /* namespace simex */ }
+
+//end of C++ code
+#endif //__cplusplus
+
+#endif //SIMEX_BENCH_BENCH_PROGRAM_HEADER_GUARD
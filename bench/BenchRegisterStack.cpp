@@ -0,0 +1,194 @@
+/**
+ * \file BenchRegisterStack.cpp
+ *
+ * Measure calls and returns through the register-stack, for recursion which
+ * stays within the local register ring, recursion deep enough to spill, leaf
+ * calls from a loop, and returns from callee frames of different sizes.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/MachineState.h>
+
+#include "Benchmark.h"
+#include "BenchProgram.h"
+
+using namespace simex;
+using namespace simex::bench;
+using namespace std;
+
+namespace {
+
+    /**
+     * Number of instructions run per benchmark iteration.
+     */
+    const uint64_t STEPS = 1 << 16;
+
+    /**
+     * The special register number of rJ, which each caller saves.
+     */
+    const uint8_t RJ = sreg2offset(SReg::SR_RJ);
+
+    /**
+     * Compute fib(20) recursively, forever.
+     */
+    const vector<uint32_t>& fibProgram()
+    {
+        static const vector<uint32_t> program = {
+            tetra(Opcode::OP_SETL,   2, 0x00, 0x14),
+            tetra(Opcode::OP_PUSHJ,  1, 0x00, 0x02),
+            tetra(Opcode::OP_JMPB,   0xFF, 0xFF, 0xFE),
+            //fib: return $0 < 2 ? $0 : fib($0 - 1) + fib($0 - 2).
+            tetra(Opcode::OP_CMPI,   1, 0, 2),
+            tetra(Opcode::OP_BN,     1, 0x00, 0x08),
+            tetra(Opcode::OP_GET,    1, 0, RJ),
+            tetra(Opcode::OP_SUBI,   3, 0, 1),
+            tetra(Opcode::OP_PUSHJB, 2, 0xFF, 0xFC),
+            tetra(Opcode::OP_SUBI,   4, 0, 2),
+            tetra(Opcode::OP_PUSHJB, 3, 0xFF, 0xFA),
+            tetra(Opcode::OP_PUT,    RJ, 0, 1),
+            tetra(Opcode::OP_ADDU,   0, 2, 3),
+            tetra(Opcode::OP_POP,    1, 0, 0) };
+
+        return program;
+    }
+
+    /**
+     * Compute ackermann(2, 200) recursively, forever.  This nests about 400
+     * frames deep, which is well beyond the local register ring.
+     */
+    const vector<uint32_t>& ackermannProgram()
+    {
+        static const vector<uint32_t> program = {
+            tetra(Opcode::OP_SETL,   1, 0x00, 0x02),
+            tetra(Opcode::OP_SETL,   2, 0x00, 0xC8),
+            tetra(Opcode::OP_PUSHJ,  0, 0x00, 0x02),
+            tetra(Opcode::OP_JMPB,   0xFF, 0xFF, 0xFD),
+            //A(m, n) with m in $0 and n in $1.
+            tetra(Opcode::OP_BNZ,    0, 0x00, 0x03),
+            tetra(Opcode::OP_ADDUI,  0, 1, 1),
+            tetra(Opcode::OP_POP,    1, 0, 0),
+            tetra(Opcode::OP_GET,    2, 0, RJ),
+            tetra(Opcode::OP_BNZ,    1, 0x00, 0x07),
+            //A(m - 1, 1)
+            tetra(Opcode::OP_SUBI,   4, 0, 1),
+            tetra(Opcode::OP_SETL,   5, 0x00, 0x01),
+            tetra(Opcode::OP_PUSHJB, 3, 0xFF, 0xF9),
+            tetra(Opcode::OP_ORI,    0, 3, 0),
+            tetra(Opcode::OP_PUT,    RJ, 0, 2),
+            tetra(Opcode::OP_POP,    1, 0, 0),
+            //A(m - 1, A(m, n - 1))
+            tetra(Opcode::OP_SUBI,   5, 1, 1),
+            tetra(Opcode::OP_ORI,    4, 0, 0),
+            tetra(Opcode::OP_PUSHJB, 3, 0xFF, 0xF3),
+            tetra(Opcode::OP_SUBI,   4, 0, 1),
+            tetra(Opcode::OP_ORI,    5, 3, 0),
+            tetra(Opcode::OP_PUSHJB, 3, 0xFF, 0xF0),
+            tetra(Opcode::OP_ORI,    0, 3, 0),
+            tetra(Opcode::OP_PUT,    RJ, 0, 2),
+            tetra(Opcode::OP_POP,    1, 0, 0) };
+
+        return program;
+    }
+
+    /**
+     * Call a leaf function which increments its argument, forever.
+     */
+    const vector<uint32_t>& leafProgram()
+    {
+        static const vector<uint32_t> program = {
+            tetra(Opcode::OP_ORI,    3, 1, 0),
+            tetra(Opcode::OP_PUSHJ,  2, 0x00, 0x03),
+            tetra(Opcode::OP_ADDU,   1, 1, 2),
+            tetra(Opcode::OP_JMPB,   0xFF, 0xFF, 0xFD),
+            //leaf: return $0 + 1.
+            tetra(Opcode::OP_ADDUI,  0, 0, 1),
+            tetra(Opcode::OP_POP,    1, 0, 0) };
+
+        return program;
+    }
+
+    /**
+     * Call a function which grows its frame to the given number of registers
+     * and returns nothing, forever.  Every register of the callee frame falls
+     * into the hole on POP.
+     */
+    vector<uint32_t> frameProgram(uint8_t frameSize)
+    {
+        return {
+            tetra(Opcode::OP_PUSHJ,  1, 0x00, 0x02),
+            tetra(Opcode::OP_JMPB,   0xFF, 0xFF, 0xFF),
+            //frame: set $(frameSize - 1) and return.
+            tetra(Opcode::OP_SETL,   frameSize - 1, 0x00, 0x01),
+            tetra(Opcode::OP_POP,    0, 0, 0) };
+    }
+
+    /**
+     * Run a call-heavy program.
+     */
+    void runCalls(BenchmarkState& state, const vector<uint32_t>& program)
+    {
+        auto m = machine(program);
+
+        while (state.keepRunning())
+        {
+            m->run(STEPS);
+            state.addItems(STEPS);
+        }
+    }
+}
+
+/**
+ * Recursion which stays within the local register ring.
+ */
+SIMEX_BENCHMARK(register_stack_fib)
+{
+    runCalls(state, fibProgram());
+}
+
+/**
+ * Recursion which spills to and fills from the rS region.
+ */
+SIMEX_BENCHMARK(register_stack_ackermann)
+{
+    runCalls(state, ackermannProgram());
+}
+
+/**
+ * Shallow calls to a leaf function.
+ */
+SIMEX_BENCHMARK(register_stack_leaf)
+{
+    runCalls(state, leafProgram());
+}
+
+/**
+ * Returns from a callee frame larger than the registers which POP zeroes
+ * immediately.
+ */
+SIMEX_BENCHMARK(register_stack_pop_frame_64)
+{
+    runCalls(state, frameProgram(64));
+}
+
+/**
+ * Returns from a larger callee frame.  This should cost the same as returns
+ * from a smaller frame, since POP leaves the callee frame in the hole without
+ * zeroing it.
+ */
+SIMEX_BENCHMARK(register_stack_pop_frame_128)
+{
+    runCalls(state, frameProgram(128));
+}
+
+/**
+ * Returns from a callee frame which uses nearly every register.
+ */
+SIMEX_BENCHMARK(register_stack_pop_frame_250)
+{
+    runCalls(state, frameProgram(250));
+}
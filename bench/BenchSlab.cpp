@@ -0,0 +1,152 @@
+/**
+ * \file BenchSlab.cpp
+ *
+ * Measure the segment allocation system call, with 1 to 32 guest threads
+ * sharing one address space.  Each thread runs its own machine, which
+ * allocates a small segment and frees it again in a loop.  Items are
+ * allocations, counted across all threads.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <memory>
+#include <simex/MachineState.h>
+#include <thread>
+#include <vector>
+
+#include "Benchmark.h"
+#include "BenchProgram.h"
+
+using namespace simex;
+using namespace simex::bench;
+using namespace std;
+
+namespace {
+
+    /**
+     * Number of allocations made by each thread per benchmark iteration.
+     */
+    const uint64_t ROUNDS = 4096;
+
+    /**
+     * Number of instructions in each round of the loop.
+     */
+    const uint64_t ROUND_STEPS = 6;
+
+    /**
+     * An endless loop which allocates a 256 byte segment and frees it.  A
+     * system call drops the registers above its result, so the arguments are
+     * set on every round.
+     */
+    vector<uint32_t> allocateLoop()
+    {
+        return {
+            tetra(Opcode::OP_SETL,    12, 0x01, 0x00),
+            tetra(Opcode::OP_SETL,    13, 0x00,
+                  SEGMENT_READ | SEGMENT_WRITE),
+            tetra(Opcode::OP_SYSCALL, 11, 0x00, 0x01),
+            tetra(Opcode::OP_ORI,     15, 11, 0),
+            tetra(Opcode::OP_SYSCALL, 14, 0x00, 0x02),
+            tetra(Opcode::OP_JMPB,    0xFF, 0xFF, 0xFB) };
+    }
+
+    /**
+     * Run the allocation loop on the given number of threads, each with its
+     * own machine on a shared address space.  The machines run the same code
+     * segment, which each predecodes into blocks of its own.
+     */
+    void runThreads(BenchmarkState& state, size_t count)
+    {
+        vector<uint32_t> program = allocateLoop();
+        auto space = make_shared<AddressSpace>();
+        vector<unique_ptr<MachineState>> machines;
+        uint64_t addr = CODE_BASE;
+
+        space->map(
+            CODE_BASE, 4 * program.size(), SEGMENT_READ | SEGMENT_EXECUTE);
+
+        for (uint32_t t : program)
+        {
+            uint8_t bytes[4] = {
+                (uint8_t)(t >> 24), (uint8_t)(t >> 16), (uint8_t)(t >> 8),
+                (uint8_t)t };
+
+            space->write(addr, bytes, sizeof(bytes));
+            addr += 4;
+        }
+
+        while (machines.size() < count)
+        {
+            machines.emplace_back(new MachineState(space));
+            machines.back()->setPC(CODE_BASE);
+        }
+
+        while (state.keepRunning())
+        {
+            vector<thread> threads;
+
+            for (auto& m : machines)
+            {
+                MachineState* p = m.get();
+                threads.emplace_back([=]() { p->run(ROUNDS * ROUND_STEPS); });
+            }
+
+            for (thread& t : threads)
+                t.join();
+
+            state.addItems(count * ROUNDS);
+        }
+    }
+}
+
+/**
+ * Allocate on one thread.
+ */
+SIMEX_BENCHMARK(slab_allocate_1_thread)
+{
+    runThreads(state, 1);
+}
+
+/**
+ * Allocate on 2 threads.
+ */
+SIMEX_BENCHMARK(slab_allocate_2_threads)
+{
+    runThreads(state, 2);
+}
+
+/**
+ * Allocate on 4 threads.
+ */
+SIMEX_BENCHMARK(slab_allocate_4_threads)
+{
+    runThreads(state, 4);
+}
+
+/**
+ * Allocate on 8 threads.
+ */
+SIMEX_BENCHMARK(slab_allocate_8_threads)
+{
+    runThreads(state, 8);
+}
+
+/**
+ * Allocate on 16 threads.
+ */
+SIMEX_BENCHMARK(slab_allocate_16_threads)
+{
+    runThreads(state, 16);
+}
+
+/**
+ * Allocate on 32 threads.
+ */
+SIMEX_BENCHMARK(slab_allocate_32_threads)
+{
+    runThreads(state, 32);
+}
@@ -0,0 +1,177 @@
+/**
+ * \file BenchStartup.cpp
+ *
+ * Measure the launch of a machine from a 50 MB executable image, with its
+ * segments copied into guest memory or mapped copy-on-write from the image.
+ * The counter is the KiB of memory made resident by each launch.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <cstdio>
+#include <simex/MachineState.h>
+#include <unistd.h>
+
+#include "Benchmark.h"
+#include "BenchProgram.h"
+
+using namespace simex;
+using namespace simex::bench;
+using namespace std;
+
+namespace {
+
+    /**
+     * Layout of the executable image: a text segment followed by an
+     * initialized data segment, which is followed in memory by bss.
+     */
+    const uint64_t TEXT_BASE = 0x10000;
+    const uint64_t TEXT_SIZE = 16 << 20;
+    const uint64_t IMAGE_DATA_BASE = 0x2000000;
+    const uint64_t IMAGE_DATA_SIZE = 34 << 20;
+    const uint64_t BSS_SIZE = 16 << 20;
+
+    /**
+     * Number of instructions run per launch.
+     */
+    const uint64_t STEPS = 64;
+
+    /**
+     * Get the executable image, whose text starts with a loop which copies
+     * octas between the data segment and bss.
+     */
+    int image()
+    {
+        static int fd = -1;
+        if (fd >= 0)
+            return fd;
+
+        FILE* file = tmpfile();
+        fd = fileno(file);
+
+        vector<uint8_t> chunk(1 << 20);
+        uint32_t seed = 1;
+        for (uint8_t& byte : chunk)
+        {
+            seed = seed * 1103515245 + 12345;
+            byte = static_cast<uint8_t>(seed >> 16);
+        }
+
+        const vector<uint32_t> program = {
+            tetra(Opcode::OP_SETML, 1, 0x02, 0x00),
+            tetra(Opcode::OP_SETML, 5, 0x04, 0x20),
+            tetra(Opcode::OP_LDO,   3, 1, 2),
+            tetra(Opcode::OP_STO,   3, 5, 2),
+            tetra(Opcode::OP_ADDUI, 2, 2, 8),
+            tetra(Opcode::OP_JMPB,  0xFF, 0xFF, 0xFD) };
+
+        for (size_t k = 0; k < program.size(); ++k)
+        {
+            chunk[4 * k + 0] = (uint8_t)(program[k] >> 24);
+            chunk[4 * k + 1] = (uint8_t)(program[k] >> 16);
+            chunk[4 * k + 2] = (uint8_t)(program[k] >> 8);
+            chunk[4 * k + 3] = (uint8_t)program[k];
+        }
+
+        for (uint64_t off = 0; off < TEXT_SIZE + IMAGE_DATA_SIZE;
+             off += chunk.size())
+        {
+            ssize_t count = (ssize_t)chunk.size();
+            if (count != pwrite(fd, chunk.data(), chunk.size(), off))
+                return -1;
+        }
+
+        return fd;
+    }
+
+    /**
+     * Map a segment from the image by copying it into guest memory.
+     */
+    void copySegment(
+        AddressSpace& space, uint64_t base, uint64_t size, uint8_t policy,
+        int fd, uint64_t offset, uint64_t length)
+    {
+        vector<uint8_t> chunk(1 << 20);
+
+        space.map(base, size, policy);
+        for (uint64_t done = 0; done < length; done += chunk.size())
+        {
+            pread(fd, chunk.data(), chunk.size(), offset + done);
+            space.write(base + done, chunk.data(), chunk.size());
+        }
+    }
+
+    /**
+     * Get the KiB of memory resident in this process.
+     */
+    uint64_t residentKiB()
+    {
+        unsigned long size = 0, resident = 0;
+        FILE* statm = fopen("/proc/self/statm", "r");
+
+        if (statm)
+        {
+            if (2 != fscanf(statm, "%lu %lu", &size, &resident))
+                resident = 0;
+            fclose(statm);
+        }
+
+        return resident * (uint64_t)sysconf(_SC_PAGESIZE) / 1024;
+    }
+
+    /**
+     * Launch the image repeatedly, loading its segments with the given
+     * method.
+     */
+    template <typename LOAD>
+    void launch(BenchmarkState& state, LOAD load)
+    {
+        int fd = image();
+
+        while (state.keepRunning())
+        {
+            uint64_t before = residentKiB();
+
+            auto space = make_shared<AddressSpace>();
+            load(
+                *space, TEXT_BASE, TEXT_SIZE, SEGMENT_READ | SEGMENT_EXECUTE,
+                fd, 0, TEXT_SIZE);
+            load(
+                *space, IMAGE_DATA_BASE, IMAGE_DATA_SIZE + BSS_SIZE,
+                SEGMENT_READ | SEGMENT_WRITE, fd, TEXT_SIZE, IMAGE_DATA_SIZE);
+
+            MachineState m(space);
+            m.setPC(TEXT_BASE);
+            m.run(STEPS);
+
+            state.addCounter(residentKiB() - before);
+            state.addItems(1);
+        }
+    }
+}
+
+/**
+ * Launch with the image copied into guest memory.
+ */
+SIMEX_BENCHMARK(startup_copy)
+{
+    launch(state, &copySegment);
+}
+
+/**
+ * Launch with the image mapped copy-on-write.
+ */
+SIMEX_BENCHMARK(startup_map_file)
+{
+    launch(
+        state,
+        [](AddressSpace& space, uint64_t base, uint64_t size, uint8_t policy,
+           int fd, uint64_t offset, uint64_t length)
+        {
+            space.mapFile(base, size, policy, fd, offset, length);
+        });
+}
@@ -0,0 +1,194 @@
+/**
+ * \file BenchStreaming.cpp
+ *
+ * Measure clearing, copying, and reading a buffer larger than the last level
+ * cache, with ordinary and uncached loads and stores, and with runs of
+ * stores run one at a time or fused.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/MachineState.h>
+
+#include "Benchmark.h"
+#include "BenchProgram.h"
+
+using namespace simex;
+using namespace simex::bench;
+using namespace std;
+
+namespace {
+
+    /**
+     * The guest address and size of the buffer, which is streamed through
+     * 64 bytes at a time.
+     */
+    const uint64_t BUFFER_BASE = 0x40000000;
+    const uint64_t BUFFER_SIZE = 0x40000000;
+
+    /**
+     * Number of instructions run per benchmark iteration.
+     */
+    const uint64_t STEPS = 1 << 20;
+
+    /**
+     * Set $1 to the buffer, $5 to its second half, and $9 to the mask of the
+     * offset into the given number of bytes.
+     */
+    vector<uint32_t> prologue(uint64_t span)
+    {
+        uint64_t mask = span - 1;
+
+        return {
+            tetra(Opcode::OP_SETML, 1, 0x40, 0x00),
+            tetra(Opcode::OP_SETML, 5, 0x60, 0x00),
+            tetra(Opcode::OP_SETML, 9, (uint8_t)(mask >> 24),
+                  (uint8_t)(mask >> 16)),
+            tetra(Opcode::OP_ORL,   9, 0xFF, 0xFF) };
+    }
+
+    /**
+     * Append eight loads or stores of $10 through $17 to consecutive octas
+     * at $Y.
+     */
+    void octas(vector<uint32_t>& program, Opcode op, uint8_t y, bool constant)
+    {
+        for (uint8_t k = 0; k < 8; ++k)
+            program.push_back(tetra(op, constant ? 0 : 10 + k, y, 8 * k));
+    }
+
+    /**
+     * An endless loop which clears the buffer with STCOI.
+     */
+    vector<uint32_t> clearLoop()
+    {
+        auto program = prologue(BUFFER_SIZE);
+
+        program.push_back(tetra(Opcode::OP_ADDU, 3, 1, 2));
+        octas(program, Opcode::OP_STCOI, 3, true);
+        program.push_back(tetra(Opcode::OP_ADDUI, 2, 2, 64));
+        program.push_back(tetra(Opcode::OP_AND,   2, 2, 9));
+        program.push_back(tetra(Opcode::OP_JMPB,  0xFF, 0xFF, 0xF5));
+
+        return program;
+    }
+
+    /**
+     * An endless loop which copies the first half of the buffer to the
+     * second, with the given load and store.
+     */
+    vector<uint32_t> copyLoop(Opcode load, Opcode store)
+    {
+        auto program = prologue(BUFFER_SIZE / 2);
+
+        program.push_back(tetra(Opcode::OP_ADDU, 3, 1, 2));
+        program.push_back(tetra(Opcode::OP_ADDU, 4, 5, 2));
+        octas(program, load, 3, false);
+        octas(program, store, 4, false);
+        program.push_back(tetra(Opcode::OP_ADDUI, 2, 2, 64));
+        program.push_back(tetra(Opcode::OP_AND,   2, 2, 9));
+        program.push_back(tetra(Opcode::OP_JMPB,  0xFF, 0xFF, 0xEC));
+
+        return program;
+    }
+
+    /**
+     * An endless loop which reads the buffer with the given load.
+     */
+    vector<uint32_t> readLoop(Opcode load)
+    {
+        auto program = prologue(BUFFER_SIZE);
+
+        program.push_back(tetra(Opcode::OP_ADDU, 3, 1, 2));
+        octas(program, load, 3, false);
+        program.push_back(tetra(Opcode::OP_ADDUI, 2, 2, 64));
+        program.push_back(tetra(Opcode::OP_AND,   2, 2, 9));
+        program.push_back(tetra(Opcode::OP_JMPB,  0xFF, 0xFF, 0xF5));
+
+        return program;
+    }
+
+    /**
+     * Run a loop over the buffer, whose pages are all touched first.
+     */
+    void runLoop(
+        BenchmarkState& state, const vector<uint32_t>& program,
+        bool fusion = true)
+    {
+        auto m = machine(program);
+        AddressSpace& space = m->addressSpace();
+        vector<uint8_t> chunk(1 << 20, 0x5A);
+
+        space.map(BUFFER_BASE, BUFFER_SIZE, SEGMENT_READ | SEGMENT_WRITE);
+        for (uint64_t off = 0; off < BUFFER_SIZE; off += chunk.size())
+            space.write(BUFFER_BASE + off, chunk.data(), chunk.size());
+
+        m->setFusion(fusion);
+
+        while (state.keepRunning())
+        {
+            m->run(STEPS);
+            state.addItems(STEPS);
+        }
+    }
+}
+
+/**
+ * Clear with STCOI, one store at a time.
+ */
+SIMEX_BENCHMARK(streaming_clear_stco)
+{
+    runLoop(state, clearLoop(), false);
+}
+
+/**
+ * Clear with runs of STCOI fused into a single fill.
+ */
+SIMEX_BENCHMARK(streaming_clear_stco_fused)
+{
+    runLoop(state, clearLoop());
+}
+
+/**
+ * Copy with LDOI and STOI.
+ */
+SIMEX_BENCHMARK(streaming_copy_cached)
+{
+    runLoop(state, copyLoop(Opcode::OP_LDOI, Opcode::OP_STOI));
+}
+
+/**
+ * Copy with LDUNCI and STUNCI, one store at a time.
+ */
+SIMEX_BENCHMARK(streaming_copy_uncached)
+{
+    runLoop(state, copyLoop(Opcode::OP_LDUNCI, Opcode::OP_STUNCI), false);
+}
+
+/**
+ * Copy with LDUNCI and runs of STUNCI fused into a single copy.
+ */
+SIMEX_BENCHMARK(streaming_copy_uncached_fused)
+{
+    runLoop(state, copyLoop(Opcode::OP_LDUNCI, Opcode::OP_STUNCI));
+}
+
+/**
+ * Read with LDOI.
+ */
+SIMEX_BENCHMARK(streaming_read_cached)
+{
+    runLoop(state, readLoop(Opcode::OP_LDOI));
+}
+
+/**
+ * Read with LDUNCI.
+ */
+SIMEX_BENCHMARK(streaming_read_uncached)
+{
+    runLoop(state, readLoop(Opcode::OP_LDUNCI));
+}
@@ -0,0 +1,122 @@
+/**
+ * \file Benchmark.h
+ *
+ * Minimal benchmark harness for SIMEX micro-benchmarks.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#ifndef  SIMEX_BENCH_BENCHMARK_HEADER_GUARD
+# define SIMEX_BENCH_BENCHMARK_HEADER_GUARD
+
+#include <chrono>
+#include <cstdint>
+
+//this header is C++ specific
+#ifdef __cplusplus
+
+namespace simex { namespace bench {
+
+/**
+ * Get the number of heap allocations performed by this process so far.
+ */
+std::uint64_t allocationCount();
+
+/**
+ * The BenchmarkState tracks timing and the number of items processed by a
+ * single benchmark.
+ */
+class BenchmarkState
+{
+public:
+
+    /**
+     * Create a benchmark state which runs for at least the given duration.
+     */
+    BenchmarkState(std::chrono::nanoseconds minDuration);
+
+    /**
+     * Returns true while the benchmark should keep running.  The first call
+     * starts the clock.
+     */
+    bool keepRunning();
+
+    /**
+     * Record that the given number of items were processed.
+     */
+    inline void addItems(std::uint64_t count) { items_ += count; }
+
+    /**
+     * Record a named counter which is reported per item, such as the number of
+     * dispatches performed.
+     */
+    inline void addCounter(std::uint64_t count) { counter_ += count; }
+
+    /**
+     * Get the number of items processed.
+     */
+    inline std::uint64_t items() const { return items_; }
+
+    /**
+     * Get the counter value.
+     */
+    inline std::uint64_t counter() const { return counter_; }
+
+    /**
+     * Get the number of iterations run.
+     */
+    inline std::uint64_t iterations() const { return iterations_; }
+
+    /**
+     * Get the elapsed time in nanoseconds.
+     */
+    double elapsedNanoseconds() const;
+
+    /**
+     * Get the number of allocations made while the benchmark was running.
+     */
+    inline std::uint64_t allocations() const { return allocations_; }
+
+private:
+    std::chrono::nanoseconds minDuration_;
+    std::chrono::steady_clock::time_point start_;
+    std::chrono::steady_clock::time_point end_;
+    std::uint64_t startAllocations_;
+    std::uint64_t allocations_;
+    std::uint64_t iterations_;
+    std::uint64_t items_;
+    std::uint64_t counter_;
+};
+
+/**
+ * Function type for benchmarks.
+ */
+typedef void (*benchmark_method_t)(BenchmarkState&);
+
+/**
+ * Registering a benchmark adds it to the list run by the benchmark runner.
+ */
+struct BenchmarkRegistration
+{
+    BenchmarkRegistration(const char* name, benchmark_method_t method);
+};
+
+/* namespace bench */ } /* namespace simex */ }
+
+/**
+ * Define a benchmark with the given name.
+ */
+#define SIMEX_BENCHMARK(name) \
+    static void benchmark_##name(simex::bench::BenchmarkState&); \
+    static simex::bench::BenchmarkRegistration \
+        benchmarkRegistration_##name(#name, &benchmark_##name); \
+    static void benchmark_##name(simex::bench::BenchmarkState& state)
+
+//end of C++ code
+#endif //__cplusplus
+
+#endif //SIMEX_BENCH_BENCHMARK_HEADER_GUARD
@@ -0,0 +1,169 @@
+/**
+ * \file main.cpp
+ *
+ * Benchmark runner.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Benchmark.h"
+
+using namespace simex::bench;
+using namespace std;
+
+namespace {
+
+    /**
+     * Process-wide allocation counter.
+     */
+    atomic<uint64_t> allocations(0);
+
+    /**
+     * Get the list of registered benchmarks.
+     */
+    vector<pair<string, benchmark_method_t>>& registry()
+    {
+        static vector<pair<string, benchmark_method_t>> benchmarks;
+
+        return benchmarks;
+    }
+}
+
+/**
+ * Count every heap allocation.
+ */
+void* operator new(size_t size)
+{
+    allocations.fetch_add(1, memory_order_relaxed);
+
+    void* ptr = malloc(size ? size : 1);
+    if (!ptr)
+        throw bad_alloc();
+
+    return ptr;
+}
+
+/**
+ * Release memory allocated by the counting operator new.
+ */
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+/**
+ * Release memory allocated by the counting operator new.
+ */
+void operator delete(void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+/**
+ * Get the number of heap allocations performed by this process so far.
+ */
+uint64_t simex::bench::allocationCount()
+{
+    return allocations.load(memory_order_relaxed);
+}
+
+/**
+ * Create a benchmark state which runs for at least the given duration.
+ */
+BenchmarkState::BenchmarkState(chrono::nanoseconds minDuration)
+    : minDuration_(minDuration), startAllocations_(0), allocations_(0),
+      iterations_(0), items_(0), counter_(0)
+{
+}
+
+/**
+ * Returns true while the benchmark should keep running.  The first call
+ * starts the clock.
+ */
+bool BenchmarkState::keepRunning()
+{
+    auto now = chrono::steady_clock::now();
+
+    if (iterations_ == 0)
+    {
+        startAllocations_ = allocationCount();
+        start_ = chrono::steady_clock::now();
+        ++iterations_;
+
+        return true;
+    }
+
+    end_ = now;
+    allocations_ = allocationCount() - startAllocations_;
+
+    if (end_ - start_ < minDuration_)
+    {
+        ++iterations_;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * Get the elapsed time in nanoseconds.
+ */
+double BenchmarkState::elapsedNanoseconds() const
+{
+    return chrono::duration<double, nano>(end_ - start_).count();
+}
+
+/**
+ * Register a benchmark.
+ */
+BenchmarkRegistration::BenchmarkRegistration(
+    const char* name, benchmark_method_t method)
+{
+    registry().push_back(make_pair(string(name), method));
+}
+
+/**
+ * Run every benchmark whose name contains the (optional) filter argument.
+ */
+int main(int argc, char* argv[])
+{
+    const char* filter = argc > 1 ? argv[1] : "";
+
+    printf("%-40s %14s %12s %14s %12s %12s\n",
+           "benchmark", "items", "ns/item", "items/s", "allocs/item",
+           "counter/item");
+
+    for (auto& bench : registry())
+    {
+        if (!strstr(bench.first.c_str(), filter))
+            continue;
+
+        BenchmarkState state(chrono::milliseconds(250));
+        bench.second(state);
+
+        double items = state.items() ? (double)state.items() : 1.0;
+
+        printf("%-40s %14llu %12.3f %14.0f %12.4f %12.4f\n",
+               bench.first.c_str(),
+               (unsigned long long)state.items(),
+               state.elapsedNanoseconds() / items,
+               items * 1e9 / state.elapsedNanoseconds(),
+               (double)state.allocations() / items,
+               (double)state.counter() / items);
+    }
+
+    return 0;
+}
@@ -0,0 +1,585 @@
+/**
+ * \file AddressSpace.h
+ *
+ * Guest memory segments and the address space which holds them.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#ifndef  SIMEX_ADDRESS_SPACE_HEADER_GUARD
+# define SIMEX_ADDRESS_SPACE_HEADER_GUARD
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <simex/PageTable.h>
+#include <utility>
+#include <vector>
+
+//this header is C++ specific
+#ifdef __cplusplus
+
+namespace simex {
+
+/**
+ * Segment policy bit: the segment can be read.
+ */
+const std::uint8_t SEGMENT_READ         = 0x01;
+
+/**
+ * Segment policy bit: the segment can be written.
+ */
+const std::uint8_t SEGMENT_WRITE        = 0x02;
+
+/**
+ * Segment policy bit: the segment contains executable code.
+ */
+const std::uint8_t SEGMENT_EXECUTE      = 0x04;
+
+/**
+ * Mask of all valid segment policy bits.
+ */
+const std::uint8_t SEGMENT_POLICY_MASK  = 0x07;
+
+/**
+ * The order in which guest memory holds the bytes of each value.
+ */
+enum class ByteOrder : std::uint8_t
+{
+    //every value is held in guest byte order, most significant byte first.
+    BigEndian,
+    //every octa is held in host byte order.  The byte at guest address a is
+    //held at a ^ NATIVE_BYTE_SWIZZLE, so that a value of size s at an aligned
+    //guest address a is held in host order at a ^ (NATIVE_BYTE_SWIZZLE &
+    //(8 - s)).
+    Native
+};
+
+/**
+ * The low address bits which are flipped to find a guest byte in memory with
+ * the native byte order.  This is zero on a big-endian host.
+ */
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+const std::uint64_t NATIVE_BYTE_SWIZZLE = 0;
+#else
+const std::uint64_t NATIVE_BYTE_SWIZZLE = 7;
+#endif
+
+/**
+ * A Segment is a contiguous region of guest memory with a policy.
+ */
+class Segment
+{
+public:
+
+    /**
+     * Create a zero-filled segment.  The host commits the memory of a large
+     * segment as its pages are first touched.
+     *
+     * \param base      The guest address of the first byte of this segment.
+     * \param size      The size of this segment, in bytes.
+     * \param policy    The policy bits for this segment.
+     */
+    Segment(std::uint64_t base, std::uint64_t size, std::uint8_t policy);
+
+    /**
+     * Create a segment over existing host memory, which must be zero-filled
+     * and outlive the segment.
+     *
+     * \param base      The guest address of the first byte of this segment.
+     * \param size      The size of this segment, in bytes.
+     * \param policy    The policy bits for this segment.
+     * \param memory    The host memory backing this segment.
+     */
+    Segment(std::uint64_t base, std::uint64_t size, std::uint8_t policy,
+            std::uint8_t* memory);
+
+    /**
+     * Create a segment over a host mapping, which the segment takes and
+     * unmaps when it is destroyed.
+     *
+     * \param base      The guest address of the first byte of this segment.
+     * \param size      The size of this segment, in bytes.
+     * \param policy    The policy bits for this segment.
+     * \param memory    The host mapping backing this segment.
+     * \param mapped    The length of the host mapping, in bytes.
+     */
+    Segment(std::uint64_t base, std::uint64_t size, std::uint8_t policy,
+            std::uint8_t* memory, std::uint64_t mapped);
+
+    /**
+     * Destructor.
+     */
+    ~Segment();
+
+    /**
+     * Get the guest address of the first byte of this segment.
+     */
+    inline std::uint64_t base() const { return base_; }
+
+    /**
+     * Get the size of this segment, in bytes.
+     */
+    inline std::uint64_t size() const { return size_; }
+
+    /**
+     * Get the policy bits for this segment.
+     */
+    inline std::uint8_t policy() const
+    {
+        return policy_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Returns false while this is a slab segment which is not allocated.
+     * Such a segment is never found.
+     */
+    inline bool inUse() const
+    {
+        return inUse_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Set the policy bits for this segment.  This gives the segment a new
+     * version.  Machine states cache the policy of each page they access, so
+     * use AddressSpace::changePolicy() to change the policy of a mapped
+     * segment.
+     */
+    inline void setPolicy(std::uint8_t policy)
+    {
+        policy_.store(policy, std::memory_order_relaxed);
+        changed();
+    }
+
+    /**
+     * Get the version of this segment.  This changes whenever the policy
+     * changes or the host writes to the segment, and no two segments ever
+     * share a version, so that data derived from the contents of a segment,
+     * such as predecoded instructions, can be checked cheaply.
+     */
+    inline std::uint64_t version() const
+    {
+        return version_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Returns true if the given guest address lies within this segment.
+     */
+    inline bool contains(std::uint64_t addr) const
+    {
+        return addr >= base_ && addr - base_ < size_;
+    }
+
+    /**
+     * Get the host memory backing this segment.
+     */
+    inline std::uint8_t* data() { return memory_; }
+
+private:
+    friend class AddressSpace;
+
+    //the fields read to fill a TLB entry come first, in one cache line.
+    std::uint64_t base_;
+    std::uint64_t size_;
+    std::uint8_t* memory_;
+    std::atomic<std::uint8_t> policy_;
+    //the size class of a slab segment plus one, or 0 for other segments.
+    std::uint8_t sizeClass_;
+    std::atomic<bool> inUse_;
+    std::uint8_t* allocated_;
+    std::uint64_t mapped_;
+    std::atomic<std::uint64_t> version_;
+
+    /**
+     * Get a version which no segment has had before.
+     */
+    static std::uint64_t nextVersion();
+
+    /**
+     * Give this segment a new version, once its contents or policy changed.
+     */
+    inline void changed()
+    {
+        version_.store(nextVersion(), std::memory_order_release);
+    }
+};
+
+class SlabCache;
+
+/**
+ * The AddressSpace holds the segments visible to one or more machine states.
+ *
+ * Segments are found through a radix page table, so find(), read(), and
+ * write() may run on any number of threads.  Mapping, allocating, and
+ * freeing segments, and changing their policy, take a lock, except that
+ * small segments allocated and freed through a SlabCache rarely do.  Freeing
+ * a segment or changing its policy must not race with accesses to that
+ * segment.
+ *
+ * Small segments allocated through a SlabCache are slab segments: each size
+ * class is carved into slabs of SLAB_SLOTS segments, which stay mapped for
+ * the life of the address space.  A free slab segment is never found, and is
+ * zero-filled before it is handed out again.
+ */
+class AddressSpace
+{
+public:
+
+    /**
+     * The granularity, in bytes, at which segments are placed and sized.
+     */
+    static const std::uint64_t PAGE_SIZE = 4096;
+
+    /**
+     * The guest address at which allocate() begins placing segments.
+     */
+    static const std::uint64_t ALLOCATION_BASE = 0x0000000100000000ULL;
+
+    /**
+     * The size of the host arena of an address space with host protection.
+     * Segments below this guest address are placed in the arena.
+     */
+    static const std::uint64_t HOST_ARENA_SIZE = 0x0000010000000000ULL;
+
+    /**
+     * The number of slab size classes.  Class k holds segments of
+     * PAGE_SIZE << k bytes.
+     */
+    static const std::size_t SLAB_CLASS_COUNT = 5;
+
+    /**
+     * The size of the largest slab segment.  Larger segments are mapped
+     * directly from the host.
+     */
+    static const std::uint64_t SLAB_MAX_SIZE =
+        PAGE_SIZE << (SLAB_CLASS_COUNT - 1);
+
+    /**
+     * The number of segments carved from each slab.
+     */
+    static const std::size_t SLAB_SLOTS = 64;
+
+    /**
+     * The number of free slab segments moved at once between a SlabCache and
+     * the shared depot.
+     */
+    static const std::size_t SLAB_BATCH = 16;
+
+    /**
+     * Create an empty address space.
+     *
+     * With host protection, segments below HOST_ARENA_SIZE live in a host
+     * arena at the same offset as their guest address, and the host MMU
+     * enforces their policy, so that machines can load and store without
+     * checking policy in software.  If the host can't provide the arena,
+     * policy is checked in software.
+     *
+     * In the native byte order, guest memory holds each octa in host order,
+     * so that loads and stores don't swap bytes.  The host still sees guest
+     * byte order through read() and write().
+     *
+     * \param hostProtection    true to enforce policy with the host MMU.
+     * \param order             the order in which memory holds each value.
+     */
+    explicit AddressSpace(
+        bool hostProtection = false, ByteOrder order = ByteOrder::BigEndian);
+
+    /**
+     * Destructor.
+     */
+    ~AddressSpace();
+
+    /**
+     * Map a new segment at a fixed guest address.
+     *
+     * \param base      The page aligned guest address of the segment.
+     * \param size      The size of the segment, in bytes.
+     * \param policy    The policy bits for the segment.
+     *
+     * \returns the new segment, or nullptr if the segment is misaligned or
+     * would overlap an existing segment.
+     */
+    Segment* map(std::uint64_t base, std::uint64_t size, std::uint8_t policy);
+
+    /**
+     * Map a new segment at a fixed guest address, initialized from a region
+     * of a file, such as a segment of an executable image.  The file is
+     * mapped copy-on-write, so that only the pages which are touched are
+     * read, and only the pages which are written are copied.  Bytes past the
+     * file region are zero-filled.  Changes are never written to the file.
+     *
+     * The file holds guest byte order, so in the native byte order, or in the
+     * host arena, the file region is copied into the segment instead.
+     *
+     * \param base      The page aligned guest address of the segment.
+     * \param size      The size of the segment, in bytes.
+     * \param policy    The policy bits for the segment.
+     * \param fd        The file to map, which may be closed afterward.
+     * \param offset    The page aligned offset of the region in the file.
+     * \param length    The length of the region, no larger than size.
+     *
+     * \returns the new segment, or nullptr if the segment is misaligned,
+     * would overlap an existing segment, or the region can't be read.
+     */
+    Segment* mapFile(
+        std::uint64_t base, std::uint64_t size, std::uint8_t policy, int fd,
+        std::uint64_t offset, std::uint64_t length);
+
+    /**
+     * Allocate a new segment at an implementation-defined guest address.
+     *
+     * \param size      The minimum size of the segment, in bytes.
+     * \param policy    The policy bits for the segment.
+     *
+     * \returns the guest address of the new segment, or 0 on failure.
+     */
+    std::uint64_t allocate(std::uint64_t size, std::uint8_t policy);
+
+    /**
+     * Allocate a new segment for a system thread.  A small segment without
+     * execute policy is a slab segment from the thread's cache, which only
+     * takes a lock when the cache is empty.  Others are allocated as by
+     * allocate(size, policy).
+     *
+     * \param size      The minimum size of the segment, in bytes.
+     * \param policy    The policy bits for the segment.
+     * \param cache     The slab cache of the allocating system thread.
+     *
+     * \returns the guest address of the new segment, or 0 on failure.
+     */
+    std::uint64_t
+    allocate(std::uint64_t size, std::uint8_t policy, SlabCache& cache);
+
+    /**
+     * Free the segment starting at the given guest address.
+     *
+     * \param base      The base address of the segment to free.
+     *
+     * \returns true if a segment was freed.
+     */
+    bool free(std::uint64_t base);
+
+    /**
+     * Free the segment starting at the given guest address for a system
+     * thread.  A slab segment goes back to the thread's cache, which only
+     * takes a lock when the cache is full.
+     *
+     * \param base      The base address of the segment to free.
+     * \param cache     The slab cache of the freeing system thread.
+     *
+     * \returns true if a segment was freed.
+     */
+    bool free(std::uint64_t base, SlabCache& cache);
+
+    /**
+     * Change the policy of the segment starting at the given guest address.
+     *
+     * \param base      The base address of the segment.
+     * \param policy    The new policy bits for the segment.
+     *
+     * \returns true if the policy was changed.
+     */
+    bool changePolicy(std::uint64_t base, std::uint8_t policy);
+
+    /**
+     * Find the segment containing the given guest address.  This is
+     * lock-free, and its cost does not depend on the number of segments.
+     *
+     * \param addr      The guest address to look up.
+     *
+     * \returns the segment containing this address, or nullptr.
+     */
+    Segment* find(std::uint64_t addr);
+
+    /**
+     * Copy bytes out of guest memory, ignoring segment policy.  This is used
+     * by the host, such as by loaders and system calls.  Bytes are copied in
+     * guest byte order, whatever the byte order of memory.
+     *
+     * \param addr      The guest address to read from.
+     * \param out       The host buffer to read into.
+     * \param size      The number of bytes to read.
+     *
+     * \returns true if the whole range was mapped and copied.
+     */
+    bool read(std::uint64_t addr, void* out, std::size_t size);
+
+    /**
+     * Copy bytes into guest memory, ignoring segment policy.  This is used by
+     * the host, such as by loaders and system calls.  Bytes are copied in
+     * guest byte order, whatever the byte order of memory.  Each segment
+     * written to gets a new version.
+     *
+     * \param addr      The guest address to write to.
+     * \param in        The host buffer to write from.
+     * \param size      The number of bytes to write.
+     *
+     * \returns true if the whole range was mapped and copied.
+     */
+    bool write(std::uint64_t addr, const void* in, std::size_t size);
+
+    /**
+     * Get the generation of this address space.  This changes whenever a
+     * segment is mapped, freed, or changes policy, so that translations
+     * cached by a machine state can be checked cheaply.  Handing out a free
+     * slab segment doesn't change it, since no translation of a free segment
+     * is ever cached.
+     */
+    inline std::uint64_t generation() const
+    {
+        return generation_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Get the order in which guest memory holds the bytes of each value.
+     */
+    inline ByteOrder byteOrder() const { return order_; }
+
+    /**
+     * Get the guest view of the host arena, where the octa at each guest
+     * address below HOST_ARENA_SIZE is at the same offset, or nullptr if this
+     * address space has no host protection.  Pages of the guest view are
+     * only accessible as far as the policy of their segment allows; an
+     * access which the host MMU refuses raises SIGSEGV.
+     */
+    inline std::uint8_t* guestView() const { return guestView_; }
+
+private:
+
+    friend class SlabCache;
+
+    /**
+     * Returns true if any segment overlaps the given range of guest
+     * addresses.  The caller holds the lock.
+     */
+    bool overlaps(std::uint64_t base, std::uint64_t length) const;
+
+    /**
+     * Map a new segment at a fixed guest address.  The caller holds the
+     * lock.
+     */
+    Segment* place(std::uint64_t base, std::uint64_t size, std::uint8_t policy);
+
+    /**
+     * Carve a new slab for a size class, adding its segments to the depot.
+     * The caller holds the lock.
+     *
+     * \returns false if there is no room for the slab.
+     */
+    bool carveSlab(std::size_t sizeClass);
+
+    /**
+     * Move a batch of free slab segments of a size class from the depot to a
+     * cache, carving a new slab if the depot is empty.
+     *
+     * \returns false if no segment could be moved.
+     */
+    bool refill(SlabCache& cache, std::size_t sizeClass);
+
+    /**
+     * Move up to count free slab segments of a size class from a cache to the
+     * depot.
+     */
+    void drain(SlabCache& cache, std::size_t sizeClass, std::size_t count);
+
+    /**
+     * Mark a slab segment free, revoking its policy and zero-filling it.
+     *
+     * \returns false if the segment was already free.
+     */
+    bool release(Segment* seg);
+
+    /**
+     * Insert a new segment, unless it would overlap an existing segment.  The
+     * caller holds the lock.
+     *
+     * \param seg       The segment to insert.
+     *
+     * \returns the inserted segment, or nullptr if it was discarded.
+     */
+    Segment* insert(std::unique_ptr<Segment> seg);
+
+    /**
+     * Set the host protection of the guest view of a range of the arena to
+     * match a segment policy.
+     */
+    void protect(std::uint64_t base, std::uint64_t size, std::uint8_t policy);
+
+    /**
+     * Copy bytes out of memory with the native byte order.
+     *
+     * \param out       The host buffer to copy into, in guest byte order.
+     * \param data      The memory of the segment holding the bytes.
+     * \param offset    The offset of the first byte in the segment.
+     * \param size      The number of bytes to copy.
+     */
+    static void readNative(
+        std::uint8_t* out, const std::uint8_t* data, std::uint64_t offset,
+        std::size_t size);
+
+    /**
+     * Copy bytes into memory with the native byte order.
+     *
+     * \param data      The memory of the segment holding the bytes.
+     * \param offset    The offset of the first byte in the segment.
+     * \param in        The host buffer to copy from, in guest byte order.
+     * \param size      The number of bytes to copy.
+     */
+    static void writeNative(
+        std::uint8_t* data, std::uint64_t offset, const std::uint8_t* in,
+        std::size_t size);
+
+    std::mutex lock_;
+    std::map<std::uint64_t, std::unique_ptr<Segment>> segments_;
+    std::vector<Segment*> depot_[SLAB_CLASS_COUNT];
+    std::vector<std::pair<std::uint8_t*, std::uint64_t>> slabMemory_;
+    PageTable pages_;
+    std::uint64_t nextBase_;
+    std::atomic<std::uint64_t> generation_;
+    ByteOrder order_;
+    int arenaFile_;
+    std::uint8_t* guestView_;
+    std::uint8_t* hostView_;
+};
+
+/**
+ * A SlabCache holds the free slab segments of a single system thread, so
+ * that most of its small allocations and frees take no lock.  Each machine
+ * state has one.  A cache must be destroyed before its address space.
+ */
+class SlabCache
+{
+public:
+
+    /**
+     * Create an empty cache for allocating from the given address space.
+     *
+     * \param space     The address space to allocate from.
+     */
+    explicit SlabCache(AddressSpace& space);
+
+    /**
+     * Destructor.  Free segments go back to the depot of the address space.
+     */
+    ~SlabCache();
+
+private:
+    friend class AddressSpace;
+
+    AddressSpace& space_;
+    std::vector<Segment*> free_[AddressSpace::SLAB_CLASS_COUNT];
+};
+
+/* namespace simex */ }
+
+//end of C++ code
+#endif //__cplusplus
+
+#endif //SIMEX_ADDRESS_SPACE_HEADER_GUARD
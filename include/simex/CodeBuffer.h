@@ -0,0 +1,218 @@
+/**
+ * \file CodeBuffer.h
+ *
+ * A contiguous buffer of big-endian instruction tetras and data.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#ifndef  SIMEX_CODE_BUFFER_HEADER_GUARD
+# define SIMEX_CODE_BUFFER_HEADER_GUARD
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+#include <simex/DecodedInstruction.h>
+
+//this header is C++ specific
+#ifdef __cplusplus
+
+namespace simex {
+
+/**
+ * A CodeBuffer collects emitted instructions and data in contiguous memory,
+ * so that a whole section can be written with a single call.
+ *
+ * A default constructed buffer owns its memory and grows as needed.  A buffer
+ * can instead be placed over existing memory, such as a memory-mapped section
+ * of an output file; such a buffer never grows, and appends which would
+ * overflow it fail.
+ */
+class CodeBuffer
+{
+public:
+
+    /**
+     * Create an empty buffer which owns its memory.
+     */
+    CodeBuffer();
+
+    /**
+     * Create an empty buffer over existing memory.
+     *
+     * \param memory    The memory to write into.
+     * \param capacity  The size of this memory, in bytes.
+     */
+    CodeBuffer(std::uint8_t* memory, std::size_t capacity);
+
+    /**
+     * Destructor.
+     */
+    ~CodeBuffer();
+
+    CodeBuffer(const CodeBuffer&) = delete;
+    CodeBuffer& operator=(const CodeBuffer&) = delete;
+
+    /**
+     * Append a tetra in big-endian byte order.
+     *
+     * \param tetra     The tetra to append.
+     *
+     * \returns true if the tetra was appended, or false if this buffer is
+     * placed over existing memory which is full.
+     */
+    inline bool emitTetra(std::uint32_t tetra)
+    {
+        if (size_ + 4 > capacity_ && !grow(4))
+            return false;
+
+        std::uint8_t* p = data_ + size_;
+        p[0] = static_cast<std::uint8_t>(tetra >> 24);
+        p[1] = static_cast<std::uint8_t>(tetra >> 16);
+        p[2] = static_cast<std::uint8_t>(tetra >> 8);
+        p[3] = static_cast<std::uint8_t>(tetra);
+        size_ += 4;
+
+        return true;
+    }
+
+    /**
+     * Append an instruction.
+     *
+     * \param ins       The instruction to append.
+     *
+     * \returns true if the instruction was appended.
+     */
+    inline bool emit(DecodedInstruction ins)
+    {
+        return emitTetra(ins.tetra());
+    }
+
+    /**
+     * Append raw bytes, such as data embedded in a code section.
+     *
+     * \param in        The bytes to append.
+     * \param size      The number of bytes to append.
+     *
+     * \returns true if the bytes were appended.
+     */
+    bool emitBytes(const void* in, std::size_t size);
+
+    /**
+     * Replace a previously emitted tetra, such as a forward branch whose
+     * target is now known.
+     *
+     * \param offset    The byte offset of the tetra within this buffer.
+     * \param tetra     The new tetra value.
+     *
+     * \returns true if the tetra was replaced, or false if it lies outside of
+     * the emitted bytes.
+     */
+    bool patchTetra(std::size_t offset, std::uint32_t tetra);
+
+    /**
+     * Replace a previously emitted instruction.
+     *
+     * \param offset    The byte offset of the instruction within this buffer.
+     * \param ins       The new instruction.
+     *
+     * \returns true if the instruction was replaced.
+     */
+    inline bool patch(std::size_t offset, DecodedInstruction ins)
+    {
+        return patchTetra(offset, ins.tetra());
+    }
+
+    /**
+     * Read back a previously emitted tetra.
+     *
+     * \param offset    The byte offset of the tetra, which must lie within the
+     *                  emitted bytes.
+     */
+    inline std::uint32_t tetraAt(std::size_t offset) const
+    {
+        const std::uint8_t* p = data_ + offset;
+
+        return
+            (static_cast<std::uint32_t>(p[0]) << 24)
+          | (static_cast<std::uint32_t>(p[1]) << 16)
+          | (static_cast<std::uint32_t>(p[2]) << 8)
+          | p[3];
+    }
+
+    /**
+     * Make sure that at least the given number of bytes can be appended
+     * without growing again.
+     *
+     * \returns true if the space is available.
+     */
+    bool reserve(std::size_t bytes);
+
+    /**
+     * Discard everything emitted, keeping the memory.
+     */
+    inline void clear() { size_ = 0; }
+
+    /**
+     * Get the number of bytes emitted.
+     */
+    inline std::size_t size() const { return size_; }
+
+    /**
+     * Get the number of bytes which can be emitted before growing.
+     */
+    inline std::size_t capacity() const { return capacity_; }
+
+    /**
+     * Get the emitted bytes.
+     */
+    inline const std::uint8_t* data() const { return data_; }
+
+    /**
+     * Write everything emitted to an ostream with a single write.
+     *
+     * \param out       The binary ostream to write to.
+     *
+     * \returns true if the stream is still good after the write.
+     */
+    bool write(std::ostream& out) const;
+
+    /**
+     * Write everything emitted to a file descriptor.  A single write is
+     * issued unless the descriptor accepts only part of the data.
+     *
+     * \param fd        The file descriptor to write to.
+     *
+     * \returns true if every byte was written.
+     */
+    bool write(int fd) const;
+
+private:
+
+    /**
+     * Grow owned memory to hold at least the given number of additional
+     * bytes.
+     *
+     * \returns false if this buffer is placed over existing memory.
+     */
+    bool grow(std::size_t bytes);
+
+    std::uint8_t* data_;
+    std::size_t size_;
+    std::size_t capacity_;
+    bool owned_;
+    std::vector<std::uint8_t> storage_;
+};
+
+/* namespace simex */ }
+
+//end of C++ code
+#endif //__cplusplus
+
+#endif //SIMEX_CODE_BUFFER_HEADER_GUARD
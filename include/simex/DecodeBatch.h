@@ -0,0 +1,105 @@
+/**
+ * \file DecodeBatch.h
+ *
+ * Decode whole runs of big-endian instruction tetras into
+ * structure-of-arrays form.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#ifndef  SIMEX_DECODE_BATCH_HEADER_GUARD
+# define SIMEX_DECODE_BATCH_HEADER_GUARD
+
+#include <cstddef>
+#include <cstdint>
+
+#include <simex/Opcode.h>
+
+//this header is C++ specific
+#ifdef __cplusplus
+
+namespace simex {
+
+/**
+ * The output arrays for a batch decode.  Entry i of each array describes the
+ * i-th instruction of the batch.  Each array must have room for the number of
+ * instructions decoded.
+ */
+struct DecodedBatch
+{
+    //the opcode of each instruction.
+    Opcode* opcode;
+    //the X value of each instruction.
+    std::uint8_t* x;
+    //the Y value of each instruction.
+    std::uint8_t* y;
+    //the Z value of each instruction.
+    std::uint8_t* z;
+    //the combined 16-bit YZ value of each instruction.
+    std::uint16_t* yz;
+    //the combined 24-bit XYZ value of each instruction.
+    std::uint32_t* xyz;
+};
+
+/**
+ * The implementations available for batch decoding.
+ */
+enum class DecodeStrategy
+{
+    //one instruction at a time; always available.
+    Scalar                      = 0,
+    //SSSE3 byte shuffles, sixteen instructions at a time.
+    SSSE3,
+    //AVX2 byte shuffles, thirty-two instructions at a time.
+    AVX2
+};
+
+/**
+ * Returns true if the given strategy can run on this processor.
+ *
+ * \param strategy  The strategy to check.
+ */
+bool decodeStrategySupported(DecodeStrategy strategy);
+
+/**
+ * Get the fastest strategy supported by this processor.
+ */
+DecodeStrategy bestDecodeStrategy();
+
+/**
+ * Decode a run of big-endian instruction tetras using the fastest strategy
+ * supported by this processor.
+ *
+ * \param in        Pointer to the first byte of the first tetra.  No
+ *                  alignment is required.
+ * \param count     The number of tetras to decode.
+ * \param out       The output arrays.
+ */
+void decodeBatch(
+    const std::uint8_t* in, std::size_t count, const DecodedBatch& out);
+
+/**
+ * Decode a run of big-endian instruction tetras using the given strategy.  If
+ * the strategy is not supported by this processor, the scalar strategy is
+ * used.
+ *
+ * \param in        Pointer to the first byte of the first tetra.  No
+ *                  alignment is required.
+ * \param count     The number of tetras to decode.
+ * \param out       The output arrays.
+ * \param strategy  The strategy to use.
+ */
+void decodeBatch(
+    const std::uint8_t* in, std::size_t count, const DecodedBatch& out,
+    DecodeStrategy strategy);
+
+/* namespace simex */ }
+
+//end of C++ code
+#endif //__cplusplus
+
+#endif //SIMEX_DECODE_BATCH_HEADER_GUARD
@@ -0,0 +1,231 @@
+/**
+ * \file DecodedInstruction.h
+ *
+ * Allocation-free decoded instruction values.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#ifndef  SIMEX_DECODED_INSTRUCTION_HEADER_GUARD
+# define SIMEX_DECODED_INSTRUCTION_HEADER_GUARD
+
+#include <cstdint>
+#include <iosfwd>
+
+#include <simex/Opcode.h>
+#include <simex/OpcodeTraits.h>
+
+//this header is C++ specific
+#ifdef __cplusplus
+
+namespace simex {
+
+/**
+ * Forward declaration for MachineState.
+ */
+class MachineState;
+
+/**
+ * Forward declaration for CodeBuffer.
+ */
+class CodeBuffer;
+
+/**
+ * An InstructionHandler is the flyweight shared by every decoded instruction
+ * with a given opcode.  There is exactly one static handler per opcode, which
+ * describes the opcode.
+ */
+struct InstructionHandler
+{
+    //the opcode handled by this handler.
+    Opcode opcode;
+    //the name of this opcode.
+    const char* name;
+};
+
+/**
+ * Get the flyweight handler for the given opcode.
+ *
+ * \param op        The opcode to look up.
+ *
+ * \returns the static handler for this opcode.
+ */
+const InstructionHandler& instructionHandler(Opcode op);
+
+/**
+ * A DecodedInstruction is a four byte value holding an opcode, an X value, a Y
+ * value, and a Z value.  Unlike Instruction, decoding a DecodedInstruction
+ * never allocates; per-opcode details are found through the static
+ * InstructionHandler table.
+ */
+class DecodedInstruction
+{
+public:
+
+    /**
+     * The default constructor creates a SYSCALL 0,0,0 instruction.
+     */
+    DecodedInstruction()
+        : op_{Opcode::OP_SYSCALL}, x_{0}, y_{0}, z_{0}
+    {
+    }
+
+    /**
+     * Create a decoded instruction from an opcode and an XYZ value.
+     */
+    DecodedInstruction(Opcode op, std::uint8_t x, std::uint8_t y,
+                       std::uint8_t z)
+        : op_{op}, x_{x}, y_{y}, z_{z}
+    {
+    }
+
+    /**
+     * Decode an instruction from its component values.
+     *
+     * \param op    The opcode for this instruction.
+     * \param x     The X value for this instruction.
+     * \param y     The Y value for this instruction.
+     * \param z     The Z value for this instruction.
+     *
+     * \returns the decoded instruction.
+     */
+    static inline DecodedInstruction
+    decode(Opcode op, std::uint8_t x, std::uint8_t y, std::uint8_t z)
+    {
+        return DecodedInstruction(op, x, y, z);
+    }
+
+    /**
+     * Decode an instruction from a tetra value, with the opcode in the most
+     * significant byte.
+     *
+     * \param tetra The tetra value to decode.
+     *
+     * \returns the decoded instruction.
+     */
+    static inline DecodedInstruction decode(std::uint32_t tetra)
+    {
+        return
+            DecodedInstruction(
+                static_cast<Opcode>(tetra >> 24),
+                static_cast<std::uint8_t>(tetra >> 16),
+                static_cast<std::uint8_t>(tetra >> 8),
+                static_cast<std::uint8_t>(tetra));
+    }
+
+    /**
+     * Decode an instruction from four big-endian bytes in memory.
+     *
+     * \param in    Pointer to the first byte of the instruction.
+     *
+     * \returns the decoded instruction.
+     */
+    static inline DecodedInstruction decode(const std::uint8_t* in)
+    {
+        return DecodedInstruction(static_cast<Opcode>(in[0]), in[1], in[2],
+                                  in[3]);
+    }
+
+    /**
+     * Evaluate this instruction against a machine state, as if it had been
+     * fetched from the current program counter.
+     *
+     * \param state     The current machine state.
+     *
+     * \sideeffect The machine state is updated based upon the evaluation of
+     * this instruction.
+     */
+    void evaluate(MachineState* state) const;
+
+    /**
+     * The emit method writes this instruction to the given binary ostream.
+     * Emitting many instructions through a CodeBuffer is much faster.
+     *
+     * \param out       The ostream to which this instruction is emitted.
+     */
+    void emit(std::ostream& out) const;
+
+    /**
+     * The emit method appends this instruction to the given code buffer.
+     *
+     * \param out       The code buffer to which this instruction is emitted.
+     *
+     * \returns true if the instruction was appended.
+     */
+    bool emit(CodeBuffer& out) const;
+
+    /**
+     * Get the flyweight handler for this instruction.
+     */
+    inline const InstructionHandler& handler() const
+    {
+        return instructionHandler(op_);
+    }
+
+    /**
+     * Get the opcode for this instruction.
+     */
+    inline Opcode opcode() const { return op_; }
+
+    /**
+     * Get the traits of this instruction's opcode.
+     */
+    inline const OpcodeTraits& traits() const { return opcodeTraits(op_); }
+
+    /**
+     * Get the X value for this instruction.
+     */
+    inline std::uint8_t x() const { return x_; }
+
+    /**
+     * Get the Y value for this instruction.
+     */
+    inline std::uint8_t y() const { return y_; }
+
+    /**
+     * Get the Z value for this instruction.
+     */
+    inline std::uint8_t z() const { return z_; }
+
+    /**
+     * Get the combined 16-bit YZ value for this instruction.
+     */
+    inline std::uint16_t yz() const
+    {
+        return static_cast<std::uint16_t>((y_ << 8) | z_);
+    }
+
+    /**
+     * Get the combined 24-bit XYZ value for this instruction.
+     */
+    inline std::uint32_t xyz() const
+    {
+        return (static_cast<std::uint32_t>(x_) << 16) | yz();
+    }
+
+    /**
+     * Get this instruction as a tetra value, with the opcode in the most
+     * significant byte.
+     */
+    inline std::uint32_t tetra() const
+    {
+        return (static_cast<std::uint32_t>(opcode2byte(op_)) << 24) | xyz();
+    }
+
+private:
+    Opcode op_;
+    std::uint8_t x_;
+    std::uint8_t y_;
+    std::uint8_t z_;
+};
+
+/* namespace simex */ }
+
+//end of C++ code
+#endif //__cplusplus
+
+#endif //SIMEX_DECODED_INSTRUCTION_HEADER_GUARD
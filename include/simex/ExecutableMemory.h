@@ -0,0 +1,116 @@
+/**
+ * \file ExecutableMemory.h
+ *
+ * Host memory holding machine code generated at run time.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#ifndef  SIMEX_EXECUTABLE_MEMORY_HEADER_GUARD
+# define SIMEX_EXECUTABLE_MEMORY_HEADER_GUARD
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//this header is C++ specific
+#ifdef __cplusplus
+
+namespace simex {
+
+/**
+ * ExecutableMemory holds host machine code, such as blocks translated by the
+ * JIT, for as long as it lives.
+ *
+ * Memory is reserved from the host in chunks.  Where the host allows it, each
+ * chunk is mapped twice: once executable and once writable, so that no
+ * mapping is ever both writable and executable, and code is packed densely,
+ * written through the writable view and run from the executable one.
+ * Otherwise code is copied onto pages of its own, which are then made
+ * executable and are never writable again.  Code which was already added may
+ * run on any number of threads while a single thread adds more.
+ */
+class ExecutableMemory
+{
+public:
+
+    /**
+     * The number of bytes reserved from the host at a time.  Larger code is
+     * given a chunk of its own.
+     */
+    static const std::size_t CHUNK_SIZE = 64 * 1024;
+
+    /**
+     * The alignment of each piece of code packed into a chunk.
+     */
+    static const std::size_t CODE_ALIGNMENT = 16;
+
+    /**
+     * Create an empty code store.
+     */
+    ExecutableMemory();
+
+    /**
+     * Destructor.  Every piece of code added is released, so none of it may
+     * still be running.
+     */
+    ~ExecutableMemory();
+
+    ExecutableMemory(const ExecutableMemory&) = delete;
+    ExecutableMemory& operator=(const ExecutableMemory&) = delete;
+
+    /**
+     * Copy machine code into executable memory.  Only one thread may add code
+     * at a time.
+     *
+     * \param code      The machine code to copy.
+     * \param size      The size of the code, in bytes.
+     *
+     * \returns the executable copy, or nullptr if the host would not map
+     * executable memory.
+     */
+    const void* add(const void* code, std::size_t size);
+
+    /**
+     * Get the number of bytes of host pages which hold code.
+     */
+    inline std::size_t memoryUsage() const { return used_; }
+
+private:
+
+    /**
+     * A range of host memory reserved for code.
+     */
+    struct Chunk
+    {
+        //the executable view of the chunk.
+        std::uint8_t* code;
+        //the writable view of the same memory, or nullptr if the host
+        //could not map the chunk twice.
+        std::uint8_t* writable;
+        std::size_t size;
+    };
+
+    /**
+     * Reserve a chunk of at least the given size from the host.
+     *
+     * eturns false if the host would not map the memory.
+     */
+    bool reserve(std::size_t size);
+
+    std::vector<Chunk> chunks_;
+    //the offset of the first unused byte of the last chunk.
+    std::size_t next_;
+    std::size_t used_;
+};
+
+/* namespace simex */ }
+
+//end of C++ code
+#endif //__cplusplus
+
+#endif //SIMEX_EXECUTABLE_MEMORY_HEADER_GUARD
@@ -17,6 +17,7 @@
 #include <iosfwd>
 #include <memory>
 
+#include <simex/DecodedInstruction.h>
 #include <simex/Opcode.h>
 
 //this header is C++ specific
@@ -32,6 +33,10 @@ class MachineState;
 /**
  * An instruction is a four byte sequence containing a opcode, an X value, a Y
  * value, and a Z value.  Instructions can be decoded, evaluated, and emitted.
+ *
+ * Instruction is a heap-allocated compatibility wrapper around
+ * DecodedInstruction.  Hot paths should decode to DecodedInstruction values
+ * instead, which never allocate.
  */
 class Instruction 
 {
@@ -43,8 +48,8 @@ public:
     virtual ~Instruction();
 
     /**
-     * By default, the evaluate method places the machine into an invalid opcode
-     * exception state.  This behavior can be overridden by derived types.
+     * By default, the evaluate method evaluates this instruction through the
+     * machine state.  This behavior can be overridden by derived types.
      *
      * \param state     The current machine state.
      *
@@ -66,13 +71,32 @@ public:
     static std::shared_ptr<Instruction>
     decode(Opcode op, std::uint8_t x, std::uint8_t y, std::uint8_t z);
 
+    /**
+     * Wrap an already decoded instruction value in an Instruction.
+     *
+     * \param ins   The decoded instruction value.
+     *
+     * \returns the wrapped instruction, which can be emitted or evaluated.
+     */
+    static std::shared_ptr<Instruction> decode(DecodedInstruction ins);
+
     /**
      * The emit method writes an Instruction to the given binary ostream.
+     * Emitting many instructions through a CodeBuffer is much faster.
      *
      * \param out       The ostream to which this instruction is emitted.
      */
     void emit(std::ostream& out) const;
 
+    /**
+     * The emit method appends an Instruction to the given code buffer.
+     *
+     * \param out       The code buffer to which this instruction is emitted.
+     *
+     * \returns true if the instruction was appended.
+     */
+    bool emit(CodeBuffer& out) const;
+
     /**
      * Get the opcode for this instruction.
      *
@@ -101,6 +125,16 @@ public:
      */
     inline std::uint8_t z() const { return z_; }
 
+    /**
+     * Get the allocation-free value form of this instruction.
+     *
+     * \returns this instruction as a DecodedInstruction.
+     */
+    inline DecodedInstruction decoded() const
+    {
+        return DecodedInstruction(op_, x_, y_, z_);
+    }
+
 protected:
     /**
      * The constructor takes an opcode, and an XYZ value.
@@ -0,0 +1,355 @@
+/**
+ * \file MachineState.h
+ *
+ * The state of a single SIMEX system thread, and the interpreter which
+ * evaluates instructions against it.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#ifndef  SIMEX_MACHINE_STATE_HEADER_GUARD
+# define SIMEX_MACHINE_STATE_HEADER_GUARD
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <type_traits>
+
+#include <simex/AddressSpace.h>
+#include <simex/DecodedInstruction.h>
+#include <simex/SReg.h>
+
+//this header is C++ specific
+#ifdef __cplusplus
+
+namespace simex {
+
+/**
+ * Fault codes.  When an exception is detected, the fault code is placed in
+ * rCC before control is transferred to the fault handler at rFF.
+ */
+enum class Fault : std::uint8_t
+{
+    //no fault.
+    None                        =   0x00,
+    //the opcode is reserved.
+    InvalidInstruction          =   0x01,
+    //the instruction is valid, but not supported by this implementation.
+    UnsupportedInstruction      =   0x02,
+    //signed integer overflow.
+    IntegerOverflow             =   0x03,
+    //integer division by zero.
+    DivideCheck                 =   0x04,
+    //an access was not permitted by the segment policy, or was unmapped.
+    MemoryProtection            =   0x05,
+    //an access was not aligned by its size.
+    MemoryAlignment             =   0x06,
+    //the system call index is not implemented.
+    UnsupportedSyscall          =   0x07,
+    //the register-stack grew past its limit.
+    StackOverflow               =   0x08,
+};
+
+/**
+ * Convert a fault to its numeric fault code.
+ *
+ * \param fault     The fault to convert.
+ *
+ * \returns the fault code stored in rCC.
+ */
+inline std::uint8_t fault2code(Fault fault)
+{
+    return static_cast<std::underlying_type<Fault>::type>(fault);
+}
+
+/**
+ * The reason that MachineState::run() returned.
+ */
+enum class RunStatus
+{
+    //the machine was halted, such as by the exit system call.
+    Halted                      = 0,
+    //a fault occurred, and no fault handler was installed in rFF.
+    Faulted,
+    //the instruction limit passed to run() was reached.
+    InstructionLimit
+};
+
+/**
+ * Function type for host system call implementations.
+ *
+ * A system call sees its arguments as local registers $0, $1, ... of a fresh
+ * register-stack frame, exactly as a function called by PUSHJ would.  It
+ * places its results starting at $0 and returns the number of results.
+ */
+typedef std::uint8_t (*syscall_method_t)(MachineState* state);
+
+/**
+ * Counts of the blocks and functions which were tiered up from the
+ * interpreter to the JIT.
+ */
+struct JitStatistics
+{
+    //blocks which were entered often enough to be queued.
+    std::uint64_t hotBlocks;
+    //functions which were called often enough for their blocks to be queued.
+    std::uint64_t hotFunctions;
+    //blocks queued for the background compiler.
+    std::uint64_t queued;
+    //blocks whose compiled code was patched in.
+    std::uint64_t installed;
+    //blocks which the JIT could not translate, or which were predecoded
+    //again before their code was ready.
+    std::uint64_t rejected;
+};
+
+/**
+ * Forward declaration to the private MachineStateImplementation.
+ */
+struct MachineStateImplementation;
+
+/**
+ * The MachineState class holds the program counter, register-stack, and
+ * special registers of a single SIMEX system thread, and evaluates
+ * instructions fetched from its address space.
+ */
+class MachineState
+{
+public:
+
+    /**
+     * Create a machine state that executes from the given address space.
+     *
+     * \param space     The address space shared by this machine state.
+     */
+    MachineState(std::shared_ptr<AddressSpace> space);
+
+    /**
+     * Destructor.  Clean up this instance.
+     */
+    ~MachineState();
+
+    /**
+     * Run instructions starting at the current program counter.
+     *
+     * \param maxInstructions   The maximum number of instructions to run.
+     *
+     * \returns the reason that execution stopped.
+     */
+    RunStatus
+    run(std::uint64_t maxInstructions =
+            std::numeric_limits<std::uint64_t>::max());
+
+    /**
+     * Evaluate a single instruction as if it had been fetched from the
+     * current program counter.
+     *
+     * \param ins       The instruction to evaluate.
+     */
+    void evaluate(DecodedInstruction ins);
+
+    /**
+     * Get the current program counter.
+     */
+    std::uint64_t pc() const;
+
+    /**
+     * Set the program counter.
+     */
+    void setPC(std::uint64_t pc);
+
+    /**
+     * Read a general purpose register.  Reading a register in the hole between
+     * rL and the global registers extends rL, as for guest code.
+     *
+     * \param r         The register to read.
+     *
+     * \returns the value of this register.
+     */
+    std::uint64_t reg(std::uint8_t r);
+
+    /**
+     * Write a general purpose register.  Writing a register in the hole
+     * between rL and the global registers extends rL, as for guest code.
+     *
+     * \param r         The register to write.
+     * \param value     The value to write.
+     */
+    void setReg(std::uint8_t r, std::uint64_t value);
+
+    /**
+     * Read a special register.  Reserved registers read as 0.
+     *
+     * \param r         The special register to read.
+     *
+     * \returns the value of this special register.
+     */
+    std::uint64_t sreg(SReg r) const;
+
+    /**
+     * Write a special register directly, without the restrictions of PUT.
+     * Writes to reserved registers are ignored.  This is meant for the host.
+     *
+     * \param r         The special register to write.
+     * \param value     The value to write.
+     */
+    void setSReg(SReg r, std::uint64_t value);
+
+    /**
+     * Register a host system call implementation.
+     *
+     * \param index     The system call index, as found in the YZ value of the
+     *                  SYSCALL instruction.
+     * \param method    The implementation, or nullptr to remove it.
+     */
+    void registerSyscall(std::uint16_t index, syscall_method_t method);
+
+    /**
+     * Halt the machine.  The current run() returns RunStatus::Halted after the
+     * current instruction completes.
+     *
+     * \param exitCode  The exit code for this machine.
+     */
+    void halt(std::uint64_t exitCode);
+
+    /**
+     * Returns true if this machine is halted.
+     */
+    bool halted() const;
+
+    /**
+     * Get the exit code passed to halt().
+     */
+    std::uint64_t exitCode() const;
+
+    /**
+     * Get the total number of instructions evaluated by this machine.
+     */
+    std::uint64_t instructionCount() const;
+
+    /**
+     * Get the number of instruction dispatches performed by this machine.
+     * This is less than instructionCount() when superinstructions run.
+     */
+    std::uint64_t dispatchCount() const;
+
+    /**
+     * Enable or disable superinstruction fusion.  Fusion is enabled by
+     * default.  Changing this setting causes code to be predecoded again.
+     *
+     * \param enabled   true if common instruction sequences should be
+     *                  combined into superinstructions.
+     */
+    void setFusion(bool enabled);
+
+    /**
+     * Returns true if superinstruction fusion is enabled.
+     */
+    bool fusion() const;
+
+    /**
+     * Enable or disable the JIT, which translates integer, branch, load, and
+     * store instructions to host machine code.  The JIT is disabled by
+     * default, and is only available on x86-64 hosts; elsewhere, code is
+     * always interpreted.  Changing this setting causes code to be
+     * predecoded again.
+     *
+     * \param enabled   true if blocks should be translated to host machine
+     *                  code.
+     */
+    void setJit(bool enabled);
+
+    /**
+     * Returns true if the JIT is enabled.
+     */
+    bool jit() const;
+
+    /**
+     * Set when the JIT translates code.  Code starts out interpreted, with
+     * each block counting its entries and the calls to it.  A block which is
+     * entered blockThreshold times, or which starts a function that is called
+     * functionThreshold times, is queued for a background compiler thread,
+     * along with the other blocks of the function up to its first POP.  Its
+     * code is patched in the next time the machine enters a block which is
+     * waiting for code.  The defaults are 256 entries and 32 calls.
+     *
+     * A block threshold of 0 translates every block as it is first
+     * predecoded, on the thread which runs it; a function threshold of 0
+     * leaves calls uncounted.  The new thresholds take effect on the next
+     * entry to each block, which keeps the entries and calls counted so far.
+     * Switching between a block threshold of 0 and another one while the JIT
+     * is enabled predecodes code again.
+     *
+     * \param blockThreshold      The entries after which a block is queued.
+     * \param functionThreshold   The calls after which the blocks of a
+     *                            function are queued.
+     */
+    void setJitThresholds(
+        std::uint64_t blockThreshold, std::uint64_t functionThreshold);
+
+    /**
+     * Get the number of entries after which a block is queued for the JIT.
+     */
+    std::uint64_t jitBlockThreshold() const;
+
+    /**
+     * Get the number of calls after which the blocks of a function are queued
+     * for the JIT.
+     */
+    std::uint64_t jitFunctionThreshold() const;
+
+    /**
+     * Wait for the background compiler to translate every block queued so
+     * far, and patch in the code.
+     */
+    void waitForJit();
+
+    /**
+     * Get the counts of blocks and functions tiered up to the JIT.
+     */
+    JitStatistics jitStatistics() const;
+
+    /**
+     * Set the limit on the number of registers held in the rS region, below
+     * the registers that are held by the machine itself.  When the
+     * register-stack grows past this limit, a stack overflow fault is raised
+     * once the instruction which grew it completes.  A little more room is
+     * kept past the limit for the fault handler; if that is exhausted too,
+     * the machine halts with a stack overflow fault.  The limit is capped by
+     * the address space reserved for the rS region.
+     *
+     * \param registers The largest number of registers in the rS region.
+     */
+    void setStackLimit(std::uint64_t registers);
+
+    /**
+     * Get the limit on the number of registers held in the rS region.
+     */
+    std::uint64_t stackLimit() const;
+
+    /**
+     * Get the address space used by this machine.
+     */
+    AddressSpace& addressSpace();
+
+    /**
+     * Get the cache of free slab segments which this system thread allocates
+     * from.  Host system calls which allocate or free segments for this
+     * machine should use it.
+     */
+    SlabCache& slabCache();
+
+private:
+    std::unique_ptr<MachineStateImplementation> impl_;
+};
+
+/* namespace simex */ }
+
+//end of C++ code
+#endif //__cplusplus
+
+#endif //SIMEX_MACHINE_STATE_HEADER_GUARD
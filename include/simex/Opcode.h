@@ -14,6 +14,7 @@
 # define SIMEX_OPCODE_HEADER_GUARD
 
 #include <cstdint>
+#include <type_traits>
 
 //this header is C++ specific
 #ifdef __cplusplus
@@ -290,7 +291,7 @@ enum class Opcode : std::uint8_t
  *
  * \returns the converted opcode as a byte.
  */
-inline uint8_t opcode2byte(Opcode op)
+constexpr uint8_t opcode2byte(Opcode op)
 {
     //explicit conversion to the uint8_t type.
     return static_cast<std::underlying_type<Opcode>::type>(op);
@@ -0,0 +1,335 @@
+/**
+ * \file OpcodeTraits.h
+ *
+ * Compile-time facts about each opcode, such as its operand format and
+ * memory access width.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#ifndef  SIMEX_OPCODE_TRAITS_HEADER_GUARD
+# define SIMEX_OPCODE_TRAITS_HEADER_GUARD
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include <simex/Opcode.h>
+
+//this header is C++ specific
+#ifdef __cplusplus
+
+namespace simex {
+
+/**
+ * How the X, Y, and Z bytes of an instruction are interpreted.
+ */
+enum class OperandFormat : std::uint8_t
+{
+    //X, Y, and Z are separate operands; Z may be a register or a constant.
+    ThreeOperand                =   0x00,
+    //X is an operand and YZ is a 16-bit constant.
+    WydeConstant,
+    //X is an operand and YZ is a 16-bit tetra offset from the instruction.
+    WydeRelative,
+    //XYZ is a 24-bit tetra offset from the instruction.
+    TriByteRelative,
+    //XYZ is a 24-bit constant.
+    TriByteConstant
+};
+
+/**
+ * The kind of memory access made by an opcode.
+ */
+enum class MemoryAccess : std::uint8_t
+{
+    //no memory is accessed through the effective address.
+    None                        =   0x00,
+    //memory is read.
+    Load,
+    //memory is written.
+    Store,
+    //memory is read and conditionally written, as for CSWAP.
+    Swap
+};
+
+/**
+ * The facts about a single opcode.
+ */
+struct OpcodeTraits
+{
+    //false for reserved opcodes.
+    bool valid;
+    //how the X, Y, and Z bytes are interpreted.
+    OperandFormat format;
+    //true if the Z byte is a constant rather than a register.
+    bool zImmediate;
+    //true if a relative offset is taken backward.
+    bool backward;
+    //true for probable branches.
+    bool probable;
+    //true for branches and conditional sets, which test condition.
+    bool conditional;
+    //the condition tested: N, Z, P, OD, NN, NZ, NP, EV.
+    std::uint8_t condition;
+    //the kind of memory access made through the effective address.
+    MemoryAccess access;
+    //the width of that memory access in bytes, or 0.
+    std::uint8_t width;
+    //true if a sub-octa access is sign extended or range checked.
+    bool isSigned;
+    //true if this opcode can raise a fault in this implementation.
+    bool canFault;
+};
+
+namespace detail {
+
+    /**
+     * Compute the traits for the opcode with the given value.
+     */
+    constexpr OpcodeTraits computeOpcodeTraits(std::uint8_t code)
+    {
+        OpcodeTraits t{
+            true, OperandFormat::ThreeOperand, false, false, false, false, 0,
+            MemoryAccess::None, 0, false, false };
+
+        //reserved opcodes.
+        if ((code >= 0x98 && code <= 0x9D) || (code >= 0xB8 && code <= 0xBD)
+         || (code >= 0xD0 && code <= 0xD7) || (code >= 0xDA && code <= 0xDF)
+         || code == 0xFF)
+        {
+            t.valid = false;
+            t.canFault = true;
+            return t;
+        }
+
+        //the Z byte of an odd opcode is a constant, with a few exceptions.
+        if (code >= 0x40 && code < 0x60)
+            t.zImmediate = true;
+        else if (code >= 0xE0)
+            t.zImmediate = code != 0xF6 && code != 0xFB;
+        else if (code < 0x18)
+            t.zImmediate = code >= 0x08 && (code & 1);
+        else
+            t.zImmediate = code & 1;
+
+        //operand format.
+        if (code == 0x00 || (code >= 0xE0 && code <= 0xEF) || code == 0xF8)
+            t.format = OperandFormat::WydeConstant;
+        else if ((code >= 0x40 && code <= 0x5F)
+              || (code >= 0xF2 && code <= 0xF5))
+            t.format = OperandFormat::WydeRelative;
+        else if (code == 0xF0 || code == 0xF1)
+            t.format = OperandFormat::TriByteRelative;
+        else if (code == 0xFC || code == 0xFD)
+            t.format = OperandFormat::TriByteConstant;
+
+        t.backward =
+            (t.format == OperandFormat::WydeRelative
+          || t.format == OperandFormat::TriByteRelative)
+         && (code & 1);
+
+        //branches, probable branches, and conditional sets.
+        if (code >= 0x40 && code <= 0x7F)
+        {
+            t.conditional = true;
+            t.condition = (code >> 1) & 7;
+            t.probable = code >= 0x50 && code <= 0x5F;
+        }
+
+        //memory access.
+        if (code >= 0x80 && code <= 0x8F)
+        {
+            t.access = MemoryAccess::Load;
+            t.width = 1 << ((code >> 2) & 3);
+        }
+        else if (code >= 0xA0 && code <= 0xAF)
+        {
+            t.access = MemoryAccess::Store;
+            t.width = 1 << ((code >> 2) & 3);
+        }
+        else if (code >= 0x90 && code <= 0x97)
+        {
+            t.access = code < 0x94 || code > 0x95
+                ? MemoryAccess::Load : MemoryAccess::Swap;
+            t.width = code < 0x94 ? 4 : 8;
+        }
+        else if (code >= 0xB0 && code <= 0xB7)
+        {
+            t.access = MemoryAccess::Store;
+            t.width = code < 0xB4 ? 4 : 8;
+        }
+
+        t.isSigned =
+            ((code >= 0x80 && code <= 0x8F) || (code >= 0xA0 && code <= 0xAF))
+         && !(code & 2) && t.width < 8;
+
+        //signed arithmetic overflow, division, memory access, system calls,
+        //and instructions that are only partially supported.
+        t.canFault =
+            (code >= 0x18 && code <= 0x19) || (code >= 0x1C && code <= 0x1D)
+         || (code >= 0x20 && code <= 0x21) || (code >= 0x24 && code <= 0x25)
+         || (code >= 0x34 && code <= 0x35) || (code >= 0x38 && code <= 0x39)
+         || t.access != MemoryAccess::None
+         || code == 0x00 || code == 0xF8 || code == 0xFA || code == 0xFB;
+
+        return t;
+    }
+
+    /**
+     * Build the traits table for every opcode value.
+     */
+    template <std::size_t... Codes>
+    constexpr std::array<OpcodeTraits, sizeof...(Codes)>
+    makeOpcodeTraits(std::index_sequence<Codes...>)
+    {
+        return {{ computeOpcodeTraits(static_cast<std::uint8_t>(Codes))... }};
+    }
+
+    /**
+     * The traits of every opcode, indexed by opcode value.
+     */
+    constexpr std::array<OpcodeTraits, 256> OPCODE_TRAITS =
+        makeOpcodeTraits(std::make_index_sequence<256>());
+}
+
+/**
+ * Get the traits for an opcode.  This can be evaluated at compile time.
+ *
+ * \param op        The opcode to look up.
+ *
+ * \returns the traits of this opcode.
+ */
+constexpr const OpcodeTraits& opcodeTraits(Opcode op)
+{
+    return detail::OPCODE_TRAITS[static_cast<std::uint8_t>(op)];
+}
+
+/**
+ * The traits of a fixed opcode, for specializing code at compile time.
+ */
+template <Opcode OP>
+struct OpcodeTraitsOf
+{
+    static constexpr Opcode opcode = OP;
+    static constexpr bool valid = opcodeTraits(OP).valid;
+    static constexpr OperandFormat format = opcodeTraits(OP).format;
+    static constexpr bool zImmediate = opcodeTraits(OP).zImmediate;
+    static constexpr bool backward = opcodeTraits(OP).backward;
+    static constexpr bool probable = opcodeTraits(OP).probable;
+    static constexpr bool conditional = opcodeTraits(OP).conditional;
+    static constexpr std::uint8_t condition = opcodeTraits(OP).condition;
+    static constexpr MemoryAccess access = opcodeTraits(OP).access;
+    static constexpr std::uint8_t width = opcodeTraits(OP).width;
+    static constexpr bool isSigned = opcodeTraits(OP).isSigned;
+    static constexpr bool canFault = opcodeTraits(OP).canFault;
+};
+
+//storage for the members of OpcodeTraitsOf.
+template <Opcode OP> constexpr Opcode OpcodeTraitsOf<OP>::opcode;
+template <Opcode OP> constexpr bool OpcodeTraitsOf<OP>::valid;
+template <Opcode OP> constexpr OperandFormat OpcodeTraitsOf<OP>::format;
+template <Opcode OP> constexpr bool OpcodeTraitsOf<OP>::zImmediate;
+template <Opcode OP> constexpr bool OpcodeTraitsOf<OP>::backward;
+template <Opcode OP> constexpr bool OpcodeTraitsOf<OP>::probable;
+template <Opcode OP> constexpr bool OpcodeTraitsOf<OP>::conditional;
+template <Opcode OP> constexpr std::uint8_t OpcodeTraitsOf<OP>::condition;
+template <Opcode OP> constexpr MemoryAccess OpcodeTraitsOf<OP>::access;
+template <Opcode OP> constexpr std::uint8_t OpcodeTraitsOf<OP>::width;
+template <Opcode OP> constexpr bool OpcodeTraitsOf<OP>::isSigned;
+template <Opcode OP> constexpr bool OpcodeTraitsOf<OP>::canFault;
+
+/*
+ * Consistency checks between the traits table and the Opcode enumeration.
+ * Each family is checked at its first and last member, so that a renumbered
+ * opcode or a broken range test fails to compile.
+ */
+static_assert(opcodeTraits(Opcode::OP_ADD).format
+                == OperandFormat::ThreeOperand
+           && !opcodeTraits(Opcode::OP_ADD).zImmediate
+           && opcodeTraits(Opcode::OP_ADDI).zImmediate
+           && opcodeTraits(Opcode::OP_ADDI).canFault
+           && !opcodeTraits(Opcode::OP_ADDUI).canFault,
+              "ADD family traits");
+static_assert(!opcodeTraits(Opcode::OP_FLOT).zImmediate
+           && opcodeTraits(Opcode::OP_FLOTI).zImmediate
+           && !opcodeTraits(Opcode::OP_FCMP).zImmediate,
+              "floating point traits");
+static_assert(opcodeTraits(Opcode::OP_BN).format
+                == OperandFormat::WydeRelative
+           && !opcodeTraits(Opcode::OP_BN).backward
+           && opcodeTraits(Opcode::OP_BNB).backward
+           && !opcodeTraits(Opcode::OP_BEVB).probable
+           && opcodeTraits(Opcode::OP_PBN).probable
+           && opcodeTraits(Opcode::OP_PBEVB).probable
+           && opcodeTraits(Opcode::OP_PBEVB).backward
+           && opcodeTraits(Opcode::OP_BZ).condition == 1
+           && opcodeTraits(Opcode::OP_PBNZB).condition == 5
+           && opcodeTraits(Opcode::OP_ZSEVI).condition == 7
+           && !opcodeTraits(Opcode::OP_CSN).probable,
+              "branch and conditional set traits");
+static_assert(opcodeTraits(Opcode::OP_LDB).access == MemoryAccess::Load
+           && opcodeTraits(Opcode::OP_LDB).width == 1
+           && opcodeTraits(Opcode::OP_LDB).isSigned
+           && !opcodeTraits(Opcode::OP_LDBU).isSigned
+           && opcodeTraits(Opcode::OP_LDWI).width == 2
+           && opcodeTraits(Opcode::OP_LDTU).width == 4
+           && opcodeTraits(Opcode::OP_LDOUI).width == 8
+           && !opcodeTraits(Opcode::OP_LDO).isSigned
+           && opcodeTraits(Opcode::OP_LDSF).width == 4
+           && opcodeTraits(Opcode::OP_LDHTI).width == 4
+           && opcodeTraits(Opcode::OP_CSWAP).access == MemoryAccess::Swap
+           && opcodeTraits(Opcode::OP_LDUNCI).width == 8,
+              "load traits");
+static_assert(opcodeTraits(Opcode::OP_STB).access == MemoryAccess::Store
+           && opcodeTraits(Opcode::OP_STB).isSigned
+           && !opcodeTraits(Opcode::OP_STBU).isSigned
+           && opcodeTraits(Opcode::OP_STOUI).width == 8
+           && opcodeTraits(Opcode::OP_STSF).width == 4
+           && opcodeTraits(Opcode::OP_STHTI).width == 4
+           && opcodeTraits(Opcode::OP_STCO).width == 8
+           && opcodeTraits(Opcode::OP_STUNCI).access == MemoryAccess::Store
+           && opcodeTraits(Opcode::OP_GO).access == MemoryAccess::None,
+              "store traits");
+static_assert(!opcodeTraits(Opcode::OP_RESERVED_x98).valid
+           && !opcodeTraits(Opcode::OP_RESERVED_xBD).valid
+           && !opcodeTraits(Opcode::OP_RESERVED_xD7).valid
+           && !opcodeTraits(Opcode::OP_RESERVED_xDF).valid
+           && !opcodeTraits(Opcode::OP_RESERVED_xFF).valid
+           && opcodeTraits(Opcode::OP_MUX).valid
+           && opcodeTraits(Opcode::OP_PUSHGOI).valid,
+              "reserved opcode traits");
+static_assert(opcodeTraits(Opcode::OP_SETH).format
+                == OperandFormat::WydeConstant
+           && opcodeTraits(Opcode::OP_ANDNL).format
+                == OperandFormat::WydeConstant
+           && opcodeTraits(Opcode::OP_SYSCALL).format
+                == OperandFormat::WydeConstant
+           && opcodeTraits(Opcode::OP_POP).format
+                == OperandFormat::WydeConstant
+           && opcodeTraits(Opcode::OP_JMPB).format
+                == OperandFormat::TriByteRelative
+           && opcodeTraits(Opcode::OP_JMPB).backward
+           && opcodeTraits(Opcode::OP_PUSHJB).backward
+           && opcodeTraits(Opcode::OP_GETA).format
+                == OperandFormat::WydeRelative
+           && opcodeTraits(Opcode::OP_SWYM).format
+                == OperandFormat::TriByteConstant
+           && !opcodeTraits(Opcode::OP_PUT).zImmediate
+           && opcodeTraits(Opcode::OP_PUTI).zImmediate
+           && !opcodeTraits(Opcode::OP_UNSAVE).zImmediate
+           && opcodeTraits(Opcode::OP_GET).format
+                == OperandFormat::ThreeOperand,
+              "wyde, jump, and special traits");
+
+/* namespace simex */ }
+
+//end of C++ code
+#endif //__cplusplus
+
+#endif //SIMEX_OPCODE_TRAITS_HEADER_GUARD
@@ -0,0 +1,156 @@
+/**
+ * \file PageTable.h
+ *
+ * A radix page table mapping guest pages to the segments which hold them.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#ifndef  SIMEX_PAGE_TABLE_HEADER_GUARD
+# define SIMEX_PAGE_TABLE_HEADER_GUARD
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+//this header is C++ specific
+#ifdef __cplusplus
+
+namespace simex {
+
+/**
+ * Forward declaration for Segment.
+ */
+class Segment;
+
+/**
+ * The PageTable maps each guest page of the 64-bit address space to the
+ * segment holding it, which supplies the host memory and policy of the page.
+ *
+ * The table is a radix tree of six levels, indexed by nine bits of the guest
+ * page number at each level, with seven bits at the root.  A slot covered
+ * entirely by one segment holds that segment directly, at whatever level, so
+ * large segments need only a handful of slots.  A slot whose span holds only
+ * part of a single segment also holds that segment directly, and a lookup
+ * checks the bounds of the segment, so scattered segments need no nodes of
+ * their own.  A slot is split into a child node only once a second segment
+ * lands in its span.
+ *
+ * Lookups are lock-free, and may run on any number of threads while a single
+ * writer inserts and removes segments.  Slots are published with release
+ * stores, and nodes are never freed before the table, so a reader never
+ * follows a dangling node.  A segment must not be destroyed while a reader
+ * may still hold it.
+ */
+class PageTable
+{
+public:
+
+    /**
+     * The number of bits in the offset of an address within its page.
+     */
+    static const int PAGE_BITS = 12;
+
+    /**
+     * The number of bits of the page number indexed at each level.
+     */
+    static const int LEVEL_BITS = 9;
+
+    /**
+     * The number of levels in the tree.
+     */
+    static const int LEVELS = 6;
+
+    /**
+     * A node of the tree.  Each slot is zero if it is empty, a pointer to a
+     * child node, or a pointer to a segment tagged with FULL_TAG or
+     * PARTIAL_TAG.
+     */
+    struct Node
+    {
+        std::atomic<std::uintptr_t> slots[1 << LEVEL_BITS];
+    };
+
+    /**
+     * Create an empty page table.
+     */
+    PageTable();
+
+    /**
+     * Destructor.
+     */
+    ~PageTable();
+
+    /**
+     * Find the segment holding the given guest address.  This is safe to
+     * call while another thread inserts or removes segments.
+     *
+     * \param addr      The guest address to look up.
+     *
+     * \returns the segment holding this address, or nullptr.
+     */
+    Segment* find(std::uint64_t addr) const;
+
+    /**
+     * Insert a segment, which must be page aligned, sized in whole pages, and
+     * must not overlap any segment in the table.  Only one thread may insert
+     * or remove segments at a time.
+     *
+     * \param seg       The segment to insert.
+     */
+    void insert(Segment* seg);
+
+    /**
+     * Remove a segment which was inserted.  Only one thread may insert or
+     * remove segments at a time.
+     *
+     * \param seg       The segment to remove.
+     */
+    void remove(Segment* seg);
+
+    /**
+     * Get the number of bytes of host memory used by the nodes of the tree.
+     */
+    inline std::size_t memoryUsage() const
+    {
+        return nodes_.size() * sizeof(Node);
+    }
+
+private:
+
+    /**
+     * Tag bit marking a slot which holds a segment covering its whole span.
+     */
+    static const std::uintptr_t FULL_TAG = 1;
+
+    /**
+     * Tag bit marking a slot which holds the only segment in its span, which
+     * covers part of it.
+     */
+    static const std::uintptr_t PARTIAL_TAG = 2;
+
+    /**
+     * Mask of the tag bits of a slot.
+     */
+    static const std::uintptr_t TAG_MASK = FULL_TAG | PARTIAL_TAG;
+
+    void assign(
+        Node* node, int level, std::uint64_t first, std::uint64_t last,
+        Segment* seg);
+
+    Node* root_;
+    std::vector<std::unique_ptr<Node>> nodes_;
+};
+
+/* namespace simex */ }
+
+//end of C++ code
+#endif //__cplusplus
+
+#endif //SIMEX_PAGE_TABLE_HEADER_GUARD
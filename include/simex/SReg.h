@@ -14,6 +14,7 @@
 # define SIMEX_SREG_HEADER_GUARD
 
 #include <cstdint>
+#include <type_traits>
 
 //this header is C++ specific
 #ifdef __cplusplus
@@ -0,0 +1,82 @@
+/**
+ * \file Syscall.h
+ *
+ * Enumeration of the system calls built into the SIMEX simulator.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#ifndef  SIMEX_SYSCALL_HEADER_GUARD
+# define SIMEX_SYSCALL_HEADER_GUARD
+
+#include <cstdint>
+#include <type_traits>
+
+//this header is C++ specific
+#ifdef __cplusplus
+
+namespace simex {
+
+/**
+ * The Syscall Enumeration contains the system calls provided by every
+ * MachineState.  The index is the YZ value of the SYSCALL instruction.
+ */
+enum class Syscall : std::uint16_t
+{
+    //exit $0: halt this machine with the exit code in $0.
+    SC_EXIT                         =   0x0000,
+    //allocate segment $0 bytes with policy $1: $0 = base address, or 0.
+    SC_SEGMENT_ALLOCATE             =   0x0001,
+    //free the segment at base address $0: $0 = status.
+    SC_SEGMENT_FREE                 =   0x0002,
+    //change the policy of the segment at base $0 to $1: $0 = status.
+    SC_SEGMENT_POLICY               =   0x0003,
+};
+
+/**
+ * Status codes returned by system calls.
+ */
+enum class SyscallStatus : std::uint64_t
+{
+    //the system call succeeded.
+    Success                         =   0x00,
+    //the address is not the base address of a segment.
+    InvalidSegment                  =   0x01,
+    //the policy contains unknown bits.
+    InvalidPolicy                   =   0x02,
+};
+
+/**
+ * Convert a system call to its 16-bit index.
+ *
+ * \param sc        The system call to convert.
+ *
+ * \returns the index of this system call.
+ */
+inline std::uint16_t syscall2index(Syscall sc)
+{
+    return static_cast<std::underlying_type<Syscall>::type>(sc);
+}
+
+/**
+ * Convert a system call status to the value returned in $0.
+ *
+ * \param status    The status to convert.
+ *
+ * \returns the numeric status code.
+ */
+inline std::uint64_t status2code(SyscallStatus status)
+{
+    return static_cast<std::underlying_type<SyscallStatus>::type>(status);
+}
+
+/* namespace simex */}
+
+//end of C++ specific section
+#endif //__cplusplus
+
+#endif //SIMEX_SYSCALL_HEADER_GUARD
@@ -0,0 +1,91 @@
+/**
+ * \file AddressSpace/AddressSpace.cpp
+ *
+ * Constructor for AddressSpace.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <fcntl.h>
+#include <simex/AddressSpace.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace simex;
+using namespace std;
+
+static_assert(AddressSpace::PAGE_SIZE == 1 << PageTable::PAGE_BITS,
+              "the page table maps whole segment pages");
+
+//storage for static constants.
+const uint64_t AddressSpace::PAGE_SIZE;
+const uint64_t AddressSpace::ALLOCATION_BASE;
+const uint64_t AddressSpace::HOST_ARENA_SIZE;
+const size_t AddressSpace::SLAB_CLASS_COUNT;
+const uint64_t AddressSpace::SLAB_MAX_SIZE;
+const size_t AddressSpace::SLAB_SLOTS;
+const size_t AddressSpace::SLAB_BATCH;
+
+/**
+ * Create an empty address space.
+ *
+ * With host protection, segments below HOST_ARENA_SIZE live in a host arena
+ * at the same offset as their guest address, and the host MMU enforces their
+ * policy, so that machines can load and store without checking policy in
+ * software.  If the host can't provide the arena, policy is checked in
+ * software.
+ *
+ * In the native byte order, guest memory holds each octa in host order, so
+ * that loads and stores don't swap bytes.  The host still sees guest byte
+ * order through read() and write().
+ *
+ * \param hostProtection    true to enforce policy with the host MMU.
+ * \param order             the order in which memory holds each value.
+ */
+AddressSpace::AddressSpace(bool hostProtection, ByteOrder order)
+    : nextBase_(ALLOCATION_BASE), generation_(0), order_(order),
+      arenaFile_(-1),
+      guestView_(nullptr), hostView_(nullptr)
+{
+    if (!hostProtection)
+        return;
+
+    //the arena is a sparse file mapped twice: the guest view is protected to
+    //match each segment policy, and the host view is always writable.
+    arenaFile_ = memfd_create("simex-arena", MFD_CLOEXEC);
+    if (arenaFile_ < 0)
+        return;
+
+    if (0 != ftruncate(arenaFile_, HOST_ARENA_SIZE))
+    {
+        close(arenaFile_);
+        arenaFile_ = -1;
+        return;
+    }
+
+    void* guest =
+        mmap(nullptr, HOST_ARENA_SIZE, PROT_NONE,
+             MAP_SHARED | MAP_NORESERVE, arenaFile_, 0);
+    void* host =
+        mmap(nullptr, HOST_ARENA_SIZE, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_NORESERVE, arenaFile_, 0);
+
+    if (MAP_FAILED == guest || MAP_FAILED == host)
+    {
+        if (MAP_FAILED != guest)
+            munmap(guest, HOST_ARENA_SIZE);
+        if (MAP_FAILED != host)
+            munmap(host, HOST_ARENA_SIZE);
+
+        close(arenaFile_);
+        arenaFile_ = -1;
+        return;
+    }
+
+    guestView_ = static_cast<uint8_t*>(guest);
+    hostView_ = static_cast<uint8_t*>(host);
+}
@@ -0,0 +1,85 @@
+/**
+ * \file AddressSpace/allocate.cpp
+ *
+ * Implementation of AddressSpace::allocate().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/AddressSpace.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Allocate a new segment at an implementation-defined guest address.
+ *
+ * \param size      The minimum size of the segment, in bytes.
+ * \param policy    The policy bits for the segment.
+ *
+ * \returns the guest address of the new segment, or 0 on failure.
+ */
+uint64_t AddressSpace::allocate(uint64_t size, uint8_t policy)
+{
+    lock_guard<mutex> guard(lock_);
+    uint64_t length = ((size + PAGE_SIZE - 1) / PAGE_SIZE) * PAGE_SIZE;
+
+    if (0 == size || length < size)
+        return 0;
+
+    //place the segment after the last allocation, skipping fixed mappings.
+    while (nextBase_ + length > nextBase_)
+    {
+        uint64_t base = nextBase_;
+        nextBase_ += length;
+
+        if (place(base, size, policy))
+            return base;
+    }
+
+    return 0;
+}
+
+/**
+ * Allocate a new segment for a system thread.  A small segment without
+ * execute policy is a slab segment from the thread's cache, which only takes
+ * a lock when the cache is empty.  Others are allocated as by
+ * allocate(size, policy).
+ *
+ * \param size      The minimum size of the segment, in bytes.
+ * \param policy    The policy bits for the segment.
+ * \param cache     The slab cache of the allocating system thread.
+ *
+ * \returns the guest address of the new segment, or 0 on failure.
+ */
+uint64_t AddressSpace::allocate(uint64_t size, uint8_t policy, SlabCache& cache)
+{
+    if (0 == size || size > SLAB_MAX_SIZE || (policy & SEGMENT_EXECUTE))
+        return allocate(size, policy);
+
+    //the smallest class holding the whole size.
+    size_t sizeClass = 0;
+    while ((PAGE_SIZE << sizeClass) < size)
+        ++sizeClass;
+
+    vector<Segment*>& free = cache.free_[sizeClass];
+    if (free.empty() && !refill(cache, sizeClass))
+        return 0;
+
+    Segment* seg = free.back();
+    free.pop_back();
+
+    //no translation of a free segment can be cached, so handing it out
+    //doesn't change the generation.
+    seg->setPolicy(policy);
+    if (nullptr != guestView_ && seg->base_ + seg->size_ <= HOST_ARENA_SIZE)
+        protect(seg->base_, seg->size_, policy);
+
+    seg->inUse_.store(true, memory_order_release);
+
+    return seg->base_;
+}
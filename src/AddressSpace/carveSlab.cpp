@@ -0,0 +1,77 @@
+/**
+ * \file AddressSpace/carveSlab.cpp
+ *
+ * Implementation of AddressSpace::carveSlab().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/AddressSpace.h>
+#include <sys/mman.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Carve a new slab for a size class, adding its segments to the depot.  The
+ * caller holds the lock.
+ *
+ * \param sizeClass The size class of the slab.
+ *
+ * \returns false if there is no room for the slab.
+ */
+bool AddressSpace::carveSlab(size_t sizeClass)
+{
+    uint64_t size = PAGE_SIZE << sizeClass;
+    uint64_t length = size * SLAB_SLOTS;
+    uint64_t base = 0;
+
+    //place the slab after the last allocation, skipping fixed mappings.
+    while (0 == base && nextBase_ + length > nextBase_)
+    {
+        if (!overlaps(nextBase_, length))
+            base = nextBase_;
+
+        nextBase_ += length;
+    }
+
+    if (0 == base)
+        return false;
+
+    //slabs in the host arena share its memory.  Others are mapped from the
+    //host in one piece, which commits pages as they are first touched.
+    uint8_t* memory;
+    if (nullptr != guestView_ && base + length <= HOST_ARENA_SIZE)
+    {
+        memory = hostView_ + base;
+    }
+    else
+    {
+        void* slab =
+            mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (MAP_FAILED == slab)
+            return false;
+
+        memory = static_cast<uint8_t*>(slab);
+        slabMemory_.emplace_back(memory, length);
+    }
+
+    //the depot hands out its last segment first, so lower addresses go last.
+    for (size_t slot = SLAB_SLOTS; slot > 0; --slot)
+    {
+        uint64_t offset = (slot - 1) * size;
+        unique_ptr<Segment> seg(
+            new Segment(base + offset, size, 0, memory + offset));
+
+        seg->sizeClass_ = static_cast<uint8_t>(sizeClass + 1);
+        seg->inUse_.store(false, memory_order_relaxed);
+        depot_[sizeClass].push_back(insert(move(seg)));
+    }
+
+    return true;
+}
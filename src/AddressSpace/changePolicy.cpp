@@ -0,0 +1,42 @@
+/**
+ * \file AddressSpace/changePolicy.cpp
+ *
+ * Implementation of AddressSpace::changePolicy().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/AddressSpace.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Change the policy of the segment starting at the given guest address.
+ *
+ * \param base      The base address of the segment.
+ * \param policy    The new policy bits for the segment.
+ *
+ * \returns true if the policy was changed.
+ */
+bool AddressSpace::changePolicy(uint64_t base, uint8_t policy)
+{
+    lock_guard<mutex> guard(lock_);
+
+    auto seg = segments_.find(base);
+    if (seg == segments_.end() || !seg->second->inUse()
+     || (policy & ~SEGMENT_POLICY_MASK))
+        return false;
+
+    seg->second->setPolicy(policy);
+    if (nullptr != guestView_ && base + seg->second->size() <= HOST_ARENA_SIZE)
+        protect(base, seg->second->size(), policy);
+
+    ++generation_;
+
+    return true;
+}
@@ -0,0 +1,36 @@
+/**
+ * \file AddressSpace/dAddressSpace.cpp
+ *
+ * Destructor for AddressSpace.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/AddressSpace.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace simex;
+
+/**
+ * Destructor.
+ */
+AddressSpace::~AddressSpace()
+{
+    //segments in the arena must not outlive it.
+    segments_.clear();
+
+    for (auto& slab : slabMemory_)
+        munmap(slab.first, slab.second);
+
+    if (nullptr != guestView_)
+    {
+        munmap(guestView_, HOST_ARENA_SIZE);
+        munmap(hostView_, HOST_ARENA_SIZE);
+        close(arenaFile_);
+    }
+}
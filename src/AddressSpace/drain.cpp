@@ -0,0 +1,36 @@
+/**
+ * \file AddressSpace/drain.cpp
+ *
+ * Implementation of AddressSpace::drain().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <algorithm>
+#include <simex/AddressSpace.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Move up to count free slab segments of a size class from a cache to the
+ * depot.  The segments freed most recently stay in the cache.
+ *
+ * \param cache     The cache to drain.
+ * \param sizeClass The size class to drain.
+ * \param count     The number of segments to move.
+ */
+void AddressSpace::drain(SlabCache& cache, size_t sizeClass, size_t count)
+{
+    lock_guard<mutex> guard(lock_);
+    vector<Segment*>& free = cache.free_[sizeClass];
+
+    count = min(count, free.size());
+    depot_[sizeClass].insert(
+        depot_[sizeClass].end(), free.begin(), free.begin() + count);
+    free.erase(free.begin(), free.begin() + count);
+}
@@ -0,0 +1,34 @@
+/**
+ * \file AddressSpace/find.cpp
+ *
+ * Implementation of AddressSpace::find().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/AddressSpace.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Find the segment containing the given guest address.
+ *
+ * \param addr      The guest address to look up.
+ *
+ * \returns the segment containing this address, or nullptr.
+ */
+Segment* AddressSpace::find(uint64_t addr)
+{
+    Segment* seg = pages_.find(addr);
+
+    //free slab segments stay in the page table, but are never found.
+    if (nullptr == seg || !seg->inUse())
+        return nullptr;
+
+    return seg;
+}
@@ -0,0 +1,90 @@
+/**
+ * \file AddressSpace/free.cpp
+ *
+ * Implementation of AddressSpace::free().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <fcntl.h>
+#include <simex/AddressSpace.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Free the segment starting at the given guest address.
+ *
+ * \param base      The base address of the segment to free.
+ *
+ * \returns true if a segment was freed.
+ */
+bool AddressSpace::free(uint64_t base)
+{
+    lock_guard<mutex> guard(lock_);
+
+    auto seg = segments_.find(base);
+    if (seg == segments_.end() || !seg->second->inUse())
+        return false;
+
+    //slab segments stay mapped, and go back to the depot.
+    if (0 != seg->second->sizeClass_)
+    {
+        Segment* slab = seg->second.get();
+        if (!release(slab))
+            return false;
+
+        depot_[slab->sizeClass_ - 1].push_back(slab);
+        return true;
+    }
+
+    uint64_t size = seg->second->size();
+    bool arena = nullptr != guestView_ && base + size <= HOST_ARENA_SIZE;
+
+    pages_.remove(seg->second.get());
+    segments_.erase(seg);
+    ++generation_;
+
+    //release the arena pages, leaving them zero-filled for the next mapping.
+    if (arena)
+    {
+        protect(base, size, 0);
+        fallocate(
+            arenaFile_, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, base, size);
+    }
+
+    return true;
+}
+
+/**
+ * Free the segment starting at the given guest address for a system thread.
+ * A slab segment goes back to the thread's cache, which only takes a lock
+ * when the cache is full.
+ *
+ * \param base      The base address of the segment to free.
+ * \param cache     The slab cache of the freeing system thread.
+ *
+ * \returns true if a segment was freed.
+ */
+bool AddressSpace::free(uint64_t base, SlabCache& cache)
+{
+    Segment* seg = find(base);
+    if (nullptr == seg || 0 == seg->sizeClass_ || seg->base_ != base)
+        return free(base);
+
+    if (!release(seg))
+        return false;
+
+    size_t sizeClass = seg->sizeClass_ - 1;
+    vector<Segment*>& free = cache.free_[sizeClass];
+
+    free.push_back(seg);
+    if (free.size() > 2 * SLAB_BATCH)
+        drain(cache, sizeClass, SLAB_BATCH);
+
+    return true;
+}
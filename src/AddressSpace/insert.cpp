@@ -0,0 +1,37 @@
+/**
+ * \file AddressSpace/insert.cpp
+ *
+ * Implementation of AddressSpace::insert().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/AddressSpace.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Insert a new segment, unless it would overlap an existing segment.  The
+ * caller holds the lock.
+ *
+ * \param seg       The segment to insert.
+ *
+ * \returns the inserted segment, or nullptr if it was discarded.
+ */
+Segment* AddressSpace::insert(unique_ptr<Segment> seg)
+{
+    if (overlaps(seg->base(), seg->size()))
+        return nullptr;
+
+    Segment* ret = seg.get();
+    segments_.emplace(ret->base(), move(seg));
+    pages_.insert(ret);
+    ++generation_;
+
+    return ret;
+}
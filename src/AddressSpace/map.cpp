@@ -0,0 +1,33 @@
+/**
+ * \file AddressSpace/map.cpp
+ *
+ * Implementation of AddressSpace::map().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/AddressSpace.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Map a new segment at a fixed guest address.
+ *
+ * \param base      The page aligned guest address of the segment.
+ * \param size      The size of the segment, in bytes.
+ * \param policy    The policy bits for the segment.
+ *
+ * \returns the new segment, or nullptr if the segment is misaligned or would
+ * overlap an existing segment.
+ */
+Segment* AddressSpace::map(uint64_t base, uint64_t size, uint8_t policy)
+{
+    lock_guard<mutex> guard(lock_);
+
+    return place(base, size, policy);
+}
@@ -0,0 +1,130 @@
+/**
+ * \file AddressSpace/mapFile.cpp
+ *
+ * Implementation of AddressSpace::mapFile().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <simex/AddressSpace.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace simex;
+using namespace std;
+
+namespace {
+
+/**
+ * The size of each read when a file region is copied into a segment.
+ */
+const size_t COPY_CHUNK = 64 * 1024;
+
+}
+
+/**
+ * Map a new segment at a fixed guest address, initialized from a region of a
+ * file, such as a segment of an executable image.  The file is mapped
+ * copy-on-write, so that only the pages which are touched are read, and only
+ * the pages which are written are copied.  Bytes past the file region are
+ * zero-filled.  Changes are never written to the file.
+ *
+ * The file holds guest byte order, so in the native byte order, or in the
+ * host arena, the file region is copied into the segment instead.
+ *
+ * \param base      The page aligned guest address of the segment.
+ * \param size      The size of the segment, in bytes.
+ * \param policy    The policy bits for the segment.
+ * \param fd        The file to map, which may be closed afterward.
+ * \param offset    The page aligned offset of the region in the file.
+ * \param length    The length of the region, no larger than size.
+ *
+ * \returns the new segment, or nullptr if the segment is misaligned, would
+ * overlap an existing segment, or the region can't be read.
+ */
+Segment* AddressSpace::mapFile(
+    uint64_t base, uint64_t size, uint8_t policy, int fd, uint64_t offset,
+    uint64_t length)
+{
+    uint64_t pages = (size + PAGE_SIZE - 1) / PAGE_SIZE;
+    uint64_t mapped = pages * PAGE_SIZE;
+    struct stat st;
+
+    if (0 == size || length > size || 0 != (offset % PAGE_SIZE)
+     || offset + length < offset)
+        return nullptr;
+
+    //pages past the end of the file can't be touched, so the whole region
+    //must be in the file.
+    if (0 != fstat(fd, &st) || (uint64_t)st.st_size < offset + length)
+        return nullptr;
+
+    //copy the region when memory can't hold the file's bytes as they are.
+    if (ByteOrder::Native == order_
+     || (nullptr != guestView_ && base + mapped <= HOST_ARENA_SIZE))
+    {
+        Segment* seg = map(base, size, policy);
+        if (!seg)
+            return nullptr;
+
+        unique_ptr<uint8_t[]> chunk(new uint8_t[COPY_CHUNK]);
+        for (uint64_t done = 0; done < length; )
+        {
+            size_t count = (size_t)min<uint64_t>(length - done, COPY_CHUNK);
+            ssize_t got = pread(fd, chunk.get(), count, offset + done);
+
+            if (got < 0 && EINTR == errno)
+                continue;
+
+            if (got <= 0)
+            {
+                free(base);
+                return nullptr;
+            }
+
+            write(base + done, chunk.get(), (size_t)got);
+            done += (uint64_t)got;
+        }
+
+        return seg;
+    }
+
+    if (0 != (base % PAGE_SIZE) || base + mapped < base)
+        return nullptr;
+
+    //reserve zero-filled pages for the whole segment, then map the file
+    //region over the front of them.
+    void* memory =
+        mmap(nullptr, mapped, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (MAP_FAILED == memory)
+        return nullptr;
+
+    uint8_t* bytes = static_cast<uint8_t*>(memory);
+    uint64_t filePages = (length + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE;
+
+    if (0 != length
+     && MAP_FAILED ==
+            mmap(bytes, filePages, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_FIXED, fd, (off_t)offset))
+    {
+        munmap(memory, mapped);
+        return nullptr;
+    }
+
+    //the rest of the last file page holds whatever follows the region.
+    memset(bytes + length, 0, filePages - length);
+
+    unique_ptr<Segment> seg(new Segment(base, mapped, policy, bytes, mapped));
+    lock_guard<mutex> guard(lock_);
+
+    return insert(move(seg));
+}
@@ -0,0 +1,42 @@
+/**
+ * \file AddressSpace/overlaps.cpp
+ *
+ * Implementation of AddressSpace::overlaps().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/AddressSpace.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Returns true if any segment overlaps the given range of guest addresses.
+ * The caller holds the lock.
+ *
+ * \param base      The first guest address of the range.
+ * \param length    The length of the range, in bytes.
+ */
+bool AddressSpace::overlaps(uint64_t base, uint64_t length) const
+{
+    //the segment following this base must not overlap.
+    auto next = segments_.lower_bound(base);
+    if (next != segments_.end() && next->first < base + length)
+        return true;
+
+    //the segment preceding this base must not overlap.
+    if (next != segments_.begin())
+    {
+        auto prev = next;
+        --prev;
+        if (prev->second->base() + prev->second->size() > base)
+            return true;
+    }
+
+    return false;
+}
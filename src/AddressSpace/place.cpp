@@ -0,0 +1,51 @@
+/**
+ * \file AddressSpace/place.cpp
+ *
+ * Implementation of AddressSpace::place().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/AddressSpace.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Map a new segment at a fixed guest address.  The caller holds the lock.
+ *
+ * \param base      The page aligned guest address of the segment.
+ * \param size      The size of the segment, in bytes.
+ * \param policy    The policy bits for the segment.
+ *
+ * \returns the new segment, or nullptr if the segment is misaligned or would
+ * overlap an existing segment.
+ */
+Segment* AddressSpace::place(uint64_t base, uint64_t size, uint8_t policy)
+{
+    //segments are page aligned and sized in whole pages.
+    uint64_t pages = (size + PAGE_SIZE - 1) / PAGE_SIZE;
+    uint64_t length = pages * PAGE_SIZE;
+
+    if (0 == size || 0 != (base % PAGE_SIZE) || base + length < base)
+        return nullptr;
+
+    //segments in the host arena share its memory.
+    if (nullptr != guestView_ && base + length <= HOST_ARENA_SIZE)
+    {
+        Segment* seg =
+            insert(
+                unique_ptr<Segment>(
+                    new Segment(base, length, policy, hostView_ + base)));
+        if (seg)
+            protect(base, length, policy);
+
+        return seg;
+    }
+
+    return insert(unique_ptr<Segment>(new Segment(base, length, policy)));
+}
@@ -0,0 +1,45 @@
+/**
+ * \file AddressSpace/protect.cpp
+ *
+ * Implementation of AddressSpace::protect().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/AddressSpace.h>
+#include <sys/mman.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Set the host protection of the guest view of a range of the arena to match
+ * a segment policy.
+ *
+ * The host MMU can't express write-only or execute-only access, so those
+ * pages stay inaccessible and every access to them is checked in software.
+ * Execution never goes through the guest view.
+ *
+ * \param base      The page aligned guest address of the range.
+ * \param size      The size of the range, in bytes.
+ * \param policy    The policy bits for the range.
+ */
+void AddressSpace::protect(uint64_t base, uint64_t size, uint8_t policy)
+{
+    int prot = PROT_NONE;
+
+    if (policy & SEGMENT_READ)
+    {
+        prot = PROT_READ;
+        if (policy & SEGMENT_WRITE)
+            prot |= PROT_WRITE;
+    }
+
+    //this only fails if the host runs out of mappings, in which case the
+    //range keeps its old protection; narrowing always succeeds.
+    mprotect(guestView_ + base, size, prot);
+}
@@ -0,0 +1,55 @@
+/**
+ * \file AddressSpace/read.cpp
+ *
+ * Implementation of AddressSpace::read().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <simex/AddressSpace.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Copy bytes out of guest memory, ignoring segment policy.  This is used by
+ * the host, such as by loaders and system calls.  Bytes are copied in guest
+ * byte order, whatever the byte order of memory.
+ *
+ * \param addr      The guest address to read from.
+ * \param out       The host buffer to read into.
+ * \param size      The number of bytes to read.
+ *
+ * \returns true if the whole range was mapped and copied.
+ */
+bool AddressSpace::read(uint64_t addr, void* out, size_t size)
+{
+    uint8_t* dst = static_cast<uint8_t*>(out);
+
+    while (size > 0)
+    {
+        Segment* seg = find(addr);
+        if (!seg)
+            return false;
+
+        uint64_t offset = addr - seg->base();
+        size_t count = (size_t)min<uint64_t>(size, seg->size() - offset);
+
+        if (ByteOrder::Native == order_)
+            readNative(dst, seg->data(), offset, count);
+        else
+            memcpy(dst, seg->data() + offset, count);
+
+        dst += count;
+        addr += count;
+        size -= count;
+    }
+
+    return true;
+}
@@ -0,0 +1,55 @@
+/**
+ * \file AddressSpace/readNative.cpp
+ *
+ * Implementation of AddressSpace::readNative().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <cstring>
+#include <simex/AddressSpace.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Copy bytes out of memory with the native byte order.  Whole octas are
+ * copied with a single swap each, and the bytes of partial octas one at a
+ * time.
+ *
+ * \param out       The host buffer to copy into, in guest byte order.
+ * \param data      The memory of the segment holding the bytes.
+ * \param offset    The offset of the first byte in the segment.
+ * \param size      The number of bytes to copy.
+ */
+void AddressSpace::readNative(
+    uint8_t* out, const uint8_t* data, uint64_t offset, size_t size)
+{
+    if (0 == NATIVE_BYTE_SWIZZLE)
+    {
+        memcpy(out, data + offset, size);
+        return;
+    }
+
+    while (size > 0 && (offset & 7))
+    {
+        *out++ = data[offset++ ^ NATIVE_BYTE_SWIZZLE];
+        --size;
+    }
+
+    for (; size >= 8; size -= 8, offset += 8, out += 8)
+    {
+        uint64_t octa;
+
+        memcpy(&octa, data + offset, sizeof(octa));
+        octa = __builtin_bswap64(octa);
+        memcpy(out, &octa, sizeof(octa));
+    }
+
+    for (; size > 0; --size)
+        *out++ = data[offset++ ^ NATIVE_BYTE_SWIZZLE];
+}
@@ -0,0 +1,43 @@
+/**
+ * \file AddressSpace/refill.cpp
+ *
+ * Implementation of AddressSpace::refill().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <algorithm>
+#include <simex/AddressSpace.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Move a batch of free slab segments of a size class from the depot to a
+ * cache, carving a new slab if the depot is empty.
+ *
+ * \param cache     The cache to refill.
+ * \param sizeClass The size class to refill.
+ *
+ * \returns false if no segment could be moved.
+ */
+bool AddressSpace::refill(SlabCache& cache, size_t sizeClass)
+{
+    lock_guard<mutex> guard(lock_);
+    vector<Segment*>& depot = depot_[sizeClass];
+
+    if (depot.empty() && !carveSlab(sizeClass))
+        return false;
+
+    //the last segments of the depot stay last in the cache.
+    size_t count = min(depot.size(), SLAB_BATCH);
+    cache.free_[sizeClass].insert(
+        cache.free_[sizeClass].end(), depot.end() - count, depot.end());
+    depot.resize(depot.size() - count);
+
+    return true;
+}
@@ -0,0 +1,83 @@
+/**
+ * \file AddressSpace/release.cpp
+ *
+ * Implementation of AddressSpace::release().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <cstring>
+#include <fcntl.h>
+#include <simex/AddressSpace.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Mark a slab segment free, revoking its policy and zero-filling it.
+ *
+ * \param seg       The slab segment to release.
+ *
+ * \returns false if the segment was already free.
+ */
+bool AddressSpace::release(Segment* seg)
+{
+    if (!seg->inUse_.exchange(false, memory_order_acq_rel))
+        return false;
+
+    bool arena =
+        nullptr != guestView_ && seg->base_ + seg->size_ <= HOST_ARENA_SIZE;
+
+    seg->setPolicy(0);
+    if (arena)
+        protect(seg->base_, seg->size_, 0);
+
+    //machines may have cached translations of this segment.
+    ++generation_;
+
+    //a segment of a single host page is cleared by hand, which is cheaper
+    //than dropping it and faulting it back in.  Larger ones are zero-filled
+    //by dropping their pages, so that pages the guest never touched stay
+    //uncommitted.
+    static const uintptr_t hostPage = sysconf(_SC_PAGESIZE);
+    if (seg->size_ <= hostPage)
+    {
+        memset(seg->memory_, 0, seg->size_);
+        return true;
+    }
+
+    if (arena)
+    {
+        if (0 != fallocate(
+                arenaFile_, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                seg->base_, seg->size_))
+            memset(seg->memory_, 0, seg->size_);
+
+        return true;
+    }
+
+    //only whole host pages can be dropped; the rest is cleared by hand.
+    uintptr_t start = reinterpret_cast<uintptr_t>(seg->memory_);
+    uintptr_t end = start + seg->size_;
+    uintptr_t first = (start + hostPage - 1) & ~(hostPage - 1);
+    uintptr_t last = end & ~(hostPage - 1);
+
+    if (first >= last
+     || 0 != madvise(
+            reinterpret_cast<void*>(first), last - first, MADV_DONTNEED))
+    {
+        memset(seg->memory_, 0, seg->size_);
+        return true;
+    }
+
+    memset(seg->memory_, 0, first - start);
+    memset(reinterpret_cast<uint8_t*>(last), 0, end - last);
+
+    return true;
+}
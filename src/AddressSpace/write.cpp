@@ -0,0 +1,57 @@
+/**
+ * \file AddressSpace/write.cpp
+ *
+ * Implementation of AddressSpace::write().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <simex/AddressSpace.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Copy bytes into guest memory, ignoring segment policy.  This is used by the
+ * host, such as by loaders and system calls.  Bytes are copied in guest byte
+ * order, whatever the byte order of memory.  Each segment written to gets a
+ * new version.
+ *
+ * \param addr      The guest address to write to.
+ * \param in        The host buffer to write from.
+ * \param size      The number of bytes to write.
+ *
+ * \returns true if the whole range was mapped and copied.
+ */
+bool AddressSpace::write(uint64_t addr, const void* in, size_t size)
+{
+    const uint8_t* src = static_cast<const uint8_t*>(in);
+
+    while (size > 0)
+    {
+        Segment* seg = find(addr);
+        if (!seg)
+            return false;
+
+        uint64_t offset = addr - seg->base();
+        size_t count = (size_t)min<uint64_t>(size, seg->size() - offset);
+
+        if (ByteOrder::Native == order_)
+            writeNative(seg->data(), offset, src, count);
+        else
+            memcpy(seg->data() + offset, src, count);
+
+        seg->changed();
+        src += count;
+        addr += count;
+        size -= count;
+    }
+
+    return true;
+}
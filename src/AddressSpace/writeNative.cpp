@@ -0,0 +1,54 @@
+/**
+ * \file AddressSpace/writeNative.cpp
+ *
+ * Implementation of AddressSpace::writeNative().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <cstring>
+#include <simex/AddressSpace.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Copy bytes into memory with the native byte order.  Whole octas are copied
+ * with a single swap each, and the bytes of partial octas one at a time.
+ *
+ * \param data      The memory of the segment holding the bytes.
+ * \param offset    The offset of the first byte in the segment.
+ * \param in        The host buffer to copy from, in guest byte order.
+ * \param size      The number of bytes to copy.
+ */
+void AddressSpace::writeNative(
+    uint8_t* data, uint64_t offset, const uint8_t* in, size_t size)
+{
+    if (0 == NATIVE_BYTE_SWIZZLE)
+    {
+        memcpy(data + offset, in, size);
+        return;
+    }
+
+    while (size > 0 && (offset & 7))
+    {
+        data[offset++ ^ NATIVE_BYTE_SWIZZLE] = *in++;
+        --size;
+    }
+
+    for (; size >= 8; size -= 8, offset += 8, in += 8)
+    {
+        uint64_t octa;
+
+        memcpy(&octa, in, sizeof(octa));
+        octa = __builtin_bswap64(octa);
+        memcpy(data + offset, &octa, sizeof(octa));
+    }
+
+    for (; size > 0; --size)
+        data[offset++ ^ NATIVE_BYTE_SWIZZLE] = *in++;
+}
@@ -0,0 +1,35 @@
+/**
+ * \file CodeBuffer/CodeBuffer.cpp
+ *
+ * Constructors for CodeBuffer.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/CodeBuffer.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Create an empty buffer which owns its memory.
+ */
+CodeBuffer::CodeBuffer()
+    : data_(nullptr), size_(0), capacity_(0), owned_(true)
+{
+}
+
+/**
+ * Create an empty buffer over existing memory.
+ *
+ * \param memory    The memory to write into.
+ * \param capacity  The size of this memory, in bytes.
+ */
+CodeBuffer::CodeBuffer(uint8_t* memory, size_t capacity)
+    : data_(memory), size_(0), capacity_(capacity), owned_(false)
+{
+}
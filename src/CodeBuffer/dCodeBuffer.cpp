@@ -0,0 +1,22 @@
+/**
+ * \file CodeBuffer/dCodeBuffer.cpp
+ *
+ * Destructor for CodeBuffer.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/CodeBuffer.h>
+
+using namespace simex;
+
+/**
+ * Destructor.
+ */
+CodeBuffer::~CodeBuffer()
+{
+}
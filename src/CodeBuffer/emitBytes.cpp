@@ -0,0 +1,37 @@
+/**
+ * \file CodeBuffer/emitBytes.cpp
+ *
+ * CodeBuffer::emitBytes() implementation.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <cstring>
+#include <simex/CodeBuffer.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Append raw bytes, such as data embedded in a code section.
+ *
+ * \param in        The bytes to append.
+ * \param size      The number of bytes to append.
+ *
+ * \returns true if the bytes were appended.
+ */
+bool CodeBuffer::emitBytes(const void* in, size_t size)
+{
+    if (!reserve(size))
+        return false;
+
+    if (size)
+        memcpy(data_ + size_, in, size);
+    size_ += size;
+
+    return true;
+}
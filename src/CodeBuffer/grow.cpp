@@ -0,0 +1,38 @@
+/**
+ * \file CodeBuffer/grow.cpp
+ *
+ * Grow the memory owned by a CodeBuffer.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/CodeBuffer.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Grow owned memory to hold at least the given number of additional bytes.
+ * Capacity doubles, so appends are amortized constant time.
+ *
+ * \returns false if this buffer is placed over existing memory.
+ */
+bool CodeBuffer::grow(size_t bytes)
+{
+    if (!owned_)
+        return false;
+
+    size_t capacity = capacity_ ? 2 * capacity_ : 4096;
+    while (capacity < size_ + bytes)
+        capacity *= 2;
+
+    storage_.resize(capacity);
+    data_ = storage_.data();
+    capacity_ = capacity;
+
+    return true;
+}
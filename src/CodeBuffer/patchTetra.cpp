@@ -0,0 +1,40 @@
+/**
+ * \file CodeBuffer/patchTetra.cpp
+ *
+ * CodeBuffer::patchTetra() implementation.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/CodeBuffer.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Replace a previously emitted tetra, such as a forward branch whose target
+ * is now known.
+ *
+ * \param offset    The byte offset of the tetra within this buffer.
+ * \param tetra     The new tetra value.
+ *
+ * \returns true if the tetra was replaced, or false if it lies outside of the
+ * emitted bytes.
+ */
+bool CodeBuffer::patchTetra(size_t offset, uint32_t tetra)
+{
+    if (offset > size_ || size_ - offset < 4)
+        return false;
+
+    uint8_t* p = data_ + offset;
+    p[0] = static_cast<uint8_t>(tetra >> 24);
+    p[1] = static_cast<uint8_t>(tetra >> 16);
+    p[2] = static_cast<uint8_t>(tetra >> 8);
+    p[3] = static_cast<uint8_t>(tetra);
+
+    return true;
+}
@@ -0,0 +1,27 @@
+/**
+ * \file CodeBuffer/reserve.cpp
+ *
+ * CodeBuffer::reserve() implementation.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/CodeBuffer.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Make sure that at least the given number of bytes can be appended without
+ * growing again.
+ *
+ * \returns true if the space is available.
+ */
+bool CodeBuffer::reserve(size_t bytes)
+{
+    return size_ + bytes <= capacity_ || grow(bytes);
+}
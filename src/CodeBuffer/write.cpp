@@ -0,0 +1,66 @@
+/**
+ * \file CodeBuffer/write.cpp
+ *
+ * CodeBuffer::write() implementations.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <cerrno>
+#include <ostream>
+#include <simex/CodeBuffer.h>
+#include <unistd.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Write everything emitted to an ostream with a single write.
+ *
+ * \param out       The binary ostream to write to.
+ *
+ * \returns true if the stream is still good after the write.
+ */
+bool CodeBuffer::write(std::ostream& out) const
+{
+    out.write(reinterpret_cast<const char*>(data_), size_);
+
+    return out.good();
+}
+
+/**
+ * Write everything emitted to a file descriptor.  A single write is issued
+ * unless the descriptor accepts only part of the data, or the write is
+ * interrupted.
+ *
+ * \param fd        The file descriptor to write to.
+ *
+ * \returns true if every byte was written.
+ */
+bool CodeBuffer::write(int fd) const
+{
+    const uint8_t* p = data_;
+    size_t left = size_;
+
+    while (left > 0)
+    {
+        ssize_t written = ::write(fd, p, left);
+
+        if (written < 0)
+        {
+            if (EINTR == errno)
+                continue;
+
+            return false;
+        }
+
+        p += written;
+        left -= static_cast<size_t>(written);
+    }
+
+    return true;
+}
@@ -0,0 +1,79 @@
+/**
+ * \file DecodeBatch/DecodeBatchImplementation.h
+ *
+ * Private header for the batch decode strategies.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#ifndef  SIMEX_DECODE_BATCH_IMPLEMENTATION_HEADER_GUARD
+# define SIMEX_DECODE_BATCH_IMPLEMENTATION_HEADER_GUARD
+
+#include <cstddef>
+#include <cstdint>
+#include <simex/DecodeBatch.h>
+
+//this header is C++ specific
+#ifdef __cplusplus
+
+/*
+ * The vector strategies are built with per-function target attributes, so
+ * the library as a whole does not require SSSE3 or AVX2.  They are only
+ * available when building for x86 with GCC or Clang.
+ */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+# define SIMEX_DECODE_BATCH_X86
+#endif
+
+namespace simex {
+
+/**
+ * Get the output arrays starting at the given instruction of a batch.
+ */
+inline DecodedBatch offsetBatch(const DecodedBatch& out, std::size_t offset)
+{
+    return DecodedBatch{
+        out.opcode + offset, out.x + offset, out.y + offset, out.z + offset,
+        out.yz + offset, out.xyz + offset };
+}
+
+/**
+ * Decode every tetra one at a time.
+ *
+ * \returns count.
+ */
+std::size_t decodeBatchScalar(
+    const std::uint8_t* in, std::size_t count, const DecodedBatch& out);
+
+#ifdef SIMEX_DECODE_BATCH_X86
+
+/**
+ * Decode tetras sixteen at a time using SSSE3.  A remainder of fewer than
+ * sixteen tetras is left for the caller.
+ *
+ * \returns the number of tetras decoded.
+ */
+std::size_t decodeBatchSSSE3(
+    const std::uint8_t* in, std::size_t count, const DecodedBatch& out);
+
+/**
+ * Decode tetras thirty-two at a time using AVX2.  A remainder of fewer than
+ * thirty-two tetras is left for the caller.
+ *
+ * \returns the number of tetras decoded.
+ */
+std::size_t decodeBatchAVX2(
+    const std::uint8_t* in, std::size_t count, const DecodedBatch& out);
+
+#endif //SIMEX_DECODE_BATCH_X86
+
+/* namespace simex */ }
+
+//end of C++ code
+#endif //__cplusplus
+
+#endif //SIMEX_DECODE_BATCH_IMPLEMENTATION_HEADER_GUARD
@@ -0,0 +1,32 @@
+/**
+ * \file DecodeBatch/bestDecodeStrategy.cpp
+ *
+ * Select the fastest batch decode strategy for this processor.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include "DecodeBatchImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Get the fastest strategy supported by this processor.  The processor is
+ * only checked once.
+ */
+DecodeStrategy simex::bestDecodeStrategy()
+{
+    static const DecodeStrategy best =
+        decodeStrategySupported(DecodeStrategy::AVX2)
+            ? DecodeStrategy::AVX2
+            : decodeStrategySupported(DecodeStrategy::SSSE3)
+                ? DecodeStrategy::SSSE3
+                : DecodeStrategy::Scalar;
+
+    return best;
+}
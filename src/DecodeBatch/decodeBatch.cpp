@@ -0,0 +1,61 @@
+/**
+ * \file DecodeBatch/decodeBatch.cpp
+ *
+ * Decode a run of big-endian instruction tetras into structure-of-arrays
+ * form.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include "DecodeBatchImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Decode a run of big-endian instruction tetras using the fastest strategy
+ * supported by this processor.
+ *
+ * \param in        Pointer to the first byte of the first tetra.
+ * \param count     The number of tetras to decode.
+ * \param out       The output arrays.
+ */
+void simex::decodeBatch(
+    const uint8_t* in, size_t count, const DecodedBatch& out)
+{
+    decodeBatch(in, count, out, bestDecodeStrategy());
+}
+
+/**
+ * Decode a run of big-endian instruction tetras using the given strategy.
+ * The vector strategies leave a short remainder, which is decoded one tetra
+ * at a time.
+ *
+ * \param in        Pointer to the first byte of the first tetra.
+ * \param count     The number of tetras to decode.
+ * \param out       The output arrays.
+ * \param strategy  The strategy to use.
+ */
+void simex::decodeBatch(
+    const uint8_t* in, size_t count, const DecodedBatch& out,
+    DecodeStrategy strategy)
+{
+    size_t done = 0;
+
+    if (!decodeStrategySupported(strategy))
+        strategy = DecodeStrategy::Scalar;
+
+#ifdef SIMEX_DECODE_BATCH_X86
+    if (DecodeStrategy::AVX2 == strategy)
+        done = decodeBatchAVX2(in, count, out);
+    else if (DecodeStrategy::SSSE3 == strategy)
+        done = decodeBatchSSSE3(in, count, out);
+#endif
+
+    if (done < count)
+        decodeBatchScalar(in + 4 * done, count - done, offsetBatch(out, done));
+}
@@ -0,0 +1,106 @@
+/**
+ * \file DecodeBatch/decodeBatchAVX2.cpp
+ *
+ * Decode a batch of tetras thirty-two at a time using AVX2 byte shuffles.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include "DecodeBatchImplementation.h"
+
+#ifdef SIMEX_DECODE_BATCH_X86
+
+#include <immintrin.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Decode tetras thirty-two at a time using AVX2.
+ *
+ * This is the SSSE3 transpose applied to both 128-bit lanes at once.  Byte
+ * shuffles and unpacks stay within a lane, so each result is permuted back
+ * into instruction order before it is stored.
+ *
+ * \returns the number of tetras decoded.
+ */
+__attribute__((target("avx2")))
+size_t simex::decodeBatchAVX2(
+    const uint8_t* in, size_t count, const DecodedBatch& out)
+{
+    const __m256i fields =
+        _mm256_setr_epi8(
+            0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15,
+            0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+    const __m256i yz =
+        _mm256_setr_epi8(
+            3, 2, 7, 6, 11, 10, 15, 14, -1, -1, -1, -1, -1, -1, -1, -1,
+            3, 2, 7, 6, 11, 10, 15, 14, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m256i xyz =
+        _mm256_setr_epi8(
+            3, 2, 1, -1, 7, 6, 5, -1, 11, 10, 9, -1, 15, 14, 13, -1,
+            3, 2, 1, -1, 7, 6, 5, -1, 11, 10, 9, -1, 15, 14, 13, -1);
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    size_t i = 0;
+
+    for (; i + 32 <= count; i += 32, in += 128)
+    {
+        __m256i t[4];
+
+        for (int k = 0; k < 4; ++k)
+        {
+            t[k] =
+                _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(in + 32*k));
+
+            _mm256_storeu_si256(
+                reinterpret_cast<__m256i*>(out.xyz + i + 8*k),
+                _mm256_shuffle_epi8(t[k], xyz));
+        }
+
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(out.yz + i),
+            _mm256_permute4x64_epi64(
+                _mm256_unpacklo_epi64(
+                    _mm256_shuffle_epi8(t[0], yz),
+                    _mm256_shuffle_epi8(t[1], yz)),
+                _MM_SHUFFLE(3, 1, 2, 0)));
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(out.yz + i + 16),
+            _mm256_permute4x64_epi64(
+                _mm256_unpacklo_epi64(
+                    _mm256_shuffle_epi8(t[2], yz),
+                    _mm256_shuffle_epi8(t[3], yz)),
+                _MM_SHUFFLE(3, 1, 2, 0)));
+
+        //each lane now holds opcodes, X, Y, and Z for four tetras.
+        for (int k = 0; k < 4; ++k)
+            t[k] = _mm256_shuffle_epi8(t[k], fields);
+
+        __m256i a = _mm256_unpacklo_epi32(t[0], t[1]);
+        __m256i b = _mm256_unpackhi_epi32(t[0], t[1]);
+        __m256i c = _mm256_unpacklo_epi32(t[2], t[3]);
+        __m256i d = _mm256_unpackhi_epi32(t[2], t[3]);
+
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(out.opcode + i),
+            _mm256_permutevar8x32_epi32(_mm256_unpacklo_epi64(a, c), order));
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(out.x + i),
+            _mm256_permutevar8x32_epi32(_mm256_unpackhi_epi64(a, c), order));
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(out.y + i),
+            _mm256_permutevar8x32_epi32(_mm256_unpacklo_epi64(b, d), order));
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(out.z + i),
+            _mm256_permutevar8x32_epi32(_mm256_unpackhi_epi64(b, d), order));
+    }
+
+    return i;
+}
+
+#endif //SIMEX_DECODE_BATCH_X86
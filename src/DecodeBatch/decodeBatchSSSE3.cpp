@@ -0,0 +1,92 @@
+/**
+ * \file DecodeBatch/decodeBatchSSSE3.cpp
+ *
+ * Decode a batch of tetras sixteen at a time using SSSE3 byte shuffles.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include "DecodeBatchImplementation.h"
+
+#ifdef SIMEX_DECODE_BATCH_X86
+
+#include <immintrin.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Decode tetras sixteen at a time using SSSE3.
+ *
+ * Each group of four tetras is shuffled so that its opcodes, X values, Y
+ * values, and Z values each occupy one 32-bit lane, and four such groups are
+ * then transposed into one vector per field.  YZ and XYZ values are shuffled
+ * directly from the big-endian input into little-endian words.
+ *
+ * \returns the number of tetras decoded.
+ */
+__attribute__((target("ssse3")))
+size_t simex::decodeBatchSSSE3(
+    const uint8_t* in, size_t count, const DecodedBatch& out)
+{
+    const __m128i fields =
+        _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+    const __m128i yz =
+        _mm_setr_epi8(3, 2, 7, 6, 11, 10, 15, 14, -1, -1, -1, -1, -1, -1,
+                      -1, -1);
+    const __m128i xyz =
+        _mm_setr_epi8(3, 2, 1, -1, 7, 6, 5, -1, 11, 10, 9, -1, 15, 14, 13,
+                      -1);
+    size_t i = 0;
+
+    for (; i + 16 <= count; i += 16, in += 64)
+    {
+        __m128i t[4];
+
+        for (int k = 0; k < 4; ++k)
+        {
+            t[k] =
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16*k));
+
+            _mm_storeu_si128(
+                reinterpret_cast<__m128i*>(out.xyz + i + 4*k),
+                _mm_shuffle_epi8(t[k], xyz));
+        }
+
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(out.yz + i),
+            _mm_unpacklo_epi64(
+                _mm_shuffle_epi8(t[0], yz), _mm_shuffle_epi8(t[1], yz)));
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(out.yz + i + 8),
+            _mm_unpacklo_epi64(
+                _mm_shuffle_epi8(t[2], yz), _mm_shuffle_epi8(t[3], yz)));
+
+        //each vector now holds opcodes, X, Y, and Z for four tetras.
+        for (int k = 0; k < 4; ++k)
+            t[k] = _mm_shuffle_epi8(t[k], fields);
+
+        __m128i a = _mm_unpacklo_epi32(t[0], t[1]);
+        __m128i b = _mm_unpackhi_epi32(t[0], t[1]);
+        __m128i c = _mm_unpacklo_epi32(t[2], t[3]);
+        __m128i d = _mm_unpackhi_epi32(t[2], t[3]);
+
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(out.opcode + i),
+            _mm_unpacklo_epi64(a, c));
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(out.x + i), _mm_unpackhi_epi64(a, c));
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(out.y + i), _mm_unpacklo_epi64(b, d));
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(out.z + i), _mm_unpackhi_epi64(b, d));
+    }
+
+    return i;
+}
+
+#endif //SIMEX_DECODE_BATCH_X86
@@ -0,0 +1,38 @@
+/**
+ * \file DecodeBatch/decodeBatchScalar.cpp
+ *
+ * Decode a batch of tetras one at a time.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include "DecodeBatchImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Decode every tetra one at a time.
+ *
+ * \returns count.
+ */
+size_t simex::decodeBatchScalar(
+    const uint8_t* in, size_t count, const DecodedBatch& out)
+{
+    for (size_t i = 0; i < count; ++i, in += 4)
+    {
+        out.opcode[i] = static_cast<Opcode>(in[0]);
+        out.x[i] = in[1];
+        out.y[i] = in[2];
+        out.z[i] = in[3];
+        out.yz[i] = static_cast<uint16_t>((in[2] << 8) | in[3]);
+        out.xyz[i] =
+            (static_cast<uint32_t>(in[1]) << 16) | out.yz[i];
+    }
+
+    return count;
+}
@@ -0,0 +1,46 @@
+/**
+ * \file DecodeBatch/decodeStrategySupported.cpp
+ *
+ * Check whether a batch decode strategy can run on this processor.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include "DecodeBatchImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Returns true if the given strategy can run on this processor.
+ *
+ * \param strategy  The strategy to check.
+ */
+bool simex::decodeStrategySupported(DecodeStrategy strategy)
+{
+#ifdef SIMEX_DECODE_BATCH_X86
+    //this may be called before static constructors have run.
+    __builtin_cpu_init();
+#endif
+
+    switch (strategy)
+    {
+        case DecodeStrategy::Scalar:
+            return true;
+
+#ifdef SIMEX_DECODE_BATCH_X86
+        case DecodeStrategy::SSSE3:
+            return __builtin_cpu_supports("ssse3");
+
+        case DecodeStrategy::AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+
+        default:
+            return false;
+    }
+}
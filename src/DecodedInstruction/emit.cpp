@@ -0,0 +1,46 @@
+/**
+ * \file DecodedInstruction/emit.cpp
+ *
+ * DecodedInstruction::emit() implementations.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <ostream>
+#include <simex/CodeBuffer.h>
+#include <simex/DecodedInstruction.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * The emit method writes this instruction to the given binary ostream.  The
+ * instruction is assembled in a small code buffer and written with a single
+ * call.
+ *
+ * \param out       The ostream to which this instruction is emitted.
+ */
+void DecodedInstruction::emit(std::ostream& out) const
+{
+    uint8_t bytes[4];
+    CodeBuffer buffer(bytes, sizeof(bytes));
+
+    emit(buffer);
+    buffer.write(out);
+}
+
+/**
+ * The emit method appends this instruction to the given code buffer.
+ *
+ * \param out       The code buffer to which this instruction is emitted.
+ *
+ * \returns true if the instruction was appended.
+ */
+bool DecodedInstruction::emit(CodeBuffer& out) const
+{
+    return out.emit(*this);
+}
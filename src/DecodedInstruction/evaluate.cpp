@@ -0,0 +1,32 @@
+/**
+ * \file DecodedInstruction/evaluate.cpp
+ *
+ * DecodedInstruction::evaluate() implementation.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/DecodedInstruction.h>
+#include <simex/MachineState.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Evaluate this instruction against a machine state, as if it had been
+ * fetched from the current program counter.  The machine state is placed
+ * into a fault state for reserved opcodes.
+ *
+ * \param state     The current machine state.
+ *
+ * \sideeffect The machine state is updated based upon the evaluation of
+ * this instruction.
+ */
+void DecodedInstruction::evaluate(MachineState* state) const
+{
+    state->evaluate(*this);
+}
@@ -0,0 +1,290 @@
+/**
+ * \file DecodedInstruction/instructionHandler.cpp
+ *
+ * Static flyweight handler table and instructionHandler() implementation.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/DecodedInstruction.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Flyweight handlers, indexed by opcode.
+ */
+static const InstructionHandler handlerTable[256] = {
+    { Opcode::OP_SYSCALL,       "SYSCALL" },
+    { Opcode::OP_FCMP,          "FCMP" },
+    { Opcode::OP_FUN,           "FUN" },
+    { Opcode::OP_FEQL,          "FEQL" },
+    { Opcode::OP_FADD,          "FADD" },
+    { Opcode::OP_FIX,           "FIX" },
+    { Opcode::OP_FSUB,          "FSUB" },
+    { Opcode::OP_FIXU,          "FIXU" },
+    { Opcode::OP_FLOT,          "FLOT" },
+    { Opcode::OP_FLOTI,         "FLOTI" },
+    { Opcode::OP_FLOTU,         "FLOTU" },
+    { Opcode::OP_FLOTUI,        "FLOTUI" },
+    { Opcode::OP_SFLOT,         "SFLOT" },
+    { Opcode::OP_SFLOTI,        "SFLOTI" },
+    { Opcode::OP_SFLOTU,        "SFLOTU" },
+    { Opcode::OP_SFLOTUI,       "SFLOTUI" },
+    { Opcode::OP_FMUL,          "FMUL" },
+    { Opcode::OP_FCMPE,         "FCMPE" },
+    { Opcode::OP_FUNE,          "FUNE" },
+    { Opcode::OP_FEQLE,         "FEQLE" },
+    { Opcode::OP_FDIV,          "FDIV" },
+    { Opcode::OP_FSQRT,         "FSQRT" },
+    { Opcode::OP_FREM,          "FREM" },
+    { Opcode::OP_FINT,          "FINT" },
+    { Opcode::OP_MUL,           "MUL" },
+    { Opcode::OP_MULI,          "MULI" },
+    { Opcode::OP_MULU,          "MULU" },
+    { Opcode::OP_MULUI,         "MULUI" },
+    { Opcode::OP_DIV,           "DIV" },
+    { Opcode::OP_DIVI,          "DIVI" },
+    { Opcode::OP_DIVU,          "DIVU" },
+    { Opcode::OP_DIVUI,         "DIVUI" },
+    { Opcode::OP_ADD,           "ADD" },
+    { Opcode::OP_ADDI,          "ADDI" },
+    { Opcode::OP_ADDU,          "ADDU" },
+    { Opcode::OP_ADDUI,         "ADDUI" },
+    { Opcode::OP_SUB,           "SUB" },
+    { Opcode::OP_SUBI,          "SUBI" },
+    { Opcode::OP_SUBU,          "SUBU" },
+    { Opcode::OP_SUBUI,         "SUBUI" },
+    { Opcode::OP_2ADDU,         "2ADDU" },
+    { Opcode::OP_2ADDUI,        "2ADDUI" },
+    { Opcode::OP_4ADDU,         "4ADDU" },
+    { Opcode::OP_4ADDUI,        "4ADDUI" },
+    { Opcode::OP_8ADDU,         "8ADDU" },
+    { Opcode::OP_8ADDUI,        "8ADDUI" },
+    { Opcode::OP_16ADDU,        "16ADDU" },
+    { Opcode::OP_16ADDUI,       "16ADDUI" },
+    { Opcode::OP_CMP,           "CMP" },
+    { Opcode::OP_CMPI,          "CMPI" },
+    { Opcode::OP_CMPU,          "CMPU" },
+    { Opcode::OP_CMPUI,         "CMPUI" },
+    { Opcode::OP_NEG,           "NEG" },
+    { Opcode::OP_NEGI,          "NEGI" },
+    { Opcode::OP_NEGU,          "NEGU" },
+    { Opcode::OP_NEGUI,         "NEGUI" },
+    { Opcode::OP_SL,            "SL" },
+    { Opcode::OP_SLI,           "SLI" },
+    { Opcode::OP_SLU,           "SLU" },
+    { Opcode::OP_SLUI,          "SLUI" },
+    { Opcode::OP_SR,            "SR" },
+    { Opcode::OP_SRI,           "SRI" },
+    { Opcode::OP_SRU,           "SRU" },
+    { Opcode::OP_SRUI,          "SRUI" },
+    { Opcode::OP_BN,            "BN" },
+    { Opcode::OP_BNB,           "BNB" },
+    { Opcode::OP_BZ,            "BZ" },
+    { Opcode::OP_BZB,           "BZB" },
+    { Opcode::OP_BP,            "BP" },
+    { Opcode::OP_BPB,           "BPB" },
+    { Opcode::OP_BOD,           "BOD" },
+    { Opcode::OP_BODB,          "BODB" },
+    { Opcode::OP_BNN,           "BNN" },
+    { Opcode::OP_BNNB,          "BNNB" },
+    { Opcode::OP_BNZ,           "BNZ" },
+    { Opcode::OP_BNZB,          "BNZB" },
+    { Opcode::OP_BNP,           "BNP" },
+    { Opcode::OP_BNPB,          "BNPB" },
+    { Opcode::OP_BEV,           "BEV" },
+    { Opcode::OP_BEVB,          "BEVB" },
+    { Opcode::OP_PBN,           "PBN" },
+    { Opcode::OP_PBNB,          "PBNB" },
+    { Opcode::OP_PBZ,           "PBZ" },
+    { Opcode::OP_PBZB,          "PBZB" },
+    { Opcode::OP_PBP,           "PBP" },
+    { Opcode::OP_PBPB,          "PBPB" },
+    { Opcode::OP_PBOD,          "PBOD" },
+    { Opcode::OP_PBODB,         "PBODB" },
+    { Opcode::OP_PBNN,          "PBNN" },
+    { Opcode::OP_PBNNB,         "PBNNB" },
+    { Opcode::OP_PBNZ,          "PBNZ" },
+    { Opcode::OP_PBNZB,         "PBNZB" },
+    { Opcode::OP_PBNP,          "PBNP" },
+    { Opcode::OP_PBNPB,         "PBNPB" },
+    { Opcode::OP_PBEV,          "PBEV" },
+    { Opcode::OP_PBEVB,         "PBEVB" },
+    { Opcode::OP_CSN,           "CSN" },
+    { Opcode::OP_CSNI,          "CSNI" },
+    { Opcode::OP_CSZ,           "CSZ" },
+    { Opcode::OP_CSZI,          "CSZI" },
+    { Opcode::OP_CSP,           "CSP" },
+    { Opcode::OP_CSPI,          "CSPI" },
+    { Opcode::OP_CSOD,          "CSOD" },
+    { Opcode::OP_CSODI,         "CSODI" },
+    { Opcode::OP_CSNN,          "CSNN" },
+    { Opcode::OP_CSNNI,         "CSNNI" },
+    { Opcode::OP_CSNZ,          "CSNZ" },
+    { Opcode::OP_CSNZI,         "CSNZI" },
+    { Opcode::OP_CSNP,          "CSNP" },
+    { Opcode::OP_CSNPI,         "CSNPI" },
+    { Opcode::OP_CSEV,          "CSEV" },
+    { Opcode::OP_CSEVI,         "CSEVI" },
+    { Opcode::OP_ZSN,           "ZSN" },
+    { Opcode::OP_ZSNI,          "ZSNI" },
+    { Opcode::OP_ZSZ,           "ZSZ" },
+    { Opcode::OP_ZSZI,          "ZSZI" },
+    { Opcode::OP_ZSP,           "ZSP" },
+    { Opcode::OP_ZSPI,          "ZSPI" },
+    { Opcode::OP_ZSOD,          "ZSOD" },
+    { Opcode::OP_ZSODI,         "ZSODI" },
+    { Opcode::OP_ZSNN,          "ZSNN" },
+    { Opcode::OP_ZSNNI,         "ZSNNI" },
+    { Opcode::OP_ZSNZ,          "ZSNZ" },
+    { Opcode::OP_ZSNZI,         "ZSNZI" },
+    { Opcode::OP_ZSNP,          "ZSNP" },
+    { Opcode::OP_ZSNPI,         "ZSNPI" },
+    { Opcode::OP_ZSEV,          "ZSEV" },
+    { Opcode::OP_ZSEVI,         "ZSEVI" },
+    { Opcode::OP_LDB,           "LDB" },
+    { Opcode::OP_LDBI,          "LDBI" },
+    { Opcode::OP_LDBU,          "LDBU" },
+    { Opcode::OP_LDBUI,         "LDBUI" },
+    { Opcode::OP_LDW,           "LDW" },
+    { Opcode::OP_LDWI,          "LDWI" },
+    { Opcode::OP_LDWU,          "LDWU" },
+    { Opcode::OP_LDWUI,         "LDWUI" },
+    { Opcode::OP_LDT,           "LDT" },
+    { Opcode::OP_LDTI,          "LDTI" },
+    { Opcode::OP_LDTU,          "LDTU" },
+    { Opcode::OP_LDTUI,         "LDTUI" },
+    { Opcode::OP_LDO,           "LDO" },
+    { Opcode::OP_LDOI,          "LDOI" },
+    { Opcode::OP_LDOU,          "LDOU" },
+    { Opcode::OP_LDOUI,         "LDOUI" },
+    { Opcode::OP_LDSF,          "LDSF" },
+    { Opcode::OP_LDSFI,         "LDSFI" },
+    { Opcode::OP_LDHT,          "LDHT" },
+    { Opcode::OP_LDHTI,         "LDHTI" },
+    { Opcode::OP_CSWAP,         "CSWAP" },
+    { Opcode::OP_CSWAPI,        "CSWAPI" },
+    { Opcode::OP_LDUNC,         "LDUNC" },
+    { Opcode::OP_LDUNCI,        "LDUNCI" },
+    { Opcode::OP_RESERVED_x98,  "RESERVED" },
+    { Opcode::OP_RESERVED_x99,  "RESERVED" },
+    { Opcode::OP_RESERVED_x9A,  "RESERVED" },
+    { Opcode::OP_RESERVED_x9B,  "RESERVED" },
+    { Opcode::OP_RESERVED_x9C,  "RESERVED" },
+    { Opcode::OP_RESERVED_x9D,  "RESERVED" },
+    { Opcode::OP_GO,            "GO" },
+    { Opcode::OP_GOI,           "GOI" },
+    { Opcode::OP_STB,           "STB" },
+    { Opcode::OP_STBI,          "STBI" },
+    { Opcode::OP_STBU,          "STBU" },
+    { Opcode::OP_STBUI,         "STBUI" },
+    { Opcode::OP_STW,           "STW" },
+    { Opcode::OP_STWI,          "STWI" },
+    { Opcode::OP_STWU,          "STWU" },
+    { Opcode::OP_STWUI,         "STWUI" },
+    { Opcode::OP_STT,           "STT" },
+    { Opcode::OP_STTI,          "STTI" },
+    { Opcode::OP_STTU,          "STTU" },
+    { Opcode::OP_STTUI,         "STTUI" },
+    { Opcode::OP_STO,           "STO" },
+    { Opcode::OP_STOI,          "STOI" },
+    { Opcode::OP_STOU,          "STOU" },
+    { Opcode::OP_STOUI,         "STOUI" },
+    { Opcode::OP_STSF,          "STSF" },
+    { Opcode::OP_STSFI,         "STSFI" },
+    { Opcode::OP_STHT,          "STHT" },
+    { Opcode::OP_STHTI,         "STHTI" },
+    { Opcode::OP_STCO,          "STCO" },
+    { Opcode::OP_STCOI,         "STCOI" },
+    { Opcode::OP_STUNC,         "STUNC" },
+    { Opcode::OP_STUNCI,        "STUNCI" },
+    { Opcode::OP_RESERVED_xB8,  "RESERVED" },
+    { Opcode::OP_RESERVED_xB9,  "RESERVED" },
+    { Opcode::OP_RESERVED_xBA,  "RESERVED" },
+    { Opcode::OP_RESERVED_xBB,  "RESERVED" },
+    { Opcode::OP_RESERVED_xBC,  "RESERVED" },
+    { Opcode::OP_RESERVED_xBD,  "RESERVED" },
+    { Opcode::OP_PUSHGO,        "PUSHGO" },
+    { Opcode::OP_PUSHGOI,       "PUSHGOI" },
+    { Opcode::OP_OR,            "OR" },
+    { Opcode::OP_ORI,           "ORI" },
+    { Opcode::OP_ORN,           "ORN" },
+    { Opcode::OP_ORNI,          "ORNI" },
+    { Opcode::OP_NOR,           "NOR" },
+    { Opcode::OP_NORI,          "NORI" },
+    { Opcode::OP_XOR,           "XOR" },
+    { Opcode::OP_XORI,          "XORI" },
+    { Opcode::OP_AND,           "AND" },
+    { Opcode::OP_ANDI,          "ANDI" },
+    { Opcode::OP_ANDN,          "ANDN" },
+    { Opcode::OP_ANDNI,         "ANDNI" },
+    { Opcode::OP_NAND,          "NAND" },
+    { Opcode::OP_NANDI,         "NANDI" },
+    { Opcode::OP_NXOR,          "NXOR" },
+    { Opcode::OP_NXORI,         "NXORI" },
+    { Opcode::OP_RESERVED_xD0,  "RESERVED" },
+    { Opcode::OP_RESERVED_xD1,  "RESERVED" },
+    { Opcode::OP_RESERVED_xD2,  "RESERVED" },
+    { Opcode::OP_RESERVED_xD3,  "RESERVED" },
+    { Opcode::OP_RESERVED_xD4,  "RESERVED" },
+    { Opcode::OP_RESERVED_xD5,  "RESERVED" },
+    { Opcode::OP_RESERVED_xD6,  "RESERVED" },
+    { Opcode::OP_RESERVED_xD7,  "RESERVED" },
+    { Opcode::OP_MUX,           "MUX" },
+    { Opcode::OP_MUXI,          "MUXI" },
+    { Opcode::OP_RESERVED_xDA,  "RESERVED" },
+    { Opcode::OP_RESERVED_xDB,  "RESERVED" },
+    { Opcode::OP_RESERVED_xDC,  "RESERVED" },
+    { Opcode::OP_RESERVED_xDD,  "RESERVED" },
+    { Opcode::OP_RESERVED_xDE,  "RESERVED" },
+    { Opcode::OP_RESERVED_xDF,  "RESERVED" },
+    { Opcode::OP_SETH,          "SETH" },
+    { Opcode::OP_SETMH,         "SETMH" },
+    { Opcode::OP_SETML,         "SETML" },
+    { Opcode::OP_SETL,          "SETL" },
+    { Opcode::OP_INCH,          "INCH" },
+    { Opcode::OP_INCMH,         "INCMH" },
+    { Opcode::OP_INCML,         "INCML" },
+    { Opcode::OP_INCL,          "INCL" },
+    { Opcode::OP_ORH,           "ORH" },
+    { Opcode::OP_ORMH,          "ORMH" },
+    { Opcode::OP_ORML,          "ORML" },
+    { Opcode::OP_ORL,           "ORL" },
+    { Opcode::OP_ANDNH,         "ANDNH" },
+    { Opcode::OP_ANDNMH,        "ANDNMH" },
+    { Opcode::OP_ANDNML,        "ANDNML" },
+    { Opcode::OP_ANDNL,         "ANDNL" },
+    { Opcode::OP_JMP,           "JMP" },
+    { Opcode::OP_JMPB,          "JMPB" },
+    { Opcode::OP_PUSHJ,         "PUSHJ" },
+    { Opcode::OP_PUSHJB,        "PUSHJB" },
+    { Opcode::OP_GETA,          "GETA" },
+    { Opcode::OP_GETAB,         "GETAB" },
+    { Opcode::OP_PUT,           "PUT" },
+    { Opcode::OP_PUTI,          "PUTI" },
+    { Opcode::OP_POP,           "POP" },
+    { Opcode::OP_RESUME,        "RESUME" },
+    { Opcode::OP_SAVE,          "SAVE" },
+    { Opcode::OP_UNSAVE,        "UNSAVE" },
+    { Opcode::OP_SYNC,          "SYNC" },
+    { Opcode::OP_SWYM,          "SWYM" },
+    { Opcode::OP_GET,           "GET" },
+    { Opcode::OP_RESERVED_xFF,  "RESERVED" }
+};
+
+/**
+ * Get the flyweight handler for the given opcode.
+ *
+ * \param op        The opcode to look up.
+ *
+ * \returns the static handler for this opcode.
+ */
+const InstructionHandler& simex::instructionHandler(Opcode op)
+{
+    return handlerTable[opcode2byte(op)];
+}
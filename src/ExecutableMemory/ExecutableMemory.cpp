@@ -0,0 +1,28 @@
+/**
+ * \file ExecutableMemory/ExecutableMemory.cpp
+ *
+ * Constructor for ExecutableMemory.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/ExecutableMemory.h>
+
+using namespace simex;
+using namespace std;
+
+//storage for static constants.
+const size_t ExecutableMemory::CHUNK_SIZE;
+const size_t ExecutableMemory::CODE_ALIGNMENT;
+
+/**
+ * Create an empty code store.
+ */
+ExecutableMemory::ExecutableMemory()
+    : next_(0), used_(0)
+{
+}
@@ -0,0 +1,88 @@
+/**
+ * \file ExecutableMemory/add.cpp
+ *
+ * Copy machine code into executable memory.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <cstring>
+#include <simex/ExecutableMemory.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Copy machine code into executable memory.  In a chunk which is mapped
+ * twice, the code is written through the writable view just past the code
+ * added before it, and is executable as soon as it is written.  Otherwise it
+ * starts on a fresh page of the last chunk, so that the pages made executable
+ * here were never executable before.  A new chunk is reserved when the code
+ * doesn't fit.
+ *
+ * \param code      The machine code to copy.
+ * \param size      The size of the code, in bytes.
+ *
+ * \returns the executable copy, or nullptr if the host would not map
+ * executable memory.
+ */
+const void* ExecutableMemory::add(const void* code, size_t size)
+{
+    static const size_t pageSize = sysconf(_SC_PAGESIZE);
+
+    if (0 == size)
+        return nullptr;
+
+    size_t offset = 0;
+    size_t used = 0;
+    if (!chunks_.empty())
+    {
+        size_t align =
+            nullptr != chunks_.back().writable ? CODE_ALIGNMENT : pageSize;
+
+        offset = (next_ + align - 1) & ~(align - 1);
+        used = next_;
+    }
+
+    if (chunks_.empty() || offset + size > chunks_.back().size)
+    {
+        if (!reserve(size))
+            return nullptr;
+
+        offset = 0;
+        used = 0;
+    }
+
+    Chunk& chunk = chunks_.back();
+    uint8_t* out = chunk.code + offset;
+    size_t end = offset + size;
+
+    if (nullptr != chunk.writable)
+    {
+        memcpy(chunk.writable + offset, code, size);
+        __builtin___clear_cache(
+            reinterpret_cast<char*>(out), reinterpret_cast<char*>(out + size));
+    }
+    else
+    {
+        end = (end + pageSize - 1) & ~(pageSize - 1);
+
+        memcpy(out, code, size);
+        if (mprotect(out, end - offset, PROT_READ | PROT_EXEC))
+            return nullptr;
+    }
+
+    //count each host page once, when the first code is put on it.
+    used_ +=
+        ((end + pageSize - 1) & ~(pageSize - 1))
+      - ((used + pageSize - 1) & ~(pageSize - 1));
+    next_ = end;
+
+    return out;
+}
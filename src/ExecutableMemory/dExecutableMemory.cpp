@@ -0,0 +1,31 @@
+/**
+ * \file ExecutableMemory/dExecutableMemory.cpp
+ *
+ * Implementation of the ExecutableMemory destructor.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/ExecutableMemory.h>
+#include <sys/mman.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Destructor.  Every piece of code added is released, so none of it may still
+ * be running.
+ */
+ExecutableMemory::~ExecutableMemory()
+{
+    for (const Chunk& chunk : chunks_)
+    {
+        munmap(chunk.code, chunk.size);
+        if (nullptr != chunk.writable)
+            munmap(chunk.writable, chunk.size);
+    }
+}
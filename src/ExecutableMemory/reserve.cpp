@@ -0,0 +1,87 @@
+/**
+ * \file ExecutableMemory/reserve.cpp
+ *
+ * Reserve a chunk of host memory for code.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <algorithm>
+#include <simex/ExecutableMemory.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Reserve a chunk of at least the given size from the host.  The chunk is
+ * mapped from an anonymous file twice, executable and writable, so that code
+ * can be packed into it without changing the protection of pages which may
+ * already be running.  If the host refuses either mapping, the chunk is
+ * mapped once, writable, and each piece of code is made executable on pages
+ * of its own.
+ *
+ * \param size      The smallest size of the chunk, in bytes.
+ *
+ * \returns false if the host would not map the memory.
+ */
+bool ExecutableMemory::reserve(size_t size)
+{
+    static const size_t pageSize = sysconf(_SC_PAGESIZE);
+    size_t length = (max(size, CHUNK_SIZE) + pageSize - 1) & ~(pageSize - 1);
+    Chunk chunk = { nullptr, nullptr, length };
+
+    int fd = memfd_create("simex-code", MFD_CLOEXEC);
+    if (fd >= 0)
+    {
+        void* code = MAP_FAILED;
+        void* writable = MAP_FAILED;
+
+        if (0 == ftruncate(fd, length))
+        {
+            code =
+                mmap(nullptr, length, PROT_READ | PROT_EXEC, MAP_SHARED,
+                     fd, 0);
+            writable =
+                mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED,
+                     fd, 0);
+        }
+
+        close(fd);
+
+        if (MAP_FAILED != code && MAP_FAILED != writable)
+        {
+            chunk.code = static_cast<uint8_t*>(code);
+            chunk.writable = static_cast<uint8_t*>(writable);
+        }
+        else
+        {
+            if (MAP_FAILED != code)
+                munmap(code, length);
+            if (MAP_FAILED != writable)
+                munmap(writable, length);
+        }
+    }
+
+    if (nullptr == chunk.code)
+    {
+        void* code =
+            mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+        if (MAP_FAILED == code)
+            return false;
+
+        chunk.code = static_cast<uint8_t*>(code);
+    }
+
+    chunks_.push_back(chunk);
+    next_ = 0;
+
+    return true;
+}
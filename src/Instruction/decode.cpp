@@ -18,13 +18,15 @@ using namespace std;
 namespace {
 
     /**
-     * Internal concrete implementation of Instruction that can be used for
-     * invalid instructions.
+     * Internal concrete implementation of Instruction, which wraps a decoded
+     * instruction value.  Evaluation goes through the DecodedInstruction to
+     * the machine state, which faults for invalid opcodes.
      */
-    class InvalidInstruction : public Instruction
+    class DecodedInstructionWrapper : public Instruction
     {
     public:
-        InvalidInstruction(Opcode op, uint8_t x, uint8_t y, uint8_t z)
+        DecodedInstructionWrapper(
+            Opcode op, uint8_t x, uint8_t y, uint8_t z)
             : Instruction(op, x, y, z)
         {
         }
@@ -44,5 +46,19 @@ namespace {
 shared_ptr<Instruction>
 Instruction::decode(Opcode op, std::uint8_t x, std::uint8_t y, std::uint8_t z)
 {
-    return make_shared<InvalidInstruction>(op, x, y, z);
+    return decode(DecodedInstruction::decode(op, x, y, z));
+}
+
+/**
+ * Wrap an already decoded instruction value in an Instruction.
+ *
+ * \param ins   The decoded instruction value.
+ *
+ * \returns the wrapped instruction, which can be emitted or evaluated.
+ */
+shared_ptr<Instruction> Instruction::decode(DecodedInstruction ins)
+{
+    return
+        make_shared<DecodedInstructionWrapper>(
+            ins.opcode(), ins.x(), ins.y(), ins.z());
 }
@@ -1,7 +1,7 @@
 /**
  * \file Instruction/emit.cpp
  *
- * Instruction::emit() implementation.
+ * Instruction::emit() implementations.
  *
  * Copyright (C) 2016 Justin Handville - All Rights Reserved.
  *
@@ -11,20 +11,36 @@
  */
 
 #include <ostream>
+#include <simex/CodeBuffer.h>
 #include <simex/Instruction.h>
 
 using namespace simex;
 using namespace std;
 
 /**
- * The emit method writes an Instruction to the given binary ostream.
+ * The emit method writes an Instruction to the given binary ostream.  The
+ * instruction is assembled in a small code buffer and written with a single
+ * call.
  *
  * \param out       The ostream to which this instruction is emitted.
  */
 void Instruction::emit(std::ostream& out) const
 {
-    out.put(static_cast<char>(opcode()));
-    out.put(static_cast<char>(x()));
-    out.put(static_cast<char>(y()));
-    out.put(static_cast<char>(z()));
+    uint8_t bytes[4];
+    CodeBuffer buffer(bytes, sizeof(bytes));
+
+    emit(buffer);
+    buffer.write(out);
+}
+
+/**
+ * The emit method appends an Instruction to the given code buffer.
+ *
+ * \param out       The code buffer to which this instruction is emitted.
+ *
+ * \returns true if the instruction was appended.
+ */
+bool Instruction::emit(CodeBuffer& out) const
+{
+    return out.emit(decoded());
 }
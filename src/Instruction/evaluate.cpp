@@ -16,8 +16,8 @@ using namespace simex;
 using namespace std;
 
 /**
- * By default, the evaluate method places the machine into an invalid opcode
- * exception state.  This behavior can be overridden by derived types.
+ * By default, the evaluate method evaluates this instruction through the
+ * machine state.  This behavior can be overridden by derived types.
  *
  * \param state     The current machine state.
  *
@@ -26,5 +26,5 @@ using namespace std;
  */
 void Instruction::evaluate(MachineState* state) const
 {
-    //TODO - implement
+    decoded().evaluate(state);
 }
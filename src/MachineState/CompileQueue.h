@@ -0,0 +1,225 @@
+/**
+ * \file MachineState/CompileQueue.h
+ *
+ * The background compiler, which translates blocks that got hot in the
+ * interpreter.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#ifndef  SIMEX_MACHINE_STATE_COMPILE_QUEUE_HEADER_GUARD
+# define SIMEX_MACHINE_STATE_COMPILE_QUEUE_HEADER_GUARD
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "MachineStateImplementation.h"
+#include "PredecodedInstruction.h"
+
+//this header is C++ specific
+#ifdef __cplusplus
+
+namespace simex {
+
+/**
+ * The most instructions scanned for the blocks of a hot function, from its
+ * first instruction up to its first POP.
+ */
+const std::size_t MAX_FUNCTION_INSTRUCTIONS = 1024;
+
+/**
+ * A block queued for the background compiler, and the code translated for
+ * it.
+ */
+struct CompileJob
+{
+    //the block to patch, and the address of its first instruction.
+    PredecodedInstruction* block;
+    std::uint64_t pc;
+    //the value of rG when the block was queued.
+    std::uint64_t rG;
+    //true if memory holds octas in the native byte order.
+    bool native;
+    //the ordinary records of the block.
+    std::vector<PredecodedInstruction> records;
+    //the record which runs the code, and the code itself, which is empty if
+    //the block could not be translated.
+    PredecodedInstruction compiled;
+    std::vector<std::uint8_t> code;
+};
+
+/**
+ * The CompileQueue runs the JIT on a background thread for the blocks which
+ * got hot in the interpreter.  The interpreter queues a copy of the records
+ * of each block, and later takes the translated code back and patches it in
+ * itself, so the compiler thread never touches the block caches or the
+ * machine state.
+ */
+class CompileQueue
+{
+public:
+
+    /**
+     * Start the compiler thread for the given machine state.
+     */
+    explicit CompileQueue(MachineStateImplementation* m)
+        : ready(false), m_(m), busy_(false), stopping_(false),
+          thread_(&CompileQueue::run, this)
+    {
+    }
+
+    /**
+     * Stop the compiler thread.  Blocks still queued are dropped.
+     */
+    ~CompileQueue()
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            stopping_ = true;
+        }
+
+        changed_.notify_all();
+        thread_.join();
+    }
+
+    CompileQueue(const CompileQueue&) = delete;
+    CompileQueue& operator=(const CompileQueue&) = delete;
+
+    /**
+     * Queue a block for the compiler thread.
+     */
+    void push(CompileJob&& job)
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            pending_.push_back(std::move(job));
+        }
+
+        changed_.notify_all();
+    }
+
+    /**
+     * Wait until every block queued so far has been translated.
+     */
+    void wait()
+    {
+        std::unique_lock<std::mutex> guard(lock_);
+
+        changed_.wait(guard, [this] { return pending_.empty() && !busy_; });
+    }
+
+    /**
+     * Take the blocks which have been translated since the last call.
+     */
+    std::vector<CompileJob> take()
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        std::vector<CompileJob> jobs;
+
+        jobs.swap(done_);
+        ready.store(false, std::memory_order_relaxed);
+
+        return jobs;
+    }
+
+    //true when translated blocks are waiting to be taken.  The interpreter
+    //checks this without taking the lock.
+    std::atomic<bool> ready;
+
+private:
+
+    /**
+     * Translate queued blocks until stopped.
+     */
+    void run()
+    {
+        std::unique_lock<std::mutex> guard(lock_);
+
+        for (;;)
+        {
+            changed_.wait(
+                guard, [this] { return stopping_ || !pending_.empty(); });
+            if (stopping_)
+                return;
+
+            CompileJob job = std::move(pending_.front());
+            pending_.pop_front();
+            busy_ = true;
+            guard.unlock();
+
+            if (!translateBlock(
+                    m_, job.pc, job.rG, job.native, job.records.data(),
+                    job.records.size(), &job.code, &job.compiled))
+            {
+                job.code.clear();
+            }
+
+            guard.lock();
+            done_.push_back(std::move(job));
+            busy_ = false;
+            ready.store(true, std::memory_order_relaxed);
+            changed_.notify_all();
+        }
+    }
+
+    //only used for the displacements of its fields.
+    MachineStateImplementation* m_;
+    std::mutex lock_;
+    std::condition_variable changed_;
+    std::deque<CompileJob> pending_;
+    std::vector<CompileJob> done_;
+    //true while the compiler thread translates a block outside of the lock.
+    bool busy_;
+    bool stopping_;
+    //started last, once everything it uses is constructed.
+    std::thread thread_;
+};
+
+/**
+ * Queue the block starting at an address for the background compiler, if it
+ * is still counting its entries.  From then on, its profile record waits for
+ * the code.
+ *
+ * \param m         The machine state.
+ * \param code      The cache of the segment holding the block.
+ * \param pc        The address of the first instruction of the block.
+ */
+void queueBlock(
+    MachineStateImplementation* m, PredecodedSegment* code, std::uint64_t pc);
+
+/**
+ * Queue the blocks of the function starting at an address for the
+ * background compiler: each block which was predecoded, from the first
+ * instruction of the function up to its first POP.
+ *
+ * \param m         The machine state.
+ * \param code      The cache of the segment holding the function.
+ * \param pc        The address of the first instruction of the function.
+ */
+void queueFunction(
+    MachineStateImplementation* m, PredecodedSegment* code, std::uint64_t pc);
+
+/**
+ * Patch the code which the background compiler translated into the blocks
+ * it was queued for.  A block which could not be translated runs its
+ * ordinary records from then on.
+ *
+ * \param m         The machine state.
+ */
+void installCompiled(MachineStateImplementation* m);
+
+/* namespace simex */ }
+
+//end of C++ code
+#endif //__cplusplus
+
+#endif //SIMEX_MACHINE_STATE_COMPILE_QUEUE_HEADER_GUARD
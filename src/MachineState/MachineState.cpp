@@ -0,0 +1,100 @@
+/**
+ * \file MachineState/MachineState.cpp
+ *
+ * Constructor for MachineState.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/MachineState.h>
+#include <simex/Syscall.h>
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * SC_EXIT: halt the machine with $0 as the exit code.
+ */
+static uint8_t syscallExit(MachineState* state)
+{
+    state->halt(state->reg(0));
+
+    return 0;
+}
+
+/**
+ * SC_SEGMENT_ALLOCATE: allocate a segment of $0 bytes with the policy in $1,
+ * returning its base address, or 0 on failure.
+ */
+static uint8_t syscallSegmentAllocate(MachineState* state)
+{
+    uint64_t size = state->reg(0);
+    uint64_t policy = state->reg(1);
+    uint64_t base = 0;
+
+    if (!(policy & ~static_cast<uint64_t>(SEGMENT_POLICY_MASK)))
+        base = state->addressSpace().allocate(
+            size, (uint8_t)policy, state->slabCache());
+
+    state->setReg(0, base);
+
+    return 1;
+}
+
+/**
+ * SC_SEGMENT_FREE: free the segment at base address $0, returning a status.
+ */
+static uint8_t syscallSegmentFree(MachineState* state)
+{
+    SyscallStatus status = SyscallStatus::Success;
+
+    if (!state->addressSpace().free(state->reg(0), state->slabCache()))
+        status = SyscallStatus::InvalidSegment;
+
+    state->setReg(0, status2code(status));
+
+    return 1;
+}
+
+/**
+ * SC_SEGMENT_POLICY: change the policy of the segment at base address $0 to
+ * $1, returning a status.  Any predecoded code for the segment is discarded.
+ */
+static uint8_t syscallSegmentPolicy(MachineState* state)
+{
+    uint64_t base = state->reg(0);
+    uint64_t policy = state->reg(1);
+    SyscallStatus status = SyscallStatus::Success;
+
+    if (policy & ~static_cast<uint64_t>(SEGMENT_POLICY_MASK))
+        status = SyscallStatus::InvalidPolicy;
+    else if (!state->addressSpace().changePolicy(base, (uint8_t)policy))
+        status = SyscallStatus::InvalidSegment;
+
+    state->setReg(0, status2code(status));
+
+    return 1;
+}
+
+/**
+ * Create a machine state that executes from the given address space.
+ *
+ * \param space     The address space shared by this machine state.
+ */
+MachineState::MachineState(shared_ptr<AddressSpace> space)
+    : impl_(new MachineStateImplementation(this, space))
+{
+    registerSyscall(syscall2index(Syscall::SC_EXIT), &syscallExit);
+    registerSyscall(
+        syscall2index(Syscall::SC_SEGMENT_ALLOCATE), &syscallSegmentAllocate);
+    registerSyscall(
+        syscall2index(Syscall::SC_SEGMENT_FREE), &syscallSegmentFree);
+    registerSyscall(
+        syscall2index(Syscall::SC_SEGMENT_POLICY), &syscallSegmentPolicy);
+}
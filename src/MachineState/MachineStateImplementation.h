@@ -0,0 +1,1049 @@
+/**
+ * \file MachineState/MachineStateImplementation.h
+ *
+ * Private header for MachineState.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#ifndef  SIMEX_MACHINE_STATE_IMPLEMENTATION_HEADER_GUARD
+# define SIMEX_MACHINE_STATE_IMPLEMENTATION_HEADER_GUARD
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <simex/AddressSpace.h>
+#include <simex/MachineState.h>
+#include <simex/OpcodeTraits.h>
+#include <simex/SReg.h>
+#include <unordered_map>
+#include <vector>
+
+//this header is C++ specific
+#ifdef __cplusplus
+
+#if defined(__GNUC__)
+# define SIMEX_LIKELY(x)    __builtin_expect(!!(x), 1)
+# define SIMEX_UNLIKELY(x)  __builtin_expect(!!(x), 0)
+# define SIMEX_COLD         __attribute__((cold, noinline))
+#else
+# define SIMEX_LIKELY(x)    (x)
+# define SIMEX_UNLIKELY(x)  (x)
+# define SIMEX_COLD
+#endif
+
+/*
+ * The vector byte swaps are built with per-function target attributes, so
+ * the library as a whole does not require SSSE3 or AVX2.  They are only
+ * available when building for x86 with GCC or Clang.
+ */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+# define SIMEX_SWAP_OCTAS_X86
+#endif
+
+/*
+ * Uncached stores use the non-temporal store of SSE2, which every x86-64
+ * host has.  Elsewhere they are ordinary stores.
+ */
+#if defined(__GNUC__) && defined(__x86_64__)
+# define SIMEX_UNCACHED_X86
+# include <emmintrin.h>
+#endif
+
+/*
+ * The baseline JIT emits x86-64 code for the System V calling convention.
+ * Elsewhere, every block is interpreted, whatever the JIT setting.
+ */
+#if defined(__GNUC__) && defined(__x86_64__) && !defined(_WIN32)
+# define SIMEX_JIT_X86_64
+#endif
+
+namespace simex {
+
+/**
+ * Number of special registers defined by the specification.
+ */
+const int SPECIAL_REGISTER_COUNT = 32;
+
+/**
+ * Slots of the special register file.  The registers used by every call,
+ * return, and multiply come first, so that they share a cache line with the
+ * program counter.  The fault registers, which are rarely touched, come last.
+ * Reserved registers read from a slot which is always zero, and write to a
+ * slot which is never read, so that GET and PUT need no test for them.
+ */
+enum SRegSlot : std::uint8_t
+{
+    SLOT_RJ,
+    SLOT_RL,
+    SLOT_RO,
+    SLOT_RG,
+    SLOT_RH,
+    SLOT_RS,
+    SLOT_RJJ,
+    SLOT_RD,
+    SLOT_RE,
+    SLOT_RM,
+    SLOT_RR,
+    SLOT_RP,
+    SLOT_RFF,
+    SLOT_RF,
+    SLOT_ROP,
+    SLOT_RXX,
+    SLOT_RYY,
+    SLOT_RZZ,
+    SLOT_RCC,
+    SLOT_ZERO,
+    SLOT_SINK,
+
+    //the number of slots in the special register file.
+    SREG_SLOT_COUNT
+};
+
+/**
+ * Get the slot of a special register for reading.  Reserved registers and
+ * indices past the last special register map to SLOT_ZERO.
+ *
+ * \param r         The special register index.
+ */
+constexpr SRegSlot sregReadSlot(int r)
+{
+    switch (static_cast<SReg>(r))
+    {
+        case SReg::SR_RD:   return SLOT_RD;
+        case SReg::SR_RE:   return SLOT_RE;
+        case SReg::SR_RH:   return SLOT_RH;
+        case SReg::SR_RJ:   return SLOT_RJ;
+        case SReg::SR_RJJ:  return SLOT_RJJ;
+        case SReg::SR_RM:   return SLOT_RM;
+        case SReg::SR_RR:   return SLOT_RR;
+        case SReg::SR_RP:   return SLOT_RP;
+        case SReg::SR_RO:   return SLOT_RO;
+        case SReg::SR_RS:   return SLOT_RS;
+        case SReg::SR_RG:   return SLOT_RG;
+        case SReg::SR_RL:   return SLOT_RL;
+        case SReg::SR_RFF:  return SLOT_RFF;
+        case SReg::SR_RF:   return SLOT_RF;
+        case SReg::SR_ROP:  return SLOT_ROP;
+        case SReg::SR_RXX:  return SLOT_RXX;
+        case SReg::SR_RYY:  return SLOT_RYY;
+        case SReg::SR_RZZ:  return SLOT_RZZ;
+        case SReg::SR_RCC:  return SLOT_RCC;
+        default:            return SLOT_ZERO;
+    }
+}
+
+/**
+ * Get the slot of a special register for writing.  Reserved registers and
+ * indices past the last special register map to SLOT_SINK.
+ *
+ * \param r         The special register index.
+ */
+constexpr SRegSlot sregWriteSlot(int r)
+{
+    return SLOT_ZERO == sregReadSlot(r) ? SLOT_SINK : sregReadSlot(r);
+}
+
+/**
+ * Number of general purpose registers visible at any time.
+ */
+const int REGISTER_COUNT = 256;
+
+/**
+ * Number of octas in the local register ring.  This is a power of two which
+ * holds several full frames of locals, so that calls and returns rarely need
+ * to spill or fill.
+ */
+const std::uint64_t RING_SIZE = 512;
+
+/**
+ * Mask which maps a register-stack offset to its slot in the ring.
+ */
+const std::uint64_t RING_MASK = RING_SIZE - 1;
+
+/**
+ * Alignment of the machine state, so that the ring starts on a cache line.
+ */
+const std::size_t CACHE_LINE_SIZE = 64;
+
+/**
+ * Largest number of registers which are zeroed immediately when they are
+ * dropped into the hole.  This is a few cache lines of octas, which costs
+ * less to zero than a later pass over the written flags.  Larger drops are
+ * zeroed lazily.
+ */
+const std::uint64_t SMALL_DROP = 4 * CACHE_LINE_SIZE / sizeof(std::uint64_t);
+
+/**
+ * Number of octas of address space reserved for the rS region of each
+ * machine.  Only the pages which spills reach are committed, so this costs
+ * address space but not memory.
+ */
+const std::uint64_t STACK_RESERVE = std::uint64_t(1) << 27;
+
+/**
+ * Number of octas in the rS region past the stack limit, which are left for
+ * the stack overflow fault handler.
+ */
+const std::uint64_t STACK_SLACK = std::uint64_t(1) << 16;
+
+/**
+ * Number of entries in the software TLB of each machine.  This is a power of
+ * two, so that a guest page maps to its entry with a mask.
+ */
+const std::uint64_t TLB_SIZE = 256;
+
+/**
+ * Mask which maps a guest page number to its entry in the software TLB.
+ */
+const std::uint64_t TLB_MASK = TLB_SIZE - 1;
+
+/**
+ * Mask of the offset of a guest address within its page.
+ */
+const std::uint64_t PAGE_OFFSET_MASK = AddressSpace::PAGE_SIZE - 1;
+
+/**
+ * Tag of a TLB entry which matches no access.  Tags of valid entries have
+ * the page offset bits clear, and the compared address keeps at most its low
+ * alignment bits, so this never matches.
+ */
+const std::uint64_t TLB_INVALID = ~std::uint64_t(0);
+
+/**
+ * An entry in the software TLB, which caches the translation of one guest
+ * page.  The policy of the page is folded into a tag for each kind of access,
+ * which is the page address if the access is allowed, or TLB_INVALID.
+ */
+struct TlbEntry
+{
+    //the tag matched by loads.
+    std::uint64_t read;
+    //the tag matched by stores.
+    std::uint64_t write;
+    //added to a guest address in this page to get its host address.
+    std::uintptr_t addend;
+};
+
+/**
+ * Reserve address space for an rS region, without committing any of it.
+ *
+ * \returns the start of the region.
+ */
+std::uint64_t* reserveRegisterStack();
+
+/**
+ * Release the address space of an rS region.
+ *
+ * \param backing   The start of the region.
+ */
+void releaseRegisterStack(std::uint64_t* backing);
+
+/**
+ * Forward declaration for the predecoded block cache of a segment, and its
+ * deleter, which is defined along with it.
+ */
+class PredecodedSegment;
+struct PredecodedSegmentDeleter
+{
+    void operator()(PredecodedSegment* code) const;
+};
+
+/**
+ * Forward declaration for the background compiler, and its deleter, which
+ * is defined along with it.
+ */
+class CompileQueue;
+struct CompileQueueDeleter
+{
+    void operator()(CompileQueue* queue) const;
+};
+
+/**
+ * The default number of entries after which a block is queued for the
+ * background compiler.
+ */
+const std::uint64_t JIT_BLOCK_THRESHOLD = 256;
+
+/**
+ * The default number of calls after which the blocks of a function are
+ * queued for the background compiler.
+ */
+const std::uint64_t JIT_FUNCTION_THRESHOLD = 32;
+
+/**
+ * The call target when no block was just entered by a call.  Blocks start on
+ * a tetra, so this never matches one.
+ */
+const std::uint64_t NO_CALL = ~0ULL;
+
+/**
+ * Private implementation details for MachineState.
+ */
+struct MachineStateImplementation
+{
+    MachineStateImplementation(MachineState* owner_,
+                               std::shared_ptr<AddressSpace> space_)
+        : pc(0), remaining(0), budget(0), arena(space_->guestView()),
+          arenaLimit(0), owner(owner_), space(space_), slabs(*space_),
+          instructions(0), fusedInstructions(0), halted(false),
+          faulted(false), fusion(true), jit(false),
+          blockThreshold(JIT_BLOCK_THRESHOLD),
+          functionThreshold(JIT_FUNCTION_THRESHOLD), callTarget(NO_CALL),
+          exitCode(0),
+          code(nullptr), spilled(0), dirty(0),
+          backing(reserveRegisterStack()),
+          committed(0), stackLimit(STACK_RESERVE - STACK_SLACK),
+          deferredFault(Fault::None), deferredPc(0), deferredBudget(0),
+          labels(nullptr), jitStats()
+    {
+        memset(sregs, 0, sizeof(sregs));
+        memset(globals, 0, sizeof(globals));
+        memset(ring, 0, sizeof(ring));
+        memset(written, 0, sizeof(written));
+        memset(tlb, 0xFF, sizeof(tlb));
+        tlbGeneration = space->generation();
+    }
+
+    ~MachineStateImplementation()
+    {
+        releaseRegisterStack(backing);
+    }
+
+    /**
+     * Allocate on a cache line boundary, which operator new does not promise
+     * for over-aligned types before C++17.
+     */
+    static void* operator new(std::size_t size)
+    {
+        void* p = nullptr;
+
+        if (posix_memalign(&p, CACHE_LINE_SIZE, size))
+            throw std::bad_alloc();
+
+        return p;
+    }
+
+    static void operator delete(void* p)
+    {
+        free(p);
+    }
+
+    //the program counter, the instruction budget, and the hot special
+    //registers share the first cache line.
+    std::uint64_t pc;
+    std::uint64_t remaining;
+    std::uint64_t sregs[SREG_SLOT_COUNT];
+    std::uint64_t budget;
+    //the guest view of the host arena, or nullptr.
+    std::uint8_t* arena;
+    //guest addresses below this are accessed directly through the arena,
+    //which is only done while runProtected() catches host faults.
+    std::uint64_t arenaLimit;
+    MachineState* owner;
+    std::shared_ptr<AddressSpace> space;
+    //the free slab segments of this system thread.
+    SlabCache slabs;
+    std::uint64_t instructions;
+    //instructions run by superinstructions without their own dispatch.
+    std::uint64_t fusedInstructions;
+    bool halted;
+    bool faulted;
+    bool fusion;
+    //true if blocks are translated to host machine code.
+    bool jit;
+    //the entries after which a block, and the calls after which a function,
+    //is queued for the background compiler.  A block threshold of 0
+    //translates each block as it is predecoded, and a function threshold of
+    //0 leaves calls uncounted.
+    std::uint64_t blockThreshold;
+    std::uint64_t functionThreshold;
+    //the target of the last call, so that the block entered by the call
+    //counts it for its function.
+    std::uint64_t callTarget;
+    std::uint64_t exitCode;
+    std::uint64_t globals[REGISTER_COUNT];
+    //the predecoded block cache for the segment of the last block run.
+    PredecodedSegment* code;
+    //the predecoded block cache of each segment this machine has run, by
+    //base address.  These belong to this machine alone, as other machines
+    //sharing the address space may run with other settings.
+    std::unordered_map<
+        std::uint64_t,
+        std::unique_ptr<PredecodedSegment, PredecodedSegmentDeleter>> caches;
+    //the local register ring.  Register-stack offset k, from spilled up to
+    //rO + rL, is held in ring[k & RING_MASK].
+    alignas(CACHE_LINE_SIZE) std::uint64_t ring[RING_SIZE];
+    //offsets below this have been spilled from the ring.
+    std::uint64_t spilled;
+    //nonzero for each ring slot which was written since it was last zeroed.
+    alignas(CACHE_LINE_SIZE) std::uint8_t written[RING_SIZE];
+    //the high-water mark of the hole.  Offsets from rO + rL up to this may
+    //hold stale values left by POP or PUT; the slots of the other offsets
+    //above the frame, up to spilled + RING_SIZE, are zero.
+    std::uint64_t dirty;
+    //the rS region, which holds spilled offsets; entries at or above spilled
+    //are always zero.  This is a fixed range of reserved address space, so it
+    //never moves as it grows.
+    std::uint64_t* backing;
+    //the number of octas at the start of the rS region which are committed.
+    std::uint64_t committed;
+    //spilling past this offset raises a stack overflow fault.
+    std::uint64_t stackLimit;
+    //a fault to raise once the current instruction completes, or None.
+    Fault deferredFault;
+    //the address of the instruction which deferred the fault.
+    std::uint64_t deferredPc;
+    //the instruction budget which was left when the fault was deferred.
+    std::uint64_t deferredBudget;
+    std::unordered_map<std::uint16_t, syscall_method_t> syscalls;
+    //the generation of the address space when the TLB was last flushed.
+    std::uint64_t tlbGeneration;
+    //the software TLB, indexed by guest page number.
+    TlbEntry tlb[TLB_SIZE];
+    //the threaded code address of each dispatch index, once the interpreter
+    //has run with computed goto, or nullptr.
+    const void* const* labels;
+    //the background compiler, started when the first block gets hot.
+    std::unique_ptr<CompileQueue, CompileQueueDeleter> compiler;
+    //counts of the blocks and functions tiered up to the JIT.
+    JitStatistics jitStats;
+};
+
+static_assert(
+    2 + SLOT_RS + 1 <= CACHE_LINE_SIZE / sizeof(std::uint64_t),
+    "the hot special registers share a cache line with the program counter");
+
+/**
+ * Get a reference to a special register.
+ */
+inline std::uint64_t& sr(MachineStateImplementation* m, SReg r)
+{
+    return m->sregs[sregReadSlot(sreg2offset(r))];
+}
+
+/**
+ * Returns true if the given special register index is reserved.
+ */
+constexpr bool isReservedSReg(int r)
+{
+    return SLOT_ZERO == sregReadSlot(r);
+}
+
+/**
+ * Get the first register index which is global.  rG holds the number of
+ * global registers, which start at $255 and grow downward.
+ */
+inline std::uint64_t globalBase(MachineStateImplementation* m)
+{
+    return REGISTER_COUNT - sr(m, SReg::SR_RG);
+}
+
+/**
+ * Spill the oldest registers in the ring to the rS region, until offsets from
+ * spilled up to top fit in the ring.  The freed slots are zeroed.
+ *
+ * \param m         The machine state.
+ * \param top       The offset just past the registers which must fit.
+ */
+SIMEX_COLD void
+spillRegisters(MachineStateImplementation* m, std::uint64_t top);
+
+/**
+ * Commit the pages of the rS region up to the given offset.  Pages are
+ * committed in geometrically growing runs, so that deep recursion commits
+ * in O(1) amortized time.
+ *
+ * \param m         The machine state.
+ * \param end       The offset just past the last one which must be committed.
+ *
+ * \returns false if the offset is past the reserved address space.
+ */
+SIMEX_COLD bool
+commitRegisterStack(MachineStateImplementation* m, std::uint64_t end);
+
+/**
+ * Fill registers from the rS region back into the ring, so that offsets from
+ * bottom up to rO + rL are all held in the ring.
+ *
+ * \param m         The machine state.
+ * \param bottom    The lowest offset which must be in the ring.
+ */
+SIMEX_COLD void
+fillRegisters(MachineStateImplementation* m, std::uint64_t bottom);
+
+/**
+ * Get the ring slot for a register-stack offset.
+ */
+inline std::uint64_t& ringSlot(MachineStateImplementation* m, std::uint64_t k)
+{
+    return m->ring[k & RING_MASK];
+}
+
+/**
+ * Write the ring slot for a register-stack offset, marking it as written.
+ */
+inline void
+writeRing(MachineStateImplementation* m, std::uint64_t k, std::uint64_t value)
+{
+    std::uint64_t slot = k & RING_MASK;
+
+    m->ring[slot] = value;
+    m->written[slot] = 1;
+}
+
+/**
+ * Zero the written ring slots for register-stack offsets from begin up to end,
+ * which are being exposed below the high-water mark of the hole.
+ *
+ * \param m         The machine state.
+ * \param begin     The first offset to zero.
+ * \param end       The offset just past the last one to zero.
+ */
+void zeroStale(
+    MachineStateImplementation* m, std::uint64_t begin, std::uint64_t end);
+
+/**
+ * Drop the local registers at offsets from begin up to end into the hole.  A
+ * few registers are simply zeroed.  Otherwise, this only raises the
+ * high-water mark, so that the cost doesn't depend on how many registers are
+ * dropped; they are zeroed by extendLocals() if they are ever exposed again.
+ */
+inline void dropLocals(
+    MachineStateImplementation* m, std::uint64_t begin, std::uint64_t end)
+{
+    if (end - begin <= SMALL_DROP)
+    {
+        for (std::uint64_t k = begin; k < end; ++k)
+            ringSlot(m, k) = 0;
+    }
+    else if (end > m->dirty)
+    {
+        m->dirty = end;
+    }
+}
+
+/**
+ * Extend rL to cover local register r, which is in the hole.  Registers in
+ * the hole read as 0, so those below the high-water mark which were written
+ * are zeroed as they are exposed.
+ */
+inline void extendLocals(MachineStateImplementation* m, std::uint8_t r)
+{
+    std::uint64_t& rL = sr(m, SReg::SR_RL);
+    std::uint64_t base = sr(m, SReg::SR_RO);
+    std::uint64_t top = base + r + 1;
+
+    if (SIMEX_UNLIKELY(top > m->spilled + RING_SIZE))
+        spillRegisters(m, top);
+
+    if (SIMEX_UNLIKELY(base + rL < m->dirty))
+        zeroStale(m, base + rL, top);
+
+    rL = r + 1;
+}
+
+/**
+ * Read a register without extending rL.  Registers in the hole read as 0.
+ */
+inline std::uint64_t peekReg(MachineStateImplementation* m, std::uint8_t r)
+{
+    if (r >= globalBase(m))
+        return m->globals[r];
+    else if (r >= sr(m, SReg::SR_RL))
+        return 0;
+    else
+        return ringSlot(m, sr(m, SReg::SR_RO) + r);
+}
+
+/**
+ * Read a register.  Reading a register in the hole extends rL to cover it.
+ */
+inline std::uint64_t readReg(MachineStateImplementation* m, std::uint8_t r)
+{
+    if (r >= globalBase(m))
+        return m->globals[r];
+
+    if (r >= sr(m, SReg::SR_RL))
+        extendLocals(m, r);
+
+    return ringSlot(m, sr(m, SReg::SR_RO) + r);
+}
+
+/**
+ * Write a register.  Writing a register in the hole extends rL to cover it.
+ */
+inline void
+writeReg(MachineStateImplementation* m, std::uint8_t r, std::uint64_t value)
+{
+    if (r >= globalBase(m))
+    {
+        m->globals[r] = value;
+        return;
+    }
+
+    if (r >= sr(m, SReg::SR_RL))
+        extendLocals(m, r);
+
+    writeRing(m, sr(m, SReg::SR_RO) + r, value);
+}
+
+/**
+ * Returns true if the Z value of this instruction is an immediate constant
+ * rather than a register.
+ */
+inline bool zIsImmediate(Opcode op)
+{
+    return opcodeTraits(op).zImmediate;
+}
+
+/**
+ * Raise a fault.  The fault state is recorded in the fault registers, and
+ * control is transferred to the fault handler at rFF.  If no fault handler is
+ * installed, the machine halts.
+ *
+ * Faults are rare, so this is kept out of line and away from the handlers;
+ * the only cost on the hot path of an instruction which can fault is the
+ * predictable branch around the call.
+ *
+ * \param m         The machine state.
+ * \param fault     The fault to raise.
+ * \param i         The instruction which faulted.
+ */
+SIMEX_COLD void
+raiseFault(MachineStateImplementation* m, Fault fault, DecodedInstruction i);
+
+/**
+ * Defer a fault until the current instruction completes.  This is used where
+ * a fault is detected in the middle of an instruction which can't be undone,
+ * such as a spill past the stack limit.  The interpreter stops after this
+ * instruction, and raises the fault before running the rest of its budget.
+ *
+ * \param m         The machine state.
+ * \param fault     The fault to raise.
+ */
+SIMEX_COLD void deferFault(MachineStateImplementation* m, Fault fault);
+
+/**
+ * Raise a deferred fault.  Since the instruction which deferred it has
+ * completed, rF is set so that RESUME continues at the program counter.
+ *
+ * \param m         The machine state.
+ */
+SIMEX_COLD void raiseDeferredFault(MachineStateImplementation* m);
+
+/**
+ * Run the rest of the instruction budget from the current program counter,
+ * and account for the instructions run.
+ *
+ * \param m         The machine state.
+ */
+void interpret(MachineStateImplementation* m);
+
+/**
+ * Run the rest of the instruction budget, letting loads and stores access
+ * the host arena directly.  A host fault on an arena access is caught, and
+ * the instruction which caused it is run again with policy checked in
+ * software, which raises the guest fault precisely.
+ *
+ * \param m         The machine state, whose address space has a host arena.
+ */
+void runProtected(MachineStateImplementation* m);
+
+/**
+ * Translate a guest address which missed in the software TLB, checking
+ * alignment and policy, and fill the TLB entry for its page.  On failure, a
+ * fault is raised and nullptr is returned.
+ *
+ * \param m         The machine state.
+ * \param i         The instruction accessing memory.
+ * \param addr      The guest address.
+ * \param size      The size of the access, which the address must be
+ *                  aligned to.
+ * \param policy    The policy required of the segment.
+ *
+ * \returns the host address, or nullptr if a fault was raised.
+ */
+SIMEX_COLD std::uint8_t*
+translateMiss(
+    MachineStateImplementation* m, DecodedInstruction i, std::uint64_t addr,
+    std::uint64_t size, std::uint8_t policy);
+
+/**
+ * Invalidate every entry in the software TLB, and record the generation of
+ * the address space.
+ *
+ * \param m         The machine state.
+ */
+SIMEX_COLD void flushTlb(MachineStateImplementation* m);
+
+/**
+ * Flush the software TLB if segments were mapped, freed, or changed policy
+ * since it was last flushed.  This is checked whenever the host may have
+ * changed segments: when run() starts, and after each system call.
+ */
+inline void syncTlb(MachineStateImplementation* m)
+{
+    if (SIMEX_UNLIKELY(m->tlbGeneration != m->space->generation()))
+        flushTlb(m);
+}
+
+/**
+ * Translate a guest address to host memory, if it is in the arena or hits in
+ * the software TLB.  Unlike translate(), nothing is checked on a miss, and no
+ * fault is raised.
+ *
+ * \returns the host address, or nullptr if the address missed.
+ */
+inline std::uint8_t*
+translateHit(
+    MachineStateImplementation* m, std::uint64_t addr, std::uint64_t size,
+    std::uint8_t policy)
+{
+    if (addr < m->arenaLimit && !(addr & (size - 1)))
+        return m->arena + addr;
+
+    const TlbEntry& e = m->tlb[(addr / AddressSpace::PAGE_SIZE) & TLB_MASK];
+    std::uint64_t tag = addr & (~PAGE_OFFSET_MASK | (size - 1));
+
+    if ((!(policy & SEGMENT_READ) || tag == e.read)
+     && (!(policy & SEGMENT_WRITE) || tag == e.write))
+    {
+        return reinterpret_cast<std::uint8_t*>(addr + e.addend);
+    }
+
+    return nullptr;
+}
+
+/**
+ * Translate a guest address to host memory, checking alignment and policy.
+ * On failure, a fault is raised and nullptr is returned.
+ *
+ * While the host MMU enforces policy, an aligned address in the arena is
+ * returned without any check; an access which the policy forbids raises a
+ * host fault, which runProtected() turns into a guest fault.  Otherwise, a
+ * hit in the software TLB costs a shift, a compare, and an add.  The low bits
+ * of the address which must be zero for alignment are kept in the compared
+ * tag, so a misaligned access misses and faults in translateMiss().  Execute
+ * access is only checked by the predecoder, and always misses.
+ */
+inline std::uint8_t*
+translate(
+    MachineStateImplementation* m, DecodedInstruction i, std::uint64_t addr,
+    std::uint64_t size, std::uint8_t policy)
+{
+    if (SIMEX_LIKELY(
+            !(policy & SEGMENT_EXECUTE)
+         && addr < m->arenaLimit && !(addr & (size - 1))))
+    {
+        return m->arena + addr;
+    }
+
+    const TlbEntry& e = m->tlb[(addr / AddressSpace::PAGE_SIZE) & TLB_MASK];
+    std::uint64_t tag = addr & (~PAGE_OFFSET_MASK | (size - 1));
+
+    if (SIMEX_LIKELY(
+            !(policy & SEGMENT_EXECUTE)
+         && (!(policy & SEGMENT_READ) || tag == e.read)
+         && (!(policy & SEGMENT_WRITE) || tag == e.write)))
+    {
+        return reinterpret_cast<std::uint8_t*>(addr + e.addend);
+    }
+
+    return translateMiss(m, i, addr, size, policy);
+}
+
+/**
+ * Load a big-endian value from host memory.
+ */
+template <typename T>
+inline T loadBE(const std::uint8_t* p)
+{
+    std::uint64_t value = 0;
+
+    for (std::size_t i = 0; i < sizeof(T); ++i)
+        value = (value << 8) | p[i];
+
+    return static_cast<T>(value);
+}
+
+/**
+ * Store a big-endian value to host memory.
+ */
+template <typename T>
+inline void storeBE(std::uint8_t* p, T value)
+{
+    std::uint64_t v = static_cast<std::uint64_t>(value);
+
+    for (std::size_t i = sizeof(T); i > 0; --i)
+    {
+        p[i - 1] = static_cast<std::uint8_t>(v);
+        v >>= 8;
+    }
+}
+
+/**
+ * Load a value from guest memory at a translated host address.  Big-endian
+ * memory is swapped into host order.  Native memory already holds each octa in
+ * host order, so a smaller value is found by flipping the low bits of its
+ * address, and loaded as is.
+ */
+template <typename T, bool NATIVE>
+inline T loadGuest(const std::uint8_t* p)
+{
+    if (!NATIVE)
+        return loadBE<T>(p);
+
+    T value;
+    std::uintptr_t swizzle = NATIVE_BYTE_SWIZZLE & (8 - sizeof(T));
+
+    memcpy(&value, reinterpret_cast<const std::uint8_t*>(
+                       reinterpret_cast<std::uintptr_t>(p) ^ swizzle),
+           sizeof(T));
+
+    return value;
+}
+
+/**
+ * Store a value to guest memory at a translated host address, in the byte
+ * order of the memory.
+ */
+template <typename T, bool NATIVE>
+inline void storeGuest(std::uint8_t* p, T value)
+{
+    if (!NATIVE)
+    {
+        storeBE<T>(p, value);
+        return;
+    }
+
+    std::uintptr_t swizzle = NATIVE_BYTE_SWIZZLE & (8 - sizeof(T));
+
+    memcpy(reinterpret_cast<std::uint8_t*>(
+               reinterpret_cast<std::uintptr_t>(p) ^ swizzle),
+           &value, sizeof(T));
+}
+
+/**
+ * Store an octa to guest memory at a translated host address, without
+ * bringing its cache line into the host cache.  These stores are weakly
+ * ordered, so fenceUncached() must run before another thread may look.
+ */
+template <bool NATIVE>
+inline void storeUncached(std::uint8_t* p, std::uint64_t value)
+{
+#ifdef SIMEX_UNCACHED_X86
+    std::uint8_t octa[8];
+    long long bits;
+
+    storeGuest<std::uint64_t, NATIVE>(octa, value);
+    memcpy(&bits, octa, sizeof(bits));
+    _mm_stream_si64(reinterpret_cast<long long*>(p), bits);
+#else
+    storeGuest<std::uint64_t, NATIVE>(p, value);
+#endif
+}
+
+/**
+ * Order every uncached store made so far before any later store, so that
+ * other threads see them.  This runs at SYNC and whenever run() returns.
+ */
+inline void fenceUncached()
+{
+#ifdef SIMEX_UNCACHED_X86
+    _mm_sfence();
+#endif
+}
+
+/**
+ * Translate an octa-aligned guest address to host memory for a run of octas,
+ * checking alignment and policy.  On failure, a fault is raised and nullptr
+ * is returned.
+ *
+ * \param m         The machine state.
+ * \param i         The instruction accessing memory.
+ * \param addr      The guest address of the first octa.
+ * \param policy    The policy required of the segment.
+ * \param available Set to the number of octas from addr to the end of its
+ *                  segment, which the caller checks against the run.
+ */
+inline std::uint8_t*
+translateOctas(
+    MachineStateImplementation* m, DecodedInstruction i, std::uint64_t addr,
+    std::uint8_t policy, std::uint64_t* available)
+{
+    if (SIMEX_UNLIKELY(addr & 7))
+    {
+        raiseFault(m, Fault::MemoryAlignment, i);
+        return nullptr;
+    }
+
+    Segment* seg = m->space->find(addr);
+    if (SIMEX_UNLIKELY(!seg || (seg->policy() & policy) != policy))
+    {
+        raiseFault(m, Fault::MemoryProtection, i);
+        return nullptr;
+    }
+
+    *available = (seg->size() - (addr - seg->base())) / 8;
+
+    return seg->data() + (addr - seg->base());
+}
+
+/**
+ * Copy octas, reversing the bytes of each, so that host-order registers
+ * become big-endian guest memory or the reverse.  The source and destination
+ * must not overlap, and need not be aligned.
+ *
+ * \param dst       The destination.
+ * \param src       The source.
+ * \param count     The number of octas to copy.
+ */
+void swapOctas(void* dst, const void* src, std::size_t count);
+
+#ifdef SIMEX_SWAP_OCTAS_X86
+
+/**
+ * Copy octas four at a time using SSSE3.  A remainder of fewer than four
+ * octas is left for the caller.
+ *
+ * \returns the number of octas copied.
+ */
+std::size_t swapOctasSSSE3(void* dst, const void* src, std::size_t count);
+
+/**
+ * Copy octas eight at a time using AVX2.  A remainder of fewer than eight
+ * octas is left for the caller.
+ *
+ * \returns the number of octas copied.
+ */
+std::size_t swapOctasAVX2(void* dst, const void* src, std::size_t count);
+
+#endif //SIMEX_SWAP_OCTAS_X86
+
+/**
+ * Copy octas between host-order registers and guest memory, in the byte
+ * order of the memory.  The source and destination must not overlap.
+ *
+ * \param m         The machine state.
+ * \param dst       The destination.
+ * \param src       The source.
+ * \param count     The number of octas to copy.
+ */
+inline void copyOctas(
+    MachineStateImplementation* m, void* dst, const void* src,
+    std::size_t count)
+{
+    if (ByteOrder::Native == m->space->byteOrder())
+        memcpy(dst, src, 8 * count);
+    else
+        swapOctas(dst, src, count);
+}
+
+/**
+ * Save the register context, as for SAVE, to the image at the given address.
+ * The image holds the special registers, the global registers, and every
+ * register-stack offset below rO + rL, as octas in the byte order of memory.
+ * On failure, a fault is raised.
+ *
+ * \param m         The machine state.
+ * \param i         The instruction saving the context.
+ * \param addr      The address of the image.
+ * \param size      Set to the size of the image in bytes.
+ *
+ * \returns true if the context was saved.
+ */
+bool saveContext(
+    MachineStateImplementation* m, DecodedInstruction i, std::uint64_t addr,
+    std::uint64_t* size);
+
+/**
+ * Restore the register context, as for UNSAVE, from the image at the given
+ * address.  On failure, a fault is raised and the context is unchanged.
+ *
+ * \param m         The machine state.
+ * \param i         The instruction restoring the context.
+ * \param addr      The address of the image.
+ *
+ * \returns true if the context was restored.
+ */
+bool restoreContext(
+    MachineStateImplementation* m, DecodedInstruction i, std::uint64_t addr);
+
+/**
+ * Push a register-stack frame, as for PUSHJ, PUSHGO, and SYSCALL.  Registers
+ * $0 through $X-1 are hidden, $X holds the number of hidden registers, and
+ * $X+1 becomes $0 of the new frame.
+ */
+inline void pushFrame(MachineStateImplementation* m, std::uint8_t x)
+{
+    std::uint64_t& rL = sr(m, SReg::SR_RL);
+    std::uint64_t& rO = sr(m, SReg::SR_RO);
+    std::uint64_t count = x;
+
+    //a global X pushes every local register.
+    if (count >= globalBase(m))
+        count = rL;
+
+    //the count register itself is in the hole; extend rL to cover it.
+    if (count >= rL)
+        extendLocals(m, static_cast<std::uint8_t>(count));
+
+    writeRing(m, rO + count, count);
+    rO += count + 1;
+    rL -= count + 1;
+}
+
+/**
+ * Pop a register-stack frame, as for POP and SYSCALL, returning the given
+ * number of registers starting at $0 to the caller.
+ */
+inline void popFrame(MachineStateImplementation* m, std::uint64_t count)
+{
+    std::uint64_t& rL = sr(m, SReg::SR_RL);
+    std::uint64_t& rO = sr(m, SReg::SR_RO);
+    std::uint64_t dest = rO - 1;
+    std::uint64_t top = rO + rL;
+
+    //the count register of a deep caller may have been spilled.
+    if (SIMEX_UNLIKELY(dest < m->spilled))
+        fillRegisters(m, dest);
+
+    std::uint64_t hidden = ringSlot(m, dest);
+
+    //returned values can't overlap the caller's global registers.
+    if (hidden + count > globalBase(m))
+        count = globalBase(m) - hidden;
+
+    //returning registers from the hole may need room in the ring.
+    if (SIMEX_UNLIKELY(dest + count > m->spilled + RING_SIZE))
+        spillRegisters(m, dest + count);
+
+    //copy returned values down; registers in the hole return as 0.
+    for (std::uint64_t i = 0; i < count; ++i)
+        writeRing(m, dest + i, i < rL ? ringSlot(m, rO + i) : 0);
+
+    //the rest of the callee frame is now in the hole.
+    if (dest + count < top)
+        dropLocals(m, dest + count, top);
+
+    rO -= hidden + 1;
+    rL = hidden + count;
+
+    //bring back the rest of the caller frame if it was spilled.
+    if (SIMEX_UNLIKELY(rO < m->spilled))
+        fillRegisters(m, rO);
+}
+
+/* namespace simex */ }
+
+//end of C++ code
+#endif //__cplusplus
+
+#endif //SIMEX_MACHINE_STATE_IMPLEMENTATION_HEADER_GUARD
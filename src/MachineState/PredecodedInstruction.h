@@ -0,0 +1,365 @@
+/**
+ * \file MachineState/PredecodedInstruction.h
+ *
+ * Predecoded instruction records and the per-segment cache of predecoded
+ * basic blocks.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#ifndef  SIMEX_MACHINE_STATE_PREDECODED_INSTRUCTION_HEADER_GUARD
+# define SIMEX_MACHINE_STATE_PREDECODED_INSTRUCTION_HEADER_GUARD
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <simex/AddressSpace.h>
+#include <simex/DecodedInstruction.h>
+#include <simex/ExecutableMemory.h>
+#include <vector>
+
+#include "MachineStateImplementation.h"
+#include "dispatchTable.h"
+
+//this header is C++ specific
+#ifdef __cplusplus
+
+/*
+ * GCC and Clang support taking the address of a label, which lets each
+ * handler jump directly to the next handler.  Other compilers fall back to a
+ * switch inside of a loop.  Define SIMEX_NO_COMPUTED_GOTO to force the
+ * fallback.
+ */
+#if defined(__GNUC__) && !defined(SIMEX_NO_COMPUTED_GOTO)
+# define SIMEX_COMPUTED_GOTO
+#endif
+
+namespace simex {
+
+/**
+ * Index of each distinct handler template.  Records carry this index so that
+ * the predecoder can recognize families of instructions, such as branches.
+ */
+enum HandlerIndex : std::uint8_t
+{
+#define SIMEX_HANDLER(handler) HANDLER_##handler,
+    SIMEX_HANDLER_LIST
+#undef SIMEX_HANDLER
+
+    //the number of handler indices.
+    HANDLER_COUNT
+};
+
+/**
+ * Index of each dispatch target.  Every opcode has its own specialized
+ * handler, at the index equal to its opcode value, followed by the
+ * superinstruction handlers, the call and return handlers specialized for a
+ * register count, the load and store handlers specialized for the native byte
+ * order, and the block sentinel.
+ */
+enum DispatchIndex : std::uint16_t
+{
+#define SIMEX_DISPATCH(code, opcode, handler) DISPATCH_##opcode,
+    SIMEX_DISPATCH_TABLE
+#undef SIMEX_DISPATCH
+
+#define SIMEX_FUSED_HANDLER(handler) DISPATCH_##handler,
+    SIMEX_FUSED_HANDLER_LIST
+#undef SIMEX_FUSED_HANDLER
+
+#define SIMEX_CALL_HANDLER(name, handler, opcode, count) DISPATCH_##name,
+    SIMEX_CALL_HANDLER_LIST
+#undef SIMEX_CALL_HANDLER
+
+#define SIMEX_NATIVE_HANDLER(name, handler, opcode) DISPATCH_##name,
+    SIMEX_NATIVE_HANDLER_LIST
+#undef SIMEX_NATIVE_HANDLER
+
+    //the sentinel record which ends every predecoded block.
+    DISPATCH_BLOCK_END,
+
+    //the number of dispatch indices.
+    DISPATCH_COUNT
+};
+
+static_assert(DISPATCH_OP_RESERVED_xFF == 0xFF,
+              "each opcode dispatches at its own value");
+
+/**
+ * The maximum number of instructions in a predecoded block.
+ */
+const std::size_t MAX_BLOCK_INSTRUCTIONS = 64;
+
+/**
+ * A PredecodedInstruction is a host-endian record for a single instruction,
+ * with everything that can be derived from the instruction and its address
+ * computed ahead of time.
+ *
+ * A superinstruction record covers count instructions, and is immediately
+ * followed by the ordinary records for each of those instructions.  This lets
+ * a superinstruction run its parts through the ordinary handlers, and lets
+ * the interpreter fall back to the ordinary records when fewer than count
+ * instructions remain in the instruction budget.  A block compiled by the
+ * JIT starts with a record for its compiled code in the same way, followed
+ * by every ordinary record of the block.  Until the JIT gets to it, a block
+ * starts with a record which counts its entries instead, and which is
+ * patched into the record for its compiled code once that is ready.
+ */
+struct PredecodedInstruction
+{
+    //the threaded code address of the handler, when using computed goto.
+    const void* label;
+    //the Z constant, the shifted wyde constant, the low octa of the
+    //reciprocal of a DIVI or DIVUI constant, or 0.
+    std::uint64_t imm;
+    //the absolute target of a relative branch, jump, call, or GETA, or the
+    //high octa of the reciprocal of a DIVI or DIVUI constant.
+    std::uint64_t target;
+    //the original instruction, used for operands and fault state.
+    DecodedInstruction ins;
+    //the dispatch target for this record.
+    std::uint16_t dispatch;
+    //the handler family for this instruction.
+    std::uint8_t handler;
+    //the number of instructions covered by this record.
+    std::uint8_t count;
+
+    inline Opcode opcode() const { return ins.opcode(); }
+    inline std::uint8_t x() const { return ins.x(); }
+    inline std::uint8_t y() const { return ins.y(); }
+    inline std::uint8_t z() const { return ins.z(); }
+    inline std::uint16_t yz() const { return ins.yz(); }
+};
+
+/**
+ * Predecode a single instruction.
+ *
+ * \param p         The record to fill.
+ * \param pc        The address of the instruction.
+ * \param ins       The instruction to predecode.
+ * \param order     The byte order of memory, which selects the handler for
+ *                  a load or store.
+ *
+ * \returns true if this instruction ends a basic block.
+ */
+bool predecodeInstruction(
+    PredecodedInstruction* p, std::uint64_t pc, DecodedInstruction ins,
+    ByteOrder order);
+
+/**
+ * Combine common instruction sequences into superinstructions.
+ *
+ * \param in        The ordinary records for a block, without the sentinel.
+ * \param count     The number of records in the block.
+ * \param out       The output records, which must have room for at least
+ *                  count + count / 2 records.
+ *
+ * \returns the number of records written to out.
+ */
+std::size_t fuseInstructions(
+    const PredecodedInstruction* in, std::size_t count,
+    PredecodedInstruction* out);
+
+/**
+ * The host function for a block translated by the JIT.  It is called with
+ * the machine state, and with the ring slots and written flags of local
+ * register $0 of the frame, and returns with the program counter set.
+ */
+typedef void (*CompiledBlock)(
+    MachineStateImplementation* m, std::uint64_t* locals,
+    std::uint8_t* written);
+
+/**
+ * Pack the frame which a compiled block was translated for into the imm of
+ * its record: the value of rG, which decides which registers are global, and
+ * the number of local registers which the block touches.
+ */
+inline std::uint64_t compiledGuard(std::uint64_t rG, std::uint64_t locals)
+{
+    return rG | (locals << 16);
+}
+
+/**
+ * Translate the longest prefix of a basic block which the JIT supports into
+ * host machine code, without adding the code to executable memory.  Nothing
+ * is read from the machine state, so this may run on another thread.
+ *
+ * \param m         The machine state which will run the code.
+ * \param pc        The address of the first instruction of the block.
+ * \param rG        The value of rG which the code is specialized for.
+ * \param native    true if memory holds octas in the native byte order.
+ * \param in        The ordinary records for the block, without the sentinel.
+ * \param count     The number of records in the block.
+ * \param code      Set to the machine code.
+ * \param out       The record to fill, except for the address of the code.
+ *
+ * \returns true if the code and record were filled, or false if too little
+ * of the block was supported, or this host has no JIT.
+ */
+bool translateBlock(
+    MachineStateImplementation* m, std::uint64_t pc, std::uint64_t rG,
+    bool native, const PredecodedInstruction* in, std::size_t count,
+    std::vector<std::uint8_t>* code, PredecodedInstruction* out);
+
+/**
+ * Translate the longest prefix of a basic block which the JIT supports into
+ * host machine code, and build the record which runs it.  The record covers
+ * the instructions which were compiled, and is followed by the ordinary
+ * records of the block, which run instead when the compiled code can't.
+ *
+ * \param m         The machine state.
+ * \param pc        The address of the first instruction of the block.
+ * \param in        The ordinary records for the block, without the sentinel.
+ * \param count     The number of records in the block.
+ * \param memory    The executable memory which holds the code.
+ * \param out       The record to fill.
+ *
+ * \returns true if the record was filled, or false if too little of the
+ * block was supported, or this host has no JIT.
+ */
+bool compileBlock(
+    MachineStateImplementation* m, std::uint64_t pc,
+    const PredecodedInstruction* in, std::size_t count,
+    ExecutableMemory* memory, PredecodedInstruction* out);
+
+/**
+ * Deleter for memory allocated with calloc().
+ */
+struct FreeDeleter
+{
+    inline void operator()(void* p) const { std::free(p); }
+};
+
+/**
+ * The PredecodedSegment is the cache of predecoded basic blocks for a single
+ * executable segment, which belongs to a single machine state.  Blocks are
+ * indexed by the tetra offset of their first instruction.
+ */
+class PredecodedSegment
+{
+public:
+
+    /**
+     * Create an empty cache for the given version of a segment.
+     */
+    PredecodedSegment(
+        Segment* seg, std::uint64_t version_, bool fused_, bool jit_,
+        bool tiered_)
+        : base(seg->base()), size(seg->size()), data(seg->data()),
+          version(version_), fused(fused_), jit(jit_), tiered(tiered_),
+          entries(
+              static_cast<PredecodedInstruction**>(
+                  calloc(seg->size() / 4, sizeof(PredecodedInstruction*))))
+    {
+        if (nullptr == entries)
+            throw std::bad_alloc();
+    }
+
+    //the base address of the segment.
+    std::uint64_t base;
+    //the size of the segment.
+    std::uint64_t size;
+    //the memory of the segment.
+    const std::uint8_t* data;
+    //the version of the segment which was predecoded.
+    std::uint64_t version;
+    //true if blocks in this cache use superinstructions.
+    bool fused;
+    //true if blocks in this cache start with code translated by the JIT.
+    bool jit;
+    //true if blocks in this cache start with a record which counts their
+    //entries, until the JIT translates them.
+    bool tiered;
+    //the block starting at each tetra, or nullptr.  This is allocated with
+    //calloc(), so that the pages of a large segment which never run are
+    //never touched.
+    std::unique_ptr<PredecodedInstruction*[], FreeDeleter> entries;
+    //storage for each predecoded block.
+    std::vector<std::unique_ptr<PredecodedInstruction[]>> blocks;
+    //the host machine code of the compiled blocks.
+    ExecutableMemory compiled;
+
+    /**
+     * Decode the instruction at an address in the segment.
+     */
+    inline DecodedInstruction decode(std::uint64_t pc, ByteOrder order) const
+    {
+        const std::uint8_t* in = data + (pc - base);
+
+        return ByteOrder::Native == order
+            ? DecodedInstruction::decode(loadGuest<std::uint32_t, true>(in))
+            : DecodedInstruction::decode(in);
+    }
+};
+
+/**
+ * Predecode the ordinary records of the basic block starting at an address
+ * in a segment, without fusing them.  The block ends at a branch, at the end
+ * of the segment, or at MAX_BLOCK_INSTRUCTIONS.
+ *
+ * \param code      The cache of the segment.
+ * \param pc        The address of the first instruction of the block.
+ * \param order     The byte order of memory.
+ * \param records   The records to fill, with room for MAX_BLOCK_INSTRUCTIONS.
+ *
+ * \returns the number of records filled.
+ */
+std::size_t decodeBlock(
+    const PredecodedSegment* code, std::uint64_t pc, ByteOrder order,
+    PredecodedInstruction* records);
+
+/**
+ * Predecode the basic block starting at the program counter, adding it to the
+ * cache for the segment containing it.  If the program counter can't be
+ * executed, a fault is raised and nullptr is returned.
+ *
+ * \param m         The machine state.
+ * \param labels    The threaded code address of each dispatch index, or
+ *                  nullptr if computed goto is not used.
+ *
+ * \returns the first record of the block.
+ */
+PredecodedInstruction*
+predecodeBlock(MachineStateImplementation* m, const void* const* labels);
+
+/**
+ * Find the predecoded block starting at the program counter.  Blocks in the
+ * segment of the last block found are looked up directly.
+ *
+ * \param m         The machine state.
+ * \param labels    The threaded code address of each dispatch index, or
+ *                  nullptr if computed goto is not used.
+ *
+ * \returns the first record of the block, or nullptr if a fault was raised.
+ */
+inline PredecodedInstruction*
+findBlock(MachineStateImplementation* m, const void* const* labels)
+{
+    PredecodedSegment* code = m->code;
+
+    if (SIMEX_LIKELY(nullptr != code))
+    {
+        std::uint64_t offset = m->pc - code->base;
+
+        if (SIMEX_LIKELY(offset < code->size && !(offset & 3)))
+        {
+            PredecodedInstruction* block = code->entries[offset >> 2];
+            if (SIMEX_LIKELY(nullptr != block))
+                return block;
+        }
+    }
+
+    return predecodeBlock(m, labels);
+}
+
+/* namespace simex */ }
+
+//end of C++ code
+#endif //__cplusplus
+
+#endif //SIMEX_MACHINE_STATE_PREDECODED_INSTRUCTION_HEADER_GUARD
@@ -0,0 +1,642 @@
+/**
+ * \file MachineState/X86Emitter.h
+ *
+ * A minimal x86-64 instruction encoder for the baseline JIT.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#ifndef  SIMEX_MACHINE_STATE_X86_EMITTER_HEADER_GUARD
+# define SIMEX_MACHINE_STATE_X86_EMITTER_HEADER_GUARD
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <vector>
+
+//this header is C++ specific
+#ifdef __cplusplus
+
+namespace simex {
+
+/**
+ * The general purpose registers of x86-64, numbered as they are encoded.
+ */
+enum X86Reg : std::uint8_t
+{
+    RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI,
+    R8, R9, R10, R11, R12, R13, R14, R15,
+
+    //no register, for a memory operand without an index.
+    NO_REG = 0xFF
+};
+
+/**
+ * The condition codes of x86-64, numbered as they are encoded in Jcc, SETcc,
+ * and CMOVcc.
+ */
+enum X86Cond : std::uint8_t
+{
+    CC_O, CC_NO, CC_B, CC_AE, CC_E, CC_NE, CC_BE, CC_A,
+    CC_S, CC_NS, CC_P, CC_NP, CC_L, CC_GE, CC_LE, CC_G
+};
+
+/**
+ * The opcode extension of each group 1 arithmetic instruction, which also
+ * selects its register to register form.
+ */
+enum X86Alu : std::uint8_t
+{
+    ALU_ADD = 0,
+    ALU_OR = 1,
+    ALU_AND = 4,
+    ALU_SUB = 5,
+    ALU_XOR = 6,
+    ALU_CMP = 7
+};
+
+/**
+ * The opcode extension of each group 2 shift instruction.
+ */
+enum X86Shift : std::uint8_t
+{
+    SHIFT_ROL = 0,
+    SHIFT_SHL = 4,
+    SHIFT_SHR = 5,
+    SHIFT_SAR = 7
+};
+
+/**
+ * A memory operand: base + index * scale + disp.
+ */
+struct X86Mem
+{
+    X86Mem(X86Reg base_, std::int32_t disp_ = 0)
+        : base(base_), index(NO_REG), scale(1), disp(disp_)
+    {
+    }
+
+    X86Mem(X86Reg base_, X86Reg index_, std::uint8_t scale_,
+           std::int32_t disp_)
+        : base(base_), index(index_), scale(scale_), disp(disp_)
+    {
+    }
+
+    X86Reg base;
+    X86Reg index;
+    std::uint8_t scale;
+    std::int32_t disp;
+};
+
+/**
+ * The X86Emitter appends x86-64 instructions to a byte buffer.  Only the
+ * handful of instructions which the JIT uses are provided, each with 64-bit
+ * operands unless its name says otherwise.  Forward jumps are emitted with a
+ * 32-bit displacement which is patched once the target is bound.
+ */
+class X86Emitter
+{
+public:
+
+    /**
+     * Get the emitted bytes.
+     */
+    inline const std::vector<std::uint8_t>& code() const { return code_; }
+
+    /**
+     * Get the offset of the next instruction.
+     */
+    inline std::size_t offset() const { return code_.size(); }
+
+    /**
+     * mov dst, [mem]
+     */
+    inline void load(X86Reg dst, const X86Mem& mem)
+    {
+        op(0x48, {0x8B}, dst, mem);
+    }
+
+    /**
+     * mov [mem], src
+     */
+    inline void store(const X86Mem& mem, X86Reg src)
+    {
+        op(0x48, {0x89}, src, mem);
+    }
+
+    /**
+     * mov byte [mem], imm8
+     */
+    inline void storeByte(const X86Mem& mem, std::uint8_t imm)
+    {
+        op(0x40, {0xC6}, RAX, mem);
+        byte(imm);
+    }
+
+    /**
+     * Load a value of the given size from memory, extending it to 64 bits
+     * with zeros or with its sign: movzx, movsx, mov, or movsxd.
+     */
+    inline void loadSized(
+        X86Reg dst, const X86Mem& mem, unsigned size, bool isSigned)
+    {
+        switch (size)
+        {
+            case 1:
+                op(isSigned ? 0x48 : 0x40,
+                   {0x0F, static_cast<std::uint8_t>(isSigned ? 0xBE : 0xB6)},
+                   dst, mem);
+                break;
+
+            case 2:
+                op(isSigned ? 0x48 : 0x40,
+                   {0x0F, static_cast<std::uint8_t>(isSigned ? 0xBF : 0xB7)},
+                   dst, mem);
+                break;
+
+            case 4:
+                op(isSigned ? 0x48 : 0x40,
+                   {static_cast<std::uint8_t>(isSigned ? 0x63 : 0x8B)},
+                   dst, mem);
+                break;
+
+            default:
+                load(dst, mem);
+                break;
+        }
+    }
+
+    /**
+     * Store the low bytes of a register to memory.  Only RAX through RBX may
+     * be stored as a byte.
+     */
+    inline void storeSized(const X86Mem& mem, X86Reg src, unsigned size)
+    {
+        switch (size)
+        {
+            case 1:
+                op(0x40, {0x88}, src, mem);
+                break;
+
+            case 2:
+                byte(0x66);
+                op(0x40, {0x89}, src, mem);
+                break;
+
+            case 4:
+                op(0x40, {0x89}, src, mem);
+                break;
+
+            default:
+                store(mem, src);
+                break;
+        }
+    }
+
+    /**
+     * Extend the low bytes of src into dst with its sign: movsx or movsxd.
+     */
+    inline void signExtend(X86Reg dst, X86Reg src, unsigned size)
+    {
+        switch (size)
+        {
+            case 1: opRR(0x48, {0x0F, 0xBE}, dst, src); break;
+            case 2: opRR(0x48, {0x0F, 0xBF}, dst, src); break;
+            case 4: opRR(0x48, {0x63}, dst, src); break;
+            default: mov(dst, src); break;
+        }
+    }
+
+    /**
+     * Extend the low bytes of src into dst with zeros.
+     */
+    inline void zeroExtend(X86Reg dst, X86Reg src, unsigned size)
+    {
+        switch (size)
+        {
+            case 1: opRR(0x40, {0x0F, 0xB6}, dst, src); break;
+            case 2: opRR(0x40, {0x0F, 0xB7}, dst, src); break;
+            case 4: opRR(0x40, {0x8B}, dst, src); break;
+            default: mov(dst, src); break;
+        }
+    }
+
+    /**
+     * Reverse the bytes in the low size bytes of a register.  The bytes
+     * above them are left undefined.
+     */
+    inline void byteSwap(X86Reg r, unsigned size)
+    {
+        switch (size)
+        {
+            case 1:
+                break;
+
+            case 2:
+                byte(0x66);
+                rex(0x40, RAX, NO_REG, r);
+                byte(0xC1);
+                modrm(3, SHIFT_ROL, r);
+                byte(8);
+                break;
+
+            case 4:
+                rex(0x40, RAX, NO_REG, r);
+                byte(0x0F);
+                byte(0xC8 + (r & 7));
+                break;
+
+            default:
+                rex(0x48, RAX, NO_REG, r);
+                byte(0x0F);
+                byte(0xC8 + (r & 7));
+                break;
+        }
+    }
+
+    /**
+     * mov dst, src
+     */
+    inline void mov(X86Reg dst, X86Reg src)
+    {
+        if (dst != src)
+            opRR(0x48, {0x8B}, dst, src);
+    }
+
+    /**
+     * Load a constant, with the shortest encoding that holds it.  The flags
+     * are left alone, so zero is loaded with a mov rather than an xor.
+     */
+    inline void movImm(X86Reg dst, std::uint64_t imm)
+    {
+        if (imm <= 0xFFFFFFFFU)
+        {
+            rex(0x40, RAX, NO_REG, dst);
+            byte(0xB8 + (dst & 7));
+            imm32(static_cast<std::uint32_t>(imm));
+        }
+        else if (fitsInt32(static_cast<std::int64_t>(imm)))
+        {
+            rex(0x48, RAX, NO_REG, dst);
+            byte(0xC7);
+            modrm(3, 0, dst);
+            imm32(static_cast<std::uint32_t>(imm));
+        }
+        else
+        {
+            rex(0x48, RAX, NO_REG, dst);
+            byte(0xB8 + (dst & 7));
+            imm32(static_cast<std::uint32_t>(imm));
+            imm32(static_cast<std::uint32_t>(imm >> 32));
+        }
+    }
+
+    /**
+     * ALU dst, src
+     */
+    inline void alu(X86Alu ext, X86Reg dst, X86Reg src)
+    {
+        opRR(0x48, {static_cast<std::uint8_t>(8 * ext + 1)}, src, dst);
+    }
+
+    /**
+     * ALU dst, imm32, with the immediate sign-extended to 64 bits.
+     */
+    inline void aluImm(X86Alu ext, X86Reg dst, std::int32_t imm)
+    {
+        rex(0x48, RAX, NO_REG, dst);
+        if (fitsInt8(imm))
+        {
+            byte(0x83);
+            modrm(3, ext, dst);
+            byte(static_cast<std::uint8_t>(imm));
+        }
+        else
+        {
+            byte(0x81);
+            modrm(3, ext, dst);
+            imm32(static_cast<std::uint32_t>(imm));
+        }
+    }
+
+    /**
+     * ALU dst, [mem]
+     */
+    inline void aluLoad(X86Alu ext, X86Reg dst, const X86Mem& mem)
+    {
+        op(0x48, {static_cast<std::uint8_t>(8 * ext + 3)}, dst, mem);
+    }
+
+    /**
+     * ALU qword [mem], imm32, with the immediate sign-extended to 64 bits.
+     */
+    inline void aluStoreImm(X86Alu ext, const X86Mem& mem, std::int32_t imm)
+    {
+        if (fitsInt8(imm))
+        {
+            op(0x48, {0x83}, static_cast<X86Reg>(ext), mem);
+            byte(static_cast<std::uint8_t>(imm));
+        }
+        else
+        {
+            op(0x48, {0x81}, static_cast<X86Reg>(ext), mem);
+            imm32(static_cast<std::uint32_t>(imm));
+        }
+    }
+
+    /**
+     * test a, b
+     */
+    inline void test(X86Reg a, X86Reg b)
+    {
+        opRR(0x48, {0x85}, b, a);
+    }
+
+    /**
+     * test r, imm32
+     */
+    inline void testImm(X86Reg r, std::int32_t imm)
+    {
+        rex(0x48, RAX, NO_REG, r);
+        byte(0xF7);
+        modrm(3, 0, r);
+        imm32(static_cast<std::uint32_t>(imm));
+    }
+
+    /**
+     * imul dst, src
+     */
+    inline void imul(X86Reg dst, X86Reg src)
+    {
+        opRR(0x48, {0x0F, 0xAF}, dst, src);
+    }
+
+    /**
+     * mul src, leaving the product of RAX and src in RDX:RAX.
+     */
+    inline void mul(X86Reg src)
+    {
+        rex(0x48, RAX, NO_REG, src);
+        byte(0xF7);
+        modrm(3, 4, src);
+    }
+
+    /**
+     * not r
+     */
+    inline void bitwiseNot(X86Reg r)
+    {
+        rex(0x48, RAX, NO_REG, r);
+        byte(0xF7);
+        modrm(3, 2, r);
+    }
+
+    /**
+     * Shift r by CL.
+     */
+    inline void shiftCl(X86Shift ext, X86Reg r)
+    {
+        rex(0x48, RAX, NO_REG, r);
+        byte(0xD3);
+        modrm(3, ext, r);
+    }
+
+    /**
+     * Shift r by a constant.
+     */
+    inline void shiftImm(X86Shift ext, X86Reg r, std::uint8_t count)
+    {
+        rex(0x48, RAX, NO_REG, r);
+        byte(0xC1);
+        modrm(3, ext, r);
+        byte(count);
+    }
+
+    /**
+     * lea dst, [mem]
+     */
+    inline void lea(X86Reg dst, const X86Mem& mem)
+    {
+        op(0x48, {0x8D}, dst, mem);
+    }
+
+    /**
+     * setcc r8, for RAX through RBX.
+     */
+    inline void setcc(X86Cond cc, X86Reg r)
+    {
+        byte(0x0F);
+        byte(0x90 + cc);
+        modrm(3, 0, r);
+    }
+
+    /**
+     * cmovcc dst, src
+     */
+    inline void cmov(X86Cond cc, X86Reg dst, X86Reg src)
+    {
+        opRR(0x48, {0x0F, static_cast<std::uint8_t>(0x40 + cc)}, dst, src);
+    }
+
+    /**
+     * Jump if the condition holds, to a target bound later.
+     *
+     * \returns the jump, to pass to bind().
+     */
+    inline std::size_t jcc(X86Cond cc)
+    {
+        byte(0x0F);
+        byte(0x80 + cc);
+        imm32(0);
+
+        return code_.size();
+    }
+
+    /**
+     * Jump to a target bound later.
+     *
+     * \returns the jump, to pass to bind().
+     */
+    inline std::size_t jmp()
+    {
+        byte(0xE9);
+        imm32(0);
+
+        return code_.size();
+    }
+
+    /**
+     * Jump to an offset which was already emitted.
+     */
+    inline void jmpTo(std::size_t target)
+    {
+        std::size_t jump = jmp();
+
+        bind(jump, target);
+    }
+
+    /**
+     * Make a jump land on the next instruction emitted.
+     */
+    inline void bind(std::size_t jump)
+    {
+        bind(jump, code_.size());
+    }
+
+    /**
+     * Make a jump land on the given offset.
+     */
+    inline void bind(std::size_t jump, std::size_t target)
+    {
+        std::int32_t rel = static_cast<std::int32_t>(
+            static_cast<std::int64_t>(target)
+          - static_cast<std::int64_t>(jump));
+
+        memcpy(&code_[jump - 4], &rel, sizeof(rel));
+    }
+
+    /**
+     * Call a host function through RAX.
+     */
+    inline void call(const void* function)
+    {
+        movImm(RAX, reinterpret_cast<std::uintptr_t>(function));
+        byte(0xFF);
+        modrm(3, 2, RAX);
+    }
+
+    /**
+     * push r
+     */
+    inline void push(X86Reg r)
+    {
+        rex(0x40, RAX, NO_REG, r);
+        byte(0x50 + (r & 7));
+    }
+
+    /**
+     * pop r
+     */
+    inline void pop(X86Reg r)
+    {
+        rex(0x40, RAX, NO_REG, r);
+        byte(0x58 + (r & 7));
+    }
+
+    /**
+     * ret
+     */
+    inline void ret()
+    {
+        byte(0xC3);
+    }
+
+private:
+
+    static inline bool fitsInt8(std::int64_t v)
+    {
+        return v >= -128 && v <= 127;
+    }
+
+    static inline bool fitsInt32(std::int64_t v)
+    {
+        return v >= INT32_MIN && v <= INT32_MAX;
+    }
+
+    inline void byte(unsigned b)
+    {
+        code_.push_back(static_cast<std::uint8_t>(b));
+    }
+
+    inline void imm32(std::uint32_t v)
+    {
+        for (int i = 0; i < 4; ++i)
+            byte(v >> (8 * i));
+    }
+
+    inline void modrm(unsigned mod, unsigned reg, unsigned rm)
+    {
+        byte((mod << 6) | ((reg & 7) << 3) | (rm & 7));
+    }
+
+    /**
+     * Emit a REX prefix built on base, which is 0x40 or 0x48 for REX.W, if
+     * it is needed.
+     */
+    inline void rex(unsigned base, unsigned reg, unsigned index, unsigned rm)
+    {
+        unsigned prefix = base;
+
+        if (reg & 8)
+            prefix |= 4;
+        if (NO_REG != index && (index & 8))
+            prefix |= 2;
+        if (NO_REG != rm && (rm & 8))
+            prefix |= 1;
+
+        if (0x40 != prefix)
+            byte(prefix);
+    }
+
+    /**
+     * Emit an instruction with a register and a memory operand.
+     */
+    inline void op(
+        unsigned prefix, std::initializer_list<std::uint8_t> opcode,
+        X86Reg reg, const X86Mem& mem)
+    {
+        rex(prefix, reg, mem.index, mem.base);
+        for (std::uint8_t b : opcode)
+            byte(b);
+
+        unsigned mod =
+            0 == mem.disp && 5 != (mem.base & 7) ? 0
+          : fitsInt8(mem.disp) ? 1 : 2;
+
+        if (NO_REG == mem.index && 4 != (mem.base & 7))
+        {
+            modrm(mod, reg, mem.base);
+        }
+        else
+        {
+            unsigned index = NO_REG == mem.index ? 4 : (mem.index & 7);
+            unsigned scale =
+                8 == mem.scale ? 3 : 4 == mem.scale ? 2 : 2 == mem.scale;
+
+            modrm(mod, reg, 4);
+            byte((scale << 6) | (index << 3) | (mem.base & 7));
+        }
+
+        if (1 == mod)
+            byte(static_cast<std::uint8_t>(mem.disp));
+        else if (2 == mod)
+            imm32(static_cast<std::uint32_t>(mem.disp));
+    }
+
+    /**
+     * Emit an instruction with two register operands.
+     */
+    inline void opRR(
+        unsigned prefix, std::initializer_list<std::uint8_t> opcode,
+        X86Reg reg, X86Reg rm)
+    {
+        rex(prefix, reg, NO_REG, rm);
+        for (std::uint8_t b : opcode)
+            byte(b);
+        modrm(3, reg, rm);
+    }
+
+    std::vector<std::uint8_t> code_;
+};
+
+/* namespace simex */ }
+
+//end of C++ code
+#endif //__cplusplus
+
+#endif //SIMEX_MACHINE_STATE_X86_EMITTER_HEADER_GUARD
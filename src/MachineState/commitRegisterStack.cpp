@@ -0,0 +1,57 @@
+/**
+ * \file MachineState/commitRegisterStack.cpp
+ *
+ * Commit pages of the rS region as the register-stack grows.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <algorithm>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Commit the pages of the rS region up to the given offset.  Pages are
+ * committed in geometrically growing runs, so that deep recursion commits
+ * in O(1) amortized time.  The region never moves, so nothing is copied, and
+ * new pages read as zero.
+ *
+ * \param m         The machine state.
+ * \param end       The offset just past the last one which must be committed.
+ *
+ * \returns false if the offset is past the reserved address space.
+ */
+bool simex::commitRegisterStack(MachineStateImplementation* m, uint64_t end)
+{
+    static const uint64_t page = sysconf(_SC_PAGESIZE) / sizeof(uint64_t);
+
+    if (end <= m->committed)
+        return true;
+
+    if (end > STACK_RESERVE)
+        return false;
+
+    uint64_t target = max(end, 2 * m->committed);
+    target = min(STACK_RESERVE, (target + page - 1) / page * page);
+
+    if (mprotect(
+            m->backing + m->committed,
+            (target - m->committed) * sizeof(uint64_t),
+            PROT_READ | PROT_WRITE))
+    {
+        return false;
+    }
+
+    m->committed = target;
+
+    return true;
+}
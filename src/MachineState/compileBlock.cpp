@@ -0,0 +1,923 @@
+/**
+ * \file MachineState/compileBlock.cpp
+ *
+ * Translate the start of a basic block into x86-64 machine code.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "PredecodedInstruction.h"
+
+#ifdef SIMEX_JIT_X86_64
+# include "X86Emitter.h"
+#endif
+
+using namespace simex;
+using namespace std;
+
+#ifdef SIMEX_JIT_X86_64
+
+namespace {
+
+/**
+ * The fewest instructions worth compiling.  A shorter block costs as much
+ * to enter as it saves in dispatch.
+ */
+const size_t MIN_COMPILED_INSTRUCTIONS = 2;
+
+/**
+ * The host registers which hold the machine state, the local registers of
+ * the frame, and their written flags while compiled code runs.  These are
+ * saved by the callee, so they survive calls back into the library.
+ */
+const X86Reg MACHINE = RBX;
+const X86Reg LOCALS = R12;
+const X86Reg WRITTEN = R13;
+
+/**
+ * The shift which maps a guest address to its page number.
+ */
+const uint8_t PAGE_SHIFT = 12;
+
+static_assert(AddressSpace::PAGE_SIZE == 1 << PAGE_SHIFT,
+              "compiled code finds the TLB entry of a page with a shift");
+static_assert(sizeof(TlbEntry) == 3 * sizeof(uint64_t),
+              "compiled code indexes the TLB with a scale of three octas");
+
+/**
+ * Raise a fault on behalf of compiled code, which has already set the
+ * program counter and charged the instructions run.
+ */
+void compiledFault(
+    MachineStateImplementation* m, uint32_t fault, uint32_t tetra)
+{
+    raiseFault(m, static_cast<Fault>(fault), DecodedInstruction::decode(tetra));
+}
+
+/**
+ * Translate an address which missed in the TLB on behalf of compiled code,
+ * which has already set the program counter and charged the instructions
+ * run, in case the access faults.
+ */
+uint8_t* compiledTranslate(
+    MachineStateImplementation* m, uint64_t addr, uint32_t tetra,
+    uint32_t size, uint32_t policy)
+{
+    return translateMiss(
+        m, DecodedInstruction::decode(tetra), addr, size,
+        static_cast<uint8_t>(policy));
+}
+
+/**
+ * Code emitted after the body of the block for an instruction which may
+ * leave it early: a fault, or a TLB miss which may fault.
+ */
+struct Stub
+{
+    //the jump to the stub.
+    size_t jump;
+    //where the body resumes after a miss which translated, or 0 for a fault.
+    size_t resume;
+    //the instruction, and its index in the block.
+    const PredecodedInstruction* p;
+    size_t index;
+    //the fault to raise.
+    Fault fault;
+    //the size and policy of a translated access.
+    unsigned size;
+    uint8_t policy;
+};
+
+/**
+ * The BlockCompiler emits the code for one block.  Each guest instruction
+ * becomes a short template which works on the registers in memory, so that
+ * every instruction completes before the next one starts, and a fault
+ * leaves exactly the state which the interpreter would.
+ */
+class BlockCompiler
+{
+public:
+
+    /**
+     * Create a compiler for the block at pc, for a frame with the given rG.
+     * The machine state is only used to find the displacements of its
+     * fields, so that a block can be compiled on another thread.
+     */
+    BlockCompiler(
+        MachineStateImplementation* m, uint64_t pc, uint64_t rG, bool native)
+        : m_(m), pc_(pc), globalBase_(REGISTER_COUNT - rG), locals_(0),
+          native_(native)
+    {
+    }
+
+    /**
+     * Compile the longest prefix of the block which is supported.
+     *
+     * \returns the number of instructions compiled.
+     */
+    size_t compile(const PredecodedInstruction* in, size_t count)
+    {
+        size_t n = 0;
+        bool ended = false;
+
+        e_.push(RBX);
+        e_.push(R12);
+        e_.push(R13);
+        e_.mov(MACHINE, RDI);
+        e_.mov(LOCALS, RSI);
+        e_.mov(WRITTEN, RDX);
+
+        while (n < count && supported(in[n]) && !ended)
+        {
+            ended = instruction(in[n], n);
+            ++n;
+        }
+
+        if (!ended)
+        {
+            charge(n);
+            setPc(pc_ + 4 * n);
+        }
+
+        size_t exit = e_.offset();
+
+        e_.pop(R13);
+        e_.pop(R12);
+        e_.pop(RBX);
+        e_.ret();
+
+        for (const Stub& s : stubs_)
+            stub(s, exit);
+
+        return n;
+    }
+
+    /**
+     * Get the emitted code.
+     */
+    const vector<uint8_t>& code() const { return e_.code(); }
+
+    /**
+     * Get the number of local registers which the code touches.
+     */
+    uint64_t locals() const { return locals_; }
+
+private:
+
+    /**
+     * Returns true if the JIT can translate this instruction.
+     */
+    static bool supported(const PredecodedInstruction& p)
+    {
+        switch (p.handler)
+        {
+            case HANDLER_opAdd: case HANDLER_opAddu: case HANDLER_opSub:
+            case HANDLER_opSubu: case HANDLER_opScaledAddu: case HANDLER_opCmp:
+            case HANDLER_opCmpu: case HANDLER_opNeg: case HANDLER_opNegu:
+            case HANDLER_opMul: case HANDLER_opMulu: case HANDLER_opLogic:
+            case HANDLER_opMux: case HANDLER_opSet: case HANDLER_opInc:
+            case HANDLER_opOrw: case HANDLER_opAndnw: case HANDLER_opSl:
+            case HANDLER_opSlu: case HANDLER_opSr: case HANDLER_opSru:
+            case HANDLER_opCs: case HANDLER_opZs: case HANDLER_opBranch:
+            case HANDLER_opJmp: case HANDLER_opGeta: case HANDLER_opLoad:
+            case HANDLER_opLdht: case HANDLER_opStore: case HANDLER_opStht:
+            case HANDLER_opStco: case HANDLER_opNop:
+                return true;
+
+            default:
+                return false;
+        }
+    }
+
+    /**
+     * Get the displacement of a field of the machine state.
+     */
+    X86Mem field(const void* f) const
+    {
+        return X86Mem(
+            MACHINE,
+            static_cast<int32_t>(
+                static_cast<const uint8_t*>(f)
+              - reinterpret_cast<const uint8_t*>(m_)));
+    }
+
+    /**
+     * Get the memory holding a register, which is global or local as it was
+     * when the block was compiled.
+     */
+    X86Mem reg(uint8_t r)
+    {
+        if (r >= globalBase_)
+            return field(&m_->globals[r]);
+
+        locals_ = max<uint64_t>(locals_, r + 1);
+
+        return X86Mem(LOCALS, 8 * r);
+    }
+
+    void loadReg(X86Reg dst, uint8_t r)
+    {
+        e_.load(dst, reg(r));
+    }
+
+    void storeReg(uint8_t r, X86Reg src)
+    {
+        e_.store(reg(r), src);
+        if (r < globalBase_)
+            e_.storeByte(X86Mem(WRITTEN, r), 1);
+    }
+
+    /**
+     * Load the Z operand, which is either the Z register or the Z constant.
+     */
+    void loadZ(X86Reg dst, const PredecodedInstruction& p)
+    {
+        if (p.ins.traits().zImmediate)
+            e_.movImm(dst, p.imm);
+        else
+            loadReg(dst, p.z());
+    }
+
+    /**
+     * Combine the Z operand into a host register.
+     */
+    void aluZ(X86Alu ext, X86Reg dst, const PredecodedInstruction& p)
+    {
+        if (p.ins.traits().zImmediate)
+            e_.aluImm(ext, dst, static_cast<int32_t>(p.imm));
+        else
+            e_.aluLoad(ext, dst, reg(p.z()));
+    }
+
+    /**
+     * Test a register for a branch condition.
+     *
+     * \returns the host condition which holds when the guest one does.
+     */
+    X86Cond test(uint8_t cond, X86Reg r)
+    {
+        if (3 == cond || 7 == cond)
+        {
+            e_.testImm(r, 1);
+            return 3 == cond ? CC_NE : CC_E;
+        }
+
+        e_.test(r, r);
+        switch (cond)
+        {
+            case 0: return CC_S;
+            case 1: return CC_E;
+            case 2: return CC_G;
+            case 4: return CC_NS;
+            case 5: return CC_NE;
+            default: return CC_LE;
+        }
+    }
+
+    /**
+     * Charge instructions to the instruction budget.  All but the first were
+     * run without a dispatch of their own.
+     */
+    void charge(size_t instructions)
+    {
+        e_.aluStoreImm(
+            ALU_SUB, field(&m_->remaining), static_cast<int32_t>(instructions));
+        if (instructions > 1)
+            e_.aluStoreImm(
+                ALU_ADD, field(&m_->fusedInstructions),
+                static_cast<int32_t>(instructions - 1));
+    }
+
+    /**
+     * Refund instructions charged by charge().
+     */
+    void refund(size_t instructions)
+    {
+        e_.aluStoreImm(
+            ALU_ADD, field(&m_->remaining), static_cast<int32_t>(instructions));
+        if (instructions > 1)
+            e_.aluStoreImm(
+                ALU_SUB, field(&m_->fusedInstructions),
+                static_cast<int32_t>(instructions - 1));
+    }
+
+    void setPc(uint64_t pc)
+    {
+        e_.movImm(RCX, pc);
+        e_.store(field(&m_->pc), RCX);
+    }
+
+    /**
+     * Jump to a stub which raises a fault if the condition holds.
+     */
+    void faultIf(
+        X86Cond cc, const PredecodedInstruction& p, size_t k, Fault fault)
+    {
+        stubs_.push_back(Stub{e_.jcc(cc), 0, &p, k, fault, 0, 0});
+    }
+
+    /**
+     * Compute the effective address $Y + $Z or $Y + Z into RAX.
+     */
+    void effectiveAddress(const PredecodedInstruction& p)
+    {
+        loadReg(RAX, p.y());
+        aluZ(ALU_ADD, RAX, p);
+    }
+
+    /**
+     * Translate the guest address in RAX to host memory through the software
+     * TLB, as translate() does.  A miss is handled by a stub, which fills the
+     * TLB and comes back, or raises the fault.
+     */
+    void translate(
+        const PredecodedInstruction& p, size_t k, unsigned size,
+        uint8_t policy)
+    {
+        int32_t tlb = field(&m_->tlb[0]).disp;
+        int32_t tag = static_cast<int32_t>(
+            (SEGMENT_WRITE == policy)
+                ? offsetof(TlbEntry, write) : offsetof(TlbEntry, read));
+
+        e_.mov(RDX, RAX);
+        e_.shiftImm(SHIFT_SHR, RDX, PAGE_SHIFT);
+        e_.aluImm(ALU_AND, RDX, static_cast<int32_t>(TLB_MASK));
+        e_.lea(RDX, X86Mem(RDX, RDX, 2, 0));
+        e_.mov(RCX, RAX);
+        e_.aluImm(
+            ALU_AND, RCX,
+            static_cast<int32_t>(~PAGE_OFFSET_MASK | (size - 1)));
+        e_.aluLoad(ALU_CMP, RCX, X86Mem(MACHINE, RDX, 8, tlb + tag));
+
+        size_t miss = e_.jcc(CC_NE);
+
+        e_.aluLoad(
+            ALU_ADD, RAX,
+            X86Mem(MACHINE, RDX, 8,
+                   tlb + static_cast<int32_t>(offsetof(TlbEntry, addend))));
+
+        stubs_.push_back(
+            Stub{miss, e_.offset(), &p, k, Fault::None, size, policy});
+    }
+
+    /**
+     * Load a value from guest memory at the host address in RAX, as
+     * loadGuest() does.
+     */
+    void loadGuest(X86Reg dst, unsigned size, bool isSigned)
+    {
+        if (native_)
+        {
+            if (NATIVE_BYTE_SWIZZLE & (8 - size))
+                e_.aluImm(
+                    ALU_XOR, RAX,
+                    static_cast<int32_t>(NATIVE_BYTE_SWIZZLE & (8 - size)));
+
+            e_.loadSized(dst, X86Mem(RAX), size, isSigned);
+            return;
+        }
+
+        e_.loadSized(dst, X86Mem(RAX), size, false);
+        e_.byteSwap(dst, size);
+        if (size < 8 && isSigned)
+            e_.signExtend(dst, dst, size);
+        else if (size < 8)
+            e_.zeroExtend(dst, dst, size);
+    }
+
+    /**
+     * Store a value to guest memory at the host address in RAX, as
+     * storeGuest() does.
+     */
+    void storeGuest(X86Reg src, unsigned size)
+    {
+        if (native_)
+        {
+            if (NATIVE_BYTE_SWIZZLE & (8 - size))
+                e_.aluImm(
+                    ALU_XOR, RAX,
+                    static_cast<int32_t>(NATIVE_BYTE_SWIZZLE & (8 - size)));
+        }
+        else
+        {
+            e_.byteSwap(src, size);
+        }
+
+        e_.storeSized(X86Mem(RAX), src, size);
+    }
+
+    /**
+     * Emit the template for the instruction at index k of the block.
+     *
+     * \returns true if the instruction ends the block.
+     */
+    bool instruction(const PredecodedInstruction& p, size_t k)
+    {
+        const OpcodeTraits& t = p.ins.traits();
+
+        switch (p.handler)
+        {
+            case HANDLER_opAdd:
+            case HANDLER_opSub:
+                loadReg(RAX, p.y());
+                aluZ(HANDLER_opAdd == p.handler ? ALU_ADD : ALU_SUB, RAX, p);
+                faultIf(CC_O, p, k, Fault::IntegerOverflow);
+                storeReg(p.x(), RAX);
+                break;
+
+            case HANDLER_opAddu:
+            case HANDLER_opSubu:
+                loadReg(RAX, p.y());
+                aluZ(HANDLER_opAddu == p.handler ? ALU_ADD : ALU_SUB, RAX, p);
+                storeReg(p.x(), RAX);
+                break;
+
+            case HANDLER_opScaledAddu:
+                loadReg(RAX, p.y());
+                e_.shiftImm(
+                    SHIFT_SHL, RAX, ((opcode2byte(p.opcode()) >> 1) & 3) + 1);
+                aluZ(ALU_ADD, RAX, p);
+                storeReg(p.x(), RAX);
+                break;
+
+            case HANDLER_opCmp:
+            case HANDLER_opCmpu:
+            {
+                bool isSigned = HANDLER_opCmp == p.handler;
+
+                loadReg(RAX, p.y());
+                aluZ(ALU_CMP, RAX, p);
+                e_.setcc(isSigned ? CC_G : CC_A, RCX);
+                e_.setcc(isSigned ? CC_L : CC_B, RDX);
+                e_.zeroExtend(RCX, RCX, 1);
+                e_.zeroExtend(RDX, RDX, 1);
+                e_.alu(ALU_SUB, RCX, RDX);
+                storeReg(p.x(), RCX);
+                break;
+            }
+
+            case HANDLER_opNeg:
+            case HANDLER_opNegu:
+                e_.movImm(RAX, p.y());
+                aluZ(ALU_SUB, RAX, p);
+                if (HANDLER_opNeg == p.handler)
+                    faultIf(CC_O, p, k, Fault::IntegerOverflow);
+                storeReg(p.x(), RAX);
+                break;
+
+            case HANDLER_opMul:
+                loadReg(RAX, p.y());
+                loadZ(RCX, p);
+                e_.imul(RAX, RCX);
+                faultIf(CC_O, p, k, Fault::IntegerOverflow);
+                storeReg(p.x(), RAX);
+                break;
+
+            case HANDLER_opMulu:
+                loadReg(RAX, p.y());
+                loadZ(RCX, p);
+                e_.mul(RCX);
+                e_.store(field(&sr(m_, SReg::SR_RH)), RDX);
+                storeReg(p.x(), RAX);
+                break;
+
+            case HANDLER_opLogic:
+                logic(p);
+                break;
+
+            case HANDLER_opMux:
+                loadReg(RAX, p.y());
+                loadZ(RCX, p);
+                e_.load(RDX, field(&sr(m_, SReg::SR_RM)));
+                e_.alu(ALU_AND, RAX, RDX);
+                e_.bitwiseNot(RDX);
+                e_.alu(ALU_AND, RCX, RDX);
+                e_.alu(ALU_OR, RAX, RCX);
+                storeReg(p.x(), RAX);
+                break;
+
+            case HANDLER_opSet:
+                e_.movImm(RAX, p.imm);
+                storeReg(p.x(), RAX);
+                break;
+
+            case HANDLER_opInc:
+            case HANDLER_opOrw:
+            case HANDLER_opAndnw:
+                loadReg(RAX, p.x());
+                e_.movImm(RCX, p.imm);
+                if (HANDLER_opAndnw == p.handler)
+                    e_.bitwiseNot(RCX);
+                e_.alu(
+                    HANDLER_opInc == p.handler ? ALU_ADD
+                  : HANDLER_opOrw == p.handler ? ALU_OR : ALU_AND,
+                    RAX, RCX);
+                storeReg(p.x(), RAX);
+                break;
+
+            case HANDLER_opSl:
+                shiftLeft(p, k);
+                break;
+
+            case HANDLER_opSlu:
+            case HANDLER_opSr:
+            case HANDLER_opSru:
+                shift(p);
+                break;
+
+            case HANDLER_opCs:
+            {
+                loadReg(RAX, p.y());
+
+                size_t skip = e_.jcc(
+                    static_cast<X86Cond>(test(t.condition, RAX) ^ 1));
+
+                loadZ(RCX, p);
+                storeReg(p.x(), RCX);
+                e_.bind(skip);
+                break;
+            }
+
+            case HANDLER_opZs:
+            {
+                loadZ(RCX, p);
+                loadReg(RAX, p.y());
+
+                X86Cond cc = test(t.condition, RAX);
+
+                e_.movImm(RDX, 0);
+                e_.cmov(static_cast<X86Cond>(cc ^ 1), RCX, RDX);
+                storeReg(p.x(), RCX);
+                break;
+            }
+
+            case HANDLER_opBranch:
+            {
+                charge(k + 1);
+                loadReg(RAX, p.x());
+                e_.movImm(RCX, p.target);
+                e_.movImm(RDX, pc_ + 4 * k + 4);
+
+                X86Cond cc = test(t.condition, RAX);
+
+                e_.cmov(cc, RDX, RCX);
+                e_.store(field(&m_->pc), RDX);
+                return true;
+            }
+
+            case HANDLER_opJmp:
+                charge(k + 1);
+                setPc(p.target);
+                return true;
+
+            case HANDLER_opGeta:
+                e_.movImm(RAX, p.target);
+                storeReg(p.x(), RAX);
+                break;
+
+            case HANDLER_opLoad:
+                effectiveAddress(p);
+                translate(p, k, t.width, SEGMENT_READ);
+                loadGuest(RCX, t.width, t.isSigned);
+                storeReg(p.x(), RCX);
+                break;
+
+            case HANDLER_opLdht:
+                effectiveAddress(p);
+                translate(p, k, 4, SEGMENT_READ);
+                loadGuest(RCX, 4, false);
+                e_.shiftImm(SHIFT_SHL, RCX, 32);
+                storeReg(p.x(), RCX);
+                break;
+
+            case HANDLER_opStore:
+                //a signed store faults before it translates, as opStore()
+                //does.
+                if (t.isSigned && t.width < 8)
+                {
+                    loadReg(RCX, p.x());
+                    e_.signExtend(RDX, RCX, t.width);
+                    e_.alu(ALU_CMP, RDX, RCX);
+                    faultIf(CC_NE, p, k, Fault::IntegerOverflow);
+                }
+
+                effectiveAddress(p);
+                translate(p, k, t.width, SEGMENT_WRITE);
+                loadReg(RCX, p.x());
+                storeGuest(RCX, t.width);
+                break;
+
+            case HANDLER_opStht:
+                effectiveAddress(p);
+                translate(p, k, 4, SEGMENT_WRITE);
+                loadReg(RCX, p.x());
+                e_.shiftImm(SHIFT_SHR, RCX, 32);
+                storeGuest(RCX, 4);
+                break;
+
+            case HANDLER_opStco:
+                effectiveAddress(p);
+                translate(p, k, 8, SEGMENT_WRITE);
+                e_.movImm(RCX, p.x());
+                storeGuest(RCX, 8);
+                break;
+
+            default:
+                //SWYM does nothing.
+                break;
+        }
+
+        return false;
+    }
+
+    /**
+     * OR, ORN, NOR, XOR, AND, ANDN, NAND, NXOR and their immediate forms.
+     */
+    void logic(const PredecodedInstruction& p)
+    {
+        Opcode op = p.opcode();
+        bool immediate = p.ins.traits().zImmediate;
+        Opcode base = immediate
+            ? static_cast<Opcode>(opcode2byte(op) & ~1) : op;
+
+        loadReg(RAX, p.y());
+        loadZ(RCX, p);
+
+        switch (base)
+        {
+            case Opcode::OP_OR:
+                e_.alu(ALU_OR, RAX, RCX);
+                break;
+
+            case Opcode::OP_ORN:
+                e_.bitwiseNot(RCX);
+                e_.alu(ALU_OR, RAX, RCX);
+                break;
+
+            case Opcode::OP_NOR:
+                e_.alu(ALU_OR, RAX, RCX);
+                e_.bitwiseNot(RAX);
+                break;
+
+            case Opcode::OP_XOR:
+                e_.alu(ALU_XOR, RAX, RCX);
+                break;
+
+            case Opcode::OP_AND:
+                e_.alu(ALU_AND, RAX, RCX);
+                break;
+
+            case Opcode::OP_ANDN:
+                e_.bitwiseNot(RCX);
+                e_.alu(ALU_AND, RAX, RCX);
+                break;
+
+            case Opcode::OP_NAND:
+                e_.alu(ALU_AND, RAX, RCX);
+                e_.bitwiseNot(RAX);
+                break;
+
+            default:
+                e_.alu(ALU_XOR, RAX, RCX);
+                e_.bitwiseNot(RAX);
+                break;
+        }
+
+        storeReg(p.x(), RAX);
+    }
+
+    /**
+     * SL, SLI: signed shift left, which faults unless shifting back gives
+     * $Y again.  A shift of 64 or more gives 0, so it faults unless $Y is 0.
+     */
+    void shiftLeft(const PredecodedInstruction& p, size_t k)
+    {
+        loadReg(RAX, p.y());
+
+        if (p.ins.traits().zImmediate)
+        {
+            if (p.imm >= 64)
+            {
+                e_.test(RAX, RAX);
+                faultIf(CC_NE, p, k, Fault::IntegerOverflow);
+                e_.movImm(RAX, 0);
+            }
+            else
+            {
+                uint8_t z = static_cast<uint8_t>(p.imm);
+
+                e_.mov(RDX, RAX);
+                e_.shiftImm(SHIFT_SHL, RAX, z);
+                e_.mov(RSI, RAX);
+                e_.shiftImm(SHIFT_SAR, RSI, z);
+                e_.alu(ALU_CMP, RSI, RDX);
+                faultIf(CC_NE, p, k, Fault::IntegerOverflow);
+            }
+
+            storeReg(p.x(), RAX);
+            return;
+        }
+
+        loadReg(RCX, p.z());
+        e_.mov(RDX, RAX);
+        e_.aluImm(ALU_CMP, RCX, 64);
+
+        size_t big = e_.jcc(CC_AE);
+
+        e_.shiftCl(SHIFT_SHL, RAX);
+        e_.mov(RSI, RAX);
+        e_.shiftCl(SHIFT_SAR, RSI);
+        e_.alu(ALU_CMP, RSI, RDX);
+        faultIf(CC_NE, p, k, Fault::IntegerOverflow);
+
+        size_t done = e_.jmp();
+
+        e_.bind(big);
+        e_.test(RDX, RDX);
+        faultIf(CC_NE, p, k, Fault::IntegerOverflow);
+        e_.movImm(RAX, 0);
+        e_.bind(done);
+        storeReg(p.x(), RAX);
+    }
+
+    /**
+     * SLU, SR, SRU and their immediate forms.  A shift of 64 or more gives 0,
+     * or the sign of $Y for SR.
+     */
+    void shift(const PredecodedInstruction& p)
+    {
+        X86Shift ext =
+            HANDLER_opSlu == p.handler ? SHIFT_SHL
+          : HANDLER_opSr == p.handler ? SHIFT_SAR : SHIFT_SHR;
+
+        loadReg(RAX, p.y());
+
+        if (p.ins.traits().zImmediate)
+        {
+            if (p.imm < 64)
+                e_.shiftImm(ext, RAX, static_cast<uint8_t>(p.imm));
+            else if (SHIFT_SAR == ext)
+                e_.shiftImm(ext, RAX, 63);
+            else
+                e_.movImm(RAX, 0);
+
+            storeReg(p.x(), RAX);
+            return;
+        }
+
+        loadReg(RCX, p.z());
+
+        if (SHIFT_SAR == ext)
+        {
+            e_.movImm(RDX, 63);
+            e_.aluImm(ALU_CMP, RCX, 64);
+            e_.cmov(CC_AE, RCX, RDX);
+            e_.shiftCl(ext, RAX);
+        }
+        else
+        {
+            e_.shiftCl(ext, RAX);
+            e_.movImm(RDX, 0);
+            e_.aluImm(ALU_CMP, RCX, 64);
+            e_.cmov(CC_AE, RAX, RDX);
+        }
+
+        storeReg(p.x(), RAX);
+    }
+
+    /**
+     * Emit a stub.  The instructions up to and including the one which left
+     * the body are charged and the program counter is set to it, so that a
+     * fault reports exactly the state of the instruction which faulted.
+     */
+    void stub(const Stub& s, size_t exit)
+    {
+        e_.bind(s.jump);
+        setPc(pc_ + 4 * s.index);
+        charge(s.index + 1);
+        e_.mov(RDI, MACHINE);
+
+        if (Fault::None != s.fault)
+        {
+            e_.movImm(RSI, static_cast<uint32_t>(s.fault));
+            e_.movImm(RDX, s.p->ins.tetra());
+            e_.call(reinterpret_cast<const void*>(&compiledFault));
+            e_.jmpTo(exit);
+            return;
+        }
+
+        e_.mov(RSI, RAX);
+        e_.movImm(RDX, s.p->ins.tetra());
+        e_.movImm(RCX, s.size);
+        e_.movImm(R8, s.policy);
+        e_.call(reinterpret_cast<const void*>(&compiledTranslate));
+        e_.test(RAX, RAX);
+        e_.bind(e_.jcc(CC_E), exit);
+
+        //the access translated, so the rest of the block runs.
+        refund(s.index + 1);
+        e_.jmpTo(s.resume);
+    }
+
+    MachineStateImplementation* m_;
+    X86Emitter e_;
+    vector<Stub> stubs_;
+    uint64_t pc_;
+    uint64_t globalBase_;
+    uint64_t locals_;
+    bool native_;
+};
+
+/* namespace */ }
+
+#endif //SIMEX_JIT_X86_64
+
+/**
+ * Translate the longest prefix of a basic block which the JIT supports into
+ * host machine code, without adding the code to executable memory.  Nothing
+ * is read from the machine state, so this may run on another thread.
+ *
+ * \param m         The machine state which will run the code.
+ * \param pc        The address of the first instruction of the block.
+ * \param rG        The value of rG which the code is specialized for.
+ * \param native    true if memory holds octas in the native byte order.
+ * \param in        The ordinary records for the block, without the sentinel.
+ * \param count     The number of records in the block.
+ * \param code      Set to the machine code.
+ * \param out       The record to fill, except for the address of the code.
+ *
+ * \returns true if the code and record were filled, or false if too little
+ * of the block was supported, or this host has no JIT.
+ */
+bool simex::translateBlock(
+    MachineStateImplementation* m, uint64_t pc, uint64_t rG, bool native,
+    const PredecodedInstruction* in, size_t count, vector<uint8_t>* code,
+    PredecodedInstruction* out)
+{
+#ifdef SIMEX_JIT_X86_64
+    BlockCompiler compiler(m, pc, rG, native);
+    size_t n = compiler.compile(in, count);
+
+    if (n < MIN_COMPILED_INSTRUCTIONS)
+        return false;
+
+    *code = compiler.code();
+    *out = in[0];
+    out->dispatch = DISPATCH_runCompiled;
+    out->count = static_cast<uint8_t>(n);
+    out->target = 0;
+    out->imm = compiledGuard(rG, compiler.locals());
+
+    return true;
+#else
+    (void)m; (void)pc; (void)rG; (void)native; (void)in; (void)count;
+    (void)code; (void)out;
+
+    return false;
+#endif
+}
+
+/**
+ * Translate the longest prefix of a basic block which the JIT supports into
+ * host machine code, and build the record which runs it.
+ *
+ * \param m         The machine state.
+ * \param pc        The address of the first instruction of the block.
+ * \param in        The ordinary records for the block, without the sentinel.
+ * \param count     The number of records in the block.
+ * \param memory    The executable memory which holds the code.
+ * \param out       The record to fill.
+ *
+ * \returns true if the record was filled, or false if too little of the
+ * block was supported, or this host has no JIT.
+ */
+bool simex::compileBlock(
+    MachineStateImplementation* m, uint64_t pc,
+    const PredecodedInstruction* in, size_t count, ExecutableMemory* memory,
+    PredecodedInstruction* out)
+{
+    vector<uint8_t> code;
+
+    if (!translateBlock(
+            m, pc, sr(m, SReg::SR_RG),
+            ByteOrder::Native == m->space->byteOrder(), in, count, &code, out))
+    {
+        return false;
+    }
+
+    const void* host = memory->add(code.data(), code.size());
+    if (nullptr == host)
+        return false;
+
+    out->target = reinterpret_cast<uintptr_t>(host);
+
+    return true;
+}
@@ -0,0 +1,24 @@
+/**
+ * \file MachineState/dCompileQueue.cpp
+ *
+ * Deleter for the background compiler of a machine state.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include "CompileQueue.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Stop the compiler thread and release the queue.
+ */
+void CompileQueueDeleter::operator()(CompileQueue* queue) const
+{
+    delete queue;
+}
@@ -0,0 +1,25 @@
+/**
+ * \file MachineState/dMachineState.cpp
+ *
+ * Destructor for MachineState.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/MachineState.h>
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Destructor.  Clean up this instance.
+ */
+MachineState::~MachineState()
+{
+}
@@ -0,0 +1,24 @@
+/**
+ * \file MachineState/dPredecodedSegment.cpp
+ *
+ * Deleter for the predecoded block cache of a segment.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include "PredecodedInstruction.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Release the blocks of the cache and their compiled code.
+ */
+void PredecodedSegmentDeleter::operator()(PredecodedSegment* code) const
+{
+    delete code;
+}
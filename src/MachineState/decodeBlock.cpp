@@ -0,0 +1,52 @@
+/**
+ * \file MachineState/decodeBlock.cpp
+ *
+ * Predecode the ordinary records of a basic block.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <algorithm>
+
+#include "PredecodedInstruction.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Predecode the ordinary records of the basic block starting at an address
+ * in a segment, without fusing them.  The block ends at a branch, at the end
+ * of the segment, or at MAX_BLOCK_INSTRUCTIONS.
+ *
+ * \param code      The cache of the segment.
+ * \param pc        The address of the first instruction of the block.
+ * \param order     The byte order of memory.
+ * \param records   The records to fill, with room for MAX_BLOCK_INSTRUCTIONS.
+ *
+ * \returns the number of records filled.
+ */
+size_t simex::decodeBlock(
+    const PredecodedSegment* code, uint64_t pc, ByteOrder order,
+    PredecodedInstruction* records)
+{
+    uint64_t count = min<uint64_t>((code->size - (pc - code->base)) / 4,
+                                   MAX_BLOCK_INSTRUCTIONS);
+    size_t n = 0;
+
+    while (n < count)
+    {
+        uint64_t addr = pc + 4 * n;
+        bool end = predecodeInstruction(
+            &records[n], addr, code->decode(addr, order), order);
+
+        ++n;
+        if (end)
+            break;
+    }
+
+    return n;
+}
@@ -0,0 +1,33 @@
+/**
+ * \file MachineState/deferFault.cpp
+ *
+ * Defer a fault until the current instruction completes.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Defer a fault until the current instruction completes.  The interpreter
+ * stops after this instruction, as it does when the budget runs out, and the
+ * rest of the budget is kept to be run once the fault has been raised.
+ *
+ * \param m         The machine state.
+ * \param fault     The fault to raise.
+ */
+void simex::deferFault(MachineStateImplementation* m, Fault fault)
+{
+    m->deferredFault = fault;
+    m->deferredPc = m->pc;
+    m->deferredBudget = m->remaining;
+    m->budget -= m->remaining;
+    m->remaining = 0;
+}
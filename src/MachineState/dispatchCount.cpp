@@ -0,0 +1,27 @@
+/**
+ * \file MachineState/dispatchCount.cpp
+ *
+ * Implementation of MachineState::dispatchCount().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/MachineState.h>
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Get the number of instruction dispatches performed by this machine.  This
+ * is less than instructionCount() when superinstructions run.
+ */
+uint64_t MachineState::dispatchCount() const
+{
+    return instructionCount() - impl_->fusedInstructions;
+}
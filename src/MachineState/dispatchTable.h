@@ -0,0 +1,442 @@
+/**
+ * \file MachineState/dispatchTable.h
+ *
+ * Mapping from every opcode to the handler which evaluates it.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#ifndef  SIMEX_MACHINE_STATE_DISPATCH_TABLE_HEADER_GUARD
+# define SIMEX_MACHINE_STATE_DISPATCH_TABLE_HEADER_GUARD
+
+/**
+ * Expand SIMEX_DISPATCH(code, opcode, handler) for each of the 256 opcodes,
+ * in opcode order.
+ */
+#define SIMEX_DISPATCH_TABLE \
+    SIMEX_DISPATCH(0x00, OP_SYSCALL,        opSyscall) \
+    SIMEX_DISPATCH(0x01, OP_FCMP,           opFcompare) \
+    SIMEX_DISPATCH(0x02, OP_FUN,            opFcompare) \
+    SIMEX_DISPATCH(0x03, OP_FEQL,           opFcompare) \
+    SIMEX_DISPATCH(0x04, OP_FADD,           opFarith) \
+    SIMEX_DISPATCH(0x05, OP_FIX,            opFix) \
+    SIMEX_DISPATCH(0x06, OP_FSUB,           opFarith) \
+    SIMEX_DISPATCH(0x07, OP_FIXU,           opFix) \
+    SIMEX_DISPATCH(0x08, OP_FLOT,           opFlot) \
+    SIMEX_DISPATCH(0x09, OP_FLOTI,          opFlot) \
+    SIMEX_DISPATCH(0x0A, OP_FLOTU,          opFlot) \
+    SIMEX_DISPATCH(0x0B, OP_FLOTUI,         opFlot) \
+    SIMEX_DISPATCH(0x0C, OP_SFLOT,          opFlot) \
+    SIMEX_DISPATCH(0x0D, OP_SFLOTI,         opFlot) \
+    SIMEX_DISPATCH(0x0E, OP_SFLOTU,         opFlot) \
+    SIMEX_DISPATCH(0x0F, OP_SFLOTUI,        opFlot) \
+    SIMEX_DISPATCH(0x10, OP_FMUL,           opFarith) \
+    SIMEX_DISPATCH(0x11, OP_FCMPE,          opFcompare) \
+    SIMEX_DISPATCH(0x12, OP_FUNE,           opFcompare) \
+    SIMEX_DISPATCH(0x13, OP_FEQLE,          opFcompare) \
+    SIMEX_DISPATCH(0x14, OP_FDIV,           opFarith) \
+    SIMEX_DISPATCH(0x15, OP_FSQRT,          opFunary) \
+    SIMEX_DISPATCH(0x16, OP_FREM,           opFarith) \
+    SIMEX_DISPATCH(0x17, OP_FINT,           opFunary) \
+    SIMEX_DISPATCH(0x18, OP_MUL,            opMul) \
+    SIMEX_DISPATCH(0x19, OP_MULI,           opMul) \
+    SIMEX_DISPATCH(0x1A, OP_MULU,           opMulu) \
+    SIMEX_DISPATCH(0x1B, OP_MULUI,          opMulu) \
+    SIMEX_DISPATCH(0x1C, OP_DIV,            opDiv) \
+    SIMEX_DISPATCH(0x1D, OP_DIVI,           opDiv) \
+    SIMEX_DISPATCH(0x1E, OP_DIVU,           opDivu) \
+    SIMEX_DISPATCH(0x1F, OP_DIVUI,          opDivu) \
+    SIMEX_DISPATCH(0x20, OP_ADD,            opAdd) \
+    SIMEX_DISPATCH(0x21, OP_ADDI,           opAdd) \
+    SIMEX_DISPATCH(0x22, OP_ADDU,           opAddu) \
+    SIMEX_DISPATCH(0x23, OP_ADDUI,          opAddu) \
+    SIMEX_DISPATCH(0x24, OP_SUB,            opSub) \
+    SIMEX_DISPATCH(0x25, OP_SUBI,           opSub) \
+    SIMEX_DISPATCH(0x26, OP_SUBU,           opSubu) \
+    SIMEX_DISPATCH(0x27, OP_SUBUI,          opSubu) \
+    SIMEX_DISPATCH(0x28, OP_2ADDU,          opScaledAddu) \
+    SIMEX_DISPATCH(0x29, OP_2ADDUI,         opScaledAddu) \
+    SIMEX_DISPATCH(0x2A, OP_4ADDU,          opScaledAddu) \
+    SIMEX_DISPATCH(0x2B, OP_4ADDUI,         opScaledAddu) \
+    SIMEX_DISPATCH(0x2C, OP_8ADDU,          opScaledAddu) \
+    SIMEX_DISPATCH(0x2D, OP_8ADDUI,         opScaledAddu) \
+    SIMEX_DISPATCH(0x2E, OP_16ADDU,         opScaledAddu) \
+    SIMEX_DISPATCH(0x2F, OP_16ADDUI,        opScaledAddu) \
+    SIMEX_DISPATCH(0x30, OP_CMP,            opCmp) \
+    SIMEX_DISPATCH(0x31, OP_CMPI,           opCmp) \
+    SIMEX_DISPATCH(0x32, OP_CMPU,           opCmpu) \
+    SIMEX_DISPATCH(0x33, OP_CMPUI,          opCmpu) \
+    SIMEX_DISPATCH(0x34, OP_NEG,            opNeg) \
+    SIMEX_DISPATCH(0x35, OP_NEGI,           opNeg) \
+    SIMEX_DISPATCH(0x36, OP_NEGU,           opNegu) \
+    SIMEX_DISPATCH(0x37, OP_NEGUI,          opNegu) \
+    SIMEX_DISPATCH(0x38, OP_SL,             opSl) \
+    SIMEX_DISPATCH(0x39, OP_SLI,            opSl) \
+    SIMEX_DISPATCH(0x3A, OP_SLU,            opSlu) \
+    SIMEX_DISPATCH(0x3B, OP_SLUI,           opSlu) \
+    SIMEX_DISPATCH(0x3C, OP_SR,             opSr) \
+    SIMEX_DISPATCH(0x3D, OP_SRI,            opSr) \
+    SIMEX_DISPATCH(0x3E, OP_SRU,            opSru) \
+    SIMEX_DISPATCH(0x3F, OP_SRUI,           opSru) \
+    SIMEX_DISPATCH(0x40, OP_BN,             opBranch) \
+    SIMEX_DISPATCH(0x41, OP_BNB,            opBranch) \
+    SIMEX_DISPATCH(0x42, OP_BZ,             opBranch) \
+    SIMEX_DISPATCH(0x43, OP_BZB,            opBranch) \
+    SIMEX_DISPATCH(0x44, OP_BP,             opBranch) \
+    SIMEX_DISPATCH(0x45, OP_BPB,            opBranch) \
+    SIMEX_DISPATCH(0x46, OP_BOD,            opBranch) \
+    SIMEX_DISPATCH(0x47, OP_BODB,           opBranch) \
+    SIMEX_DISPATCH(0x48, OP_BNN,            opBranch) \
+    SIMEX_DISPATCH(0x49, OP_BNNB,           opBranch) \
+    SIMEX_DISPATCH(0x4A, OP_BNZ,            opBranch) \
+    SIMEX_DISPATCH(0x4B, OP_BNZB,           opBranch) \
+    SIMEX_DISPATCH(0x4C, OP_BNP,            opBranch) \
+    SIMEX_DISPATCH(0x4D, OP_BNPB,           opBranch) \
+    SIMEX_DISPATCH(0x4E, OP_BEV,            opBranch) \
+    SIMEX_DISPATCH(0x4F, OP_BEVB,           opBranch) \
+    SIMEX_DISPATCH(0x50, OP_PBN,            opBranch) \
+    SIMEX_DISPATCH(0x51, OP_PBNB,           opBranch) \
+    SIMEX_DISPATCH(0x52, OP_PBZ,            opBranch) \
+    SIMEX_DISPATCH(0x53, OP_PBZB,           opBranch) \
+    SIMEX_DISPATCH(0x54, OP_PBP,            opBranch) \
+    SIMEX_DISPATCH(0x55, OP_PBPB,           opBranch) \
+    SIMEX_DISPATCH(0x56, OP_PBOD,           opBranch) \
+    SIMEX_DISPATCH(0x57, OP_PBODB,          opBranch) \
+    SIMEX_DISPATCH(0x58, OP_PBNN,           opBranch) \
+    SIMEX_DISPATCH(0x59, OP_PBNNB,          opBranch) \
+    SIMEX_DISPATCH(0x5A, OP_PBNZ,           opBranch) \
+    SIMEX_DISPATCH(0x5B, OP_PBNZB,          opBranch) \
+    SIMEX_DISPATCH(0x5C, OP_PBNP,           opBranch) \
+    SIMEX_DISPATCH(0x5D, OP_PBNPB,          opBranch) \
+    SIMEX_DISPATCH(0x5E, OP_PBEV,           opBranch) \
+    SIMEX_DISPATCH(0x5F, OP_PBEVB,          opBranch) \
+    SIMEX_DISPATCH(0x60, OP_CSN,            opCs) \
+    SIMEX_DISPATCH(0x61, OP_CSNI,           opCs) \
+    SIMEX_DISPATCH(0x62, OP_CSZ,            opCs) \
+    SIMEX_DISPATCH(0x63, OP_CSZI,           opCs) \
+    SIMEX_DISPATCH(0x64, OP_CSP,            opCs) \
+    SIMEX_DISPATCH(0x65, OP_CSPI,           opCs) \
+    SIMEX_DISPATCH(0x66, OP_CSOD,           opCs) \
+    SIMEX_DISPATCH(0x67, OP_CSODI,          opCs) \
+    SIMEX_DISPATCH(0x68, OP_CSNN,           opCs) \
+    SIMEX_DISPATCH(0x69, OP_CSNNI,          opCs) \
+    SIMEX_DISPATCH(0x6A, OP_CSNZ,           opCs) \
+    SIMEX_DISPATCH(0x6B, OP_CSNZI,          opCs) \
+    SIMEX_DISPATCH(0x6C, OP_CSNP,           opCs) \
+    SIMEX_DISPATCH(0x6D, OP_CSNPI,          opCs) \
+    SIMEX_DISPATCH(0x6E, OP_CSEV,           opCs) \
+    SIMEX_DISPATCH(0x6F, OP_CSEVI,          opCs) \
+    SIMEX_DISPATCH(0x70, OP_ZSN,            opZs) \
+    SIMEX_DISPATCH(0x71, OP_ZSNI,           opZs) \
+    SIMEX_DISPATCH(0x72, OP_ZSZ,            opZs) \
+    SIMEX_DISPATCH(0x73, OP_ZSZI,           opZs) \
+    SIMEX_DISPATCH(0x74, OP_ZSP,            opZs) \
+    SIMEX_DISPATCH(0x75, OP_ZSPI,           opZs) \
+    SIMEX_DISPATCH(0x76, OP_ZSOD,           opZs) \
+    SIMEX_DISPATCH(0x77, OP_ZSODI,          opZs) \
+    SIMEX_DISPATCH(0x78, OP_ZSNN,           opZs) \
+    SIMEX_DISPATCH(0x79, OP_ZSNNI,          opZs) \
+    SIMEX_DISPATCH(0x7A, OP_ZSNZ,           opZs) \
+    SIMEX_DISPATCH(0x7B, OP_ZSNZI,          opZs) \
+    SIMEX_DISPATCH(0x7C, OP_ZSNP,           opZs) \
+    SIMEX_DISPATCH(0x7D, OP_ZSNPI,          opZs) \
+    SIMEX_DISPATCH(0x7E, OP_ZSEV,           opZs) \
+    SIMEX_DISPATCH(0x7F, OP_ZSEVI,          opZs) \
+    SIMEX_DISPATCH(0x80, OP_LDB,            opLoad) \
+    SIMEX_DISPATCH(0x81, OP_LDBI,           opLoad) \
+    SIMEX_DISPATCH(0x82, OP_LDBU,           opLoad) \
+    SIMEX_DISPATCH(0x83, OP_LDBUI,          opLoad) \
+    SIMEX_DISPATCH(0x84, OP_LDW,            opLoad) \
+    SIMEX_DISPATCH(0x85, OP_LDWI,           opLoad) \
+    SIMEX_DISPATCH(0x86, OP_LDWU,           opLoad) \
+    SIMEX_DISPATCH(0x87, OP_LDWUI,          opLoad) \
+    SIMEX_DISPATCH(0x88, OP_LDT,            opLoad) \
+    SIMEX_DISPATCH(0x89, OP_LDTI,           opLoad) \
+    SIMEX_DISPATCH(0x8A, OP_LDTU,           opLoad) \
+    SIMEX_DISPATCH(0x8B, OP_LDTUI,          opLoad) \
+    SIMEX_DISPATCH(0x8C, OP_LDO,            opLoad) \
+    SIMEX_DISPATCH(0x8D, OP_LDOI,           opLoad) \
+    SIMEX_DISPATCH(0x8E, OP_LDOU,           opLoad) \
+    SIMEX_DISPATCH(0x8F, OP_LDOUI,          opLoad) \
+    SIMEX_DISPATCH(0x90, OP_LDSF,           opLdsf) \
+    SIMEX_DISPATCH(0x91, OP_LDSFI,          opLdsf) \
+    SIMEX_DISPATCH(0x92, OP_LDHT,           opLdht) \
+    SIMEX_DISPATCH(0x93, OP_LDHTI,          opLdht) \
+    SIMEX_DISPATCH(0x94, OP_CSWAP,          opCswap) \
+    SIMEX_DISPATCH(0x95, OP_CSWAPI,         opCswap) \
+    SIMEX_DISPATCH(0x96, OP_LDUNC,          opLdunc) \
+    SIMEX_DISPATCH(0x97, OP_LDUNCI,         opLdunc) \
+    SIMEX_DISPATCH(0x98, OP_RESERVED_x98,   opInvalid) \
+    SIMEX_DISPATCH(0x99, OP_RESERVED_x99,   opInvalid) \
+    SIMEX_DISPATCH(0x9A, OP_RESERVED_x9A,   opInvalid) \
+    SIMEX_DISPATCH(0x9B, OP_RESERVED_x9B,   opInvalid) \
+    SIMEX_DISPATCH(0x9C, OP_RESERVED_x9C,   opInvalid) \
+    SIMEX_DISPATCH(0x9D, OP_RESERVED_x9D,   opInvalid) \
+    SIMEX_DISPATCH(0x9E, OP_GO,             opGo) \
+    SIMEX_DISPATCH(0x9F, OP_GOI,            opGo) \
+    SIMEX_DISPATCH(0xA0, OP_STB,            opStore) \
+    SIMEX_DISPATCH(0xA1, OP_STBI,           opStore) \
+    SIMEX_DISPATCH(0xA2, OP_STBU,           opStore) \
+    SIMEX_DISPATCH(0xA3, OP_STBUI,          opStore) \
+    SIMEX_DISPATCH(0xA4, OP_STW,            opStore) \
+    SIMEX_DISPATCH(0xA5, OP_STWI,           opStore) \
+    SIMEX_DISPATCH(0xA6, OP_STWU,           opStore) \
+    SIMEX_DISPATCH(0xA7, OP_STWUI,          opStore) \
+    SIMEX_DISPATCH(0xA8, OP_STT,            opStore) \
+    SIMEX_DISPATCH(0xA9, OP_STTI,           opStore) \
+    SIMEX_DISPATCH(0xAA, OP_STTU,           opStore) \
+    SIMEX_DISPATCH(0xAB, OP_STTUI,          opStore) \
+    SIMEX_DISPATCH(0xAC, OP_STO,            opStore) \
+    SIMEX_DISPATCH(0xAD, OP_STOI,           opStore) \
+    SIMEX_DISPATCH(0xAE, OP_STOU,           opStore) \
+    SIMEX_DISPATCH(0xAF, OP_STOUI,          opStore) \
+    SIMEX_DISPATCH(0xB0, OP_STSF,           opStsf) \
+    SIMEX_DISPATCH(0xB1, OP_STSFI,          opStsf) \
+    SIMEX_DISPATCH(0xB2, OP_STHT,           opStht) \
+    SIMEX_DISPATCH(0xB3, OP_STHTI,          opStht) \
+    SIMEX_DISPATCH(0xB4, OP_STCO,           opStco) \
+    SIMEX_DISPATCH(0xB5, OP_STCOI,          opStco) \
+    SIMEX_DISPATCH(0xB6, OP_STUNC,          opStunc) \
+    SIMEX_DISPATCH(0xB7, OP_STUNCI,         opStunc) \
+    SIMEX_DISPATCH(0xB8, OP_RESERVED_xB8,   opInvalid) \
+    SIMEX_DISPATCH(0xB9, OP_RESERVED_xB9,   opInvalid) \
+    SIMEX_DISPATCH(0xBA, OP_RESERVED_xBA,   opInvalid) \
+    SIMEX_DISPATCH(0xBB, OP_RESERVED_xBB,   opInvalid) \
+    SIMEX_DISPATCH(0xBC, OP_RESERVED_xBC,   opInvalid) \
+    SIMEX_DISPATCH(0xBD, OP_RESERVED_xBD,   opInvalid) \
+    SIMEX_DISPATCH(0xBE, OP_PUSHGO,         opPushgo) \
+    SIMEX_DISPATCH(0xBF, OP_PUSHGOI,        opPushgo) \
+    SIMEX_DISPATCH(0xC0, OP_OR,             opLogic) \
+    SIMEX_DISPATCH(0xC1, OP_ORI,            opLogic) \
+    SIMEX_DISPATCH(0xC2, OP_ORN,            opLogic) \
+    SIMEX_DISPATCH(0xC3, OP_ORNI,           opLogic) \
+    SIMEX_DISPATCH(0xC4, OP_NOR,            opLogic) \
+    SIMEX_DISPATCH(0xC5, OP_NORI,           opLogic) \
+    SIMEX_DISPATCH(0xC6, OP_XOR,            opLogic) \
+    SIMEX_DISPATCH(0xC7, OP_XORI,           opLogic) \
+    SIMEX_DISPATCH(0xC8, OP_AND,            opLogic) \
+    SIMEX_DISPATCH(0xC9, OP_ANDI,           opLogic) \
+    SIMEX_DISPATCH(0xCA, OP_ANDN,           opLogic) \
+    SIMEX_DISPATCH(0xCB, OP_ANDNI,          opLogic) \
+    SIMEX_DISPATCH(0xCC, OP_NAND,           opLogic) \
+    SIMEX_DISPATCH(0xCD, OP_NANDI,          opLogic) \
+    SIMEX_DISPATCH(0xCE, OP_NXOR,           opLogic) \
+    SIMEX_DISPATCH(0xCF, OP_NXORI,          opLogic) \
+    SIMEX_DISPATCH(0xD0, OP_RESERVED_xD0,   opInvalid) \
+    SIMEX_DISPATCH(0xD1, OP_RESERVED_xD1,   opInvalid) \
+    SIMEX_DISPATCH(0xD2, OP_RESERVED_xD2,   opInvalid) \
+    SIMEX_DISPATCH(0xD3, OP_RESERVED_xD3,   opInvalid) \
+    SIMEX_DISPATCH(0xD4, OP_RESERVED_xD4,   opInvalid) \
+    SIMEX_DISPATCH(0xD5, OP_RESERVED_xD5,   opInvalid) \
+    SIMEX_DISPATCH(0xD6, OP_RESERVED_xD6,   opInvalid) \
+    SIMEX_DISPATCH(0xD7, OP_RESERVED_xD7,   opInvalid) \
+    SIMEX_DISPATCH(0xD8, OP_MUX,            opMux) \
+    SIMEX_DISPATCH(0xD9, OP_MUXI,           opMux) \
+    SIMEX_DISPATCH(0xDA, OP_RESERVED_xDA,   opInvalid) \
+    SIMEX_DISPATCH(0xDB, OP_RESERVED_xDB,   opInvalid) \
+    SIMEX_DISPATCH(0xDC, OP_RESERVED_xDC,   opInvalid) \
+    SIMEX_DISPATCH(0xDD, OP_RESERVED_xDD,   opInvalid) \
+    SIMEX_DISPATCH(0xDE, OP_RESERVED_xDE,   opInvalid) \
+    SIMEX_DISPATCH(0xDF, OP_RESERVED_xDF,   opInvalid) \
+    SIMEX_DISPATCH(0xE0, OP_SETH,           opSet) \
+    SIMEX_DISPATCH(0xE1, OP_SETMH,          opSet) \
+    SIMEX_DISPATCH(0xE2, OP_SETML,          opSet) \
+    SIMEX_DISPATCH(0xE3, OP_SETL,           opSet) \
+    SIMEX_DISPATCH(0xE4, OP_INCH,           opInc) \
+    SIMEX_DISPATCH(0xE5, OP_INCMH,          opInc) \
+    SIMEX_DISPATCH(0xE6, OP_INCML,          opInc) \
+    SIMEX_DISPATCH(0xE7, OP_INCL,           opInc) \
+    SIMEX_DISPATCH(0xE8, OP_ORH,            opOrw) \
+    SIMEX_DISPATCH(0xE9, OP_ORMH,           opOrw) \
+    SIMEX_DISPATCH(0xEA, OP_ORML,           opOrw) \
+    SIMEX_DISPATCH(0xEB, OP_ORL,            opOrw) \
+    SIMEX_DISPATCH(0xEC, OP_ANDNH,          opAndnw) \
+    SIMEX_DISPATCH(0xED, OP_ANDNMH,         opAndnw) \
+    SIMEX_DISPATCH(0xEE, OP_ANDNML,         opAndnw) \
+    SIMEX_DISPATCH(0xEF, OP_ANDNL,          opAndnw) \
+    SIMEX_DISPATCH(0xF0, OP_JMP,            opJmp) \
+    SIMEX_DISPATCH(0xF1, OP_JMPB,           opJmp) \
+    SIMEX_DISPATCH(0xF2, OP_PUSHJ,          opPushj) \
+    SIMEX_DISPATCH(0xF3, OP_PUSHJB,         opPushj) \
+    SIMEX_DISPATCH(0xF4, OP_GETA,           opGeta) \
+    SIMEX_DISPATCH(0xF5, OP_GETAB,          opGeta) \
+    SIMEX_DISPATCH(0xF6, OP_PUT,            opPut) \
+    SIMEX_DISPATCH(0xF7, OP_PUTI,           opPut) \
+    SIMEX_DISPATCH(0xF8, OP_POP,            opPop) \
+    SIMEX_DISPATCH(0xF9, OP_RESUME,         opResume) \
+    SIMEX_DISPATCH(0xFA, OP_SAVE,           opSave) \
+    SIMEX_DISPATCH(0xFB, OP_UNSAVE,         opUnsave) \
+    SIMEX_DISPATCH(0xFC, OP_SYNC,           opSync) \
+    SIMEX_DISPATCH(0xFD, OP_SWYM,           opNop) \
+    SIMEX_DISPATCH(0xFE, OP_GET,            opGet) \
+    SIMEX_DISPATCH(0xFF, OP_RESERVED_xFF,   opInvalid)
+
+/**
+ * Expand SIMEX_HANDLER(handler) once for each distinct handler in
+ * SIMEX_DISPATCH_TABLE.
+ */
+#define SIMEX_HANDLER_LIST \
+    SIMEX_HANDLER(opSyscall) \
+    SIMEX_HANDLER(opFcompare) \
+    SIMEX_HANDLER(opFarith) \
+    SIMEX_HANDLER(opFix) \
+    SIMEX_HANDLER(opFlot) \
+    SIMEX_HANDLER(opFunary) \
+    SIMEX_HANDLER(opMul) \
+    SIMEX_HANDLER(opMulu) \
+    SIMEX_HANDLER(opDiv) \
+    SIMEX_HANDLER(opDivu) \
+    SIMEX_HANDLER(opAdd) \
+    SIMEX_HANDLER(opAddu) \
+    SIMEX_HANDLER(opSub) \
+    SIMEX_HANDLER(opSubu) \
+    SIMEX_HANDLER(opScaledAddu) \
+    SIMEX_HANDLER(opCmp) \
+    SIMEX_HANDLER(opCmpu) \
+    SIMEX_HANDLER(opNeg) \
+    SIMEX_HANDLER(opNegu) \
+    SIMEX_HANDLER(opSl) \
+    SIMEX_HANDLER(opSlu) \
+    SIMEX_HANDLER(opSr) \
+    SIMEX_HANDLER(opSru) \
+    SIMEX_HANDLER(opBranch) \
+    SIMEX_HANDLER(opCs) \
+    SIMEX_HANDLER(opZs) \
+    SIMEX_HANDLER(opLoad) \
+    SIMEX_HANDLER(opLdsf) \
+    SIMEX_HANDLER(opLdht) \
+    SIMEX_HANDLER(opCswap) \
+    SIMEX_HANDLER(opLdunc) \
+    SIMEX_HANDLER(opInvalid) \
+    SIMEX_HANDLER(opGo) \
+    SIMEX_HANDLER(opStore) \
+    SIMEX_HANDLER(opStsf) \
+    SIMEX_HANDLER(opStht) \
+    SIMEX_HANDLER(opStco) \
+    SIMEX_HANDLER(opStunc) \
+    SIMEX_HANDLER(opPushgo) \
+    SIMEX_HANDLER(opLogic) \
+    SIMEX_HANDLER(opMux) \
+    SIMEX_HANDLER(opSet) \
+    SIMEX_HANDLER(opInc) \
+    SIMEX_HANDLER(opOrw) \
+    SIMEX_HANDLER(opAndnw) \
+    SIMEX_HANDLER(opJmp) \
+    SIMEX_HANDLER(opPushj) \
+    SIMEX_HANDLER(opGeta) \
+    SIMEX_HANDLER(opPut) \
+    SIMEX_HANDLER(opPop) \
+    SIMEX_HANDLER(opResume) \
+    SIMEX_HANDLER(opSave) \
+    SIMEX_HANDLER(opUnsave) \
+    SIMEX_HANDLER(opUnsupported) \
+    SIMEX_HANDLER(opSync) \
+    SIMEX_HANDLER(opNop) \
+    SIMEX_HANDLER(opGet)
+
+/**
+ * Expand SIMEX_FUSED_HANDLER(handler) once for each superinstruction handler,
+ * for the handler which runs a block compiled by the JIT, and for the
+ * handlers which count the entries to a block and wait for its code until
+ * it is compiled.  These handlers are only selected by the predecoder.
+ */
+#define SIMEX_FUSED_HANDLER_LIST \
+    SIMEX_FUSED_HANDLER(fuseSetConstant) \
+    SIMEX_FUSED_HANDLER(fuseCompareBranch) \
+    SIMEX_FUSED_HANDLER(fuseScaledLoad) \
+    SIMEX_FUSED_HANDLER(fuseScaledLoadNative) \
+    SIMEX_FUSED_HANDLER(fuseGetaPushgo) \
+    SIMEX_FUSED_HANDLER(fuseStoreConstantRun) \
+    SIMEX_FUSED_HANDLER(fuseStoreConstantRunNative) \
+    SIMEX_FUSED_HANDLER(fuseStoreUncachedRun) \
+    SIMEX_FUSED_HANDLER(fuseStoreUncachedRunNative) \
+    SIMEX_FUSED_HANDLER(runCompiled) \
+    SIMEX_FUSED_HANDLER(profileBlock) \
+    SIMEX_FUSED_HANDLER(awaitCompiled)
+
+/**
+ * Expand SIMEX_CALL_HANDLER(name, handler, opcode, count) once for each call
+ * or return handler specialized for a small register count.  PUSHJ, PUSHJB,
+ * PUSHGO, and PUSHGOI are specialized for the number of registers that they
+ * hide, and POP for the number of registers that it returns.  These handlers
+ * are only selected by the predecoder.
+ */
+#define SIMEX_CALL_HANDLER_LIST \
+    SIMEX_CALL_HANDLER(PUSHJ_0,     opPushjCount,   OP_PUSHJ,   0) \
+    SIMEX_CALL_HANDLER(PUSHJ_1,     opPushjCount,   OP_PUSHJ,   1) \
+    SIMEX_CALL_HANDLER(PUSHJ_2,     opPushjCount,   OP_PUSHJ,   2) \
+    SIMEX_CALL_HANDLER(PUSHJ_3,     opPushjCount,   OP_PUSHJ,   3) \
+    SIMEX_CALL_HANDLER(PUSHJ_4,     opPushjCount,   OP_PUSHJ,   4) \
+    SIMEX_CALL_HANDLER(PUSHGO_0,    opPushgoCount,  OP_PUSHGO,  0) \
+    SIMEX_CALL_HANDLER(PUSHGO_1,    opPushgoCount,  OP_PUSHGO,  1) \
+    SIMEX_CALL_HANDLER(PUSHGO_2,    opPushgoCount,  OP_PUSHGO,  2) \
+    SIMEX_CALL_HANDLER(PUSHGO_3,    opPushgoCount,  OP_PUSHGO,  3) \
+    SIMEX_CALL_HANDLER(PUSHGO_4,    opPushgoCount,  OP_PUSHGO,  4) \
+    SIMEX_CALL_HANDLER(PUSHGOI_0,   opPushgoCount,  OP_PUSHGOI, 0) \
+    SIMEX_CALL_HANDLER(PUSHGOI_1,   opPushgoCount,  OP_PUSHGOI, 1) \
+    SIMEX_CALL_HANDLER(PUSHGOI_2,   opPushgoCount,  OP_PUSHGOI, 2) \
+    SIMEX_CALL_HANDLER(PUSHGOI_3,   opPushgoCount,  OP_PUSHGOI, 3) \
+    SIMEX_CALL_HANDLER(PUSHGOI_4,   opPushgoCount,  OP_PUSHGOI, 4) \
+    SIMEX_CALL_HANDLER(POP_0,       opPopCount,     OP_POP,     0) \
+    SIMEX_CALL_HANDLER(POP_1,       opPopCount,     OP_POP,     1)
+
+/**
+ * Expand SIMEX_NATIVE_HANDLER(name, handler, opcode) once for each load or
+ * store handler specialized for memory with the native byte order.  These
+ * handlers are only selected by the predecoder.
+ */
+#define SIMEX_NATIVE_HANDLER_LIST \
+    SIMEX_NATIVE_HANDLER(LDB_NATIVE,     opLoad,     OP_LDB) \
+    SIMEX_NATIVE_HANDLER(LDBI_NATIVE,    opLoad,     OP_LDBI) \
+    SIMEX_NATIVE_HANDLER(LDBU_NATIVE,    opLoad,     OP_LDBU) \
+    SIMEX_NATIVE_HANDLER(LDBUI_NATIVE,   opLoad,     OP_LDBUI) \
+    SIMEX_NATIVE_HANDLER(LDW_NATIVE,     opLoad,     OP_LDW) \
+    SIMEX_NATIVE_HANDLER(LDWI_NATIVE,    opLoad,     OP_LDWI) \
+    SIMEX_NATIVE_HANDLER(LDWU_NATIVE,    opLoad,     OP_LDWU) \
+    SIMEX_NATIVE_HANDLER(LDWUI_NATIVE,   opLoad,     OP_LDWUI) \
+    SIMEX_NATIVE_HANDLER(LDT_NATIVE,     opLoad,     OP_LDT) \
+    SIMEX_NATIVE_HANDLER(LDTI_NATIVE,    opLoad,     OP_LDTI) \
+    SIMEX_NATIVE_HANDLER(LDTU_NATIVE,    opLoad,     OP_LDTU) \
+    SIMEX_NATIVE_HANDLER(LDTUI_NATIVE,   opLoad,     OP_LDTUI) \
+    SIMEX_NATIVE_HANDLER(LDO_NATIVE,     opLoad,     OP_LDO) \
+    SIMEX_NATIVE_HANDLER(LDOI_NATIVE,    opLoad,     OP_LDOI) \
+    SIMEX_NATIVE_HANDLER(LDOU_NATIVE,    opLoad,     OP_LDOU) \
+    SIMEX_NATIVE_HANDLER(LDOUI_NATIVE,   opLoad,     OP_LDOUI) \
+    SIMEX_NATIVE_HANDLER(LDSF_NATIVE,    opLdsf,     OP_LDSF) \
+    SIMEX_NATIVE_HANDLER(LDSFI_NATIVE,   opLdsf,     OP_LDSFI) \
+    SIMEX_NATIVE_HANDLER(LDHT_NATIVE,    opLdht,     OP_LDHT) \
+    SIMEX_NATIVE_HANDLER(LDHTI_NATIVE,   opLdht,     OP_LDHTI) \
+    SIMEX_NATIVE_HANDLER(CSWAP_NATIVE,   opCswap,    OP_CSWAP) \
+    SIMEX_NATIVE_HANDLER(CSWAPI_NATIVE,  opCswap,    OP_CSWAPI) \
+    SIMEX_NATIVE_HANDLER(LDUNC_NATIVE,   opLdunc,    OP_LDUNC) \
+    SIMEX_NATIVE_HANDLER(LDUNCI_NATIVE,  opLdunc,    OP_LDUNCI) \
+    SIMEX_NATIVE_HANDLER(STB_NATIVE,     opStore,    OP_STB) \
+    SIMEX_NATIVE_HANDLER(STBI_NATIVE,    opStore,    OP_STBI) \
+    SIMEX_NATIVE_HANDLER(STBU_NATIVE,    opStore,    OP_STBU) \
+    SIMEX_NATIVE_HANDLER(STBUI_NATIVE,   opStore,    OP_STBUI) \
+    SIMEX_NATIVE_HANDLER(STW_NATIVE,     opStore,    OP_STW) \
+    SIMEX_NATIVE_HANDLER(STWI_NATIVE,    opStore,    OP_STWI) \
+    SIMEX_NATIVE_HANDLER(STWU_NATIVE,    opStore,    OP_STWU) \
+    SIMEX_NATIVE_HANDLER(STWUI_NATIVE,   opStore,    OP_STWUI) \
+    SIMEX_NATIVE_HANDLER(STT_NATIVE,     opStore,    OP_STT) \
+    SIMEX_NATIVE_HANDLER(STTI_NATIVE,    opStore,    OP_STTI) \
+    SIMEX_NATIVE_HANDLER(STTU_NATIVE,    opStore,    OP_STTU) \
+    SIMEX_NATIVE_HANDLER(STTUI_NATIVE,   opStore,    OP_STTUI) \
+    SIMEX_NATIVE_HANDLER(STO_NATIVE,     opStore,    OP_STO) \
+    SIMEX_NATIVE_HANDLER(STOI_NATIVE,    opStore,    OP_STOI) \
+    SIMEX_NATIVE_HANDLER(STOU_NATIVE,    opStore,    OP_STOU) \
+    SIMEX_NATIVE_HANDLER(STOUI_NATIVE,   opStore,    OP_STOUI) \
+    SIMEX_NATIVE_HANDLER(STSF_NATIVE,    opStsf,     OP_STSF) \
+    SIMEX_NATIVE_HANDLER(STSFI_NATIVE,   opStsf,     OP_STSFI) \
+    SIMEX_NATIVE_HANDLER(STHT_NATIVE,    opStht,     OP_STHT) \
+    SIMEX_NATIVE_HANDLER(STHTI_NATIVE,   opStht,     OP_STHTI) \
+    SIMEX_NATIVE_HANDLER(STCO_NATIVE,    opStco,     OP_STCO) \
+    SIMEX_NATIVE_HANDLER(STCOI_NATIVE,   opStco,     OP_STCOI) \
+    SIMEX_NATIVE_HANDLER(STUNC_NATIVE,   opStunc,    OP_STUNC) \
+    SIMEX_NATIVE_HANDLER(STUNCI_NATIVE,  opStunc,    OP_STUNCI)
+
+#endif //SIMEX_MACHINE_STATE_DISPATCH_TABLE_HEADER_GUARD
@@ -0,0 +1,41 @@
+/**
+ * \file MachineState/evaluate.cpp
+ *
+ * Implementation of MachineState::evaluate().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/MachineState.h>
+
+#include "MachineStateImplementation.h"
+#include "PredecodedInstruction.h"
+#include "handlers.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Evaluate a single instruction as if it had been fetched from the current
+ * program counter.
+ *
+ * \param ins       The instruction to evaluate.
+ */
+void MachineState::evaluate(DecodedInstruction ins)
+{
+    PredecodedInstruction p;
+
+    //the host may have changed segments since the last instruction.
+    syncTlb(impl_.get());
+    predecodeInstruction(&p, impl_->pc, ins, impl_->space->byteOrder());
+    evaluateRecord(impl_.get(), p);
+    ++impl_->instructions;
+
+    //there is no interpreter loop to stop, so a deferred fault is raised now.
+    if (SIMEX_UNLIKELY(Fault::None != impl_->deferredFault))
+        raiseDeferredFault(impl_.get());
+}
@@ -0,0 +1,26 @@
+/**
+ * \file MachineState/exitCode.cpp
+ *
+ * Implementation of MachineState::exitCode().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/MachineState.h>
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Get the exit code passed to halt().
+ */
+uint64_t MachineState::exitCode() const
+{
+    return impl_->exitCode;
+}
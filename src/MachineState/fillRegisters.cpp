@@ -0,0 +1,46 @@
+/**
+ * \file MachineState/fillRegisters.cpp
+ *
+ * Fill registers from the rS region back into the local register ring.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <algorithm>
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Fill registers from the rS region back into the ring, so that offsets from
+ * bottom up to rO + rL are all held in the ring.
+ *
+ * \param m         The machine state.
+ * \param bottom    The lowest offset which must be in the ring.
+ */
+void simex::fillRegisters(MachineStateImplementation* m, uint64_t bottom)
+{
+    uint64_t top = sr(m, SReg::SR_RO) + sr(m, SReg::SR_RL);
+
+    //fill up to half of the ring, so that returns which go back and forth
+    //across the edge of the ring don't fill every time.
+    if (top > RING_SIZE / 2)
+        bottom = min(bottom, top - RING_SIZE / 2);
+    else
+        bottom = 0;
+
+    for (uint64_t k = bottom; k < m->spilled; ++k)
+    {
+        writeRing(m, k, m->backing[k]);
+        m->backing[k] = 0;
+    }
+
+    if (bottom < m->spilled)
+        m->spilled = bottom;
+}
@@ -0,0 +1,49 @@
+/**
+ * \file MachineState/flushTlb.cpp
+ *
+ * Invalidate every entry in the software TLB.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <cstring>
+
+#include "PredecodedInstruction.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Invalidate every entry in the software TLB, and record the generation of
+ * the address space.  Every byte of an invalid tag is 0xFF.  The predecoded
+ * block caches of segments which were since unmapped or changed are
+ * released as well.
+ *
+ * \param m         The machine state.
+ */
+void simex::flushTlb(MachineStateImplementation* m)
+{
+    memset(m->tlb, 0xFF, sizeof(m->tlb));
+    m->tlbGeneration = m->space->generation();
+
+    for (auto i = m->caches.begin(); i != m->caches.end();)
+    {
+        Segment* seg = m->space->find(i->first);
+
+        if (nullptr == seg || seg->version() != i->second->version)
+        {
+            if (m->code == i->second.get())
+                m->code = nullptr;
+
+            i = m->caches.erase(i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
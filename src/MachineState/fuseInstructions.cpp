@@ -0,0 +1,200 @@
+/**
+ * \file MachineState/fuseInstructions.cpp
+ *
+ * Combine common instruction sequences in a predecoded block into
+ * superinstructions.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include "PredecodedInstruction.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * The maximum number of instructions which build a constant: SET and three
+ * more wydes.
+ */
+static const size_t MAX_CONSTANT_INSTRUCTIONS = 4;
+
+/**
+ * Returns true if this is a branch on negative, zero, positive, or nonzero.
+ */
+static bool isSignBranch(const PredecodedInstruction& p)
+{
+    if (HANDLER_opBranch != p.handler)
+        return false;
+
+    switch (p.ins.traits().condition)
+    {
+        case 0: case 1: case 2: case 5:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+/**
+ * Returns true if this is an 8ADDU or 8ADDUI.
+ */
+static bool isScaledAddu8(const PredecodedInstruction& p)
+{
+    return Opcode::OP_8ADDU == p.opcode() || Opcode::OP_8ADDUI == p.opcode();
+}
+
+/**
+ * Returns true if this is an LDO or LDOI.
+ */
+static bool isLoadOcta(const PredecodedInstruction& p)
+{
+    return Opcode::OP_LDO == p.opcode() || Opcode::OP_LDOI == p.opcode();
+}
+
+/**
+ * Returns true if b continues a run of STCOI or STUNCI which starts with a,
+ * as the nth store of the run: the same opcode and base register, and the
+ * octa following the previous store.  STCOI must also store the same
+ * constant.
+ */
+static bool
+continuesStoreRun(
+    const PredecodedInstruction& a, const PredecodedInstruction& b, size_t n)
+{
+    return b.opcode() == a.opcode() && b.y() == a.y()
+        && (size_t)b.z() == a.z() + 8 * n
+        && (Opcode::OP_STUNCI == a.opcode() || b.x() == a.x());
+}
+
+/**
+ * Find the number of instructions in the superinstruction starting at in,
+ * and its dispatch index.
+ *
+ * \returns the number of instructions fused, or 1 if none were.
+ */
+static size_t
+match(const PredecodedInstruction* in, size_t count, uint16_t* dispatch,
+      uint64_t* imm)
+{
+    const PredecodedInstruction& a = in[0];
+
+    //SETx followed by INCx or ORx on the same register.
+    if (HANDLER_opSet == a.handler)
+    {
+        uint64_t value = a.imm;
+        size_t n = 1;
+
+        while (n < count && n < MAX_CONSTANT_INSTRUCTIONS
+            && in[n].x() == a.x()
+            && (HANDLER_opOrw == in[n].handler
+             || HANDLER_opInc == in[n].handler))
+        {
+            if (HANDLER_opOrw == in[n].handler)
+                value |= in[n].imm;
+            else
+                value += in[n].imm;
+
+            ++n;
+        }
+
+        *dispatch = DISPATCH_fuseSetConstant;
+        *imm = value;
+
+        return n;
+    }
+
+    //STCOI or STUNCI to consecutive octas through the same base register.
+    if (Opcode::OP_STCOI == a.opcode() || Opcode::OP_STUNCI == a.opcode())
+    {
+        bool native = opcode2byte(a.opcode()) != a.dispatch;
+        size_t n = 1;
+
+        while (n < count && continuesStoreRun(a, in[n], n))
+            ++n;
+
+        if (Opcode::OP_STCOI == a.opcode())
+            *dispatch = native
+                ? DISPATCH_fuseStoreConstantRunNative
+                : DISPATCH_fuseStoreConstantRun;
+        else
+            *dispatch = native
+                ? DISPATCH_fuseStoreUncachedRunNative
+                : DISPATCH_fuseStoreUncachedRun;
+
+        return n;
+    }
+
+    if (count < 2)
+        return 1;
+
+    const PredecodedInstruction& b = in[1];
+
+    if (HANDLER_opCmp == a.handler && isSignBranch(b) && b.x() == a.x())
+    {
+        *dispatch = DISPATCH_fuseCompareBranch;
+        return 2;
+    }
+
+    if (isScaledAddu8(a) && isLoadOcta(b) && b.y() == a.x())
+    {
+        *dispatch = opcode2byte(b.opcode()) == b.dispatch
+            ? DISPATCH_fuseScaledLoad : DISPATCH_fuseScaledLoadNative;
+        return 2;
+    }
+
+    if (HANDLER_opGeta == a.handler && HANDLER_opPushgo == b.handler
+     && b.y() == a.x())
+    {
+        *dispatch = DISPATCH_fuseGetaPushgo;
+        return 2;
+    }
+
+    return 1;
+}
+
+/**
+ * Combine common instruction sequences into superinstructions.
+ *
+ * \param in        The ordinary records for a block, without the sentinel.
+ * \param count     The number of records in the block.
+ * \param out       The output records, which must have room for at least
+ *                  count + count / 2 records.
+ *
+ * \returns the number of records written to out.
+ */
+size_t simex::fuseInstructions(
+    const PredecodedInstruction* in, size_t count, PredecodedInstruction* out)
+{
+    size_t written = 0;
+    size_t i = 0;
+
+    while (i < count)
+    {
+        uint16_t dispatch = 0;
+        uint64_t imm = 0;
+        size_t n = match(in + i, count - i, &dispatch, &imm);
+
+        //a superinstruction record precedes the records it covers.
+        if (n > 1)
+        {
+            PredecodedInstruction& fused = out[written++];
+
+            fused = in[i];
+            fused.dispatch = dispatch;
+            fused.imm = imm;
+            fused.count = static_cast<uint8_t>(n);
+        }
+
+        for (size_t k = 0; k < n; ++k)
+            out[written++] = in[i + k];
+
+        i += n;
+    }
+
+    return written;
+}
@@ -0,0 +1,357 @@
+/**
+ * \file MachineState/fusedHandlers.h
+ *
+ * Superinstruction handlers, which run a common sequence of instructions with
+ * a single dispatch.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#ifndef  SIMEX_MACHINE_STATE_FUSED_HANDLERS_HEADER_GUARD
+# define SIMEX_MACHINE_STATE_FUSED_HANDLERS_HEADER_GUARD
+
+#include <cstdint>
+#include <cstring>
+
+#include "CompileQueue.h"
+#include "MachineStateImplementation.h"
+#include "PredecodedInstruction.h"
+#include "handlers.h"
+
+//this header is C++ specific
+#ifdef __cplusplus
+
+namespace simex {
+
+/*
+ * Each superinstruction handler is entered with one instruction already
+ * charged to the instruction budget, and returns the next record to run, or
+ * nullptr if control leaves the block.  The records for the individual
+ * instructions follow the superinstruction record, so each part is evaluated
+ * by its ordinary handler, and faults report exactly the state of the
+ * instruction which faulted.  Each part is run by the specialized handler
+ * for its opcode; parts which have a register and an immediate form choose
+ * between the two with a single predictable test.
+ */
+
+/**
+ * Charge the rest of a superinstruction to the instruction budget.  If there
+ * isn't enough budget left, the first instruction is refunded and the
+ * ordinary records are run instead.
+ *
+ * \returns true if the superinstruction can run.
+ */
+inline bool
+chargeFused(MachineStateImplementation* m, const PredecodedInstruction* p)
+{
+    std::uint64_t extra = p->count - 1;
+
+    if (SIMEX_UNLIKELY(m->remaining < extra))
+    {
+        ++m->remaining;
+        return false;
+    }
+
+    m->remaining -= extra;
+    m->fusedInstructions += extra;
+
+    return true;
+}
+
+/**
+ * SETH/SETMH/SETML/SETL followed by INC or OR of other wydes of the same
+ * register.  The constant is folded by the predecoder.
+ */
+inline PredecodedInstruction*
+fuseSetConstant(MachineStateImplementation* m, PredecodedInstruction* p)
+{
+    if (!chargeFused(m, p))
+        return p + 1;
+
+    writeReg(m, p->x(), p->imm);
+    m->pc += 4 * p->count;
+
+    return p + p->count + 1;
+}
+
+/**
+ * CMP or CMPI followed by BN, BZ, BP, or BNZ on the comparison result.
+ */
+inline PredecodedInstruction*
+fuseCompareBranch(MachineStateImplementation* m, PredecodedInstruction* p)
+{
+    if (!chargeFused(m, p))
+        return p + 1;
+
+    if (Opcode::OP_CMPI == p[1].opcode())
+        opCmp<Opcode::OP_CMPI>(m, p[1]);
+    else
+        opCmp<Opcode::OP_CMP>(m, p[1]);
+
+    //the branch target is precomputed, so only the condition varies.
+    if (condition(p[2].ins.traits().condition, readReg(m, p[2].x())))
+        m->pc = p[2].target;
+    else
+        advance(m);
+
+    return nullptr;
+}
+
+/**
+ * 8ADDU or 8ADDUI followed by LDO or LDOI from the scaled address, from
+ * memory with the given byte order.
+ */
+template <bool NATIVE>
+inline PredecodedInstruction*
+scaledLoad(MachineStateImplementation* m, PredecodedInstruction* p)
+{
+    if (!chargeFused(m, p))
+        return p + 1;
+
+    if (Opcode::OP_8ADDUI == p[1].opcode())
+        opScaledAddu<Opcode::OP_8ADDUI>(m, p[1]);
+    else
+        opScaledAddu<Opcode::OP_8ADDU>(m, p[1]);
+
+    bool loaded = Opcode::OP_LDOI == p[2].opcode()
+        ? opLoad<Opcode::OP_LDOI, NATIVE>(m, p[2])
+        : opLoad<Opcode::OP_LDO, NATIVE>(m, p[2]);
+    if (SIMEX_UNLIKELY(!loaded))
+        return nullptr;
+
+    return p + 3;
+}
+
+/**
+ * 8ADDU or 8ADDUI followed by LDO or LDOI from the scaled address.
+ */
+inline PredecodedInstruction*
+fuseScaledLoad(MachineStateImplementation* m, PredecodedInstruction* p)
+{
+    return scaledLoad<false>(m, p);
+}
+
+/**
+ * 8ADDU or 8ADDUI followed by LDO or LDOI from the scaled address, from
+ * memory with the native byte order.
+ */
+inline PredecodedInstruction*
+fuseScaledLoadNative(MachineStateImplementation* m, PredecodedInstruction* p)
+{
+    return scaledLoad<true>(m, p);
+}
+
+/**
+ * GETA followed by PUSHGO through the loaded address.
+ */
+inline PredecodedInstruction*
+fuseGetaPushgo(MachineStateImplementation* m, PredecodedInstruction* p)
+{
+    if (!chargeFused(m, p))
+        return p + 1;
+
+    opGeta<Opcode::OP_GETA>(m, p[1]);
+
+    if (Opcode::OP_PUSHGOI == p[2].opcode())
+        opPushgo<Opcode::OP_PUSHGOI>(m, p[2]);
+    else
+        opPushgo<Opcode::OP_PUSHGO>(m, p[2]);
+
+    return nullptr;
+}
+
+/**
+ * A run of STCOI, or of STUNCI, through the same base register to
+ * consecutive octas, in memory with the given byte order.  When the first
+ * and last octas are writable and already in the arena or the software TLB,
+ * and the host memory between them is contiguous, the whole run is stored
+ * in address order.  Otherwise the ordinary records run instead, which fill
+ * the TLB and raise any fault precisely.  The rest of the run is only charged
+ * to the instruction budget once it has been stored, so that a host fault in
+ * the arena retries just the first store, and no octa after the faulting one
+ * has been written.  memset() is not used, since it need not write in order.
+ */
+template <bool UNCACHED, bool NATIVE>
+inline PredecodedInstruction*
+storeRun(MachineStateImplementation* m, PredecodedInstruction* p)
+{
+    std::uint64_t extra = p->count - 1;
+    std::uint64_t addr = effectiveAddress<
+        UNCACHED ? Opcode::OP_STUNCI : Opcode::OP_STCOI>(m, p[1]);
+    std::uint8_t* first = translateHit(m, addr, 8, SEGMENT_WRITE);
+    std::uint8_t* last = translateHit(m, addr + 8 * extra, 8, SEGMENT_WRITE);
+
+    if (SIMEX_UNLIKELY(
+            nullptr == first || last != first + 8 * extra
+         || m->remaining < extra))
+    {
+        ++m->remaining;
+        return p + 1;
+    }
+
+    if (UNCACHED)
+    {
+        for (std::uint64_t k = 0; k <= extra; ++k)
+            storeUncached<NATIVE>(first + 8 * k, readReg(m, p[k + 1].x()));
+    }
+    else
+    {
+        std::uint8_t octa[8];
+
+        storeGuest<std::uint64_t, NATIVE>(octa, p->x());
+        for (std::uint64_t k = 0; k <= extra; ++k)
+            memcpy(first + 8 * k, octa, sizeof(octa));
+    }
+
+    m->remaining -= extra;
+    m->fusedInstructions += extra;
+    m->pc += 4 * p->count;
+
+    return p + p->count + 1;
+}
+
+/**
+ * A run of STCOI through the same base register to consecutive octas.
+ */
+inline PredecodedInstruction*
+fuseStoreConstantRun(MachineStateImplementation* m, PredecodedInstruction* p)
+{
+    return storeRun<false, false>(m, p);
+}
+
+/**
+ * A run of STCOI through the same base register to consecutive octas, in
+ * memory with the native byte order.
+ */
+inline PredecodedInstruction*
+fuseStoreConstantRunNative(
+    MachineStateImplementation* m, PredecodedInstruction* p)
+{
+    return storeRun<false, true>(m, p);
+}
+
+/**
+ * A run of STUNCI through the same base register to consecutive octas.
+ */
+inline PredecodedInstruction*
+fuseStoreUncachedRun(MachineStateImplementation* m, PredecodedInstruction* p)
+{
+    return storeRun<true, false>(m, p);
+}
+
+/**
+ * A run of STUNCI through the same base register to consecutive octas, in
+ * memory with the native byte order.
+ */
+inline PredecodedInstruction*
+fuseStoreUncachedRunNative(
+    MachineStateImplementation* m, PredecodedInstruction* p)
+{
+    return storeRun<true, true>(m, p);
+}
+
+/**
+ * Run a block which the JIT translated to host machine code.  The record
+ * covers the instructions which were compiled, and holds the code in target
+ * and the frame it was compiled for in imm.  The code runs only if the
+ * budget covers all of it, rG is unchanged, and the local registers it
+ * touches are all below rL and don't wrap around the ring; otherwise the
+ * first instruction is refunded and the ordinary records run instead.  The
+ * code charges the instructions which it runs, and sets the program counter.
+ */
+inline PredecodedInstruction*
+runCompiled(MachineStateImplementation* m, PredecodedInstruction* p)
+{
+    std::uint64_t locals = p->imm >> 16;
+    std::uint64_t slot = sr(m, SReg::SR_RO) & RING_MASK;
+
+    ++m->remaining;
+
+    if (SIMEX_UNLIKELY(
+            m->remaining < p->count
+         || sr(m, SReg::SR_RG) != (p->imm & 0xFFFF)
+         || sr(m, SReg::SR_RL) < locals
+         || slot + locals > RING_SIZE))
+    {
+        return p + 1;
+    }
+
+    reinterpret_cast<CompiledBlock>(static_cast<std::uintptr_t>(p->target))(
+        m, m->ring + slot, m->written + slot);
+
+    return nullptr;
+}
+
+/**
+ * Count an entry to a block which the JIT may translate, and a call to its
+ * function if the block was entered by a call.  The record counts entries in
+ * imm and calls in target.  Once the entries reach the block threshold, the
+ * block is queued for the background compiler, and once the calls reach the
+ * function threshold, the blocks of the function are.  This record is not an
+ * instruction.
+ */
+inline PredecodedInstruction*
+profileBlock(MachineStateImplementation* m, PredecodedInstruction* p)
+{
+    ++m->remaining;
+    ++p->imm;
+
+    if (SIMEX_UNLIKELY(m->callTarget == m->pc))
+    {
+        m->callTarget = NO_CALL;
+
+        if (SIMEX_UNLIKELY(++p->target == m->functionThreshold))
+        {
+            ++m->jitStats.hotFunctions;
+            queueFunction(m, m->code, m->pc);
+        }
+    }
+
+    if (SIMEX_UNLIKELY(p->imm == m->blockThreshold)
+     && DISPATCH_profileBlock == p->dispatch)
+    {
+        ++m->jitStats.hotBlocks;
+        queueBlock(m, m->code, m->pc);
+    }
+
+    if (SIMEX_UNLIKELY(
+            nullptr != m->compiler
+         && m->compiler->ready.load(std::memory_order_relaxed)))
+    {
+        installCompiled(m);
+    }
+
+    return p + 1;
+}
+
+/**
+ * Wait for the background compiler to translate a block which was queued.
+ * Once code is ready, it is patched in; if this block was patched, its code
+ * runs right away.  This record is not an instruction.
+ */
+inline PredecodedInstruction*
+awaitCompiled(MachineStateImplementation* m, PredecodedInstruction* p)
+{
+    ++m->remaining;
+
+    if (SIMEX_UNLIKELY(m->compiler->ready.load(std::memory_order_relaxed)))
+    {
+        installCompiled(m);
+
+        if (DISPATCH_runCompiled == p->dispatch)
+            return p;
+    }
+
+    return p + 1;
+}
+
+/* namespace simex */ }
+
+//end of C++ code
+#endif //__cplusplus
+
+#endif //SIMEX_MACHINE_STATE_FUSED_HANDLERS_HEADER_GUARD
@@ -0,0 +1,36 @@
+/**
+ * \file MachineState/halt.cpp
+ *
+ * Implementation of MachineState::halt().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/MachineState.h>
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Halt the machine.  The current run() returns RunStatus::Halted after the
+ * current instruction completes.
+ *
+ * \param exitCode  The exit code for this machine.
+ */
+void MachineState::halt(uint64_t exitCode)
+{
+    MachineStateImplementation* m = impl_.get();
+
+    m->halted = true;
+    m->exitCode = exitCode;
+
+    //account for the instructions run so far, and stop the interpreter.
+    m->instructions += m->budget - m->remaining;
+    m->budget = m->remaining = 0;
+}
@@ -0,0 +1,26 @@
+/**
+ * \file MachineState/halted.cpp
+ *
+ * Implementation of MachineState::halted().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/MachineState.h>
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Returns true if this machine is halted.
+ */
+bool MachineState::halted() const
+{
+    return impl_->halted;
+}
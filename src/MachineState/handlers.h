@@ -0,0 +1,1506 @@
+/**
+ * \file MachineState/handlers.h
+ *
+ * Instruction handlers used by the interpreter loop and by single instruction
+ * evaluation.  Each handler evaluates a predecoded instruction, and returns
+ * true if execution continues with the next record of the block, or false if
+ * control leaves the block, such as for a branch or a fault.
+ *
+ * Handlers are templates on their opcode.  Operand flavor, signedness, access
+ * width, and branch condition come from OpcodeTraitsOf, so each opcode in
+ * the dispatch table gets its own specialized body without runtime checks.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#ifndef  SIMEX_MACHINE_STATE_HANDLERS_HEADER_GUARD
+# define SIMEX_MACHINE_STATE_HANDLERS_HEADER_GUARD
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include "MachineStateImplementation.h"
+#include "PredecodedInstruction.h"
+#include "reciprocal.h"
+
+//this header is C++ specific
+#ifdef __cplusplus
+
+namespace simex {
+
+/**
+ * Advance the program counter to the next instruction.
+ */
+inline void advance(MachineStateImplementation* m)
+{
+    m->pc += 4;
+}
+
+/**
+ * Get the Z operand, which is either the Z register or the Z constant.  The
+ * choice is made at compile time from the opcode.
+ */
+template <Opcode OP>
+inline std::uint64_t
+operandZ(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    if (OpcodeTraitsOf<OP>::zImmediate)
+        return i.imm;
+    else
+        return readReg(m, i.z());
+}
+
+/**
+ * Evaluate a branch condition: N, Z, P, OD, NN, NZ, NP, EV.  Handlers pass a
+ * constant condition, so the switch is resolved at compile time.
+ */
+inline bool condition(std::uint8_t cond, std::uint64_t value)
+{
+    std::int64_t v = static_cast<std::int64_t>(value);
+
+    switch (cond)
+    {
+        case 0: return v < 0;
+        case 1: return v == 0;
+        case 2: return v > 0;
+        case 3: return v & 1;
+        case 4: return v >= 0;
+        case 5: return v != 0;
+        case 6: return v <= 0;
+        default: return !(v & 1);
+    }
+}
+
+/**
+ * Reinterpret an octa as a double.
+ */
+inline double octa2double(std::uint64_t value)
+{
+    double d;
+    memcpy(&d, &value, sizeof(d));
+
+    return d;
+}
+
+/**
+ * Reinterpret a double as an octa.
+ */
+inline std::uint64_t double2octa(double d)
+{
+    std::uint64_t value;
+    memcpy(&value, &d, sizeof(value));
+
+    return value;
+}
+
+/**
+ * Reinterpret a tetra as a float.
+ */
+inline float tetra2float(std::uint32_t value)
+{
+    float f;
+    memcpy(&f, &value, sizeof(f));
+
+    return f;
+}
+
+/**
+ * Reinterpret a float as a tetra.
+ */
+inline std::uint32_t float2tetra(float f)
+{
+    std::uint32_t value;
+    memcpy(&value, &f, sizeof(value));
+
+    return value;
+}
+
+/**
+ * Returns true if y and z are within epsilon of each other, scaled by the
+ * larger (approximate) or smaller (essential) magnitude.
+ */
+inline bool
+epsilonEqual(double y, double z, double epsilon, bool essential)
+{
+    double ay = std::fabs(y), az = std::fabs(z);
+    double scale = essential ? std::fmin(ay, az) : std::fmax(ay, az);
+
+    return std::fabs(y - z) <= epsilon * scale;
+}
+
+/**
+ * SYSCALL X, YZ: call the host system call at index YZ.
+ */
+template <Opcode OP>
+inline bool
+opSyscall(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    auto sc = m->syscalls.find(i.yz());
+    if (SIMEX_UNLIKELY(sc == m->syscalls.end() || !sc->second))
+    {
+        raiseFault(m, Fault::UnsupportedSyscall, i.ins);
+        return false;
+    }
+
+    sr(m, SReg::SR_RJJ) = m->pc + 4;
+    pushFrame(m, i.x());
+
+    std::uint8_t results = sc->second(m->owner);
+
+    popFrame(m, results);
+    m->pc = sr(m, SReg::SR_RJJ);
+
+    //the system call may have changed segments, so forget the code cache
+    //and any stale translations.
+    m->code = nullptr;
+    syncTlb(m);
+
+    return false;
+}
+
+/**
+ * FCMP, FUN, FEQL, FCMPE, FUNE, FEQLE: floating point comparisons.
+ */
+template <Opcode OP>
+inline bool
+opFcompare(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    double y = octa2double(readReg(m, i.y()));
+    double z = octa2double(readReg(m, i.z()));
+    double e = octa2double(sr(m, SReg::SR_RE));
+    bool unordered = std::isnan(y) || std::isnan(z);
+    std::int64_t result;
+
+    switch (OP)
+    {
+        case Opcode::OP_FCMP:
+            result = unordered ? 0 : (y > z) - (y < z);
+            break;
+
+        case Opcode::OP_FCMPE:
+            if (unordered || epsilonEqual(y, z, e, false))
+                result = 0;
+            else
+                result = (y > z) - (y < z);
+            break;
+
+        case Opcode::OP_FEQL:
+            result = !unordered && y == z;
+            break;
+
+        case Opcode::OP_FEQLE:
+            result = !unordered && epsilonEqual(y, z, e, true);
+            break;
+
+        default:
+            result = unordered;
+            break;
+    }
+
+    writeReg(m, i.x(), static_cast<std::uint64_t>(result));
+    advance(m);
+
+    return true;
+}
+
+/**
+ * FADD, FSUB, FMUL, FDIV, FREM: binary floating point arithmetic.
+ */
+template <Opcode OP>
+inline bool
+opFarith(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    double y = octa2double(readReg(m, i.y()));
+    double z = octa2double(readReg(m, i.z()));
+    double result;
+
+    switch (OP)
+    {
+        case Opcode::OP_FADD: result = y + z; break;
+        case Opcode::OP_FSUB: result = y - z; break;
+        case Opcode::OP_FMUL: result = y * z; break;
+        case Opcode::OP_FDIV: result = y / z; break;
+        default: result = std::remainder(y, z); break;
+    }
+
+    writeReg(m, i.x(), double2octa(result));
+    advance(m);
+
+    return true;
+}
+
+/**
+ * FSQRT, FINT: unary floating point operations on $Z.
+ */
+template <Opcode OP>
+inline bool
+opFunary(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    double z = octa2double(readReg(m, i.z()));
+    double result =
+        OP == Opcode::OP_FSQRT ? std::sqrt(z) : std::nearbyint(z);
+
+    writeReg(m, i.x(), double2octa(result));
+    advance(m);
+
+    return true;
+}
+
+/**
+ * FIX, FIXU: convert $Z to an integer.
+ */
+template <Opcode OP>
+inline bool
+opFix(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    double z = std::nearbyint(octa2double(readReg(m, i.z())));
+    std::uint64_t result;
+
+    if (OP == Opcode::OP_FIXU && z >= 0.0 && z < 18446744073709551616.0)
+        result = static_cast<std::uint64_t>(z);
+    else if (z >= -9223372036854775808.0 && z < 9223372036854775808.0)
+        result = static_cast<std::uint64_t>(static_cast<std::int64_t>(z));
+    else
+        result = 0x8000000000000000ULL;
+
+    writeReg(m, i.x(), result);
+    advance(m);
+
+    return true;
+}
+
+/**
+ * FLOT, FLOTU, SFLOT, SFLOTU: convert an integer to floating point.
+ */
+template <Opcode OP>
+inline bool
+opFlot(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    std::uint64_t z = operandZ<OP>(m, i);
+    std::uint8_t code = opcode2byte(OP);
+    bool isUnsigned = code & 2;
+    bool isShort = code & 4;
+    double result;
+
+    if (isUnsigned)
+        result = static_cast<double>(z);
+    else
+        result = static_cast<double>(static_cast<std::int64_t>(z));
+
+    if (isShort)
+        result = static_cast<float>(result);
+
+    writeReg(m, i.x(), double2octa(result));
+    advance(m);
+
+    return true;
+}
+
+/**
+ * MUL, MULI: signed multiplication.
+ */
+template <Opcode OP>
+inline bool
+opMul(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    std::int64_t y = static_cast<std::int64_t>(readReg(m, i.y()));
+    std::int64_t z = static_cast<std::int64_t>(operandZ<OP>(m, i));
+    std::int64_t result;
+
+    if (SIMEX_UNLIKELY(__builtin_mul_overflow(y, z, &result)))
+    {
+        raiseFault(m, Fault::IntegerOverflow, i.ins);
+        return false;
+    }
+
+    writeReg(m, i.x(), static_cast<std::uint64_t>(result));
+    advance(m);
+
+    return true;
+}
+
+/**
+ * MULU, MULUI: unsigned multiplication.  The high octa goes to rH.
+ */
+template <Opcode OP>
+inline bool
+opMulu(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    unsigned __int128 result =
+        static_cast<unsigned __int128>(readReg(m, i.y())) * operandZ<OP>(m, i);
+
+    sr(m, SReg::SR_RH) = static_cast<std::uint64_t>(result >> 64);
+    writeReg(m, i.x(), static_cast<std::uint64_t>(result));
+    advance(m);
+
+    return true;
+}
+
+/**
+ * DIV, DIVI: signed floored division.  The remainder goes to rR.  DIVI
+ * divides through the reciprocal of its constant, held in imm and target.
+ */
+template <Opcode OP>
+inline bool
+opDiv(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    std::int64_t y = static_cast<std::int64_t>(readReg(m, i.y()));
+    std::int64_t q, r;
+
+    if (OpcodeTraitsOf<OP>::zImmediate)
+    {
+        std::uint64_t z = i.z();
+
+        if (SIMEX_UNLIKELY(z == 0))
+        {
+            raiseFault(m, Fault::DivideCheck, i.ins);
+            return false;
+        }
+
+        //for a positive divisor, floor(y / z) is ~(~y / z) when y < 0.
+        std::uint64_t sign = static_cast<std::uint64_t>(y >> 63);
+        std::uint64_t uq =
+            reciprocalDivide(static_cast<std::uint64_t>(y) ^ sign,
+                             i.imm, i.target) ^ sign;
+
+        q = static_cast<std::int64_t>(uq);
+        r = static_cast<std::int64_t>(static_cast<std::uint64_t>(y) - uq * z);
+    }
+    else
+    {
+        std::int64_t z = static_cast<std::int64_t>(readReg(m, i.z()));
+
+        if (z == 0)
+        {
+            raiseFault(m, Fault::DivideCheck, i.ins);
+            return false;
+        }
+        else if (z == -1 && y == std::numeric_limits<std::int64_t>::min())
+        {
+            raiseFault(m, Fault::IntegerOverflow, i.ins);
+            return false;
+        }
+
+        q = y / z;
+        r = y % z;
+
+        //round the quotient toward negative infinity.
+        if (r != 0 && ((r < 0) != (z < 0)))
+        {
+            q -= 1;
+            r += z;
+        }
+    }
+
+    sr(m, SReg::SR_RR) = static_cast<std::uint64_t>(r);
+    writeReg(m, i.x(), static_cast<std::uint64_t>(q));
+    advance(m);
+
+    return true;
+}
+
+/**
+ * DIVU, DIVUI: unsigned division of the 128-bit value rD:$Y.  The remainder
+ * goes to rR.  If rD is not less than the divisor, the quotient is rD and the
+ * remainder is $Y.  When rD is zero, DIVUI divides through the reciprocal of
+ * its constant, held in imm and target.
+ */
+template <Opcode OP>
+inline bool
+opDivu(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    std::uint64_t d = sr(m, SReg::SR_RD);
+    std::uint64_t y = readReg(m, i.y());
+    std::uint64_t q, r;
+
+    if (OpcodeTraitsOf<OP>::zImmediate && SIMEX_LIKELY(d == 0))
+    {
+        //a zero divisor has a zero reciprocal, giving rD and $Y as required.
+        q = reciprocalDivide(y, i.imm, i.target);
+        r = y - q * i.z();
+    }
+    else
+    {
+        std::uint64_t z =
+            OpcodeTraitsOf<OP>::zImmediate ? i.z() : readReg(m, i.z());
+
+        if (d >= z)
+        {
+            q = d;
+            r = y;
+        }
+        else
+        {
+            unsigned __int128 dividend =
+                (static_cast<unsigned __int128>(d) << 64) | y;
+
+            q = static_cast<std::uint64_t>(dividend / z);
+            r = static_cast<std::uint64_t>(dividend % z);
+        }
+    }
+
+    sr(m, SReg::SR_RR) = r;
+    writeReg(m, i.x(), q);
+    advance(m);
+
+    return true;
+}
+
+/**
+ * ADD, ADDI: signed addition.  The overflow builtin compiles to the add and a
+ * branch on the overflow flag, so the fault check costs nothing extra.
+ */
+template <Opcode OP>
+inline bool
+opAdd(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    std::int64_t y = static_cast<std::int64_t>(readReg(m, i.y()));
+    std::int64_t z = static_cast<std::int64_t>(operandZ<OP>(m, i));
+    std::int64_t result;
+
+    if (SIMEX_UNLIKELY(__builtin_add_overflow(y, z, &result)))
+    {
+        raiseFault(m, Fault::IntegerOverflow, i.ins);
+        return false;
+    }
+
+    writeReg(m, i.x(), static_cast<std::uint64_t>(result));
+    advance(m);
+
+    return true;
+}
+
+/**
+ * ADDU, ADDUI: unsigned addition.
+ */
+template <Opcode OP>
+inline bool
+opAddu(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    writeReg(m, i.x(), readReg(m, i.y()) + operandZ<OP>(m, i));
+    advance(m);
+
+    return true;
+}
+
+/**
+ * SUB, SUBI: signed subtraction.
+ */
+template <Opcode OP>
+inline bool
+opSub(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    std::int64_t y = static_cast<std::int64_t>(readReg(m, i.y()));
+    std::int64_t z = static_cast<std::int64_t>(operandZ<OP>(m, i));
+    std::int64_t result;
+
+    if (SIMEX_UNLIKELY(__builtin_sub_overflow(y, z, &result)))
+    {
+        raiseFault(m, Fault::IntegerOverflow, i.ins);
+        return false;
+    }
+
+    writeReg(m, i.x(), static_cast<std::uint64_t>(result));
+    advance(m);
+
+    return true;
+}
+
+/**
+ * SUBU, SUBUI: unsigned subtraction.
+ */
+template <Opcode OP>
+inline bool
+opSubu(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    writeReg(m, i.x(), readReg(m, i.y()) - operandZ<OP>(m, i));
+    advance(m);
+
+    return true;
+}
+
+/**
+ * 2ADDU, 4ADDU, 8ADDU, 16ADDU and their immediate forms: scaled addition.
+ */
+template <Opcode OP>
+inline bool
+opScaledAddu(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    unsigned shift = ((opcode2byte(OP) >> 1) & 3) + 1;
+
+    writeReg(m, i.x(), (readReg(m, i.y()) << shift) + operandZ<OP>(m, i));
+    advance(m);
+
+    return true;
+}
+
+/**
+ * CMP, CMPI: signed comparison.
+ */
+template <Opcode OP>
+inline bool
+opCmp(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    std::int64_t y = static_cast<std::int64_t>(readReg(m, i.y()));
+    std::int64_t z = static_cast<std::int64_t>(operandZ<OP>(m, i));
+
+    writeReg(m, i.x(), static_cast<std::uint64_t>(
+                           static_cast<std::int64_t>((y > z) - (y < z))));
+    advance(m);
+
+    return true;
+}
+
+/**
+ * CMPU, CMPUI: unsigned comparison.
+ */
+template <Opcode OP>
+inline bool
+opCmpu(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    std::uint64_t y = readReg(m, i.y());
+    std::uint64_t z = operandZ<OP>(m, i);
+
+    writeReg(m, i.x(), static_cast<std::uint64_t>(
+                           static_cast<std::int64_t>((y > z) - (y < z))));
+    advance(m);
+
+    return true;
+}
+
+/**
+ * NEG, NEGI: signed negation of $Z from the constant Y.
+ */
+template <Opcode OP>
+inline bool
+opNeg(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    std::int64_t y = i.y();
+    std::int64_t z = static_cast<std::int64_t>(operandZ<OP>(m, i));
+    std::int64_t result;
+
+    if (SIMEX_UNLIKELY(__builtin_sub_overflow(y, z, &result)))
+    {
+        raiseFault(m, Fault::IntegerOverflow, i.ins);
+        return false;
+    }
+
+    writeReg(m, i.x(), static_cast<std::uint64_t>(result));
+    advance(m);
+
+    return true;
+}
+
+/**
+ * NEGU, NEGUI: unsigned negation of $Z from the constant Y.
+ */
+template <Opcode OP>
+inline bool
+opNegu(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    writeReg(m, i.x(), static_cast<std::uint64_t>(i.y()) - operandZ<OP>(m, i));
+    advance(m);
+
+    return true;
+}
+
+/**
+ * SL, SLI: signed shift left, with overflow detection.
+ */
+template <Opcode OP>
+inline bool
+opSl(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    std::uint64_t y = readReg(m, i.y());
+    std::uint64_t z = operandZ<OP>(m, i);
+    std::uint64_t result = z >= 64 ? 0 : y << z;
+    std::int64_t back =
+        z >= 64 ? 0 : static_cast<std::int64_t>(result) >> z;
+
+    if (static_cast<std::uint64_t>(back) != y)
+    {
+        raiseFault(m, Fault::IntegerOverflow, i.ins);
+        return false;
+    }
+
+    writeReg(m, i.x(), result);
+    advance(m);
+
+    return true;
+}
+
+/**
+ * SLU, SLUI: unsigned shift left.
+ */
+template <Opcode OP>
+inline bool
+opSlu(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    std::uint64_t z = operandZ<OP>(m, i);
+
+    writeReg(m, i.x(), z >= 64 ? 0 : readReg(m, i.y()) << z);
+    advance(m);
+
+    return true;
+}
+
+/**
+ * SR, SRI: arithmetic shift right.
+ */
+template <Opcode OP>
+inline bool
+opSr(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    std::int64_t y = static_cast<std::int64_t>(readReg(m, i.y()));
+    std::uint64_t z = operandZ<OP>(m, i);
+
+    writeReg(m, i.x(), static_cast<std::uint64_t>(y >> (z >= 64 ? 63 : z)));
+    advance(m);
+
+    return true;
+}
+
+/**
+ * SRU, SRUI: logical shift right.
+ */
+template <Opcode OP>
+inline bool
+opSru(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    std::uint64_t z = operandZ<OP>(m, i);
+
+    writeReg(m, i.x(), z >= 64 ? 0 : readReg(m, i.y()) >> z);
+    advance(m);
+
+    return true;
+}
+
+/**
+ * Bcc and PBcc: conditional relative branches on $X.
+ */
+template <Opcode OP>
+inline bool
+opBranch(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    if (condition(OpcodeTraitsOf<OP>::condition, readReg(m, i.x())))
+        m->pc = i.target;
+    else
+        advance(m);
+
+    return false;
+}
+
+/**
+ * CScc, CSccI: conditionally set $X to the Z operand.
+ */
+template <Opcode OP>
+inline bool
+opCs(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    if (condition(OpcodeTraitsOf<OP>::condition, readReg(m, i.y())))
+        writeReg(m, i.x(), operandZ<OP>(m, i));
+
+    advance(m);
+
+    return true;
+}
+
+/**
+ * ZScc, ZSccI: set $X to the Z operand or to zero.
+ */
+template <Opcode OP>
+inline bool
+opZs(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    bool taken = condition(OpcodeTraitsOf<OP>::condition, readReg(m, i.y()));
+    std::uint64_t value = taken ? operandZ<OP>(m, i) : 0;
+
+    writeReg(m, i.x(), value);
+    advance(m);
+
+    return true;
+}
+
+/**
+ * Get the effective address $Y + $Z or $Y + Z.
+ */
+template <Opcode OP>
+inline std::uint64_t
+effectiveAddress(
+    MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    return readReg(m, i.y()) + operandZ<OP>(m, i);
+}
+
+/**
+ * LDB, LDW, LDT, LDO and their unsigned and immediate forms.
+ */
+template <Opcode OP, bool NATIVE = false>
+inline bool
+opLoad(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    const unsigned size = OpcodeTraitsOf<OP>::width;
+    const bool isUnsigned = !OpcodeTraitsOf<OP>::isSigned;
+    std::uint8_t* p =
+        translate(m, i.ins, effectiveAddress<OP>(m, i), size, SEGMENT_READ);
+    std::uint64_t value;
+
+    if (!p)
+        return false;
+
+    switch (size)
+    {
+        case 1:
+            value = isUnsigned
+                ? loadGuest<std::uint8_t, NATIVE>(p)
+                : static_cast<std::uint64_t>(
+                      loadGuest<std::int8_t, NATIVE>(p));
+            break;
+
+        case 2:
+            value = isUnsigned
+                ? loadGuest<std::uint16_t, NATIVE>(p)
+                : static_cast<std::uint64_t>(
+                      loadGuest<std::int16_t, NATIVE>(p));
+            break;
+
+        case 4:
+            value = isUnsigned
+                ? loadGuest<std::uint32_t, NATIVE>(p)
+                : static_cast<std::uint64_t>(
+                      loadGuest<std::int32_t, NATIVE>(p));
+            break;
+
+        default:
+            value = loadGuest<std::uint64_t, NATIVE>(p);
+            break;
+    }
+
+    writeReg(m, i.x(), value);
+    advance(m);
+
+    return true;
+}
+
+/**
+ * LDSF, LDSFI: load a short float and convert it to a double.
+ */
+template <Opcode OP, bool NATIVE = false>
+inline bool
+opLdsf(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    std::uint8_t* p =
+        translate(m, i.ins, effectiveAddress<OP>(m, i), 4, SEGMENT_READ);
+    if (!p)
+        return false;
+
+    double value = tetra2float(loadGuest<std::uint32_t, NATIVE>(p));
+
+    writeReg(m, i.x(), double2octa(value));
+    advance(m);
+
+    return true;
+}
+
+/**
+ * LDHT, LDHTI: load a tetra into the high half of $X.
+ */
+template <Opcode OP, bool NATIVE = false>
+inline bool
+opLdht(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    std::uint8_t* p =
+        translate(m, i.ins, effectiveAddress<OP>(m, i), 4, SEGMENT_READ);
+    if (!p)
+        return false;
+
+    writeReg(m, i.x(),
+             static_cast<std::uint64_t>(loadGuest<std::uint32_t, NATIVE>(p))
+                 << 32);
+    advance(m);
+
+    return true;
+}
+
+/**
+ * CSWAP, CSWAPI: if the octa at the effective address equals rP, replace it
+ * with $X and set $X to 1.  Otherwise, load it into rP and set $X to 0.
+ */
+template <Opcode OP, bool NATIVE = false>
+inline bool
+opCswap(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    std::uint8_t* p =
+        translate(m, i.ins, effectiveAddress<OP>(m, i), 8,
+                  SEGMENT_READ | SEGMENT_WRITE);
+    if (!p)
+        return false;
+
+    std::uint8_t expected[8], desired[8];
+    storeGuest<std::uint64_t, NATIVE>(expected, sr(m, SReg::SR_RP));
+    storeGuest<std::uint64_t, NATIVE>(desired, readReg(m, i.x()));
+
+    std::uint64_t e, d;
+    memcpy(&e, expected, sizeof(e));
+    memcpy(&d, desired, sizeof(d));
+
+    if (__atomic_compare_exchange_n(reinterpret_cast<std::uint64_t*>(p), &e,
+                                    d, false, __ATOMIC_SEQ_CST,
+                                    __ATOMIC_SEQ_CST))
+    {
+        writeReg(m, i.x(), 1);
+    }
+    else
+    {
+        memcpy(expected, &e, sizeof(e));
+        sr(m, SReg::SR_RP) = loadGuest<std::uint64_t, NATIVE>(expected);
+        writeReg(m, i.x(), 0);
+    }
+
+    advance(m);
+
+    return true;
+}
+
+/**
+ * GO, GOI: jump to the effective address, saving the return address in $X.
+ */
+template <Opcode OP>
+inline bool
+opGo(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    std::uint64_t target = effectiveAddress<OP>(m, i);
+
+    writeReg(m, i.x(), m->pc + 4);
+    m->pc = target;
+
+    return false;
+}
+
+/**
+ * STB, STW, STT, STO and their unsigned and immediate forms.  Signed stores
+ * of sub-octa values fault if the value does not fit.
+ */
+template <Opcode OP, bool NATIVE = false>
+inline bool
+opStore(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    const unsigned size = OpcodeTraitsOf<OP>::width;
+    std::uint64_t value = readReg(m, i.x());
+
+    if (OpcodeTraitsOf<OP>::isSigned)
+    {
+        unsigned bits = 64 - 8 * size;
+        std::int64_t sv = static_cast<std::int64_t>(value);
+
+        //shift the unsigned value, since shifting a negative one is undefined.
+        if ((static_cast<std::int64_t>(value << bits) >> bits) != sv)
+        {
+            raiseFault(m, Fault::IntegerOverflow, i.ins);
+            return false;
+        }
+    }
+
+    std::uint8_t* p =
+        translate(m, i.ins, effectiveAddress<OP>(m, i), size, SEGMENT_WRITE);
+    if (!p)
+        return false;
+
+    switch (size)
+    {
+        case 1: storeGuest<std::uint8_t, NATIVE>(p, value); break;
+        case 2: storeGuest<std::uint16_t, NATIVE>(p, value); break;
+        case 4: storeGuest<std::uint32_t, NATIVE>(p, value); break;
+        default: storeGuest<std::uint64_t, NATIVE>(p, value); break;
+    }
+
+    advance(m);
+
+    return true;
+}
+
+/**
+ * STSF, STSFI: store $X as a short float.
+ */
+template <Opcode OP, bool NATIVE = false>
+inline bool
+opStsf(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    float value = static_cast<float>(octa2double(readReg(m, i.x())));
+    std::uint8_t* p =
+        translate(m, i.ins, effectiveAddress<OP>(m, i), 4, SEGMENT_WRITE);
+    if (!p)
+        return false;
+
+    storeGuest<std::uint32_t, NATIVE>(p, float2tetra(value));
+    advance(m);
+
+    return true;
+}
+
+/**
+ * STHT, STHTI: store the high tetra of $X.
+ */
+template <Opcode OP, bool NATIVE = false>
+inline bool
+opStht(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    std::uint64_t value = readReg(m, i.x());
+    std::uint8_t* p =
+        translate(m, i.ins, effectiveAddress<OP>(m, i), 4, SEGMENT_WRITE);
+    if (!p)
+        return false;
+
+    storeGuest<std::uint32_t, NATIVE>(
+        p, static_cast<std::uint32_t>(value >> 32));
+    advance(m);
+
+    return true;
+}
+
+/**
+ * STCO, STCOI: store the constant X as an octa.
+ */
+template <Opcode OP, bool NATIVE = false>
+inline bool
+opStco(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    std::uint8_t* p =
+        translate(m, i.ins, effectiveAddress<OP>(m, i), 8, SEGMENT_WRITE);
+    if (!p)
+        return false;
+
+    storeGuest<std::uint64_t, NATIVE>(p, i.x());
+    advance(m);
+
+    return true;
+}
+
+/**
+ * LDUNC, LDUNCI: load an octa, bypassing the cache.
+ */
+template <Opcode OP, bool NATIVE = false>
+inline bool
+opLdunc(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    std::uint8_t* p =
+        translate(m, i.ins, effectiveAddress<OP>(m, i), 8, SEGMENT_READ);
+    if (!p)
+        return false;
+
+    writeReg(m, i.x(), loadGuest<std::uint64_t, NATIVE>(p));
+    advance(m);
+
+    return true;
+}
+
+/**
+ * STUNC, STUNCI: store an octa, bypassing the cache.
+ */
+template <Opcode OP, bool NATIVE = false>
+inline bool
+opStunc(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    std::uint64_t value = readReg(m, i.x());
+    std::uint8_t* p =
+        translate(m, i.ins, effectiveAddress<OP>(m, i), 8, SEGMENT_WRITE);
+    if (!p)
+        return false;
+
+    storeUncached<NATIVE>(p, value);
+    advance(m);
+
+    return true;
+}
+
+/**
+ * PUSHGO, PUSHGOI: push a register-stack frame and call the effective
+ * address.
+ */
+template <Opcode OP>
+inline bool
+opPushgo(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    std::uint64_t target = effectiveAddress<OP>(m, i);
+
+    sr(m, SReg::SR_RJ) = m->pc + 4;
+    pushFrame(m, i.x());
+    m->pc = m->callTarget = target;
+
+    return false;
+}
+
+/**
+ * OR, ORN, NOR, XOR, AND, ANDN, NAND, NXOR and their immediate forms.
+ */
+template <Opcode OP>
+inline bool
+opLogic(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    std::uint64_t y = readReg(m, i.y());
+    std::uint64_t z = operandZ<OP>(m, i);
+    std::uint64_t result;
+
+    switch (OP)
+    {
+        case Opcode::OP_OR: case Opcode::OP_ORI: result = y | z; break;
+        case Opcode::OP_ORN: case Opcode::OP_ORNI: result = y | ~z; break;
+        case Opcode::OP_NOR: case Opcode::OP_NORI: result = ~(y | z); break;
+        case Opcode::OP_XOR: case Opcode::OP_XORI: result = y ^ z; break;
+        case Opcode::OP_AND: case Opcode::OP_ANDI: result = y & z; break;
+        case Opcode::OP_ANDN: case Opcode::OP_ANDNI: result = y & ~z; break;
+        case Opcode::OP_NAND: case Opcode::OP_NANDI: result = ~(y & z); break;
+        default: result = ~(y ^ z); break;
+    }
+
+    writeReg(m, i.x(), result);
+    advance(m);
+
+    return true;
+}
+
+/**
+ * MUX, MUXI: select bits from $Y where rM is set, and from Z elsewhere.
+ */
+template <Opcode OP>
+inline bool
+opMux(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    std::uint64_t mask = sr(m, SReg::SR_RM);
+
+    writeReg(m, i.x(), (readReg(m, i.y()) & mask)
+                     | (operandZ<OP>(m, i) & ~mask));
+    advance(m);
+
+    return true;
+}
+
+/**
+ * SETH, SETMH, SETML, SETL: set $X to a wyde constant.
+ */
+template <Opcode OP>
+inline bool
+opSet(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    writeReg(m, i.x(), i.imm);
+    advance(m);
+
+    return true;
+}
+
+/**
+ * INCH, INCMH, INCML, INCL: add a wyde constant to $X.
+ */
+template <Opcode OP>
+inline bool
+opInc(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    writeReg(m, i.x(), readReg(m, i.x()) + i.imm);
+    advance(m);
+
+    return true;
+}
+
+/**
+ * ORH, ORMH, ORML, ORL: or a wyde constant into $X.
+ */
+template <Opcode OP>
+inline bool
+opOrw(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    writeReg(m, i.x(), readReg(m, i.x()) | i.imm);
+    advance(m);
+
+    return true;
+}
+
+/**
+ * ANDNH, ANDNMH, ANDNML, ANDNL: clear the bits of a wyde constant in $X.
+ */
+template <Opcode OP>
+inline bool
+opAndnw(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    writeReg(m, i.x(), readReg(m, i.x()) & ~i.imm);
+    advance(m);
+
+    return true;
+}
+
+/**
+ * JMP, JMPB: relative jump.
+ */
+template <Opcode OP>
+inline bool
+opJmp(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    m->pc = i.target;
+
+    return false;
+}
+
+/**
+ * PUSHJ, PUSHJB: push a register-stack frame and call a relative address.
+ */
+template <Opcode OP>
+inline bool
+opPushj(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    sr(m, SReg::SR_RJ) = m->pc + 4;
+    pushFrame(m, i.x());
+    m->pc = m->callTarget = i.target;
+
+    return false;
+}
+
+/**
+ * GETA, GETAB: set $X to a relative address.
+ */
+template <Opcode OP>
+inline bool
+opGeta(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    writeReg(m, i.x(), i.target);
+    advance(m);
+
+    return true;
+}
+
+/**
+ * Write a special register as for PUT.  Reserved registers ignore writes, rO
+ * and rS are read-only, rL can only shrink, and rG must leave room for rL.
+ */
+inline void
+putSpecial(MachineStateImplementation* m, std::uint8_t r, std::uint64_t value)
+{
+    switch (static_cast<SReg>(r))
+    {
+        case SReg::SR_RO:
+        case SReg::SR_RS:
+            return;
+
+        case SReg::SR_RL:
+        {
+            std::uint64_t& rL = sr(m, SReg::SR_RL);
+            if (value < rL)
+            {
+                std::uint64_t base = sr(m, SReg::SR_RO);
+                dropLocals(m, base + value, base + rL);
+                rL = value;
+            }
+            return;
+        }
+
+        case SReg::SR_RG:
+        {
+            std::uint64_t& rG = sr(m, SReg::SR_RG);
+            if (value + sr(m, SReg::SR_RL) > REGISTER_COUNT)
+                return;
+
+            //newly exposed global registers start as zero.
+            for (std::uint64_t k = rG; k < value; ++k)
+                m->globals[REGISTER_COUNT - 1 - k] = 0;
+
+            rG = value;
+            return;
+        }
+
+        default:
+            //writes to reserved registers land in the sink.
+            m->sregs[sregWriteSlot(r)] = value;
+            return;
+    }
+}
+
+/**
+ * PUT, PUTI: write the Z operand to special register X.
+ */
+template <Opcode OP>
+inline bool
+opPut(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    putSpecial(m, i.x(), operandZ<OP>(m, i));
+    advance(m);
+
+    return true;
+}
+
+/**
+ * GET: read special register Z into $X.
+ */
+template <Opcode OP>
+inline bool
+opGet(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    //reserved registers read from the zero slot.
+    writeReg(m, i.x(), m->sregs[sregReadSlot(i.z())]);
+    advance(m);
+
+    return true;
+}
+
+/**
+ * POP X, 0: return X registers to the caller.  Popping the outermost frame
+ * halts the machine with $0 (or 0) as the exit code.
+ */
+template <Opcode OP>
+inline bool
+opPop(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    if (i.yz() != 0)
+    {
+        raiseFault(m, Fault::UnsupportedInstruction, i.ins);
+        return false;
+    }
+
+    if (sr(m, SReg::SR_RO) == 0)
+    {
+        m->owner->halt(i.x() ? readReg(m, 0) : 0);
+        return false;
+    }
+
+    popFrame(m, i.x());
+    m->pc = sr(m, SReg::SR_RJ);
+
+    return false;
+}
+
+/**
+ * Push a register-stack frame for a call which hides a constant number of
+ * local registers.  This is the common case of pushFrame(), where $X is
+ * already a local register; anything else is left to pushFrame().
+ */
+template <std::uint8_t X>
+inline void pushFrameCount(MachineStateImplementation* m)
+{
+    std::uint64_t& rL = sr(m, SReg::SR_RL);
+    std::uint64_t& rO = sr(m, SReg::SR_RO);
+
+    if (SIMEX_UNLIKELY(X >= rL || X >= globalBase(m)))
+    {
+        pushFrame(m, X);
+        return;
+    }
+
+    writeRing(m, rO + X, X);
+    rO += X + 1;
+    rL -= X + 1;
+}
+
+/**
+ * PUSHJ, PUSHJB with a small X, selected by the predecoder.
+ */
+template <Opcode OP, std::uint8_t X>
+inline bool
+opPushjCount(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    sr(m, SReg::SR_RJ) = m->pc + 4;
+    pushFrameCount<X>(m);
+    m->pc = m->callTarget = i.target;
+
+    return false;
+}
+
+/**
+ * PUSHGO, PUSHGOI with a small X, selected by the predecoder.
+ */
+template <Opcode OP, std::uint8_t X>
+inline bool
+opPushgoCount(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    std::uint64_t target = effectiveAddress<OP>(m, i);
+
+    sr(m, SReg::SR_RJ) = m->pc + 4;
+    pushFrameCount<X>(m);
+    m->pc = m->callTarget = target;
+
+    return false;
+}
+
+/**
+ * POP X, 0 with X of 0 or 1, selected by the predecoder.  The returned value,
+ * if any, is moved without a loop.  Popping the outermost frame, or a frame
+ * whose caller was spilled, is left to the ordinary handler.
+ */
+template <Opcode OP, std::uint8_t X>
+inline bool
+opPopCount(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    static_assert(X <= 1, "only POP 0 and POP 1 are specialized");
+
+    std::uint64_t& rL = sr(m, SReg::SR_RL);
+    std::uint64_t& rO = sr(m, SReg::SR_RO);
+    std::uint64_t dest = rO - 1;
+
+    if (SIMEX_UNLIKELY(0 == rO || dest < m->spilled))
+        return opPop<OP>(m, i);
+
+    std::uint64_t hidden = ringSlot(m, dest);
+
+    if (X)
+    {
+        if (SIMEX_UNLIKELY(hidden + 1 > globalBase(m)))
+            return opPop<OP>(m, i);
+
+        //$0 of a frame with no locals returns as 0.
+        writeRing(m, dest, rL ? ringSlot(m, rO) : 0);
+    }
+
+    //the rest of the callee frame is now in the hole.
+    dropLocals(m, dest + X, rO + rL);
+
+    rO -= hidden + 1;
+    rL = hidden + X;
+
+    //bring back the rest of the caller frame if it was spilled.
+    if (SIMEX_UNLIKELY(rO < m->spilled))
+        fillRegisters(m, rO);
+
+    m->pc = sr(m, SReg::SR_RJ);
+
+    return false;
+}
+
+/**
+ * RESUME: return from a fault handler to the instruction after rF.
+ */
+template <Opcode OP>
+inline bool
+opResume(MachineStateImplementation* m, const PredecodedInstruction&)
+{
+    m->pc = sr(m, SReg::SR_RF) + 4;
+
+    return false;
+}
+
+/**
+ * SAVE $X, $Y, Z: save the register context to the image at $Y + Z, and set
+ * $X to the size of the image in bytes.
+ */
+template <Opcode OP>
+inline bool
+opSave(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    std::uint64_t size;
+
+    if (!saveContext(m, i.ins, effectiveAddress<OP>(m, i), &size))
+        return false;
+
+    writeReg(m, i.x(), size);
+    advance(m);
+
+    return true;
+}
+
+/**
+ * UNSAVE $X, $Y, $Z: restore the register context from the image at
+ * $Y + $Z.  X is ignored, since every register comes from the image.
+ */
+template <Opcode OP>
+inline bool
+opUnsave(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    if (!restoreContext(m, i.ins, effectiveAddress<OP>(m, i)))
+        return false;
+
+    advance(m);
+
+    return true;
+}
+
+/**
+ * SYNC: make uncached stores visible to other threads.  Every other store is
+ * already ordered by the host.
+ */
+template <Opcode OP>
+inline bool
+opSync(MachineStateImplementation* m, const PredecodedInstruction&)
+{
+    fenceUncached();
+    advance(m);
+
+    return true;
+}
+
+/**
+ * SWYM: no operation.
+ */
+template <Opcode OP>
+inline bool
+opNop(MachineStateImplementation* m, const PredecodedInstruction&)
+{
+    advance(m);
+
+    return true;
+}
+
+/**
+ * Valid instructions that this implementation does not support.
+ */
+template <Opcode OP>
+inline bool
+opUnsupported(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    raiseFault(m, Fault::UnsupportedInstruction, i.ins);
+
+    return false;
+}
+
+/**
+ * Reserved opcodes.
+ */
+template <Opcode OP>
+inline bool
+opInvalid(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    raiseFault(m, Fault::InvalidInstruction, i.ins);
+
+    return false;
+}
+
+/**
+ * Evaluate an ordinary record through the handler for its opcode, or for its
+ * byte order if it loads or stores.  This is used where records are not
+ * dispatched through threaded code.
+ */
+inline bool
+evaluateRecord(MachineStateImplementation* m, const PredecodedInstruction& i)
+{
+    switch (i.dispatch)
+    {
+#define SIMEX_NATIVE_HANDLER(name, handler, opcode) \
+        case DISPATCH_##name: return handler<Opcode::opcode, true>(m, i);
+
+        SIMEX_NATIVE_HANDLER_LIST
+
+#undef SIMEX_NATIVE_HANDLER
+
+        default:
+            break;
+    }
+
+    switch (i.opcode())
+    {
+#define SIMEX_DISPATCH(code, opcode, handler) \
+        case Opcode::opcode: return handler<Opcode::opcode>(m, i);
+
+        SIMEX_DISPATCH_TABLE
+
+#undef SIMEX_DISPATCH
+    }
+
+    return false;
+}
+
+/* namespace simex */ }
+
+//end of C++ code
+#endif //__cplusplus
+
+#endif //SIMEX_MACHINE_STATE_HANDLERS_HEADER_GUARD
@@ -0,0 +1,100 @@
+/**
+ * \file MachineState/installCompiled.cpp
+ *
+ * Patch code translated by the background compiler into its blocks.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include "CompileQueue.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Returns true if a queued block is still waiting for its code in the
+ * machine's cache for its segment, and the segment still holds the
+ * instructions which were translated.  A block whose segment was remapped,
+ * or whose cache was built again, may have been freed, so it is only read
+ * once it is found.
+ */
+static bool
+stillQueued(
+    MachineStateImplementation* m, const CompileJob& job,
+    PredecodedSegment** segmentCode)
+{
+    PredecodedInstruction records[MAX_BLOCK_INSTRUCTIONS];
+    Segment* seg = m->space->find(job.pc);
+    if (nullptr == seg)
+        return false;
+
+    auto cache = m->caches.find(seg->base());
+    if (m->caches.end() == cache)
+        return false;
+
+    PredecodedSegment* code = cache->second.get();
+    if (code->version != seg->version() || !code->tiered
+     || job.block != code->entries[(job.pc - code->base) / 4]
+     || DISPATCH_awaitCompiled != job.block->dispatch)
+    {
+        return false;
+    }
+
+    size_t n = decodeBlock(code, job.pc, m->space->byteOrder(), records);
+    if (n != job.records.size())
+        return false;
+
+    for (size_t i = 0; i < n; ++i)
+        if (records[i].ins.tetra() != job.records[i].ins.tetra())
+            return false;
+
+    *segmentCode = code;
+
+    return true;
+}
+
+/**
+ * Patch the code which the background compiler translated into the blocks
+ * it was queued for.  The record which waited for the code becomes the
+ * record which runs it.  This runs on the thread which runs the machine,
+ * between two instructions, so the interpreter never sees a block half
+ * patched.  A block which could not be translated runs its ordinary records
+ * from then on.
+ *
+ * \param m         The machine state.
+ */
+void simex::installCompiled(MachineStateImplementation* m)
+{
+    for (CompileJob& job : m->compiler->take())
+    {
+        PredecodedSegment* code = nullptr;
+
+        if (!stillQueued(m, job, &code))
+        {
+            ++m->jitStats.rejected;
+            continue;
+        }
+
+        const void* host = job.code.empty()
+            ? nullptr : code->compiled.add(job.code.data(), job.code.size());
+
+        if (nullptr == host)
+        {
+            //skip the waiting record.
+            code->entries[(job.pc - code->base) / 4] = job.block + 1;
+            ++m->jitStats.rejected;
+            continue;
+        }
+
+        job.compiled.target = reinterpret_cast<uintptr_t>(host);
+        if (nullptr != m->labels)
+            job.compiled.label = m->labels[DISPATCH_runCompiled];
+
+        *job.block = job.compiled;
+        ++m->jitStats.installed;
+    }
+}
@@ -0,0 +1,26 @@
+/**
+ * \file MachineState/instructionCount.cpp
+ *
+ * Implementation of MachineState::instructionCount().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/MachineState.h>
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Get the total number of instructions evaluated by this machine.
+ */
+uint64_t MachineState::instructionCount() const
+{
+    return impl_->instructions + (impl_->budget - impl_->remaining);
+}
@@ -0,0 +1,227 @@
+/**
+ * \file MachineState/interpret.cpp
+ *
+ * Implementation of the interpreter loop.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include "MachineStateImplementation.h"
+#include "PredecodedInstruction.h"
+#include "fusedHandlers.h"
+#include "handlers.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Run the rest of the instruction budget from the current program counter,
+ * and account for the instructions run.
+ *
+ * Instructions are run from predecoded basic blocks.  Each handler either
+ * continues with the next record of its block, or returns to the block lookup
+ * at the new program counter.
+ *
+ * \param m         The machine state.
+ */
+void simex::interpret(MachineStateImplementation* m)
+{
+    PredecodedInstruction* p;
+
+#ifdef SIMEX_COMPUTED_GOTO
+
+    /* one entry per dispatch index, jumping to the label for it. */
+    static const void* const labels[DISPATCH_COUNT] = {
+#define SIMEX_DISPATCH(code, opcode, handler) &&label_##opcode,
+        SIMEX_DISPATCH_TABLE
+#undef SIMEX_DISPATCH
+#define SIMEX_FUSED_HANDLER(handler) &&label_##handler,
+        SIMEX_FUSED_HANDLER_LIST
+#undef SIMEX_FUSED_HANDLER
+#define SIMEX_CALL_HANDLER(name, handler, opcode, count) &&label_##name,
+        SIMEX_CALL_HANDLER_LIST
+#undef SIMEX_CALL_HANDLER
+#define SIMEX_NATIVE_HANDLER(name, handler, opcode) &&label_##name,
+        SIMEX_NATIVE_HANDLER_LIST
+#undef SIMEX_NATIVE_HANDLER
+        &&label_blockEnd
+    };
+
+    //code patched in from outside of the interpreter needs the labels too.
+    m->labels = labels;
+
+    /* each handler dispatches directly to the next record. */
+#define SIMEX_NEXT() \
+    do { \
+        if (SIMEX_UNLIKELY(0 == m->remaining)) \
+            goto done; \
+        --m->remaining; \
+        goto *p->label; \
+    } while (0)
+
+resume:
+lookup:
+    if (SIMEX_UNLIKELY(0 == m->remaining))
+        goto done;
+
+    p = findBlock(m, labels);
+    if (SIMEX_UNLIKELY(nullptr == p))
+    {
+        //a fetch fault counts as an instruction.
+        if (m->remaining)
+            --m->remaining;
+
+        goto lookup;
+    }
+
+    SIMEX_NEXT();
+
+#define SIMEX_DISPATCH(code, opcode, handler) \
+label_##opcode: \
+    if (SIMEX_LIKELY(handler<Opcode::opcode>(m, *p))) \
+    { \
+        ++p; \
+        SIMEX_NEXT(); \
+    } \
+    goto lookup;
+
+    SIMEX_DISPATCH_TABLE
+
+#undef SIMEX_DISPATCH
+
+#define SIMEX_FUSED_HANDLER(handler) \
+label_##handler: \
+    p = handler(m, p); \
+    if (SIMEX_LIKELY(nullptr != p)) \
+        SIMEX_NEXT(); \
+    goto lookup;
+
+    SIMEX_FUSED_HANDLER_LIST
+
+#undef SIMEX_FUSED_HANDLER
+
+#define SIMEX_CALL_HANDLER(name, handler, opcode, count) \
+label_##name: \
+    if (SIMEX_LIKELY((handler<Opcode::opcode, count>(m, *p)))) \
+    { \
+        ++p; \
+        SIMEX_NEXT(); \
+    } \
+    goto lookup;
+
+    SIMEX_CALL_HANDLER_LIST
+
+#undef SIMEX_CALL_HANDLER
+
+#define SIMEX_NATIVE_HANDLER(name, handler, opcode) \
+label_##name: \
+    if (SIMEX_LIKELY((handler<Opcode::opcode, true>(m, *p)))) \
+    { \
+        ++p; \
+        SIMEX_NEXT(); \
+    } \
+    goto lookup;
+
+    SIMEX_NATIVE_HANDLER_LIST
+
+#undef SIMEX_NATIVE_HANDLER
+#undef SIMEX_NEXT
+
+label_blockEnd:
+    //the sentinel at the end of a block is not an instruction.
+    ++m->remaining;
+    goto lookup;
+
+#else //SIMEX_COMPUTED_GOTO
+
+resume:
+    while (m->remaining)
+    {
+        p = findBlock(m, nullptr);
+        if (SIMEX_UNLIKELY(nullptr == p))
+        {
+            //a fetch fault counts as an instruction.
+            if (m->remaining)
+                --m->remaining;
+
+            continue;
+        }
+
+        //run records from this block until control leaves it.
+        while (p && m->remaining)
+        {
+            --m->remaining;
+            switch (p->dispatch)
+            {
+#define SIMEX_DISPATCH(code, opcode, handler) \
+                case DISPATCH_##opcode: \
+                    p = handler<Opcode::opcode>(m, *p) ? p + 1 : nullptr; \
+                    break;
+
+                SIMEX_DISPATCH_TABLE
+
+#undef SIMEX_DISPATCH
+
+#define SIMEX_FUSED_HANDLER(handler) \
+                case DISPATCH_##handler: \
+                    p = handler(m, p); \
+                    break;
+
+                SIMEX_FUSED_HANDLER_LIST
+
+#undef SIMEX_FUSED_HANDLER
+
+#define SIMEX_CALL_HANDLER(name, handler, opcode, count) \
+                case DISPATCH_##name: \
+                    p = handler<Opcode::opcode, count>(m, *p) \
+                            ? p + 1 : nullptr; \
+                    break;
+
+                SIMEX_CALL_HANDLER_LIST
+
+#undef SIMEX_CALL_HANDLER
+
+#define SIMEX_NATIVE_HANDLER(name, handler, opcode) \
+                case DISPATCH_##name: \
+                    p = handler<Opcode::opcode, true>(m, *p) \
+                            ? p + 1 : nullptr; \
+                    break;
+
+                SIMEX_NATIVE_HANDLER_LIST
+
+#undef SIMEX_NATIVE_HANDLER
+
+                default:
+                    //the sentinel at the end of a block.
+                    ++m->remaining;
+                    p = nullptr;
+                    break;
+            }
+        }
+    }
+
+    goto done;
+
+#endif //SIMEX_COMPUTED_GOTO
+
+done:
+    m->instructions += m->budget - m->remaining;
+    m->budget = m->remaining = 0;
+
+    //a deferred fault stops the interpreter once its instruction
+    //completes; raise it and run the rest of the budget.
+    if (SIMEX_UNLIKELY(Fault::None != m->deferredFault))
+    {
+        m->budget = m->remaining = m->deferredBudget;
+        raiseDeferredFault(m);
+
+        if (!m->halted)
+            goto resume;
+
+        m->budget = m->remaining = 0;
+    }
+}
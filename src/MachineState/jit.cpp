@@ -0,0 +1,26 @@
+/**
+ * \file MachineState/jit.cpp
+ *
+ * Implementation of MachineState::jit().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/MachineState.h>
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Returns true if the JIT is enabled.
+ */
+bool MachineState::jit() const
+{
+    return impl_->jit;
+}
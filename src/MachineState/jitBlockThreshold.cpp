@@ -0,0 +1,26 @@
+/**
+ * \file MachineState/jitBlockThreshold.cpp
+ *
+ * Implementation of MachineState::jitBlockThreshold().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/MachineState.h>
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Get the number of entries after which a block is queued for the JIT.
+ */
+uint64_t MachineState::jitBlockThreshold() const
+{
+    return impl_->blockThreshold;
+}
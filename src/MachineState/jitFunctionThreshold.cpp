@@ -0,0 +1,27 @@
+/**
+ * \file MachineState/jitFunctionThreshold.cpp
+ *
+ * Implementation of MachineState::jitFunctionThreshold().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/MachineState.h>
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Get the number of calls after which the blocks of a function are queued for
+ * the JIT.
+ */
+uint64_t MachineState::jitFunctionThreshold() const
+{
+    return impl_->functionThreshold;
+}
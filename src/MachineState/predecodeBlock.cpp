@@ -0,0 +1,115 @@
+/**
+ * \file MachineState/predecodeBlock.cpp
+ *
+ * Translate a basic block into predecoded records.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <algorithm>
+
+#include "PredecodedInstruction.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Predecode the basic block starting at the program counter, adding it to the
+ * machine's cache for the segment containing it.  If the program counter
+ * can't be executed, a fault is raised and nullptr is returned.
+ *
+ * \param m         The machine state.
+ * \param labels    The threaded code address of each dispatch index, or
+ *                  nullptr if computed goto is not used.
+ *
+ * \returns the first record of the block.
+ */
+PredecodedInstruction*
+simex::predecodeBlock(MachineStateImplementation* m, const void* const* labels)
+{
+    uint64_t pc = m->pc;
+
+    //check that the first instruction can be fetched.
+    if (!translate(m, DecodedInstruction(), pc, 4, SEGMENT_EXECUTE))
+        return nullptr;
+
+    //build this machine's cache for the segment on first execution, or when
+    //the segment changed or the cache was built with a different fusion or
+    //JIT setting.
+    Segment* seg = m->space->find(pc);
+    uint64_t version = seg->version();
+    auto& slot = m->caches[seg->base()];
+    PredecodedSegment* code = slot.get();
+    bool tiered = m->jit && 0 != m->blockThreshold;
+    if (nullptr == code || code->version != version
+     || code->fused != m->fusion || code->jit != m->jit
+     || code->tiered != tiered)
+    {
+        code = new PredecodedSegment(seg, version, m->fusion, m->jit, tiered);
+        slot.reset(code);
+    }
+
+    m->code = code;
+
+    uint64_t index = (pc - code->base) / 4;
+    if (nullptr != code->entries[index])
+        return code->entries[index];
+
+    PredecodedInstruction records[MAX_BLOCK_INSTRUCTIONS];
+    ByteOrder order = m->space->byteOrder();
+    uint64_t n = decodeBlock(code, pc, order, records);
+
+    //room for the compiled code or the profile record, the records,
+    //superinstructions, and the sentinel.
+    unique_ptr<PredecodedInstruction[]> block(
+        new PredecodedInstruction[n + n / 2 + 2]);
+    uint64_t size = 0;
+
+    if (tiered)
+    {
+        //the profile record counts entries and calls until the block is
+        //queued for the background compiler.
+        block[0] = records[0];
+        block[0].dispatch = DISPATCH_profileBlock;
+        block[0].count = 0;
+        block[0].imm = 0;
+        block[0].target = 0;
+        size = 1;
+    }
+    else if (m->jit
+          && compileBlock(m, pc, records, n, &code->compiled, block.get()))
+    {
+        size = 1;
+    }
+
+    if (m->fusion)
+    {
+        size += fuseInstructions(records, n, block.get() + size);
+    }
+    else
+    {
+        copy(records, records + n, block.get() + size);
+        size += n;
+    }
+
+    //the sentinel leaves the block with the program counter after the block.
+    predecodeInstruction(
+        &block[size], pc + 4 * n, DecodedInstruction(), order);
+    block[size].dispatch = DISPATCH_BLOCK_END;
+
+    if (nullptr != labels)
+    {
+        for (uint64_t i = 0; i <= size; ++i)
+            block[i].label = labels[block[i].dispatch];
+    }
+
+    PredecodedInstruction* ret = block.get();
+    code->entries[index] = ret;
+    code->blocks.push_back(move(block));
+
+    return ret;
+}
@@ -0,0 +1,197 @@
+/**
+ * \file MachineState/predecodeInstruction.cpp
+ *
+ * Translate a single instruction into a predecoded record.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include "PredecodedInstruction.h"
+#include "reciprocal.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * The handler family for each opcode.
+ */
+static const uint8_t opcodeHandlers[256] = {
+#define SIMEX_DISPATCH(code, opcode, handler) HANDLER_##handler,
+    SIMEX_DISPATCH_TABLE
+#undef SIMEX_DISPATCH
+};
+
+/**
+ * Compute the target of a relative YZ branch.
+ */
+static uint64_t relativeYZ(uint64_t pc, DecodedInstruction ins)
+{
+    int64_t offset = ins.yz();
+
+    if (ins.traits().backward)
+        offset -= 0x10000;
+
+    return pc + 4 * offset;
+}
+
+/**
+ * Compute the target of a relative XYZ jump.
+ */
+static uint64_t relativeXYZ(uint64_t pc, DecodedInstruction ins)
+{
+    int64_t offset = ins.xyz();
+
+    if (ins.traits().backward)
+        offset -= 0x1000000;
+
+    return pc + 4 * offset;
+}
+
+/**
+ * Get the YZ value shifted into the wyde selected by the low two bits of the
+ * opcode: H, MH, ML, L.
+ */
+static uint64_t wyde(DecodedInstruction ins)
+{
+    unsigned shift = 48 - 16 * (opcode2byte(ins.opcode()) & 3);
+
+    return static_cast<uint64_t>(ins.yz()) << shift;
+}
+
+/**
+ * Select the handler specialized for the register count of a PUSHJ, PUSHGO,
+ * or POP, or keep the handler for its opcode if there is none.
+ */
+static uint16_t callDispatch(uint16_t dispatch, DecodedInstruction ins)
+{
+    Opcode op = ins.opcode();
+
+    //PUSHJB only differs from PUSHJ in its predecoded target.
+    if (Opcode::OP_PUSHJB == op)
+        op = Opcode::OP_PUSHJ;
+
+#define SIMEX_CALL_HANDLER(name, handler, opcode, count) \
+    if (Opcode::opcode == op && count == ins.x()) \
+        return DISPATCH_##name;
+
+    SIMEX_CALL_HANDLER_LIST
+
+#undef SIMEX_CALL_HANDLER
+
+    return dispatch;
+}
+
+/**
+ * Select the handler specialized for memory with the native byte order for a
+ * load or store.
+ */
+static uint16_t nativeDispatch(uint16_t dispatch, DecodedInstruction ins)
+{
+    Opcode op = ins.opcode();
+
+#define SIMEX_NATIVE_HANDLER(name, handler, opcode) \
+    if (Opcode::opcode == op) \
+        return DISPATCH_##name;
+
+    SIMEX_NATIVE_HANDLER_LIST
+
+#undef SIMEX_NATIVE_HANDLER
+
+    return dispatch;
+}
+
+/**
+ * Predecode a single instruction.
+ *
+ * \param p         The record to fill.
+ * \param pc        The address of the instruction.
+ * \param ins       The instruction to predecode.
+ * \param order     The byte order of memory, which selects the handler for
+ *                  a load or store.
+ *
+ * \returns true if this instruction ends a basic block.
+ */
+bool simex::predecodeInstruction(
+    PredecodedInstruction* p, uint64_t pc, DecodedInstruction ins,
+    ByteOrder order)
+{
+    p->label = nullptr;
+    p->ins = ins;
+    p->dispatch = opcode2byte(ins.opcode());
+    p->handler = opcodeHandlers[opcode2byte(ins.opcode())];
+    p->imm = ins.traits().zImmediate ? ins.z() : 0;
+    p->target = pc + 4;
+    p->count = 1;
+
+    switch (p->handler)
+    {
+        case HANDLER_opSet:
+        case HANDLER_opInc:
+        case HANDLER_opOrw:
+        case HANDLER_opAndnw:
+            p->imm = wyde(ins);
+            return false;
+
+        case HANDLER_opDiv:
+        case HANDLER_opDivu:
+            //a constant divisor is replaced with its reciprocal.
+            if (ins.traits().zImmediate)
+                reciprocal(ins.z(), &p->imm, &p->target);
+            return false;
+
+        case HANDLER_opGeta:
+            p->target = relativeYZ(pc, ins);
+            return false;
+
+        case HANDLER_opBranch:
+            p->target = relativeYZ(pc, ins);
+            return true;
+
+        case HANDLER_opPushj:
+            p->target = relativeYZ(pc, ins);
+            p->dispatch = callDispatch(p->dispatch, ins);
+            return true;
+
+        case HANDLER_opJmp:
+            p->target = relativeXYZ(pc, ins);
+            return true;
+
+        case HANDLER_opPushgo:
+            p->dispatch = callDispatch(p->dispatch, ins);
+            return true;
+
+        case HANDLER_opPop:
+            //POP with a nonzero YZ is left to the ordinary handler to fault.
+            if (0 == ins.yz())
+                p->dispatch = callDispatch(p->dispatch, ins);
+            return true;
+
+        case HANDLER_opLoad:
+        case HANDLER_opLdsf:
+        case HANDLER_opLdht:
+        case HANDLER_opCswap:
+        case HANDLER_opLdunc:
+        case HANDLER_opStore:
+        case HANDLER_opStsf:
+        case HANDLER_opStht:
+        case HANDLER_opStco:
+        case HANDLER_opStunc:
+            if (ByteOrder::Native == order)
+                p->dispatch = nativeDispatch(p->dispatch, ins);
+            return false;
+
+        case HANDLER_opGo:
+        case HANDLER_opResume:
+        case HANDLER_opSyscall:
+        case HANDLER_opUnsupported:
+        case HANDLER_opInvalid:
+            return true;
+
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,55 @@
+/**
+ * \file MachineState/queueBlock.cpp
+ *
+ * Queue a hot block for the background compiler.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include "CompileQueue.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Queue the block starting at an address for the background compiler, if it
+ * is still counting its entries.  From then on, its profile record waits for
+ * the code.
+ *
+ * \param m         The machine state.
+ * \param code      The cache of the segment holding the block.
+ * \param pc        The address of the first instruction of the block.
+ */
+void simex::queueBlock(
+    MachineStateImplementation* m, PredecodedSegment* code, uint64_t pc)
+{
+    PredecodedInstruction* block = code->entries[(pc - code->base) / 4];
+
+    if (nullptr == block || DISPATCH_profileBlock != block->dispatch)
+        return;
+
+    //the compiler thread starts when the first block gets hot.
+    if (nullptr == m->compiler)
+        m->compiler.reset(new CompileQueue(m));
+
+    ByteOrder order = m->space->byteOrder();
+    CompileJob job;
+
+    job.block = block;
+    job.pc = pc;
+    job.rG = sr(m, SReg::SR_RG);
+    job.native = ByteOrder::Native == order;
+    job.records.resize(MAX_BLOCK_INSTRUCTIONS);
+    job.records.resize(decodeBlock(code, pc, order, job.records.data()));
+
+    block->dispatch = DISPATCH_awaitCompiled;
+    if (nullptr != m->labels)
+        block->label = m->labels[DISPATCH_awaitCompiled];
+
+    ++m->jitStats.queued;
+    m->compiler->push(move(job));
+}
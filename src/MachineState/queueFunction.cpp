@@ -0,0 +1,44 @@
+/**
+ * \file MachineState/queueFunction.cpp
+ *
+ * Queue the blocks of a hot function for the background compiler.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <algorithm>
+
+#include "CompileQueue.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Queue the blocks of the function starting at an address for the
+ * background compiler: each block which was predecoded, from the first
+ * instruction of the function up to its first POP.  The scan stops after
+ * MAX_FUNCTION_INSTRUCTIONS, or at the end of the segment.
+ *
+ * \param m         The machine state.
+ * \param code      The cache of the segment holding the function.
+ * \param pc        The address of the first instruction of the function.
+ */
+void simex::queueFunction(
+    MachineStateImplementation* m, PredecodedSegment* code, uint64_t pc)
+{
+    ByteOrder order = m->space->byteOrder();
+    uint64_t left = (code->size & ~3ULL) - (pc - code->base);
+    uint64_t end = pc + min<uint64_t>(left, 4 * MAX_FUNCTION_INSTRUCTIONS);
+
+    for (uint64_t addr = pc; addr < end; addr += 4)
+    {
+        queueBlock(m, code, addr);
+
+        if (Opcode::OP_POP == code->decode(addr, order).opcode())
+            break;
+    }
+}
@@ -0,0 +1,40 @@
+/**
+ * \file MachineState/raiseDeferredFault.cpp
+ *
+ * Raise a fault which was deferred until its instruction completed.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Raise a deferred fault.  Since the instruction which deferred it has
+ * completed, rF is set so that RESUME continues at the program counter.  A
+ * fault deferred by a machine which has since halted is dropped.
+ *
+ * \param m         The machine state.
+ */
+void simex::raiseDeferredFault(MachineStateImplementation* m)
+{
+    Fault fault = m->deferredFault;
+    uint64_t pc = m->pc;
+    uint8_t tetra[4] = { 0, 0, 0, 0 };
+
+    m->deferredFault = Fault::None;
+    if (m->halted)
+        return;
+
+    //the instruction is only needed for the fault registers.
+    m->space->read(m->deferredPc, tetra, sizeof(tetra));
+
+    raiseFault(m, fault, DecodedInstruction::decode(tetra));
+    sr(m, SReg::SR_RF) = pc - 4;
+}
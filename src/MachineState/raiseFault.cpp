@@ -0,0 +1,47 @@
+/**
+ * \file MachineState/raiseFault.cpp
+ *
+ * Record the fault state and transfer control to the fault handler.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Raise a fault.  The fault state is recorded in the fault registers, and
+ * control is transferred to the fault handler at rFF.  If no fault handler is
+ * installed, the machine halts.
+ *
+ * \param m         The machine state.
+ * \param fault     The fault to raise.
+ * \param i         The instruction which faulted.
+ */
+void simex::raiseFault(
+    MachineStateImplementation* m, Fault fault, DecodedInstruction i)
+{
+    sr(m, SReg::SR_RF) = m->pc;
+    sr(m, SReg::SR_ROP) = i.tetra();
+    sr(m, SReg::SR_RXX) = peekReg(m, i.x());
+    sr(m, SReg::SR_RYY) = peekReg(m, i.y());
+    sr(m, SReg::SR_RZZ) =
+        zIsImmediate(i.opcode()) ? i.z() : peekReg(m, i.z());
+    sr(m, SReg::SR_RCC) = fault2code(fault);
+
+    if (sr(m, SReg::SR_RFF))
+    {
+        m->pc = sr(m, SReg::SR_RFF);
+    }
+    else
+    {
+        m->faulted = true;
+        m->owner->halt(0);
+    }
+}
@@ -0,0 +1,77 @@
+/**
+ * \file MachineState/reciprocal.h
+ *
+ * Division by a constant through a precomputed fixed-point reciprocal.
+ *
+ * The divisor of DIVI and DIVUI is an 8-bit constant, so the predecoder
+ * replaces it with R = ceil(2^72 / Z).  For any 64-bit n, the error in R is
+ * less than Z < 2^8, so floor(n * R / 2^72) is exactly floor(n / Z).  This
+ * turns a hardware divide of tens of cycles into two multiplies and a shift.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#ifndef  SIMEX_MACHINE_STATE_RECIPROCAL_HEADER_GUARD
+# define SIMEX_MACHINE_STATE_RECIPROCAL_HEADER_GUARD
+
+#include <cstdint>
+
+//this header is C++ specific
+#ifdef __cplusplus
+
+namespace simex {
+
+/**
+ * The fixed-point position of a reciprocal, in bits.
+ */
+const unsigned RECIPROCAL_SHIFT = 72;
+
+/**
+ * Compute the reciprocal of an 8-bit divisor.  The reciprocal of 0 is 0.
+ *
+ * \param divisor   The divisor.
+ * \param low       Set to the low octa of the reciprocal.
+ * \param high      Set to the high octa of the reciprocal.
+ */
+inline void reciprocal(
+    std::uint8_t divisor, std::uint64_t* low, std::uint64_t* high)
+{
+    unsigned __int128 r = 0;
+
+    if (divisor)
+        r = ((static_cast<unsigned __int128>(1) << RECIPROCAL_SHIFT) - 1)
+                / divisor + 1;
+
+    *low = static_cast<std::uint64_t>(r);
+    *high = static_cast<std::uint64_t>(r >> 64);
+}
+
+/**
+ * Divide by multiplying with a reciprocal.
+ *
+ * \param n         The dividend.
+ * \param low       The low octa of the reciprocal.
+ * \param high      The high octa of the reciprocal.
+ *
+ * \returns the quotient.
+ */
+inline std::uint64_t
+reciprocalDivide(std::uint64_t n, std::uint64_t low, std::uint64_t high)
+{
+    unsigned __int128 product = static_cast<unsigned __int128>(n) * low;
+
+    product = static_cast<unsigned __int128>(n) * high + (product >> 64);
+
+    return static_cast<std::uint64_t>(product >> (RECIPROCAL_SHIFT - 64));
+}
+
+/* namespace simex */ }
+
+//end of C++ code
+#endif //__cplusplus
+
+#endif //SIMEX_MACHINE_STATE_RECIPROCAL_HEADER_GUARD
@@ -0,0 +1,31 @@
+/**
+ * \file MachineState/reg.cpp
+ *
+ * Implementation of MachineState::reg().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/MachineState.h>
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Read a general purpose register.  Reading a register in the hole between rL
+ * and the global registers extends rL, as for guest code.
+ *
+ * \param r         The register to read.
+ *
+ * \returns the value of this register.
+ */
+uint64_t MachineState::reg(uint8_t r)
+{
+    return readReg(impl_.get(), r);
+}
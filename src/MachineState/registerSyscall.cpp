@@ -0,0 +1,33 @@
+/**
+ * \file MachineState/registerSyscall.cpp
+ *
+ * Implementation of MachineState::registerSyscall().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/MachineState.h>
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Register a host system call implementation.
+ *
+ * \param index     The system call index, as found in the YZ value of the
+ *                  SYSCALL instruction.
+ * \param method    The implementation, or nullptr to remove it.
+ */
+void MachineState::registerSyscall(uint16_t index, syscall_method_t method)
+{
+    if (method)
+        impl_->syscalls[index] = method;
+    else
+        impl_->syscalls.erase(index);
+}
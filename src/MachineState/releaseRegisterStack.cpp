@@ -0,0 +1,29 @@
+/**
+ * \file MachineState/releaseRegisterStack.cpp
+ *
+ * Release the address space of the rS region.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <sys/mman.h>
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Release the address space of an rS region, along with any pages which were
+ * committed.
+ *
+ * \param backing   The start of the region.
+ */
+void simex::releaseRegisterStack(uint64_t* backing)
+{
+    munmap(backing, STACK_RESERVE * sizeof(uint64_t));
+}
@@ -0,0 +1,38 @@
+/**
+ * \file MachineState/reserveRegisterStack.cpp
+ *
+ * Reserve address space for the rS region.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <new>
+#include <sys/mman.h>
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Reserve address space for an rS region, without committing any of it.  The
+ * pages are inaccessible until commitRegisterStack() reaches them, so a stray
+ * access past the committed part traps rather than reading garbage.
+ *
+ * \returns the start of the region.
+ */
+uint64_t* simex::reserveRegisterStack()
+{
+    void* p =
+        mmap(nullptr, STACK_RESERVE * sizeof(uint64_t), PROT_NONE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+    if (MAP_FAILED == p)
+        throw bad_alloc();
+
+    return static_cast<uint64_t*>(p);
+}
@@ -0,0 +1,114 @@
+/**
+ * \file MachineState/restoreContext.cpp
+ *
+ * Restore the register context from a big-endian image in guest memory.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Restore the register context, as for UNSAVE, from the image at the given
+ * address.  The special registers are read first, to find the size of the
+ * rest of the image.  The deepest offsets are restored to the rS region and
+ * the frame to the ring, as fillRegisters() would leave them.  The rest of
+ * the ring is left in the hole, so the cost depends only on the size of the
+ * image.  On failure, a fault is raised and the context is unchanged.
+ *
+ * \param m         The machine state.
+ * \param i         The instruction restoring the context.
+ * \param addr      The address of the image.
+ *
+ * \returns true if the context was restored.
+ */
+bool simex::restoreContext(
+    MachineStateImplementation* m, DecodedInstruction i, uint64_t addr)
+{
+    uint64_t available;
+    const uint8_t* p = translateOctas(m, i, addr, SEGMENT_READ, &available);
+
+    if (!p)
+        return false;
+
+    if (SIMEX_UNLIKELY(SPECIAL_REGISTER_COUNT > available))
+    {
+        raiseFault(m, Fault::MemoryProtection, i);
+        return false;
+    }
+
+    uint64_t sregs[SPECIAL_REGISTER_COUNT];
+    copyOctas(m, sregs, p, SPECIAL_REGISTER_COUNT);
+
+    uint64_t rG = sregs[sreg2offset(SReg::SR_RG)];
+    uint64_t rL = sregs[sreg2offset(SReg::SR_RL)];
+    uint64_t rO = sregs[sreg2offset(SReg::SR_RO)];
+
+    //the image can't have been saved with more than 256 local and global
+    //registers, or with more octas than fit in its segment.
+    if (SIMEX_UNLIKELY(
+            rG > REGISTER_COUNT || rL > REGISTER_COUNT - rG
+         || rG + rL > available - SPECIAL_REGISTER_COUNT
+         || rO > available - SPECIAL_REGISTER_COUNT - rG - rL))
+    {
+        raiseFault(m, Fault::MemoryProtection, i);
+        return false;
+    }
+
+    uint64_t top = rO + rL;
+
+    //keep up to half of the ring below the top, as fillRegisters() does.
+    uint64_t spilled = 0;
+    if (top > RING_SIZE / 2)
+        spilled = min(rO, top - RING_SIZE / 2);
+
+    //the rest of the register-stack must fit under the stack limit.
+    if (SIMEX_UNLIKELY(
+            spilled > m->stackLimit || !commitRegisterStack(m, spilled)))
+    {
+        raiseFault(m, Fault::StackOverflow, i);
+        return false;
+    }
+
+    //reserved special registers in the image land in the sink.
+    for (int r = 0; r < SPECIAL_REGISTER_COUNT; ++r)
+        m->sregs[sregWriteSlot(r)] = sregs[r];
+    p += 8 * SPECIAL_REGISTER_COUNT;
+
+    copyOctas(m, m->globals + REGISTER_COUNT - rG, p, rG);
+    p += 8 * rG;
+
+    //entries of the rS region above spilled are always zero.
+    if (spilled < m->spilled)
+        memset(m->backing + spilled, 0, 8 * (m->spilled - spilled));
+
+    copyOctas(m, m->backing, p, spilled);
+    p += 8 * spilled;
+
+    //the frame may wrap around the end of the ring once.
+    uint64_t slot = spilled & RING_MASK;
+    uint64_t first = min(top - spilled, RING_SIZE - slot);
+    uint64_t wrapped = top - spilled - first;
+
+    copyOctas(m, m->ring + slot, p, first);
+    copyOctas(m, m->ring, p + 8 * first, wrapped);
+    memset(m->written + slot, 1, first);
+    memset(m->written, 1, wrapped);
+
+    //the other slots still hold the old context, and are only zeroed if the
+    //frame grows over them.
+    m->spilled = spilled;
+    m->dirty = spilled + RING_SIZE;
+
+    return true;
+}
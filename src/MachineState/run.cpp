@@ -0,0 +1,56 @@
+/**
+ * \file MachineState/run.cpp
+ *
+ * Implementation of MachineState::run().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/MachineState.h>
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Run instructions starting at the current program counter.
+ *
+ * \param maxInstructions   The maximum number of instructions to run.
+ *
+ * \returns the reason that execution stopped.
+ */
+RunStatus MachineState::run(uint64_t maxInstructions)
+{
+    MachineStateImplementation* m = impl_.get();
+
+    //a fault deferred by the host is raised before anything else runs.
+    if (SIMEX_UNLIKELY(Fault::None != m->deferredFault))
+        raiseDeferredFault(m);
+
+    if (!m->halted)
+    {
+        m->budget = m->remaining = maxInstructions;
+
+        //the host may have changed segments since the last run.
+        m->code = nullptr;
+        syncTlb(m);
+
+        if (nullptr != m->space->guestView())
+            runProtected(m);
+        else
+            interpret(m);
+
+        //the host, or another thread, may look at memory once run() returns.
+        fenceUncached();
+    }
+
+    if (m->halted)
+        return m->faulted ? RunStatus::Faulted : RunStatus::Halted;
+    else
+        return RunStatus::InstructionLimit;
+}
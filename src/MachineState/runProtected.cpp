@@ -0,0 +1,171 @@
+/**
+ * \file MachineState/runProtected.cpp
+ *
+ * Implementation of runProtected(), which catches host faults on the arena.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <csetjmp>
+#include <csignal>
+#include <cstring>
+
+#include "MachineStateImplementation.h"
+#include "PredecodedInstruction.h"
+#include "handlers.h"
+
+using namespace simex;
+using namespace std;
+
+namespace {
+
+/**
+ * The arena access which the current thread is guarding.
+ */
+struct ArenaGuard
+{
+    //where to resume when an arena access faults.
+    sigjmp_buf jump;
+    //the guest view of the guarded arena, or nullptr.
+    const uint8_t* begin;
+    const uint8_t* end;
+};
+
+thread_local ArenaGuard guard;
+
+//the handlers which were installed before ours.
+struct sigaction previousSegv;
+struct sigaction previousBus;
+
+/**
+ * Pass a fault which isn't ours to the handler which was installed before
+ * ours.  A default or ignored action is restored, so that the faulting
+ * instruction is run again and the host fault takes its usual course.
+ */
+void chain(int sig, siginfo_t* info, void* context)
+{
+    const struct sigaction& previous =
+        SIGSEGV == sig ? previousSegv : previousBus;
+
+    if (previous.sa_flags & SA_SIGINFO)
+    {
+        previous.sa_sigaction(sig, info, context);
+    }
+    else if (SIG_DFL == previous.sa_handler || SIG_IGN == previous.sa_handler)
+    {
+        signal(sig, SIG_DFL);
+    }
+    else
+    {
+        previous.sa_handler(sig);
+    }
+}
+
+/**
+ * Turn a host fault on the guarded arena into a jump back to runProtected().
+ */
+void onFault(int sig, siginfo_t* info, void* context)
+{
+    const uint8_t* addr = static_cast<const uint8_t*>(info->si_addr);
+
+    if (nullptr != guard.begin && addr >= guard.begin && addr < guard.end)
+        siglongjmp(guard.jump, 1);
+
+    chain(sig, info, context);
+}
+
+/**
+ * Install the fault handler for SIGSEGV and SIGBUS, once per process.
+ */
+bool installFaultHandler()
+{
+    struct sigaction action;
+
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = &onFault;
+    //the handler leaves by jumping, so the signal must not stay blocked.
+    action.sa_flags = SA_SIGINFO | SA_NODEFER | SA_ONSTACK;
+    sigemptyset(&action.sa_mask);
+
+    sigaction(SIGSEGV, &action, &previousSegv);
+    sigaction(SIGBUS, &action, &previousBus);
+
+    return true;
+}
+
+/**
+ * Run the instruction at the program counter again with policy checked in
+ * software, after its arena access faulted.  It was already charged to the
+ * instruction budget, and nothing it changes is written before its access,
+ * so this either completes it or raises its guest fault.
+ */
+void retry(MachineStateImplementation* m)
+{
+    uint8_t tetra[4] = { 0, 0, 0, 0 };
+    PredecodedInstruction p;
+
+    m->space->read(m->pc, tetra, sizeof(tetra));
+    predecodeInstruction(
+        &p, m->pc, DecodedInstruction::decode(tetra), m->space->byteOrder());
+    evaluateRecord(m, p);
+}
+
+/**
+ * Guard the arena of a machine for the life of this object, restoring the
+ * previous guard afterward.  A host can run a machine from a system call of
+ * another machine, so guards nest.
+ */
+class ScopedGuard
+{
+public:
+
+    ScopedGuard(MachineStateImplementation* m)
+        : m_(m), limit_(m->arenaLimit)
+    {
+        memcpy(&saved_, &guard, sizeof(saved_));
+        guard.begin = m->arena;
+        guard.end = m->arena + AddressSpace::HOST_ARENA_SIZE;
+    }
+
+    ~ScopedGuard()
+    {
+        m_->arenaLimit = limit_;
+        memcpy(&guard, &saved_, sizeof(saved_));
+    }
+
+private:
+    MachineStateImplementation* m_;
+    uint64_t limit_;
+    ArenaGuard saved_;
+};
+
+}
+
+/**
+ * Run the rest of the instruction budget, letting loads and stores access the
+ * host arena directly.  A host fault on an arena access is caught, and the
+ * instruction which caused it is run again with policy checked in software,
+ * which raises the guest fault precisely.
+ *
+ * \param m         The machine state, whose address space has a host arena.
+ */
+void simex::runProtected(MachineStateImplementation* m)
+{
+    static const bool installed = installFaultHandler();
+    (void)installed;
+
+    ScopedGuard scope(m);
+
+    if (sigsetjmp(guard.jump, 0))
+    {
+        m->arenaLimit = 0;
+        retry(m);
+    }
+
+    m->arenaLimit = AddressSpace::HOST_ARENA_SIZE;
+    interpret(m);
+}
@@ -0,0 +1,78 @@
+/**
+ * \file MachineState/saveContext.cpp
+ *
+ * Save the register context to a big-endian image in guest memory.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <algorithm>
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Save the register context, as for SAVE, to the image at the given address.
+ * The image holds the special registers, the global registers, and every
+ * register-stack offset below rO + rL, as octas in the byte order of memory.
+ * The registers are contiguous in the host, apart from the ring, which may
+ * wrap once, so the image is written as a handful of bulk copies.  On
+ * failure, a fault is raised.
+ *
+ * \param m         The machine state.
+ * \param i         The instruction saving the context.
+ * \param addr      The address of the image.
+ * \param size      Set to the size of the image in bytes.
+ *
+ * \returns true if the context was saved.
+ */
+bool simex::saveContext(
+    MachineStateImplementation* m, DecodedInstruction i, uint64_t addr,
+    uint64_t* size)
+{
+    uint64_t rG = sr(m, SReg::SR_RG);
+    uint64_t top = sr(m, SReg::SR_RO) + sr(m, SReg::SR_RL);
+    uint64_t count = SPECIAL_REGISTER_COUNT + rG + top;
+    uint64_t available;
+    uint8_t* p = translateOctas(m, i, addr, SEGMENT_WRITE, &available);
+
+    if (!p)
+        return false;
+
+    if (SIMEX_UNLIKELY(count > available))
+    {
+        raiseFault(m, Fault::MemoryProtection, i);
+        return false;
+    }
+
+    //the image keeps the special registers in architectural order.
+    uint64_t sregs[SPECIAL_REGISTER_COUNT];
+    for (int r = 0; r < SPECIAL_REGISTER_COUNT; ++r)
+        sregs[r] = m->sregs[sregReadSlot(r)];
+
+    copyOctas(m, p, sregs, SPECIAL_REGISTER_COUNT);
+    p += 8 * SPECIAL_REGISTER_COUNT;
+
+    copyOctas(m, p, m->globals + REGISTER_COUNT - rG, rG);
+    p += 8 * rG;
+
+    //offsets below spilled are in the rS region, and the rest are in the ring.
+    uint64_t spilled = min(m->spilled, top);
+    copyOctas(m, p, m->backing, spilled);
+    p += 8 * spilled;
+
+    uint64_t slot = spilled & RING_MASK;
+    uint64_t first = min(top - spilled, RING_SIZE - slot);
+    copyOctas(m, p, m->ring + slot, first);
+    copyOctas(m, p + 8 * first, m->ring, top - spilled - first);
+
+    *size = 8 * count;
+
+    return true;
+}
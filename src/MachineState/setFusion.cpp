@@ -0,0 +1,31 @@
+/**
+ * \file MachineState/setFusion.cpp
+ *
+ * Implementation of MachineState::setFusion().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/MachineState.h>
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Enable or disable superinstruction fusion.  Fusion is enabled by default.
+ * Changing this setting causes code to be predecoded again.
+ *
+ * \param enabled   true if common instruction sequences should be combined
+ *                  into superinstructions.
+ */
+void MachineState::setFusion(bool enabled)
+{
+    impl_->fusion = enabled;
+    impl_->code = nullptr;
+}
@@ -0,0 +1,32 @@
+/**
+ * \file MachineState/setJit.cpp
+ *
+ * Implementation of MachineState::setJit().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/MachineState.h>
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Enable or disable the JIT.  The JIT is disabled by default, and is only
+ * available on x86-64 hosts.  Changing this setting causes code to be
+ * predecoded again.
+ *
+ * \param enabled   true if blocks should be translated to host machine
+ *                  code.
+ */
+void MachineState::setJit(bool enabled)
+{
+    impl_->jit = enabled;
+    impl_->code = nullptr;
+}
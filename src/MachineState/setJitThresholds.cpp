@@ -0,0 +1,38 @@
+/**
+ * \file MachineState/setJitThresholds.cpp
+ *
+ * Implementation of MachineState::setJitThresholds().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/MachineState.h>
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Set when the JIT translates code.  A block threshold of 0 translates every
+ * block as it is first predecoded; a function threshold of 0 leaves calls
+ * uncounted.  The new thresholds take effect on the next entry to each
+ * block, which keeps the entries and calls counted so far.  Switching
+ * between a block threshold of 0 and another one while the JIT is enabled
+ * predecodes code again, since only then do blocks count their entries.
+ *
+ * \param blockThreshold      The entries after which a block is queued.
+ * \param functionThreshold   The calls after which the blocks of a function
+ *                            are queued.
+ */
+void MachineState::setJitThresholds(
+    uint64_t blockThreshold, uint64_t functionThreshold)
+{
+    impl_->blockThreshold = blockThreshold;
+    impl_->functionThreshold = functionThreshold;
+    impl_->code = nullptr;
+}
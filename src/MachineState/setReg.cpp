@@ -0,0 +1,30 @@
+/**
+ * \file MachineState/setReg.cpp
+ *
+ * Implementation of MachineState::setReg().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/MachineState.h>
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Write a general purpose register.  Writing a register in the hole between
+ * rL and the global registers extends rL, as for guest code.
+ *
+ * \param r         The register to write.
+ * \param value     The value to write.
+ */
+void MachineState::setReg(uint8_t r, uint64_t value)
+{
+    writeReg(impl_.get(), r, value);
+}
@@ -0,0 +1,75 @@
+/**
+ * \file MachineState/setSReg.cpp
+ *
+ * Implementation of MachineState::setSReg().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <simex/MachineState.h>
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Write a special register directly, without the restrictions of PUT.  Writes
+ * to reserved registers are ignored.  This is meant for the host.
+ *
+ * \param r         The special register to write.
+ * \param value     The value to write.
+ */
+void MachineState::setSReg(SReg r, uint64_t value)
+{
+    MachineStateImplementation* m = impl_.get();
+    if (isReservedSReg(sreg2offset(r)))
+        return;
+
+    if (SReg::SR_RO != r && SReg::SR_RL != r)
+    {
+        sr(m, r) = value;
+        return;
+    }
+
+    uint64_t top = sr(m, SReg::SR_RO) + sr(m, SReg::SR_RL);
+    uint64_t newTop =
+        (SReg::SR_RO == r ? value : sr(m, SReg::SR_RO))
+      + (SReg::SR_RL == r ? value : sr(m, SReg::SR_RL));
+
+    //the new frame must fit in the reserved rS region.
+    if (value > STACK_RESERVE || newTop > STACK_RESERVE
+     || !commitRegisterStack(m, max(top, newTop)))
+    {
+        return;
+    }
+
+    //the host may move the register-stack anywhere, so spill every local
+    //register and fill the new frame from the rS region.  The host isn't
+    //bound by the stack limit, so this spill can't raise a stack overflow.
+    uint64_t limit = m->stackLimit;
+    m->stackLimit = STACK_RESERVE;
+    spillRegisters(m, top + RING_SIZE);
+    m->stackLimit = limit;
+    sr(m, r) = value;
+
+    //the only values left in the ring are stale ones in the hole.
+    memset(m->ring, 0, sizeof(m->ring));
+    memset(m->written, 0, sizeof(m->written));
+    m->dirty = 0;
+
+    uint64_t bottom = sr(m, SReg::SR_RO);
+
+    //registers above the new frame fall into the hole.
+    if (newTop < top)
+        fill(m->backing + newTop, m->backing + top, 0);
+
+    m->spilled = newTop;
+    fillRegisters(m, bottom);
+}
@@ -0,0 +1,31 @@
+/**
+ * \file MachineState/setStackLimit.cpp
+ *
+ * Implementation of MachineState::setStackLimit().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <algorithm>
+#include <simex/MachineState.h>
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Set the limit on the number of registers held in the rS region.  The limit
+ * is capped so that the slack for the fault handler fits in the reserved
+ * address space.
+ *
+ * \param registers The largest number of registers in the rS region.
+ */
+void MachineState::setStackLimit(uint64_t registers)
+{
+    impl_->stackLimit = min(registers, STACK_RESERVE - STACK_SLACK);
+}
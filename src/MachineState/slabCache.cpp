@@ -0,0 +1,28 @@
+/**
+ * \file MachineState/slabCache.cpp
+ *
+ * Implementation of MachineState::slabCache().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/MachineState.h>
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Get the cache of free slab segments which this system thread allocates
+ * from.  Host system calls which allocate or free segments for this machine
+ * should use it.
+ */
+SlabCache& MachineState::slabCache()
+{
+    return impl_->slabs;
+}
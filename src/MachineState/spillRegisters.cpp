@@ -0,0 +1,66 @@
+/**
+ * \file MachineState/spillRegisters.cpp
+ *
+ * Spill the oldest registers of the local register ring to the rS region.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <algorithm>
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Spill the oldest registers in the ring to the rS region, until offsets from
+ * spilled up to top fit in the ring.  The freed slots are zeroed.
+ *
+ * \param m         The machine state.
+ * \param top       The offset just past the registers which must fit.
+ */
+void simex::spillRegisters(MachineStateImplementation* m, uint64_t top)
+{
+    if (top <= m->spilled + RING_SIZE)
+        return;
+
+    uint64_t rO = sr(m, SReg::SR_RO);
+    uint64_t end = top - RING_SIZE;
+
+    //spill down to half of the ring, so that calls which go back and forth
+    //across the edge of the ring don't spill every time.  The count register
+    //of the caller stays in the ring for popFrame().
+    if (rO > 0)
+        end = max(end, min(top - RING_SIZE / 2, rO - 1));
+
+    //crossing the stack limit raises a stack overflow once this instruction
+    //completes.  The slack past the limit is left for the fault handler.
+    if (SIMEX_UNLIKELY(end > m->stackLimit && m->spilled <= m->stackLimit))
+        deferFault(m, Fault::StackOverflow);
+
+    //pages of the rS region are committed as spills reach them.
+    if (SIMEX_UNLIKELY(end > m->committed)
+     && (end > m->stackLimit + STACK_SLACK || !commitRegisterStack(m, end)))
+    {
+        //the fault handler overran the slack, so the machine stops.
+        sr(m, SReg::SR_RCC) = fault2code(Fault::StackOverflow);
+        m->faulted = true;
+        m->owner->halt(0);
+        return;
+    }
+
+    for (uint64_t k = m->spilled; k < end; ++k)
+    {
+        uint64_t& slot = ringSlot(m, k);
+
+        m->backing[k] = slot;
+        slot = 0;
+    }
+
+    m->spilled = end;
+}
@@ -0,0 +1,30 @@
+/**
+ * \file MachineState/sreg.cpp
+ *
+ * Implementation of MachineState::sreg().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/MachineState.h>
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Read a special register.  Reserved registers read as 0.
+ *
+ * \param r         The special register to read.
+ *
+ * \returns the value of this special register.
+ */
+uint64_t MachineState::sreg(SReg r) const
+{
+    return impl_->sregs[sregReadSlot(sreg2offset(r))];
+}
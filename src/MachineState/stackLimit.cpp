@@ -0,0 +1,26 @@
+/**
+ * \file MachineState/stackLimit.cpp
+ *
+ * Implementation of MachineState::stackLimit().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/MachineState.h>
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Get the limit on the number of registers held in the rS region.
+ */
+uint64_t MachineState::stackLimit() const
+{
+    return impl_->stackLimit;
+}
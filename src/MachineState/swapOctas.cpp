@@ -0,0 +1,88 @@
+/**
+ * \file MachineState/swapOctas.cpp
+ *
+ * Copy octas between host order and big-endian order.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <cstring>
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+namespace {
+
+    /**
+     * The widest vector copy supported by this processor.
+     */
+    enum class SwapStrategy
+    {
+        Scalar,
+        SSSE3,
+        AVX2
+    };
+
+    /**
+     * Choose the widest vector copy supported by this processor.
+     */
+    SwapStrategy bestSwapStrategy()
+    {
+#ifdef SIMEX_SWAP_OCTAS_X86
+        //this may be called before static constructors have run.
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("avx2"))
+            return SwapStrategy::AVX2;
+        else if (__builtin_cpu_supports("ssse3"))
+            return SwapStrategy::SSSE3;
+#endif
+
+        return SwapStrategy::Scalar;
+    }
+}
+
+/**
+ * Copy octas, reversing the bytes of each, so that host-order registers
+ * become big-endian guest memory or the reverse.  The source and destination
+ * must not overlap, and need not be aligned.  The vector copies leave a short
+ * remainder, which is copied one octa at a time.
+ *
+ * \param dst       The destination.
+ * \param src       The source.
+ * \param count     The number of octas to copy.
+ */
+void simex::swapOctas(void* dst, const void* src, size_t count)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    //guest order is host order.
+    memcpy(dst, src, 8 * count);
+#else
+    static const SwapStrategy strategy = bestSwapStrategy();
+    uint8_t* out = static_cast<uint8_t*>(dst);
+    const uint8_t* in = static_cast<const uint8_t*>(src);
+    size_t done = 0;
+
+#ifdef SIMEX_SWAP_OCTAS_X86
+    if (SwapStrategy::AVX2 == strategy)
+        done = swapOctasAVX2(out, in, count);
+    else if (SwapStrategy::SSSE3 == strategy)
+        done = swapOctasSSSE3(out, in, count);
+#endif
+
+    for (size_t i = done; i < count; ++i)
+    {
+        uint64_t value;
+
+        memcpy(&value, in + 8 * i, 8);
+        value = __builtin_bswap64(value);
+        memcpy(out + 8 * i, &value, 8);
+    }
+#endif
+}
@@ -0,0 +1,51 @@
+/**
+ * \file MachineState/swapOctasAVX2.cpp
+ *
+ * Byte swap octas four at a time using AVX2 byte shuffles.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include "MachineStateImplementation.h"
+
+#ifdef SIMEX_SWAP_OCTAS_X86
+
+#include <immintrin.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Copy octas, reversing the bytes of each, eight at a time using AVX2.
+ *
+ * This is the SSSE3 shuffle applied to both 128-bit lanes at once.
+ *
+ * \returns the number of octas copied.
+ */
+__attribute__((target("avx2")))
+size_t simex::swapOctasAVX2(void* dst, const void* src, size_t count)
+{
+    const __m256i reverse =
+        _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                         7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    const __m256i* in = static_cast<const __m256i*>(src);
+    __m256i* out = static_cast<__m256i*>(dst);
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8, in += 2, out += 2)
+    {
+        __m256i a = _mm256_loadu_si256(in);
+        __m256i b = _mm256_loadu_si256(in + 1);
+
+        _mm256_storeu_si256(out, _mm256_shuffle_epi8(a, reverse));
+        _mm256_storeu_si256(out + 1, _mm256_shuffle_epi8(b, reverse));
+    }
+
+    return i;
+}
+
+#endif //SIMEX_SWAP_OCTAS_X86
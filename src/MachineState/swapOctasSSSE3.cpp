@@ -0,0 +1,48 @@
+/**
+ * \file MachineState/swapOctasSSSE3.cpp
+ *
+ * Byte swap octas two at a time using SSSE3 byte shuffles.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include "MachineStateImplementation.h"
+
+#ifdef SIMEX_SWAP_OCTAS_X86
+
+#include <immintrin.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Copy octas, reversing the bytes of each, four at a time using SSSE3.
+ *
+ * \returns the number of octas copied.
+ */
+__attribute__((target("ssse3")))
+size_t simex::swapOctasSSSE3(void* dst, const void* src, size_t count)
+{
+    const __m128i reverse =
+        _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    const __m128i* in = static_cast<const __m128i*>(src);
+    __m128i* out = static_cast<__m128i*>(dst);
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4, in += 2, out += 2)
+    {
+        __m128i a = _mm_loadu_si128(in);
+        __m128i b = _mm_loadu_si128(in + 1);
+
+        _mm_storeu_si128(out, _mm_shuffle_epi8(a, reverse));
+        _mm_storeu_si128(out + 1, _mm_shuffle_epi8(b, reverse));
+    }
+
+    return i;
+}
+
+#endif //SIMEX_SWAP_OCTAS_X86
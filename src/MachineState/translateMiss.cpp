@@ -0,0 +1,59 @@
+/**
+ * \file MachineState/translateMiss.cpp
+ *
+ * Translate a guest address which missed in the software TLB.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Translate a guest address which missed in the software TLB, checking
+ * alignment and policy, and fill the TLB entry for its page.  Segments are
+ * sized in whole pages, so the whole page shares the policy of its segment.
+ * On failure, a fault is raised and nullptr is returned.
+ *
+ * \param m         The machine state.
+ * \param i         The instruction accessing memory.
+ * \param addr      The guest address.
+ * \param size      The size of the access, which the address must be aligned
+ *                  to.
+ * \param policy    The policy required of the segment.
+ *
+ * \returns the host address, or nullptr if a fault was raised.
+ */
+uint8_t* simex::translateMiss(
+    MachineStateImplementation* m, DecodedInstruction i, uint64_t addr,
+    uint64_t size, uint8_t policy)
+{
+    if (addr & (size - 1))
+    {
+        raiseFault(m, Fault::MemoryAlignment, i);
+        return nullptr;
+    }
+
+    Segment* seg = m->space->find(addr);
+    if (!seg || (seg->policy() & policy) != policy)
+    {
+        raiseFault(m, Fault::MemoryProtection, i);
+        return nullptr;
+    }
+
+    uint64_t page = addr & ~PAGE_OFFSET_MASK;
+    uint8_t* host = seg->data() + (page - seg->base());
+    TlbEntry& e = m->tlb[(addr / AddressSpace::PAGE_SIZE) & TLB_MASK];
+
+    e.read = (seg->policy() & SEGMENT_READ) ? page : TLB_INVALID;
+    e.write = (seg->policy() & SEGMENT_WRITE) ? page : TLB_INVALID;
+    e.addend = reinterpret_cast<uintptr_t>(host) - page;
+
+    return host + (addr - page);
+}
@@ -0,0 +1,32 @@
+/**
+ * \file MachineState/waitForJit.cpp
+ *
+ * Implementation of MachineState::waitForJit().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/MachineState.h>
+
+#include "CompileQueue.h"
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Wait for the background compiler to translate every block queued so far,
+ * and patch in the code.
+ */
+void MachineState::waitForJit()
+{
+    if (nullptr == impl_->compiler)
+        return;
+
+    impl_->compiler->wait();
+    installCompiled(impl_.get());
+}
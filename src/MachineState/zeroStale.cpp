@@ -0,0 +1,79 @@
+/**
+ * \file MachineState/zeroStale.cpp
+ *
+ * Zero stale registers as they are exposed from the hole.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "MachineStateImplementation.h"
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Zero the written ring slots for register-stack offsets from begin up to end,
+ * which are being exposed below the high-water mark of the hole.
+ *
+ * Only slots which were written since they were last zeroed can be stale.
+ * Their flags are checked eight at a time, so exposing a large frame which
+ * was mostly unused is cheap.
+ *
+ * \param m         The machine state.
+ * \param begin     The first offset to zero.
+ * \param end       The offset just past the last one to zero.
+ */
+void simex::zeroStale(
+    MachineStateImplementation* m, uint64_t begin, uint64_t end)
+{
+    uint64_t stop = min(end, m->dirty);
+
+    //the offsets may wrap around the end of the ring, so visit the slots in
+    //up to two contiguous pieces.
+    while (begin < stop)
+    {
+        uint64_t slot = begin & RING_MASK;
+        uint64_t last = min(RING_SIZE, slot + (stop - begin));
+
+        begin += last - slot;
+
+        //skip eight slots at once if none of them were written.
+        for (; slot + 8 <= last; slot += 8)
+        {
+            uint64_t flags;
+
+            memcpy(&flags, m->written + slot, sizeof(flags));
+            if (SIMEX_UNLIKELY(flags))
+            {
+                for (uint64_t i = slot; i < slot + 8; ++i)
+                {
+                    if (m->written[i])
+                        m->ring[i] = 0;
+                }
+
+                memset(m->written + slot, 0, 8);
+            }
+        }
+
+        for (; slot < last; ++slot)
+        {
+            if (m->written[slot])
+            {
+                m->ring[slot] = 0;
+                m->written[slot] = 0;
+            }
+        }
+    }
+
+    //every stale register is zeroed once the frame reaches the high-water
+    //mark.
+    if (end >= m->dirty)
+        m->dirty = 0;
+}
@@ -0,0 +1,33 @@
+/**
+ * \file PageTable/PageTable.cpp
+ *
+ * Implementation of the PageTable constructor.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/PageTable.h>
+
+using namespace simex;
+using namespace std;
+
+//storage for static constants.
+const int PageTable::PAGE_BITS;
+const int PageTable::LEVEL_BITS;
+const int PageTable::LEVELS;
+const uintptr_t PageTable::FULL_TAG;
+const uintptr_t PageTable::PARTIAL_TAG;
+const uintptr_t PageTable::TAG_MASK;
+
+/**
+ * Create an empty page table.
+ */
+PageTable::PageTable()
+    : root_(new Node())
+{
+    nodes_.emplace_back(root_);
+}
@@ -0,0 +1,87 @@
+/**
+ * \file PageTable/assign.cpp
+ *
+ * Assign a range of a page table node to a segment.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <algorithm>
+#include <simex/AddressSpace.h>
+#include <simex/PageTable.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Assign the inclusive range of addresses from first to last, within a single
+ * node, to a segment, or clear it.  Slots covered entirely by the range take
+ * the segment directly, as do empty slots which the range covers in part.  A
+ * slot already holding another segment is split into a child node holding
+ * both.
+ *
+ * \param node      The node holding the range.
+ * \param level     The level of this node, where the root is level 0.
+ * \param first     The first address of the range.
+ * \param last      The last address of the range.
+ * \param seg       The segment holding the range, or nullptr to clear it.
+ */
+void PageTable::assign(
+    Node* node, int level, uint64_t first, uint64_t last, Segment* seg)
+{
+    const uint64_t mask = (1 << LEVEL_BITS) - 1;
+    int shift = PAGE_BITS + LEVEL_BITS * (LEVELS - 1 - level);
+    uint64_t span = uint64_t(1) << shift;
+    uintptr_t full = seg ? reinterpret_cast<uintptr_t>(seg) | FULL_TAG : 0;
+    uintptr_t partial =
+        seg ? reinterpret_cast<uintptr_t>(seg) | PARTIAL_TAG : 0;
+
+    for (;;)
+    {
+        uint64_t slotBase = first & ~(span - 1);
+        uint64_t slotLast = slotBase + (span - 1);
+        uint64_t end = min(last, slotLast);
+        atomic<uintptr_t>& slot = node->slots[(first >> shift) & mask];
+        uintptr_t old = slot.load(memory_order_relaxed);
+        Segment* prev = reinterpret_cast<Segment*>(old & ~TAG_MASK);
+
+        if (first == slotBase && end == slotLast)
+        {
+            //any child node is left for readers which are still in it.
+            slot.store(full, memory_order_release);
+        }
+        else if (old && !(old & TAG_MASK))
+        {
+            assign(reinterpret_cast<Node*>(old), level + 1, first, end, seg);
+        }
+        else if (!old || !seg)
+        {
+            //the only segment in an empty slot, or the one being removed.
+            slot.store(partial, memory_order_release);
+        }
+        else if (prev != seg)
+        {
+            //split the slot, moving the segment already in it down a level.
+            Node* child = new Node();
+            nodes_.emplace_back(child);
+
+            uint64_t prevFirst = max(prev->base(), slotBase);
+            uint64_t prevLast =
+                min(prev->base() + (prev->size() - 1), slotLast);
+
+            assign(child, level + 1, prevFirst, prevLast, prev);
+            assign(child, level + 1, first, end, seg);
+            slot.store(reinterpret_cast<uintptr_t>(child),
+                       memory_order_release);
+        }
+
+        if (end == last)
+            return;
+
+        first = end + 1;
+    }
+}
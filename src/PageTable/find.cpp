@@ -0,0 +1,56 @@
+/**
+ * \file PageTable/find.cpp
+ *
+ * Implementation of PageTable::find().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/AddressSpace.h>
+#include <simex/PageTable.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Find the segment holding the given guest address.  This is safe to call
+ * while another thread inserts or removes segments.
+ *
+ * \param addr      The guest address to look up.
+ *
+ * \returns the segment holding this address, or nullptr.
+ */
+Segment* PageTable::find(uint64_t addr) const
+{
+    const uint64_t mask = (1 << LEVEL_BITS) - 1;
+    const Node* node = root_;
+
+    for (int level = 0; level < LEVELS; ++level)
+    {
+        int shift = PAGE_BITS + LEVEL_BITS * (LEVELS - 1 - level);
+        uintptr_t slot =
+            node->slots[(addr >> shift) & mask].load(memory_order_acquire);
+
+        if (slot & TAG_MASK)
+        {
+            Segment* seg = reinterpret_cast<Segment*>(slot & ~TAG_MASK);
+
+            //a segment which covers only part of the slot is checked.
+            if ((slot & PARTIAL_TAG) && !seg->contains(addr))
+                return nullptr;
+
+            return seg;
+        }
+
+        if (!slot)
+            return nullptr;
+
+        node = reinterpret_cast<const Node*>(slot);
+    }
+
+    return nullptr;
+}
@@ -0,0 +1,29 @@
+/**
+ * \file PageTable/insert.cpp
+ *
+ * Implementation of PageTable::insert().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/AddressSpace.h>
+#include <simex/PageTable.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Insert a segment, which must be page aligned, sized in whole pages, and must
+ * not overlap any segment in the table.  Only one thread may insert or remove
+ * segments at a time.
+ *
+ * \param seg       The segment to insert.
+ */
+void PageTable::insert(Segment* seg)
+{
+    assign(root_, 0, seg->base(), seg->base() + (seg->size() - 1), seg);
+}
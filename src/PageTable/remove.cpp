@@ -0,0 +1,28 @@
+/**
+ * \file PageTable/remove.cpp
+ *
+ * Implementation of PageTable::remove().
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/AddressSpace.h>
+#include <simex/PageTable.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Remove a segment which was inserted.  Only one thread may insert or remove
+ * segments at a time.
+ *
+ * \param seg       The segment to remove.
+ */
+void PageTable::remove(Segment* seg)
+{
+    assign(root_, 0, seg->base(), seg->base() + (seg->size() - 1), nullptr);
+}
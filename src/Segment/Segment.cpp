@@ -0,0 +1,90 @@
+/**
+ * \file Segment/Segment.cpp
+ *
+ * Constructor for Segment.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <cstdlib>
+#include <new>
+#include <simex/AddressSpace.h>
+#include <sys/mman.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Create a zero-filled segment.  The host commits the memory of a large
+ * segment as its pages are first touched.
+ *
+ * \param base      The guest address of the first byte of this segment.
+ * \param size      The size of this segment, in bytes.
+ * \param policy    The policy bits for this segment.
+ */
+Segment::Segment(uint64_t base, uint64_t size, uint8_t policy)
+    : base_(base), size_(size), memory_(nullptr), policy_(policy),
+      sizeClass_(0), inUse_(true), allocated_(nullptr), mapped_(0),
+      version_(nextVersion())
+{
+    //segments larger than a slab segment are mapped directly from the host,
+    //which commits their pages as they are first touched.
+    if (size > AddressSpace::SLAB_MAX_SIZE)
+    {
+        void* memory =
+            mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (MAP_FAILED == memory)
+            throw bad_alloc();
+
+        memory_ = static_cast<uint8_t*>(memory);
+        mapped_ = size;
+        return;
+    }
+
+    allocated_ = static_cast<uint8_t*>(calloc(size, 1));
+    if (nullptr == allocated_ && 0 != size)
+        throw bad_alloc();
+
+    memory_ = allocated_;
+}
+
+/**
+ * Create a segment over existing host memory, which must be zero-filled and
+ * outlive the segment.
+ *
+ * \param base      The guest address of the first byte of this segment.
+ * \param size      The size of this segment, in bytes.
+ * \param policy    The policy bits for this segment.
+ * \param memory    The host memory backing this segment.
+ */
+Segment::Segment(
+    uint64_t base, uint64_t size, uint8_t policy, uint8_t* memory)
+    : base_(base), size_(size), memory_(memory), policy_(policy),
+      sizeClass_(0), inUse_(true), allocated_(nullptr), mapped_(0),
+      version_(nextVersion())
+{
+}
+
+/**
+ * Create a segment over a host mapping, which the segment takes and unmaps
+ * when it is destroyed.
+ *
+ * \param base      The guest address of the first byte of this segment.
+ * \param size      The size of this segment, in bytes.
+ * \param policy    The policy bits for this segment.
+ * \param memory    The host mapping backing this segment.
+ * \param mapped    The length of the host mapping, in bytes.
+ */
+Segment::Segment(
+    uint64_t base, uint64_t size, uint8_t policy, uint8_t* memory,
+    uint64_t mapped)
+    : base_(base), size_(size), memory_(memory), policy_(policy),
+      sizeClass_(0), inUse_(true), allocated_(nullptr), mapped_(mapped),
+      version_(nextVersion())
+{
+}
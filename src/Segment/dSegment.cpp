@@ -0,0 +1,29 @@
+/**
+ * \file Segment/dSegment.cpp
+ *
+ * Destructor for Segment.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <cstdlib>
+#include <simex/AddressSpace.h>
+#include <sys/mman.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Destructor.
+ */
+Segment::~Segment()
+{
+    ::free(allocated_);
+
+    if (0 != mapped_)
+        munmap(memory_, mapped_);
+}
@@ -0,0 +1,28 @@
+/**
+ * \file Segment/nextVersion.cpp
+ *
+ * Hand out segment versions.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/AddressSpace.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Get a version which no segment has had before.  Versions are shared by
+ * every address space, so that a segment mapped where another one was never
+ * takes on its version.
+ */
+uint64_t Segment::nextVersion()
+{
+    static atomic<uint64_t> versions(0);
+
+    return versions.fetch_add(1, memory_order_relaxed) + 1;
+}
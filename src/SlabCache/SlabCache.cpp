@@ -0,0 +1,25 @@
+/**
+ * \file SlabCache/SlabCache.cpp
+ *
+ * Constructor for SlabCache.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/AddressSpace.h>
+
+using namespace simex;
+
+/**
+ * Create an empty cache for allocating from the given address space.
+ *
+ * \param space     The address space to allocate from.
+ */
+SlabCache::SlabCache(AddressSpace& space)
+    : space_(space)
+{
+}
@@ -0,0 +1,29 @@
+/**
+ * \file SlabCache/dSlabCache.cpp
+ *
+ * Destructor for SlabCache.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <simex/AddressSpace.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Destructor.  Free segments go back to the depot of the address space.
+ */
+SlabCache::~SlabCache()
+{
+    for (size_t sizeClass = 0; sizeClass < AddressSpace::SLAB_CLASS_COUNT;
+         ++sizeClass)
+    {
+        if (!free_[sizeClass].empty())
+            space_.drain(*this, sizeClass, free_[sizeClass].size());
+    }
+}
@@ -0,0 +1,402 @@
+/**
+ * \file TestAddressSpace.cpp
+ *
+ * Test the AddressSpace and Segment classes.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <simex/AddressSpace.h>
+#include <sys/mman.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Test that segments are page aligned, rounded up to whole pages, and can't
+ * overlap.
+ */
+TEST(AddressSpace, map)
+{
+    AddressSpace space;
+
+    //misaligned and empty segments are rejected.
+    EXPECT_EQ(nullptr, space.map(0x1001, 16, SEGMENT_READ));
+    EXPECT_EQ(nullptr, space.map(0x1000, 0, SEGMENT_READ));
+
+    Segment* seg = space.map(0x2000, 16, SEGMENT_READ);
+    ASSERT_NE(nullptr, seg);
+    EXPECT_EQ(0x2000U, seg->base());
+    EXPECT_EQ(AddressSpace::PAGE_SIZE, seg->size());
+    EXPECT_EQ(SEGMENT_READ, seg->policy());
+
+    //overlapping segments are rejected, but adjacent segments are fine.
+    EXPECT_EQ(nullptr, space.map(0x1000, 0x1001, SEGMENT_READ));
+    EXPECT_EQ(nullptr, space.map(0x2000, 16, SEGMENT_READ));
+    EXPECT_NE(nullptr, space.map(0x1000, 0x1000, SEGMENT_READ));
+    EXPECT_NE(nullptr, space.map(0x3000, 0x1000, SEGMENT_READ));
+}
+
+/**
+ * Test that find() returns the segment containing an address.
+ */
+TEST(AddressSpace, find)
+{
+    AddressSpace space;
+
+    Segment* a = space.map(0x1000, 0x1000, SEGMENT_READ);
+    Segment* b = space.map(0x4000, 0x2000, SEGMENT_WRITE);
+
+    EXPECT_EQ(nullptr, space.find(0x0FFF));
+    EXPECT_EQ(a, space.find(0x1000));
+    EXPECT_EQ(a, space.find(0x1FFF));
+    EXPECT_EQ(nullptr, space.find(0x2000));
+    EXPECT_EQ(b, space.find(0x4000));
+    EXPECT_EQ(b, space.find(0x5FFF));
+    EXPECT_EQ(nullptr, space.find(0x6000));
+}
+
+/**
+ * Test that allocate(), changePolicy(), and free() manage segments.
+ */
+TEST(AddressSpace, allocate_free)
+{
+    AddressSpace space;
+
+    uint64_t a = space.allocate(100, SEGMENT_READ | SEGMENT_WRITE);
+    uint64_t b = space.allocate(100, SEGMENT_READ);
+
+    EXPECT_EQ(AddressSpace::ALLOCATION_BASE, a);
+    EXPECT_NE(0U, b);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(0U, b % AddressSpace::PAGE_SIZE);
+
+    //each change to the segments moves to a new generation.
+    uint64_t generation = space.generation();
+    EXPECT_TRUE(space.changePolicy(b, SEGMENT_EXECUTE));
+    EXPECT_EQ(SEGMENT_EXECUTE, space.find(b)->policy());
+    EXPECT_NE(generation, space.generation());
+
+    //policy changes and frees must name the base of a segment.
+    generation = space.generation();
+    EXPECT_FALSE(space.changePolicy(b + 8, SEGMENT_READ));
+    EXPECT_FALSE(space.free(a + 8));
+    EXPECT_EQ(generation, space.generation());
+
+    EXPECT_TRUE(space.free(a));
+    EXPECT_EQ(nullptr, space.find(a));
+    EXPECT_FALSE(space.free(a));
+    EXPECT_NE(generation, space.generation());
+}
+
+/**
+ * Test that host reads and writes ignore policy and span segments.
+ */
+TEST(AddressSpace, read_write)
+{
+    AddressSpace space;
+    const uint8_t in[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    uint8_t out[8] = { 0 };
+
+    space.map(0x1000, 0x1000, 0);
+    space.map(0x2000, 0x1000, 0);
+
+    EXPECT_TRUE(space.write(0x1FFC, in, sizeof(in)));
+    EXPECT_TRUE(space.read(0x1FFC, out, sizeof(out)));
+    EXPECT_EQ(0, memcmp(in, out, sizeof(in)));
+
+    //unmapped ranges fail.
+    EXPECT_FALSE(space.write(0x2FFC, in, sizeof(in)));
+    EXPECT_FALSE(space.read(0x0FFC, out, sizeof(out)));
+}
+
+/**
+ * Test that segments in the host arena are visible through the guest view,
+ * and that segments beyond it are not.
+ */
+TEST(AddressSpace, host_protection)
+{
+    AddressSpace plain;
+    EXPECT_EQ(nullptr, plain.guestView());
+
+    AddressSpace space(true);
+    if (nullptr == space.guestView())
+        GTEST_SKIP() << "the host can't provide an arena";
+
+    const uint8_t in[4] = { 1, 2, 3, 4 };
+
+    Segment* seg = space.map(0x1000, 0x1000, SEGMENT_READ);
+    ASSERT_NE(nullptr, seg);
+    EXPECT_TRUE(space.write(0x1010, in, sizeof(in)));
+    EXPECT_EQ(0, memcmp(in, seg->data() + 0x10, sizeof(in)));
+    EXPECT_EQ(0, memcmp(in, space.guestView() + 0x1010, sizeof(in)));
+
+    //segments past the arena are backed by ordinary host memory.
+    Segment* far = space.map(AddressSpace::HOST_ARENA_SIZE, 0x1000, 0);
+    ASSERT_NE(nullptr, far);
+    EXPECT_TRUE(space.write(AddressSpace::HOST_ARENA_SIZE, in, sizeof(in)));
+    EXPECT_EQ(0, memcmp(in, far->data(), sizeof(in)));
+}
+
+/**
+ * Test that the host reads and writes guest byte order in an address space
+ * whose memory holds octas in the native byte order.
+ */
+TEST(AddressSpace, native_byte_order)
+{
+    AddressSpace space(false, ByteOrder::Native);
+    uint8_t in[21], out[21] = { 0 };
+    uint64_t octa;
+
+    for (size_t k = 0; k < sizeof(in); ++k)
+        in[k] = static_cast<uint8_t>(k + 1);
+
+    Segment* seg = space.map(0x1000, 0x1000, 0);
+    ASSERT_NE(nullptr, seg);
+    EXPECT_EQ(ByteOrder::Native, space.byteOrder());
+
+    //unaligned at both ends, with whole octas between.
+    EXPECT_TRUE(space.write(0x1005, in, sizeof(in)));
+    EXPECT_TRUE(space.read(0x1005, out, sizeof(out)));
+    EXPECT_EQ(0, memcmp(in, out, sizeof(in)));
+
+    //the octa at 0x1008 holds guest bytes 4 through 11 in host order.
+    memcpy(&octa, seg->data() + 8, sizeof(octa));
+    EXPECT_EQ(0x0405060708090A0BU, octa);
+}
+
+/**
+ * Test that a segment mapped from a file holds the file region, zero-filled
+ * past its end, and that writes to the segment don't reach the file.
+ */
+TEST(AddressSpace, map_file)
+{
+    FILE* file = tmpfile();
+    ASSERT_NE(nullptr, file);
+    int fd = fileno(file);
+
+    //two pages of pattern, with the region starting at the second page.
+    vector<uint8_t> image(2 * AddressSpace::PAGE_SIZE);
+    for (size_t k = 0; k < image.size(); ++k)
+        image[k] = static_cast<uint8_t>(k * 7 + 1);
+    ASSERT_EQ((ssize_t)image.size(), pwrite(fd, image.data(), image.size(), 0));
+
+    const uint64_t offset = AddressSpace::PAGE_SIZE;
+    const uint64_t length = 100;
+
+    for (ByteOrder order : { ByteOrder::BigEndian, ByteOrder::Native })
+    {
+        AddressSpace space(false, order);
+        uint8_t out[length + 8];
+
+        //misaligned offsets, oversized regions, and regions past the end of
+        //the file are rejected.
+        EXPECT_EQ(nullptr, space.mapFile(0x1000, 0x2000, 0, fd, 1, length));
+        EXPECT_EQ(nullptr, space.mapFile(0x1000, 50, 0, fd, offset, length));
+        EXPECT_EQ(
+            nullptr, space.mapFile(0x1000, 0x3000, 0, fd, offset, 0x2000));
+
+        Segment* seg = space.mapFile(0x1000, 0x2000, 0, fd, offset, length);
+        ASSERT_NE(nullptr, seg);
+        EXPECT_EQ(0x2000U, seg->size());
+        EXPECT_EQ(nullptr, space.mapFile(0x2000, 0x1000, 0, fd, 0, 0));
+
+        //the region is followed by zeroes.
+        EXPECT_TRUE(space.read(0x1000, out, sizeof(out)));
+        EXPECT_EQ(0, memcmp(image.data() + offset, out, length));
+        for (size_t k = length; k < sizeof(out); ++k)
+            EXPECT_EQ(0, out[k]);
+
+        //writes stay in the segment.
+        EXPECT_TRUE(space.write(0x1000, "\xFF", 1));
+        EXPECT_TRUE(space.read(0x1000, out, 1));
+        EXPECT_EQ(0xFF, out[0]);
+        ASSERT_EQ(1, pread(fd, out, 1, offset));
+        EXPECT_EQ(image[offset], out[0]);
+    }
+
+    fclose(file);
+}
+
+/**
+ * Test that small segments allocated through a slab cache are rounded up to
+ * their size class, are zero-filled when reused, and can't be found once
+ * freed.
+ */
+TEST(AddressSpace, slab_cache)
+{
+    AddressSpace space;
+    unique_ptr<SlabCache> owned(new SlabCache(space));
+    SlabCache& cache = *owned;
+    const uint8_t in[4] = { 1, 2, 3, 4 };
+    uint8_t out[4];
+
+    uint64_t a = space.allocate(100, SEGMENT_READ | SEGMENT_WRITE, cache);
+    uint64_t b = space.allocate(5000, SEGMENT_READ, cache);
+    uint64_t c = space.allocate(AddressSpace::SLAB_MAX_SIZE + 1, 0, cache);
+    uint64_t d = space.allocate(100, SEGMENT_EXECUTE, cache);
+
+    ASSERT_NE(0U, a);
+    ASSERT_NE(0U, b);
+    ASSERT_NE(0U, c);
+    ASSERT_NE(0U, d);
+    EXPECT_EQ(AddressSpace::PAGE_SIZE, space.find(a)->size());
+    EXPECT_EQ(2 * AddressSpace::PAGE_SIZE, space.find(b)->size());
+    EXPECT_EQ(SEGMENT_READ, space.find(b)->policy());
+    EXPECT_GT(space.find(c)->size(), AddressSpace::SLAB_MAX_SIZE);
+    EXPECT_EQ(SEGMENT_EXECUTE, space.find(d)->policy());
+
+    //a freed slab segment is gone, and comes back zero-filled.
+    EXPECT_TRUE(space.write(a, in, sizeof(in)));
+    uint64_t generation = space.generation();
+    EXPECT_TRUE(space.free(a, cache));
+    EXPECT_NE(generation, space.generation());
+    EXPECT_EQ(nullptr, space.find(a));
+    EXPECT_FALSE(space.read(a, out, sizeof(out)));
+    EXPECT_FALSE(space.free(a, cache));
+    EXPECT_FALSE(space.free(a));
+    EXPECT_FALSE(space.changePolicy(a, SEGMENT_READ));
+
+    EXPECT_EQ(a, space.allocate(4096, SEGMENT_READ, cache));
+    EXPECT_TRUE(space.read(a, out, sizeof(out)));
+    EXPECT_EQ(0, out[0] | out[1] | out[2] | out[3]);
+    EXPECT_EQ(SEGMENT_READ, space.find(a)->policy());
+
+    //slab segments can be freed without a cache, and others with one.
+    EXPECT_TRUE(space.free(b));
+    EXPECT_TRUE(space.free(c, cache));
+    EXPECT_TRUE(space.free(d, cache));
+    EXPECT_EQ(nullptr, space.find(b));
+    EXPECT_EQ(nullptr, space.find(c));
+    EXPECT_EQ(nullptr, space.find(d));
+
+    //segments left in a cache go back to the depot for other caches.
+    EXPECT_TRUE(space.free(a, cache));
+    {
+        SlabCache other(space);
+        EXPECT_NE(a, space.allocate(100, SEGMENT_READ, other));
+    }
+    owned.reset();
+    SlabCache other(space);
+    EXPECT_EQ(a, space.allocate(100, SEGMENT_READ, other));
+}
+
+/**
+ * Test that freeing a slab segment of several pages zero-fills it by dropping
+ * its pages, so that none of them stay committed, with or without host
+ * protection.
+ */
+TEST(AddressSpace, slab_release_decommits)
+{
+    size_t pageSize = sysconf(_SC_PAGESIZE);
+
+    for (bool hostProtection : { false, true })
+    {
+        AddressSpace space(hostProtection);
+        SlabCache cache(space);
+        uint64_t last = AddressSpace::SLAB_MAX_SIZE - 8;
+        uint64_t mark = 42;
+        uint64_t seen = 1;
+
+        uint64_t base = space.allocate(
+            AddressSpace::SLAB_MAX_SIZE, SEGMENT_READ | SEGMENT_WRITE, cache);
+        ASSERT_NE(0U, base);
+        Segment* seg = space.find(base);
+        ASSERT_NE(nullptr, seg);
+        uint8_t* memory = seg->data();
+
+        EXPECT_TRUE(space.write(base, &mark, sizeof(mark)));
+        EXPECT_TRUE(space.write(base + last, &mark, sizeof(mark)));
+        EXPECT_TRUE(space.free(base, cache));
+
+        //no page of the freed segment is resident.
+        if (0 == reinterpret_cast<uintptr_t>(memory) % pageSize)
+        {
+            vector<unsigned char> resident(
+                AddressSpace::SLAB_MAX_SIZE / pageSize + 1);
+
+            ASSERT_EQ(0, mincore(
+                memory, AddressSpace::SLAB_MAX_SIZE, resident.data()));
+            for (size_t k = 0; k < AddressSpace::SLAB_MAX_SIZE / pageSize; ++k)
+                EXPECT_EQ(0, resident[k] & 1);
+        }
+
+        //and it comes back zero-filled.
+        EXPECT_EQ(base, space.allocate(
+            AddressSpace::SLAB_MAX_SIZE, SEGMENT_READ | SEGMENT_WRITE, cache));
+        EXPECT_TRUE(space.read(base, &seen, sizeof(seen)));
+        EXPECT_EQ(0U, seen);
+        seen = 1;
+        EXPECT_TRUE(space.read(base + last, &seen, sizeof(seen)));
+        EXPECT_EQ(0U, seen);
+    }
+}
+
+/**
+ * Test that system threads allocating and freeing through their own caches
+ * never hand out the same segment twice.
+ */
+TEST(AddressSpace, slab_cache_threads)
+{
+    const size_t THREADS = 4;
+    const size_t ROUNDS = 200;
+    const size_t LIVE = 50;
+
+    AddressSpace space;
+    vector<thread> threads;
+    bool failed[THREADS] = { false };
+
+    for (size_t t = 0; t < THREADS; ++t)
+    {
+        threads.emplace_back([&, t]() {
+            SlabCache cache(space);
+            vector<uint64_t> live;
+
+            for (size_t round = 0; round < ROUNDS; ++round)
+            {
+                for (size_t k = 0; k < LIVE; ++k)
+                {
+                    uint64_t base = space.allocate(
+                        100 + 4096 * (k % 3), SEGMENT_READ | SEGMENT_WRITE,
+                        cache);
+                    uint64_t mark = t + 1;
+
+                    //every new segment is zero-filled, and marked as ours.
+                    uint64_t seen = 1;
+                    if (0 == base
+                     || !space.read(base, &seen, sizeof(seen)) || 0 != seen
+                     || !space.write(base, &mark, sizeof(mark)))
+                        failed[t] = true;
+
+                    live.push_back(base);
+                }
+
+                for (uint64_t base : live)
+                {
+                    uint64_t mark = 0;
+                    if (!space.read(base, &mark, sizeof(mark))
+                     || t + 1 != mark || !space.free(base, cache))
+                        failed[t] = true;
+                }
+
+                live.clear();
+            }
+        });
+    }
+
+    for (auto& th : threads)
+        th.join();
+
+    for (size_t t = 0; t < THREADS; ++t)
+        EXPECT_FALSE(failed[t]);
+}
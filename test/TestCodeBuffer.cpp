@@ -0,0 +1,125 @@
+/**
+ * \file TestCodeBuffer.cpp
+ *
+ * Test the CodeBuffer class.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <simex/CodeBuffer.h>
+#include <simex/Instruction.h>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Test that instructions and data are appended in big-endian order, and that
+ * an owned buffer grows as needed.
+ */
+TEST(CodeBuffer, emit_grow)
+{
+    CodeBuffer buffer;
+    const uint8_t data[] = { 0xDE, 0xAD };
+
+    EXPECT_EQ(0U, buffer.size());
+
+    for (int i = 0; i < 5000; ++i)
+        ASSERT_TRUE(
+            buffer.emit(
+                DecodedInstruction::decode(
+                    Opcode::OP_ADDI, 1, 2, static_cast<uint8_t>(i))));
+
+    ASSERT_TRUE(buffer.emitBytes(data, sizeof(data)));
+    ASSERT_TRUE(buffer.emitTetra(0x01020304));
+
+    EXPECT_EQ(4U * 5000 + 6, buffer.size());
+    EXPECT_LE(buffer.size(), buffer.capacity());
+    EXPECT_EQ(
+        DecodedInstruction::decode(Opcode::OP_ADDI, 1, 2, 7).tetra(),
+        buffer.tetraAt(28));
+    EXPECT_EQ(0xDE, buffer.data()[20000]);
+    EXPECT_EQ(0xAD, buffer.data()[20001]);
+    EXPECT_EQ(0x01020304U, buffer.tetraAt(20002));
+
+    buffer.clear();
+    EXPECT_EQ(0U, buffer.size());
+}
+
+/**
+ * Test that emitted tetras can be patched by offset.
+ */
+TEST(CodeBuffer, patch)
+{
+    CodeBuffer buffer;
+    auto jmp = DecodedInstruction::decode(Opcode::OP_JMP, 0, 0, 3);
+
+    buffer.emit(DecodedInstruction::decode(Opcode::OP_SWYM, 0, 0, 0));
+    buffer.emit(DecodedInstruction::decode(Opcode::OP_SWYM, 0, 0, 0));
+
+    EXPECT_TRUE(buffer.patch(4, jmp));
+    EXPECT_EQ(jmp.tetra(), buffer.tetraAt(4));
+
+    //patches must lie entirely within the emitted bytes.
+    EXPECT_FALSE(buffer.patch(5, jmp));
+    EXPECT_FALSE(buffer.patch(8, jmp));
+    EXPECT_FALSE(buffer.patchTetra(static_cast<size_t>(-1), 0));
+    EXPECT_EQ(8U, buffer.size());
+}
+
+/**
+ * Test that a buffer placed over existing memory writes straight into it and
+ * never grows.
+ */
+TEST(CodeBuffer, external_memory)
+{
+    uint8_t memory[10] = { 0 };
+    CodeBuffer buffer(memory, sizeof(memory));
+
+    EXPECT_TRUE(buffer.emitTetra(0xAABBCCDD));
+    EXPECT_TRUE(buffer.emitTetra(0x11223344));
+    EXPECT_FALSE(buffer.emitTetra(0x55667788));
+    EXPECT_FALSE(buffer.reserve(3));
+    EXPECT_TRUE(buffer.emitBytes("\x99\x88", 2));
+    EXPECT_FALSE(buffer.emitBytes("\x77", 1));
+
+    EXPECT_EQ(10U, buffer.size());
+    EXPECT_EQ(memory, buffer.data());
+    EXPECT_EQ(0xAA, memory[0]);
+    EXPECT_EQ(0x44, memory[7]);
+    EXPECT_EQ(0x88, memory[9]);
+}
+
+/**
+ * Test that a buffer can be written to an ostream and to a file descriptor.
+ */
+TEST(CodeBuffer, write)
+{
+    CodeBuffer buffer;
+    stringstream ss;
+    int fds[2];
+    char in[16];
+
+    Instruction::decode(Opcode::OP_SETL, 3, 0xAB, 0xCD)->emit(buffer);
+    buffer.emitTetra(0x00010203);
+
+    ASSERT_TRUE(buffer.write(ss));
+    EXPECT_EQ(string("\xE3\x03\xAB\xCD\x00\x01\x02\x03", 8), ss.str());
+
+    ASSERT_EQ(0, pipe(fds));
+    ASSERT_TRUE(buffer.write(fds[1]));
+    close(fds[1]);
+    ASSERT_EQ(8, read(fds[0], in, sizeof(in)));
+    close(fds[0]);
+    EXPECT_EQ(string("\xE3\x03\xAB\xCD\x00\x01\x02\x03", 8), string(in, 8));
+
+    EXPECT_FALSE(buffer.write(-1));
+}
@@ -0,0 +1,116 @@
+/**
+ * \file TestDecodeBatch.cpp
+ *
+ * Test batch decoding of instruction tetras.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <gtest/gtest.h>
+#include <random>
+#include <simex/DecodeBatch.h>
+#include <simex/DecodedInstruction.h>
+#include <vector>
+
+using namespace simex;
+using namespace std;
+
+namespace {
+
+    /**
+     * Output storage for a batch.
+     */
+    struct BatchStorage
+    {
+        BatchStorage(size_t count)
+            : opcode(count), x(count), y(count), z(count), yz(count),
+              xyz(count)
+        {
+        }
+
+        DecodedBatch batch()
+        {
+            return DecodedBatch{
+                opcode.data(), x.data(), y.data(), z.data(), yz.data(),
+                xyz.data() };
+        }
+
+        vector<Opcode> opcode;
+        vector<uint8_t> x;
+        vector<uint8_t> y;
+        vector<uint8_t> z;
+        vector<uint16_t> yz;
+        vector<uint32_t> xyz;
+    };
+}
+
+/**
+ * Test that the scalar strategy is always supported.
+ */
+TEST(DecodeBatch, scalar_supported)
+{
+    EXPECT_TRUE(decodeStrategySupported(DecodeStrategy::Scalar));
+    EXPECT_TRUE(decodeStrategySupported(bestDecodeStrategy()));
+}
+
+/**
+ * Test that every strategy matches DecodedInstruction::decode, including
+ * counts which leave a remainder for the scalar path and unaligned input.
+ */
+TEST(DecodeBatch, strategies_match_decode)
+{
+    const DecodeStrategy strategies[] = {
+        DecodeStrategy::Scalar, DecodeStrategy::SSSE3, DecodeStrategy::AVX2 };
+    const size_t counts[] = { 0, 1, 15, 16, 17, 31, 32, 33, 100 };
+    mt19937 rng(0xDEC0);
+    vector<uint8_t> bytes(4 * 100 + 1);
+
+    for (auto& b : bytes)
+        b = static_cast<uint8_t>(rng());
+
+    for (auto strategy : strategies)
+    {
+        for (auto count : counts)
+        {
+            //start one byte in, so the input is not aligned.
+            const uint8_t* in = bytes.data() + 1;
+            BatchStorage out(count);
+
+            decodeBatch(in, count, out.batch(), strategy);
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                auto ins = DecodedInstruction::decode(in + 4 * i);
+
+                EXPECT_EQ(ins.opcode(), out.opcode[i]);
+                EXPECT_EQ(ins.x(), out.x[i]);
+                EXPECT_EQ(ins.y(), out.y[i]);
+                EXPECT_EQ(ins.z(), out.z[i]);
+                EXPECT_EQ(ins.yz(), out.yz[i]);
+                EXPECT_EQ(ins.xyz(), out.xyz[i]);
+            }
+        }
+    }
+}
+
+/**
+ * Test that a batch decode does not write past the end of its outputs.
+ */
+TEST(DecodeBatch, no_overrun)
+{
+    vector<uint8_t> bytes(4 * 40, 0xA5);
+    BatchStorage out(40);
+
+    decodeBatch(bytes.data(), 33, out.batch());
+
+    EXPECT_EQ(0xA5, out.x[32]);
+    EXPECT_EQ(0x00, out.x[33]);
+    EXPECT_EQ(0xA5A5U, out.yz[32]);
+    EXPECT_EQ(0x0000U, out.yz[33]);
+    EXPECT_EQ(0xA5A5A5U, out.xyz[32]);
+    EXPECT_EQ(0x000000U, out.xyz[33]);
+}
@@ -0,0 +1,105 @@
+/**
+ * \file TestDecodedInstruction.cpp
+ *
+ * Test the DecodedInstruction class and its flyweight handler table.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <gtest/gtest.h>
+#include <simex/DecodedInstruction.h>
+#include <simex/Instruction.h>
+#include <sstream>
+#include <string>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Test that we can decode an instruction from its components.
+ */
+TEST(DecodedInstruction, decode_simple)
+{
+    const Opcode OP = Opcode::OP_ADDI;
+    const uint8_t X = 2;
+    const uint8_t Y = 21;
+    const uint8_t Z = 17;
+
+    auto ins = DecodedInstruction::decode(OP, X, Y, Z);
+
+    //test accessors
+    EXPECT_EQ(OP, ins.opcode());
+    EXPECT_EQ(X, ins.x());
+    EXPECT_EQ(Y, ins.y());
+    EXPECT_EQ(Z, ins.z());
+    EXPECT_EQ((uint16_t)0x1511, ins.yz());
+    EXPECT_EQ((uint32_t)0x021511, ins.xyz());
+    EXPECT_EQ((uint32_t)0x21021511, ins.tetra());
+}
+
+/**
+ * Test that decoding a tetra and decoding big-endian bytes agree.
+ */
+TEST(DecodedInstruction, decode_tetra_and_bytes)
+{
+    const uint8_t bytes[4] = { 0xF0, 0x12, 0x34, 0x56 };
+
+    auto fromTetra = DecodedInstruction::decode((uint32_t)0xF0123456);
+    auto fromBytes = DecodedInstruction::decode(bytes);
+
+    EXPECT_EQ(Opcode::OP_JMP, fromTetra.opcode());
+    EXPECT_EQ((uint32_t)0x123456, fromTetra.xyz());
+    EXPECT_EQ(fromTetra.tetra(), fromBytes.tetra());
+}
+
+/**
+ * Test that every opcode has a matching flyweight handler, and that the
+ * handler is shared between instances.
+ */
+TEST(DecodedInstruction, handler_table)
+{
+    for (int i = 0; i < 256; ++i)
+    {
+        Opcode op = static_cast<Opcode>(i);
+        const InstructionHandler& h = instructionHandler(op);
+
+        EXPECT_EQ(op, h.opcode);
+        EXPECT_NE(nullptr, h.name);
+
+        //handlers are flyweights.
+        EXPECT_EQ(&h, &DecodedInstruction::decode(op, 1, 2, 3).handler());
+        EXPECT_EQ(&h, &DecodedInstruction::decode(op, 4, 5, 6).handler());
+    }
+
+    EXPECT_EQ(string("8ADDU"), instructionHandler(Opcode::OP_8ADDU).name);
+    EXPECT_EQ(string("RESERVED"),
+              instructionHandler(Opcode::OP_RESERVED_xFF).name);
+}
+
+/**
+ * Test that the shared_ptr factory wraps decoded values.
+ */
+TEST(DecodedInstruction, instruction_wrapper)
+{
+    auto value = DecodedInstruction::decode(Opcode::OP_LDO, 9, 8, 7);
+    auto ins = Instruction::decode(value);
+
+    ASSERT_TRUE(!!ins);
+    EXPECT_EQ(value.tetra(), ins->decoded().tetra());
+}
+
+/**
+ * Test that we can emit a decoded instruction.
+ */
+TEST(DecodedInstruction, emit_simple)
+{
+    stringstream ss;
+
+    DecodedInstruction::decode(Opcode::OP_SETL, 3, 0xAB, 0xCD).emit(ss);
+
+    EXPECT_EQ(string("\xE3\x03\xAB\xCD", 4), ss.str());
+}
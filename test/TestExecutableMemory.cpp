@@ -0,0 +1,100 @@
+/**
+ * \file TestExecutableMemory.cpp
+ *
+ * Test the ExecutableMemory class.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <cstring>
+#include <gtest/gtest.h>
+#include <simex/ExecutableMemory.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Test that code is packed into shared pages when the host can map them
+ * twice, or copied onto pages of its own otherwise, and that nothing is added
+ * for empty code.
+ */
+TEST(ExecutableMemory, add)
+{
+    ExecutableMemory memory;
+    size_t pageSize = sysconf(_SC_PAGESIZE);
+    const uint8_t code[] = { 0x90, 0x90, 0xC3 };
+    vector<uint8_t> large(ExecutableMemory::CHUNK_SIZE + 1, 0xC3);
+
+    EXPECT_EQ(0U, memory.memoryUsage());
+    EXPECT_EQ(nullptr, memory.add(code, 0));
+    EXPECT_EQ(0U, memory.memoryUsage());
+
+    const uint8_t* first =
+        static_cast<const uint8_t*>(memory.add(code, sizeof(code)));
+    const uint8_t* second =
+        static_cast<const uint8_t*>(memory.add(code, sizeof(code)));
+
+    ASSERT_NE(nullptr, first);
+    ASSERT_NE(nullptr, second);
+    EXPECT_EQ(0, memcmp(code, first, sizeof(code)));
+    EXPECT_EQ(0, memcmp(code, second, sizeof(code)));
+    EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(first) % pageSize);
+    EXPECT_NE(first, second);
+
+    size_t used;
+    if (first + ExecutableMemory::CODE_ALIGNMENT == second)
+    {
+        //packed code shares its page.
+        used = pageSize;
+    }
+    else
+    {
+        EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(second) % pageSize);
+        used = 2 * pageSize;
+    }
+
+    EXPECT_EQ(used, memory.memoryUsage());
+
+    //code which doesn't fit the chunk is given a chunk of its own.
+    const void* third = memory.add(large.data(), large.size());
+
+    ASSERT_NE(nullptr, third);
+    EXPECT_EQ(0, memcmp(large.data(), third, large.size()));
+    EXPECT_EQ(
+        used + ((large.size() + pageSize - 1) & ~(pageSize - 1)),
+        memory.memoryUsage());
+}
+
+#if defined(__GNUC__) && defined(__x86_64__)
+
+/**
+ * Test that added code can be called, including code added after it has
+ * run.
+ */
+TEST(ExecutableMemory, call)
+{
+    ExecutableMemory memory;
+
+    //mov eax, 42; ret
+    const uint8_t code[] = { 0xB8, 0x2A, 0x00, 0x00, 0x00, 0xC3 };
+    const void* added = memory.add(code, sizeof(code));
+
+    ASSERT_NE(nullptr, added);
+    EXPECT_EQ(42, reinterpret_cast<int (*)()>(const_cast<void*>(added))());
+
+    //mov eax, 7; ret
+    const uint8_t next[] = { 0xB8, 0x07, 0x00, 0x00, 0x00, 0xC3 };
+    const void* nextAdded = memory.add(next, sizeof(next));
+
+    ASSERT_NE(nullptr, nextAdded);
+    EXPECT_EQ(7, reinterpret_cast<int (*)()>(const_cast<void*>(nextAdded))());
+    EXPECT_EQ(42, reinterpret_cast<int (*)()>(const_cast<void*>(added))());
+}
+
+#endif
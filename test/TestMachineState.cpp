@@ -0,0 +1,2003 @@
+/**
+ * \file TestMachineState.cpp
+ *
+ * Test the MachineState interpreter.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <gtest/gtest.h>
+#include <simex/MachineState.h>
+#include <simex/Syscall.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace simex;
+using namespace std;
+
+static const uint64_t CODE_BASE = 0x10000;
+static const uint64_t DATA_BASE = 0x20000;
+
+/**
+ * Encode an instruction as a tetra.
+ */
+static uint32_t I(Opcode op, uint8_t x, uint8_t y, uint8_t z)
+{
+    return DecodedInstruction(op, x, y, z).tetra();
+}
+
+/**
+ * Create an address space with the given program at CODE_BASE and a writable
+ * data segment at DATA_BASE, optionally enforcing policy with the host MMU or
+ * holding memory in the native byte order.
+ */
+static shared_ptr<AddressSpace> programSpace(
+    const vector<uint32_t>& program, bool hostProtection = false,
+    ByteOrder order = ByteOrder::BigEndian)
+{
+    auto space = make_shared<AddressSpace>(hostProtection, order);
+    uint64_t addr = CODE_BASE;
+
+    space->map(CODE_BASE, 4 * program.size(), SEGMENT_READ | SEGMENT_EXECUTE);
+    space->map(DATA_BASE, 0x1000, SEGMENT_READ | SEGMENT_WRITE);
+
+    for (uint32_t tetra : program)
+    {
+        uint8_t bytes[4] = {
+            (uint8_t)(tetra >> 24), (uint8_t)(tetra >> 16),
+            (uint8_t)(tetra >> 8), (uint8_t)tetra };
+
+        space->write(addr, bytes, sizeof(bytes));
+        addr += 4;
+    }
+
+    return space;
+}
+
+/**
+ * Create a machine with the given program at CODE_BASE and a writable data
+ * segment at DATA_BASE, optionally enforcing policy with the host MMU or
+ * holding memory in the native byte order.  The JIT is enabled when
+ * SIMEX_TEST_JIT is set, so that the same tests cover compiled code.  Each
+ * block is compiled as it is predecoded, or, when SIMEX_TEST_JIT is
+ * "tiered", on the background compiler once it is entered.
+ */
+static unique_ptr<MachineState> machine(
+    const vector<uint32_t>& program, bool hostProtection = false,
+    ByteOrder order = ByteOrder::BigEndian)
+{
+    const char* jit = getenv("SIMEX_TEST_JIT");
+    unique_ptr<MachineState> state(
+        new MachineState(programSpace(program, hostProtection, order)));
+
+    state->setPC(CODE_BASE);
+    state->setJit(nullptr != jit);
+    if (nullptr != jit)
+    {
+        if (0 == strcmp(jit, "tiered"))
+            state->setJitThresholds(1, 1);
+        else
+            state->setJitThresholds(0, 0);
+    }
+
+    return state;
+}
+
+/**
+ * A host system call which doubles its first argument.
+ */
+static uint8_t syscallDouble(MachineState* state)
+{
+    state->setReg(0, 2 * state->reg(0));
+
+    return 1;
+}
+
+/**
+ * Test that simple arithmetic runs and POP from the outermost frame halts.
+ */
+TEST(MachineState, arithmetic)
+{
+    auto state = machine({
+        I(Opcode::OP_SETL,  0, 0, 5),
+        I(Opcode::OP_SETL,  1, 0, 7),
+        I(Opcode::OP_MULI,  1, 1, 3),
+        I(Opcode::OP_ADD,   0, 0, 1),
+        I(Opcode::OP_POP,   1, 0, 0) });
+
+    EXPECT_EQ(RunStatus::Halted, state->run());
+    EXPECT_TRUE(state->halted());
+    EXPECT_EQ(26U, state->exitCode());
+    EXPECT_EQ(5U, state->instructionCount());
+}
+
+/**
+ * Test that a backward branch loop runs to completion.
+ */
+TEST(MachineState, loop)
+{
+    auto state = machine({
+        I(Opcode::OP_SETL,  0, 0, 0),
+        I(Opcode::OP_SETL,  1, 0, 10),
+        I(Opcode::OP_ADD,   0, 0, 1),
+        I(Opcode::OP_SUBI,  1, 1, 1),
+        I(Opcode::OP_BNZB,  1, 0xFF, 0xFE),
+        I(Opcode::OP_POP,   1, 0, 0) });
+
+    EXPECT_EQ(RunStatus::Halted, state->run());
+    EXPECT_EQ(55U, state->exitCode());
+    EXPECT_EQ(2U + 3U * 10U + 1U, state->instructionCount());
+}
+
+/**
+ * Test that the instruction limit stops an infinite loop.
+ */
+TEST(MachineState, instruction_limit)
+{
+    auto state = machine({
+        I(Opcode::OP_JMP,   0, 0, 0) });
+
+    EXPECT_EQ(RunStatus::InstructionLimit, state->run(1000));
+    EXPECT_FALSE(state->halted());
+    EXPECT_EQ(1000U, state->instructionCount());
+    EXPECT_EQ(CODE_BASE, state->pc());
+
+    //running again continues where we left off.
+    EXPECT_EQ(RunStatus::InstructionLimit, state->run(10));
+    EXPECT_EQ(1010U, state->instructionCount());
+}
+
+/**
+ * Test that stores and loads round trip through big-endian memory.
+ */
+TEST(MachineState, load_store)
+{
+    auto state = machine({
+        I(Opcode::OP_SETML, 2, 0x00, 0x02),
+        I(Opcode::OP_SETL,  0, 0x12, 0x34),
+        I(Opcode::OP_STOI,  0, 2, 8),
+        I(Opcode::OP_LDBUI, 3, 2, 14),
+        I(Opcode::OP_LDOI,  4, 2, 8),
+        I(Opcode::OP_ADD,   0, 3, 4),
+        I(Opcode::OP_POP,   1, 0, 0) });
+    uint8_t bytes[8];
+
+    EXPECT_EQ(RunStatus::Halted, state->run());
+    EXPECT_EQ(0x1234U + 0x12U, state->exitCode());
+
+    ASSERT_TRUE(state->addressSpace().read(DATA_BASE + 8, bytes, 8));
+    EXPECT_EQ(0x12, bytes[6]);
+    EXPECT_EQ(0x34, bytes[7]);
+}
+
+/**
+ * Test that PUSHJ and POP save and restore the caller's frame.
+ */
+TEST(MachineState, pushj_pop)
+{
+    auto state = machine({
+        I(Opcode::OP_SETL,  0, 0, 99),
+        I(Opcode::OP_SETL,  2, 0, 21),
+        I(Opcode::OP_PUSHJ, 1, 0, 3),
+        I(Opcode::OP_ADD,   0, 0, 1),
+        I(Opcode::OP_POP,   1, 0, 0),
+        //f: double $0
+        I(Opcode::OP_ADD,   0, 0, 0),
+        I(Opcode::OP_POP,   1, 0, 0) });
+
+    EXPECT_EQ(RunStatus::InstructionLimit, state->run(4));
+    EXPECT_EQ(2U, state->sreg(SReg::SR_RO));
+    EXPECT_EQ(1U, state->sreg(SReg::SR_RL));
+    EXPECT_EQ(CODE_BASE + 12, state->sreg(SReg::SR_RJ));
+
+    EXPECT_EQ(RunStatus::Halted, state->run());
+    EXPECT_EQ(99U + 42U, state->exitCode());
+    EXPECT_EQ(0U, state->sreg(SReg::SR_RO));
+    EXPECT_EQ(2U, state->sreg(SReg::SR_RL));
+}
+
+/**
+ * Test that calls and returns behave the same whether or not they have a
+ * handler specialized for their register count.
+ */
+TEST(MachineState, call_counts)
+{
+    for (Opcode call : { Opcode::OP_PUSHJ, Opcode::OP_PUSHGOI })
+    {
+        for (uint8_t x = 0; x <= 5; ++x)
+        {
+            for (uint8_t n = 0; n <= 2; ++n)
+            {
+                vector<uint32_t> program;
+
+                for (uint8_t k = 0; k < 8; ++k)
+                    program.push_back(I(Opcode::OP_SETL, k, 0, 10 + k));
+
+                program.push_back(I(Opcode::OP_GETA, 8, 0, 3));
+                if (Opcode::OP_PUSHJ == call)
+                    program.push_back(I(Opcode::OP_PUSHJ, x, 0, 2));
+                else
+                    program.push_back(I(Opcode::OP_PUSHGOI, x, 8, 0));
+                program.push_back(I(Opcode::OP_JMP, 0, 0, 0));
+                program.push_back(I(Opcode::OP_ADDUI, 0, 0, 100));
+                program.push_back(I(Opcode::OP_POP, n, 0, 0));
+
+                auto state = machine(program);
+                state->setFusion(false);
+
+                EXPECT_EQ(RunStatus::InstructionLimit, state->run(13));
+                EXPECT_EQ(CODE_BASE + 40, state->pc());
+                EXPECT_EQ(0U, state->sreg(SReg::SR_RO));
+                ASSERT_EQ((uint64_t)x + n, state->sreg(SReg::SR_RL));
+
+                for (uint8_t k = 0; k < x; ++k)
+                    EXPECT_EQ(10U + k, state->reg(k));
+                if (n > 0)
+                    EXPECT_EQ(111U + x, state->reg(x));
+                if (n > 1)
+                    EXPECT_EQ(12U + x, state->reg(x + 1));
+
+                EXPECT_EQ(0U, state->reg(x + n));
+            }
+        }
+    }
+}
+
+/**
+ * Test that recursion deeper than the local register ring spills to and fills
+ * from the rS region without losing any caller registers.
+ */
+TEST(MachineState, deep_recursion)
+{
+    auto state = machine({
+        I(Opcode::OP_SETL,   1, 0x03, 0xE8),
+        I(Opcode::OP_PUSHJ,  0, 0, 2),
+        I(Opcode::OP_POP,    1, 0, 0),
+        //sum: return $0 + sum($0 - 1), or 0.
+        I(Opcode::OP_BNZ,    0, 0, 2),
+        I(Opcode::OP_POP,    1, 0, 0),
+        I(Opcode::OP_GET,    1, 0, 0x04),
+        I(Opcode::OP_SUBI,   3, 0, 1),
+        I(Opcode::OP_PUSHJB, 2, 0xFF, 0xFC),
+        I(Opcode::OP_PUT,    0x04, 0, 1),
+        I(Opcode::OP_ADDU,   0, 0, 2),
+        I(Opcode::OP_POP,    1, 0, 0) });
+
+    //stop at the deepest call, and check that the frame is intact.
+    EXPECT_EQ(RunStatus::InstructionLimit, state->run(2 + 4 * 1000));
+    EXPECT_EQ(3001U, state->sreg(SReg::SR_RO));
+    EXPECT_EQ(0U, state->reg(0));
+
+    EXPECT_EQ(RunStatus::Halted, state->run());
+    EXPECT_EQ(500500U, state->exitCode());
+    EXPECT_EQ(0U, state->sreg(SReg::SR_RO));
+}
+
+/**
+ * Test that the host can move the register-stack while registers are
+ * spilled, and that registers above the new frame read as zero.
+ */
+TEST(MachineState, register_stack_host_move)
+{
+    auto state = machine({});
+
+    for (int r = 0; r < 200; ++r)
+        state->setReg(r, 100 + r);
+
+    //move $0 up by 150, spilling the old registers below it.
+    state->setSReg(SReg::SR_RO, 150);
+    state->setSReg(SReg::SR_RL, 10);
+    EXPECT_EQ(250U, state->reg(0));
+    EXPECT_EQ(259U, state->reg(9));
+    EXPECT_EQ(0U, state->reg(60));
+
+    //moving back down recovers the original frame, up to rL.
+    state->setSReg(SReg::SR_RL, 160);
+    state->setSReg(SReg::SR_RO, 0);
+    EXPECT_EQ(100U, state->reg(0));
+    EXPECT_EQ(259U, state->reg(159));
+    EXPECT_EQ(0U, state->reg(160));
+}
+
+/**
+ * Test that registers in the hole read as zero and extend rL on access.
+ */
+TEST(MachineState, hole)
+{
+    auto state = machine({});
+
+    EXPECT_EQ(0U, state->sreg(SReg::SR_RL));
+    state->setReg(5, 17);
+    EXPECT_EQ(6U, state->sreg(SReg::SR_RL));
+    EXPECT_EQ(0U, state->reg(3));
+    EXPECT_EQ(17U, state->reg(5));
+
+    //shrinking rL with PUT discards registers.
+    state->evaluate(DecodedInstruction(Opcode::OP_PUTI, 0x11, 0, 2));
+    EXPECT_EQ(2U, state->sreg(SReg::SR_RL));
+    EXPECT_EQ(0U, state->reg(5));
+
+    //rO is read-only to PUT.
+    state->evaluate(DecodedInstruction(Opcode::OP_PUTI, 0x0B, 0, 9));
+    EXPECT_EQ(0U, state->sreg(SReg::SR_RO));
+}
+
+/**
+ * Test that the registers of a large callee frame fall into the hole on POP,
+ * and read as zero when the caller extends rL over them.
+ */
+TEST(MachineState, hole_after_pop)
+{
+    auto state = machine({
+        I(Opcode::OP_PUSHJ,  0, 0, 3),
+        I(Opcode::OP_PUSHJ,  0, 0, 2),
+        I(Opcode::OP_POP,    0, 0, 0),
+        I(Opcode::OP_SETL, 240, 0, 9),
+        I(Opcode::OP_SETL,   0, 0, 5),
+        I(Opcode::OP_POP,    1, 0, 0) });
+
+    for (int call = 0; call < 2; ++call)
+    {
+        EXPECT_EQ(RunStatus::InstructionLimit, state->run(4));
+        EXPECT_EQ(1U, state->sreg(SReg::SR_RL));
+        EXPECT_EQ(5U, state->reg(0));
+        EXPECT_EQ(0U, state->reg(1));
+        EXPECT_EQ(0U, state->reg(241));
+        EXPECT_EQ(242U, state->sreg(SReg::SR_RL));
+
+        //drop the registers read above before the next call.
+        state->setSReg(SReg::SR_RL, 1);
+    }
+}
+
+/**
+ * Test that PUT, GET, SAVE, and UNSAVE see the special registers at their
+ * architectural indices, and that reserved registers ignore writes.
+ */
+TEST(MachineState, special_registers)
+{
+    //every register but rO, rS, rL, and rG is freely writable by PUT.
+    vector<uint32_t> program;
+    for (uint8_t r = 0; r < 32; ++r)
+    {
+        SReg sreg = static_cast<SReg>(r);
+        if (SReg::SR_RO != sreg && SReg::SR_RS != sreg
+         && SReg::SR_RL != sreg && SReg::SR_RG != sreg)
+        {
+            program.push_back(I(Opcode::OP_PUTI, r, 0, 100 + r));
+        }
+    }
+
+    program.push_back(I(Opcode::OP_GET,    0, 0, 0x09));
+    program.push_back(I(Opcode::OP_GET,    1, 0, 0x40));
+    program.push_back(I(Opcode::OP_SAVE,   2, 255, 0));
+    program.push_back(I(Opcode::OP_STOI,   255, 255, 8 * 0x12));
+    program.push_back(I(Opcode::OP_UNSAVE, 0, 255, 0));
+    program.push_back(I(Opcode::OP_GET,    0, 0, 0x12));
+
+    auto state = machine(program);
+    state->setSReg(SReg::SR_RL, 4);
+    state->setReg(255, DATA_BASE);
+    state->setReg(0, 5);
+    state->setReg(1, 5);
+
+    EXPECT_EQ(RunStatus::InstructionLimit, state->run(program.size() - 3));
+    EXPECT_EQ(0U, state->reg(0));
+    EXPECT_EQ(0U, state->reg(1));
+
+    //0x00, 0x09, 0x0A, 0x0D through 0x0F, and 0x12 through 0x18.
+    const uint32_t reserved = 0x01FCE601U;
+
+    for (uint8_t r = 0; r < 32; ++r)
+    {
+        SReg sreg = static_cast<SReg>(r);
+        uint8_t octa[8];
+        uint64_t expected = state->sreg(sreg);
+
+        if (reserved & (1U << r))
+            EXPECT_EQ(0U, expected);
+        else if (SReg::SR_RL != sreg && SReg::SR_RO != sreg
+              && SReg::SR_RS != sreg && SReg::SR_RG != sreg)
+            EXPECT_EQ(100U + r, expected);
+
+        //the image holds each register at its index.
+        ASSERT_TRUE(state->addressSpace().read(DATA_BASE + 8 * r, octa, 8));
+        uint64_t saved = 0;
+        for (int k = 0; k < 8; ++k)
+            saved = (saved << 8) | octa[k];
+        EXPECT_EQ(expected, saved);
+    }
+
+    //a reserved register in the image is ignored by UNSAVE.
+    EXPECT_EQ(RunStatus::InstructionLimit, state->run(3));
+    EXPECT_EQ(0U, state->reg(0));
+    EXPECT_EQ(0U, state->sreg(SReg::SR_RESERVED_x12));
+    EXPECT_EQ(0x1FU + 100, state->sreg(SReg::SR_RCC));
+}
+
+/**
+ * Test that SAVE writes a big-endian image of a deep register-stack, and that
+ * UNSAVE restores it after the context has been replaced.
+ */
+TEST(MachineState, save_unsave)
+{
+    auto state = machine({
+        I(Opcode::OP_SAVE,   254, 255, 0),
+        I(Opcode::OP_UNSAVE,   0, 255, 253) });
+
+    //frames of 100 registers, with the deepest spilled from the ring.
+    for (uint64_t k = 0; k < 4; ++k)
+    {
+        state->setSReg(SReg::SR_RO, 100 * k);
+        state->setSReg(SReg::SR_RL, 100);
+        for (int r = 0; r < 100; ++r)
+            state->setReg(r, 1000 * k + r);
+    }
+
+    state->setSReg(SReg::SR_RG, 20);
+    state->setSReg(SReg::SR_RJ, 0x1234);
+    state->setReg(240, 77);
+    state->setReg(253, 0);
+    state->setReg(255, DATA_BASE);
+
+    EXPECT_EQ(RunStatus::InstructionLimit, state->run(1));
+    EXPECT_EQ(8U * (32 + 20 + 400), state->reg(254));
+
+    //rJ, then $240, then register-stack offset 1.
+    uint8_t octa[8];
+    const uint64_t rJ = DATA_BASE + 8 * sreg2offset(SReg::SR_RJ);
+    ASSERT_TRUE(state->addressSpace().read(rJ, octa, 8));
+    EXPECT_EQ(0x12, octa[6]);
+    EXPECT_EQ(0x34, octa[7]);
+    ASSERT_TRUE(state->addressSpace().read(DATA_BASE + 8 * 36, octa, 8));
+    EXPECT_EQ(77, octa[7]);
+    ASSERT_TRUE(state->addressSpace().read(DATA_BASE + 8 * 53, octa, 8));
+    EXPECT_EQ(1, octa[7]);
+
+    //replace the context, with registers just above the saved frame.
+    state->setSReg(SReg::SR_RO, 390);
+    state->setSReg(SReg::SR_RL, 20);
+    state->setSReg(SReg::SR_RJ, 0);
+    for (int r = 0; r < 20; ++r)
+        state->setReg(r, 5);
+    state->setReg(240, 0);
+    state->setReg(254, 9);
+
+    EXPECT_EQ(RunStatus::InstructionLimit, state->run(1));
+    EXPECT_EQ(300U, state->sreg(SReg::SR_RO));
+    EXPECT_EQ(100U, state->sreg(SReg::SR_RL));
+    EXPECT_EQ(0x1234U, state->sreg(SReg::SR_RJ));
+    EXPECT_EQ(3000U, state->reg(0));
+    EXPECT_EQ(3099U, state->reg(99));
+    EXPECT_EQ(0U, state->reg(100));
+    EXPECT_EQ(0U, state->reg(105));
+    EXPECT_EQ(77U, state->reg(240));
+    EXPECT_EQ(0U, state->reg(254));
+
+    //the deeper frames were restored as well.
+    state->setSReg(SReg::SR_RO, 200);
+    EXPECT_EQ(2000U, state->reg(0));
+    EXPECT_EQ(2099U, state->reg(99));
+    state->setSReg(SReg::SR_RO, 100);
+    EXPECT_EQ(1050U, state->reg(50));
+    state->setSReg(SReg::SR_RO, 0);
+    EXPECT_EQ(1U, state->reg(1));
+}
+
+/**
+ * Test that SAVE and UNSAVE fault on images which don't fit their segment or
+ * describe too many registers, leaving the context unchanged.
+ */
+TEST(MachineState, save_unsave_faults)
+{
+    auto unaligned = machine({
+        I(Opcode::OP_SETML, 2, 0x00, 0x02),
+        I(Opcode::OP_SAVE,  0, 2, 4) });
+
+    EXPECT_EQ(RunStatus::Faulted, unaligned->run());
+    EXPECT_EQ(fault2code(Fault::MemoryAlignment),
+              unaligned->sreg(SReg::SR_RCC));
+
+    //the image runs past the end of the data segment.
+    auto large = machine({
+        I(Opcode::OP_SETML, 2, 0x00, 0x02),
+        I(Opcode::OP_SAVE,  0, 2, 0) });
+
+    large->setSReg(SReg::SR_RO, 500);
+    EXPECT_EQ(RunStatus::Faulted, large->run());
+    EXPECT_EQ(fault2code(Fault::MemoryProtection),
+              large->sreg(SReg::SR_RCC));
+
+    //an image with more than 256 registers can't be restored.
+    auto invalid = machine({
+        I(Opcode::OP_SETML,  2, 0x00, 0x02),
+        I(Opcode::OP_SAVE,   0, 2, 0),
+        I(Opcode::OP_STOI,   2, 2, 8 * 0x10),
+        I(Opcode::OP_SETL,   0, 0x00, 0x09),
+        I(Opcode::OP_UNSAVE, 0, 2, 3) });
+
+    EXPECT_EQ(RunStatus::Faulted, invalid->run());
+    EXPECT_EQ(fault2code(Fault::MemoryProtection),
+              invalid->sreg(SReg::SR_RCC));
+    EXPECT_EQ(9U, invalid->reg(0));
+}
+
+/**
+ * Test that a register-stack which grows past the stack limit raises a stack
+ * overflow after the call completes, and that a handler which overruns the
+ * slack past the limit stops the machine.
+ */
+TEST(MachineState, stack_overflow)
+{
+    //recurse forever; the fault handler exits with rCC.
+    const vector<uint32_t> program = {
+        I(Opcode::OP_PUSHJ,   1, 0, 0),
+        I(Opcode::OP_GET,     1, 0, sreg2offset(SReg::SR_RCC)),
+        I(Opcode::OP_SYSCALL, 0, 0, 0) };
+
+    auto unhandled = machine(program);
+    unhandled->setStackLimit(1024);
+
+    EXPECT_EQ(RunStatus::Faulted, unhandled->run());
+    EXPECT_EQ(fault2code(Fault::StackOverflow),
+              unhandled->sreg(SReg::SR_RCC));
+    //RESUME continues at the target of the call.
+    EXPECT_EQ(CODE_BASE, unhandled->sreg(SReg::SR_RF) + 4);
+    EXPECT_LT(1024U, unhandled->sreg(SReg::SR_RO));
+
+    auto handled = machine(program);
+    handled->setStackLimit(1024);
+    handled->setSReg(SReg::SR_RFF, CODE_BASE + 4);
+
+    EXPECT_EQ(RunStatus::Halted, handled->run());
+    EXPECT_EQ(fault2code(Fault::StackOverflow), handled->exitCode());
+
+    //the instruction limit doesn't lose the fault.
+    auto limited = machine(program);
+    limited->setStackLimit(1024);
+    limited->setSReg(SReg::SR_RFF, CODE_BASE + 4);
+
+    while (RunStatus::InstructionLimit == limited->run(7))
+        ;
+    EXPECT_TRUE(limited->halted());
+    EXPECT_EQ(fault2code(Fault::StackOverflow), limited->exitCode());
+
+    //a handler which keeps recursing runs out of slack.
+    auto runaway = machine({
+        I(Opcode::OP_PUSHJ,  1, 0, 0),
+        I(Opcode::OP_RESUME, 0, 0, 0) });
+    runaway->setStackLimit(1024);
+    runaway->setSReg(SReg::SR_RFF, CODE_BASE + 4);
+
+    EXPECT_EQ(RunStatus::Faulted, runaway->run());
+    EXPECT_EQ(fault2code(Fault::StackOverflow),
+              runaway->sreg(SReg::SR_RCC));
+
+    //the default limit is the largest, leaving room for the slack.
+    auto fresh = machine(program);
+    uint64_t largest = fresh->stackLimit();
+    EXPECT_GT(largest, 1024U * 1024U);
+    fresh->setStackLimit(~0ULL);
+    EXPECT_EQ(largest, fresh->stackLimit());
+}
+
+/**
+ * Test the exit system call, and host system call registration.
+ */
+TEST(MachineState, syscall)
+{
+    auto exit = machine({
+        I(Opcode::OP_SETL,    1, 0, 7),
+        I(Opcode::OP_SYSCALL, 0, 0, 0) });
+
+    EXPECT_EQ(RunStatus::Halted, exit->run());
+    EXPECT_EQ(7U, exit->exitCode());
+
+    auto twice = machine({
+        I(Opcode::OP_SETL,    1, 0, 21),
+        I(Opcode::OP_SYSCALL, 0, 0x01, 0x00),
+        I(Opcode::OP_POP,     1, 0, 0) });
+
+    twice->registerSyscall(0x100, &syscallDouble);
+    EXPECT_EQ(RunStatus::Halted, twice->run());
+    EXPECT_EQ(42U, twice->exitCode());
+}
+
+/**
+ * Test that a fault without a handler halts with the fault state recorded.
+ */
+TEST(MachineState, fault_unhandled)
+{
+    auto state = machine({
+        I(Opcode::OP_SETL,    1, 0, 7),
+        I(Opcode::OP_SYSCALL, 0, 0x12, 0x34) });
+
+    EXPECT_EQ(RunStatus::Faulted, state->run());
+    EXPECT_EQ(fault2code(Fault::UnsupportedSyscall),
+              state->sreg(SReg::SR_RCC));
+    EXPECT_EQ(CODE_BASE + 4, state->sreg(SReg::SR_RF));
+    EXPECT_EQ(0x00001234U, state->sreg(SReg::SR_ROP));
+    EXPECT_EQ(2U, state->instructionCount());
+}
+
+/**
+ * Test that a fault handler in rFF runs and RESUME continues after the
+ * faulting instruction.
+ */
+TEST(MachineState, fault_handler)
+{
+    auto state = machine({
+        I(Opcode::OP_SETL,   1, 0, 10),
+        I(Opcode::OP_DIV,    3, 1, 2),
+        I(Opcode::OP_POP,    1, 0, 0),
+        //handler: $0 = rCC
+        I(Opcode::OP_GET,    0, 0, 0x1F),
+        I(Opcode::OP_RESUME, 0, 0, 0) });
+
+    state->setSReg(SReg::SR_RFF, CODE_BASE + 12);
+
+    EXPECT_EQ(RunStatus::Halted, state->run());
+    EXPECT_EQ(fault2code(Fault::DivideCheck), state->exitCode());
+    EXPECT_EQ(CODE_BASE + 4, state->sreg(SReg::SR_RF));
+}
+
+/**
+ * Test that memory accesses check alignment, mapping, and policy.
+ */
+TEST(MachineState, memory_faults)
+{
+    auto unaligned = machine({
+        I(Opcode::OP_SETML, 2, 0x00, 0x02),
+        I(Opcode::OP_LDOI,  0, 2, 4) });
+
+    EXPECT_EQ(RunStatus::Faulted, unaligned->run());
+    EXPECT_EQ(fault2code(Fault::MemoryAlignment),
+              unaligned->sreg(SReg::SR_RCC));
+
+    auto unmapped = machine({
+        I(Opcode::OP_LDOI,  0, 2, 0) });
+
+    EXPECT_EQ(RunStatus::Faulted, unmapped->run());
+    EXPECT_EQ(fault2code(Fault::MemoryProtection),
+              unmapped->sreg(SReg::SR_RCC));
+
+    //code is not writable.
+    auto readonly = machine({
+        I(Opcode::OP_SETML, 2, 0x00, 0x01),
+        I(Opcode::OP_STOI,  0, 2, 0) });
+
+    EXPECT_EQ(RunStatus::Faulted, readonly->run());
+    EXPECT_EQ(fault2code(Fault::MemoryProtection),
+              readonly->sreg(SReg::SR_RCC));
+
+    //running off the end of the code segment faults on fetch.
+    auto runoff = machine({
+        I(Opcode::OP_SWYM,  0, 0, 0) });
+
+    runoff->addressSpace().changePolicy(CODE_BASE, SEGMENT_READ);
+    EXPECT_EQ(RunStatus::Faulted, runoff->run());
+    EXPECT_EQ(CODE_BASE, runoff->sreg(SReg::SR_RF));
+}
+
+/**
+ * Test that reserved opcodes fault.
+ */
+TEST(MachineState, invalid_instruction)
+{
+    auto state = machine({
+        I(Opcode::OP_RESERVED_x98, 0, 0, 0) });
+
+    EXPECT_EQ(RunStatus::Faulted, state->run());
+    EXPECT_EQ(fault2code(Fault::InvalidInstruction),
+              state->sreg(SReg::SR_RCC));
+}
+
+/**
+ * Test that signed ADD, SUB, MUL, and NEG raise an integer overflow fault only
+ * when the result does not fit, recording the operands in the fault registers.
+ */
+TEST(MachineState, integer_overflow)
+{
+    const uint64_t MIN = 0x8000000000000000ULL;
+    const uint64_t MAX = 0x7FFFFFFFFFFFFFFFULL;
+
+    static const struct {
+        Opcode op;
+        uint64_t y;
+        uint64_t z;
+        bool overflow;
+    } cases[] = {
+        { Opcode::OP_ADD, MAX, 1, true },
+        { Opcode::OP_ADD, MIN, (uint64_t)-1, true },
+        { Opcode::OP_ADD, MAX, (uint64_t)-1, false },
+        { Opcode::OP_SUB, MIN, 1, true },
+        { Opcode::OP_SUB, MAX, (uint64_t)-1, true },
+        { Opcode::OP_SUB, MIN, (uint64_t)-1, false },
+        { Opcode::OP_MUL, MIN, (uint64_t)-1, true },
+        { Opcode::OP_MUL, 0x100000000ULL, 0x80000000ULL, true },
+        { Opcode::OP_MUL, 0x100000000ULL, (uint64_t)-0x80000000LL, false },
+        { Opcode::OP_NEG, 0, MIN, true },
+        { Opcode::OP_NEG, 0, MIN + 1, false },
+        { Opcode::OP_NEG, 0, MAX, false } };
+
+    for (const auto& c : cases)
+    {
+        auto state = machine({});
+
+        state->setReg(1, 0x1234);
+        state->setReg(2, c.y);
+        state->setReg(3, c.z);
+
+        //NEG takes Y as a constant.
+        uint8_t y = Opcode::OP_NEG == c.op ? (uint8_t)c.y : 2;
+        state->evaluate(DecodedInstruction(c.op, 1, y, 3));
+
+        if (c.overflow)
+        {
+            EXPECT_EQ(fault2code(Fault::IntegerOverflow),
+                      state->sreg(SReg::SR_RCC));
+            EXPECT_EQ(CODE_BASE, state->sreg(SReg::SR_RF));
+            EXPECT_EQ(0x1234U, state->sreg(SReg::SR_RXX));
+            EXPECT_EQ(c.z, state->sreg(SReg::SR_RZZ));
+            EXPECT_EQ(0x1234U, state->reg(1));
+            EXPECT_TRUE(state->halted());
+        }
+        else
+        {
+            EXPECT_EQ(0U, state->sreg(SReg::SR_RCC));
+            EXPECT_EQ(CODE_BASE + 4, state->pc());
+            EXPECT_FALSE(state->halted());
+        }
+    }
+}
+
+/**
+ * Test that DIVI and DIVUI, which divide through a predecoded reciprocal,
+ * match DIV and DIVU by the same register value bit for bit.
+ */
+TEST(MachineState, divide_reciprocal)
+{
+    static const uint64_t edges[] = {
+        0, 1, 2, 254, 255, 256, 0x7FFFFFFFFFFFFFFFULL, 0x8000000000000000ULL,
+        0x8000000000000001ULL, 0xFFFFFFFFFFFFFF01ULL, 0xFFFFFFFFFFFFFFFFULL };
+    static const Opcode ops[][2] = {
+        { Opcode::OP_DIV, Opcode::OP_DIVI },
+        { Opcode::OP_DIVU, Opcode::OP_DIVUI } };
+
+    mt19937_64 random(0x51AE);
+    vector<uint64_t> dividends(begin(edges), end(edges));
+
+    for (int n = 0; n < 16; ++n)
+    {
+        dividends.push_back(random());
+        //small magnitudes exercise the rounding of negative quotients.
+        dividends.push_back(random() % 1024 - 512);
+    }
+
+    for (const auto& op : ops)
+    {
+        for (int z = 0; z < 256; ++z)
+        {
+            for (uint64_t y : dividends)
+            {
+                //rD is honored by DIVU; the reciprocal applies only to 0.
+                uint64_t d = (y & 3) ? 0 : y % 256;
+                auto r = machine({});
+                auto i = machine({});
+
+                r->setSReg(SReg::SR_RD, d);
+                r->setReg(2, y);
+                r->setReg(3, z);
+                r->evaluate(DecodedInstruction(op[0], 1, 2, 3));
+
+                i->setSReg(SReg::SR_RD, d);
+                i->setReg(2, y);
+                i->evaluate(DecodedInstruction(op[1], 1, 2, (uint8_t)z));
+
+                ASSERT_EQ(r->reg(1), i->reg(1)) << y << " / " << z;
+                ASSERT_EQ(r->sreg(SReg::SR_RR), i->sreg(SReg::SR_RR))
+                    << y << " / " << z;
+                ASSERT_EQ(r->sreg(SReg::SR_RCC), i->sreg(SReg::SR_RCC));
+                ASSERT_EQ(r->pc(), i->pc());
+            }
+        }
+    }
+}
+
+/**
+ * Test that decoded instructions evaluate through the machine state.
+ */
+TEST(MachineState, decoded_evaluate)
+{
+    auto state = machine({});
+
+    DecodedInstruction::decode(Opcode::OP_SETL, 3, 0, 42)
+        .evaluate(state.get());
+
+    EXPECT_EQ(42U, state->reg(3));
+    EXPECT_EQ(CODE_BASE + 4, state->pc());
+    EXPECT_EQ(1U, state->instructionCount());
+}
+
+/**
+ * Test that the register and immediate forms of each integer operation, which
+ * run through separately generated handlers, compute the same result.
+ */
+TEST(MachineState, immediate_twins)
+{
+    static const uint8_t ranges[][2] = {
+        { 0x18, 0x40 }, { 0x60, 0x80 }, { 0xC0, 0xE0 } };
+    static const uint64_t values[] = {
+        0, 1, 0x7F, 0xFFFFFFFFFFFFFFFFULL, 0x8000000000000000ULL };
+
+    for (const auto& range : ranges)
+    {
+        for (int op = range[0]; op < range[1]; op += 2)
+        {
+            Opcode reg = static_cast<Opcode>(op);
+            Opcode imm = static_cast<Opcode>(op + 1);
+
+            if (!opcodeTraits(reg).valid)
+                continue;
+
+            ASSERT_FALSE(opcodeTraits(reg).zImmediate);
+            ASSERT_TRUE(opcodeTraits(imm).zImmediate) << op;
+
+            for (uint64_t value : values)
+            {
+                auto r = machine({});
+                auto i = machine({});
+
+                r->setReg(1, 0x1234);
+                r->setReg(2, value);
+                r->setReg(3, 7);
+                r->evaluate(DecodedInstruction(reg, 1, 2, 3));
+
+                i->setReg(1, 0x1234);
+                i->setReg(2, value);
+                i->evaluate(DecodedInstruction(imm, 1, 2, 7));
+
+                EXPECT_EQ(r->reg(1), i->reg(1)) << op;
+                EXPECT_EQ(r->pc(), i->pc());
+                EXPECT_EQ(r->sreg(SReg::SR_RR), i->sreg(SReg::SR_RR));
+                EXPECT_EQ(r->sreg(SReg::SR_RCC), i->sreg(SReg::SR_RCC));
+            }
+        }
+    }
+}
+
+/**
+ * Append instructions which set $X to a tetra constant.
+ */
+static void setTetra(vector<uint32_t>& program, uint8_t x, uint32_t value)
+{
+    program.push_back(
+        I(Opcode::OP_SETML, x, (uint8_t)(value >> 24), (uint8_t)(value >> 16)));
+    program.push_back(
+        I(Opcode::OP_ORL, x, (uint8_t)(value >> 8), (uint8_t)value));
+}
+
+/**
+ * Test the segment system calls.
+ */
+TEST(MachineState, segment_syscalls)
+{
+    auto state = machine({
+        //$11 = allocate(0x1000, READ | WRITE)
+        I(Opcode::OP_SETL,    12, 0x10, 0x00),
+        I(Opcode::OP_SETL,    13, 0, SEGMENT_READ | SEGMENT_WRITE),
+        I(Opcode::OP_SYSCALL, 11, 0, 1),
+        //$14 = policy($11, 0xFF)
+        I(Opcode::OP_ORI,     15, 11, 0),
+        I(Opcode::OP_SETL,    16, 0, 0xFF),
+        I(Opcode::OP_SYSCALL, 14, 0, 3),
+        //$17 = free($11); $18 = free($11)
+        I(Opcode::OP_ORI,     18, 11, 0),
+        I(Opcode::OP_SYSCALL, 17, 0, 2),
+        I(Opcode::OP_ORI,     19, 11, 0),
+        I(Opcode::OP_SYSCALL, 18, 0, 2),
+        I(Opcode::OP_JMP,     0, 0, 0) });
+
+    EXPECT_EQ(RunStatus::InstructionLimit, state->run(100));
+    EXPECT_EQ(AddressSpace::ALLOCATION_BASE, state->reg(11));
+    EXPECT_EQ(status2code(SyscallStatus::InvalidPolicy), state->reg(14));
+    EXPECT_EQ(status2code(SyscallStatus::Success), state->reg(17));
+    EXPECT_EQ(status2code(SyscallStatus::InvalidSegment), state->reg(18));
+    EXPECT_EQ(nullptr,
+              state->addressSpace().find(AddressSpace::ALLOCATION_BASE));
+}
+
+/**
+ * Test that cached translations are dropped when a system call or the host
+ * changes the policy of a segment or frees it.
+ */
+TEST(MachineState, translation_flush)
+{
+    auto policy = machine({
+        //registers above X are dropped by each system call.
+        //$11 = allocate(0x1000, READ | WRITE)
+        I(Opcode::OP_SETL,    12, 0x10, 0x00),
+        I(Opcode::OP_SETL,    13, 0, SEGMENT_READ | SEGMENT_WRITE),
+        I(Opcode::OP_SYSCALL, 11, 0, 1),
+        I(Opcode::OP_SETL,    1, 0, 42),
+        I(Opcode::OP_STOI,    1, 11, 8),
+        I(Opcode::OP_LDOI,    2, 11, 8),
+        //$14 = policy($11, READ)
+        I(Opcode::OP_ORI,     15, 11, 0),
+        I(Opcode::OP_SETL,    16, 0, SEGMENT_READ),
+        I(Opcode::OP_SYSCALL, 14, 0, 3),
+        I(Opcode::OP_LDOI,    3, 11, 8),
+        I(Opcode::OP_STOI,    1, 11, 8) });
+
+    EXPECT_EQ(RunStatus::Faulted, policy->run());
+    EXPECT_EQ(42U, policy->reg(2));
+    EXPECT_EQ(42U, policy->reg(3));
+    EXPECT_EQ(fault2code(Fault::MemoryProtection),
+              policy->sreg(SReg::SR_RCC));
+    EXPECT_EQ(CODE_BASE + 4 * 10, policy->sreg(SReg::SR_RF));
+
+    //the host frees the data segment between runs.
+    auto freed = machine({
+        I(Opcode::OP_SETL,    20, 0, 42),
+        I(Opcode::OP_STOI,    20, 255, 0),
+        I(Opcode::OP_LDOI,    21, 255, 0),
+        I(Opcode::OP_LDOI,    22, 255, 0) });
+
+    freed->setReg(255, DATA_BASE);
+    EXPECT_EQ(RunStatus::InstructionLimit, freed->run(3));
+    EXPECT_EQ(42U, freed->reg(21));
+
+    ASSERT_TRUE(freed->addressSpace().free(DATA_BASE));
+    EXPECT_EQ(RunStatus::Faulted, freed->run());
+    EXPECT_EQ(fault2code(Fault::MemoryProtection),
+              freed->sreg(SReg::SR_RCC));
+    EXPECT_EQ(0U, freed->reg(22));
+}
+
+/**
+ * Test that code written by the guest is predecoded again after the Change
+ * Segment Policy system call.
+ */
+TEST(MachineState, predecode_policy_change)
+{
+    const uint8_t RW = SEGMENT_READ | SEGMENT_WRITE;
+    const uint8_t RX = SEGMENT_READ | SEGMENT_EXECUTE;
+    vector<uint32_t> program = {
+        //$10 = allocate(0x1000, RW)
+        I(Opcode::OP_SETL,    12, 0x10, 0x00),
+        I(Opcode::OP_SETL,    13, 0, RW),
+        I(Opcode::OP_SYSCALL, 11, 0, 1),
+        I(Opcode::OP_ORI,     10, 11, 0) };
+
+    //write "SETL $0, 11; POP 1, 0", make it executable, and call it.
+    setTetra(program, 3, I(Opcode::OP_SETL, 0, 0, 11));
+    program.push_back(I(Opcode::OP_STTUI,  3, 10, 0));
+    setTetra(program, 3, I(Opcode::OP_POP, 1, 0, 0));
+    program.push_back(I(Opcode::OP_STTUI,  3, 10, 4));
+    program.push_back(I(Opcode::OP_ORI,    12, 10, 0));
+    program.push_back(I(Opcode::OP_SETL,   13, 0, RX));
+    program.push_back(I(Opcode::OP_SYSCALL, 11, 0, 3));
+    program.push_back(I(Opcode::OP_PUSHGOI, 20, 10, 0));
+    program.push_back(I(Opcode::OP_ORI,    5, 20, 0));
+
+    //rewrite it as "SETL $0, 31", and call it again.
+    program.push_back(I(Opcode::OP_ORI,    12, 10, 0));
+    program.push_back(I(Opcode::OP_SETL,   13, 0, RW));
+    program.push_back(I(Opcode::OP_SYSCALL, 11, 0, 3));
+    setTetra(program, 3, I(Opcode::OP_SETL, 0, 0, 31));
+    program.push_back(I(Opcode::OP_STTUI,  3, 10, 0));
+    program.push_back(I(Opcode::OP_ORI,    12, 10, 0));
+    program.push_back(I(Opcode::OP_SETL,   13, 0, RX));
+    program.push_back(I(Opcode::OP_SYSCALL, 11, 0, 3));
+    program.push_back(I(Opcode::OP_PUSHGOI, 20, 10, 0));
+    program.push_back(I(Opcode::OP_ADD,    0, 5, 20));
+    program.push_back(I(Opcode::OP_POP,    1, 0, 0));
+
+    auto state = machine(program);
+
+    EXPECT_EQ(RunStatus::Halted, state->run());
+    EXPECT_EQ(11U + 31U, state->exitCode());
+}
+
+/**
+ * Test that code written by the host is predecoded again.
+ */
+TEST(MachineState, predecode_host_write)
+{
+    auto state = machine({
+        I(Opcode::OP_SETL,  0, 0, 1),
+        I(Opcode::OP_JMP,   0, 0, 0) });
+    uint32_t tetra = I(Opcode::OP_SETL, 0, 0, 2);
+    uint8_t bytes[4] = {
+        (uint8_t)(tetra >> 24), (uint8_t)(tetra >> 16), (uint8_t)(tetra >> 8),
+        (uint8_t)tetra };
+
+    EXPECT_EQ(RunStatus::InstructionLimit, state->run(10));
+    EXPECT_EQ(1U, state->reg(0));
+
+    ASSERT_TRUE(state->addressSpace().write(CODE_BASE, bytes, sizeof(bytes)));
+    state->setPC(CODE_BASE);
+
+    EXPECT_EQ(RunStatus::InstructionLimit, state->run(10));
+    EXPECT_EQ(2U, state->reg(0));
+}
+
+/**
+ * A program which uses each superinstruction idiom.
+ */
+static vector<uint32_t> idiomProgram(uint8_t loadOffset)
+{
+    return {
+        I(Opcode::OP_SETML,   1, 0x00, 0x02),
+        I(Opcode::OP_ORL,     1, 0x00, 0x00),
+        I(Opcode::OP_SETL,    2, 0, 3),
+        I(Opcode::OP_SETL,    3, 0, 77),
+        I(Opcode::OP_8ADDU,   4, 2, 1),
+        I(Opcode::OP_STOI,    3, 4, 0),
+        I(Opcode::OP_8ADDU,   5, 2, 1),
+        I(Opcode::OP_LDOI,    6, 5, loadOffset),
+        I(Opcode::OP_CMPI,    7, 6, 77),
+        I(Opcode::OP_BZ,      7, 0, 2),
+        I(Opcode::OP_SETL,    0, 0, 1),
+        I(Opcode::OP_GETA,    8, 0, 5),
+        I(Opcode::OP_PUSHGOI, 9, 8, 0),
+        I(Opcode::OP_ADD,     0, 6, 9),
+        I(Opcode::OP_POP,     1, 0, 0),
+        I(Opcode::OP_SWYM,    0, 0, 0),
+        I(Opcode::OP_SETL,    0, 0, 100),
+        I(Opcode::OP_POP,     1, 0, 0) };
+}
+
+/**
+ * Test that superinstructions give the same result with fewer dispatches.
+ */
+TEST(MachineState, fusion)
+{
+    auto fused = machine(idiomProgram(0));
+    auto plain = machine(idiomProgram(0));
+
+    //compiled blocks would change the count of dispatches.
+    fused->setJit(false);
+    plain->setJit(false);
+
+    EXPECT_TRUE(fused->fusion());
+    plain->setFusion(false);
+    EXPECT_FALSE(plain->fusion());
+
+    EXPECT_EQ(RunStatus::Halted, fused->run());
+    EXPECT_EQ(RunStatus::Halted, plain->run());
+
+    EXPECT_EQ(177U, fused->exitCode());
+    EXPECT_EQ(177U, plain->exitCode());
+    EXPECT_EQ(16U, fused->instructionCount());
+    EXPECT_EQ(16U, plain->instructionCount());
+    EXPECT_EQ(16U, plain->dispatchCount());
+    EXPECT_EQ(12U, fused->dispatchCount());
+}
+
+/**
+ * Test that stopping partway through a superinstruction leaves exactly the
+ * same state as running the instructions one at a time.
+ */
+TEST(MachineState, fusion_instruction_limit)
+{
+    for (uint64_t limit = 1; limit <= 16; ++limit)
+    {
+        auto fused = machine(idiomProgram(0));
+        auto plain = machine(idiomProgram(0));
+
+        plain->setFusion(false);
+        fused->run(limit);
+        plain->run(limit);
+
+        EXPECT_EQ(plain->pc(), fused->pc());
+        EXPECT_EQ(plain->instructionCount(), fused->instructionCount());
+        EXPECT_EQ(plain->sreg(SReg::SR_RL), fused->sreg(SReg::SR_RL));
+        EXPECT_EQ(plain->sreg(SReg::SR_RO), fused->sreg(SReg::SR_RO));
+        for (uint8_t r = 0; r < 10; ++r)
+            EXPECT_EQ(plain->reg(r), fused->reg(r));
+    }
+}
+
+/**
+ * Test that a fault in the second half of a superinstruction reports the
+ * state of the faulting instruction.
+ */
+TEST(MachineState, fusion_fault)
+{
+    auto fused = machine(idiomProgram(4));
+
+    EXPECT_EQ(RunStatus::Faulted, fused->run());
+    EXPECT_EQ(fault2code(Fault::MemoryAlignment),
+              fused->sreg(SReg::SR_RCC));
+    EXPECT_EQ(CODE_BASE + 4 * 7, fused->sreg(SReg::SR_RF));
+    EXPECT_EQ(I(Opcode::OP_LDOI, 6, 5, 4), fused->sreg(SReg::SR_ROP));
+    EXPECT_EQ(DATA_BASE + 24, fused->sreg(SReg::SR_RYY));
+    EXPECT_EQ(4U, fused->sreg(SReg::SR_RZZ));
+    EXPECT_EQ(8U, fused->instructionCount());
+    EXPECT_EQ(DATA_BASE + 24, fused->reg(5));
+}
+
+/**
+ * A loop which stores runs of constants and of uncached registers to two
+ * consecutive 64-byte blocks at $255.
+ */
+static vector<uint32_t> storeRunProgram()
+{
+    return {
+        I(Opcode::OP_SETL,   4, 0, 2),
+        I(Opcode::OP_STCOI,  0, 255, 0),
+        I(Opcode::OP_STCOI,  0, 255, 8),
+        I(Opcode::OP_STCOI,  0, 255, 16),
+        I(Opcode::OP_STCOI,  7, 255, 24),
+        I(Opcode::OP_STCOI,  7, 255, 32),
+        I(Opcode::OP_STUNCI, 1, 255, 40),
+        I(Opcode::OP_STUNCI, 2, 255, 48),
+        I(Opcode::OP_STUNCI, 3, 255, 56),
+        I(Opcode::OP_ADDUI,  255, 255, 64),
+        I(Opcode::OP_SUBI,   4, 4, 1),
+        I(Opcode::OP_BNZB,   4, 0xFF, 0xF6),
+        I(Opcode::OP_SYNC,   0, 0, 0),
+        I(Opcode::OP_POP,    0, 0, 0) };
+}
+
+/**
+ * Test that runs of STCOI and STUNCI to consecutive octas store the same
+ * bytes as the individual stores, at any instruction limit, in either byte
+ * order, and with policy enforced by the host MMU.
+ */
+TEST(MachineState, store_runs)
+{
+    const uint64_t values[3] = {
+        0x0102030405060708U, 0x1112131415161718U, 0x2122232425262728U };
+    uint8_t expected[128];
+
+    for (size_t block = 0; block < 2; ++block)
+    {
+        uint8_t* out = expected + 64 * block;
+
+        memset(out, 0, 24);
+        for (size_t k = 0; k < 2; ++k)
+        {
+            memset(out + 24 + 8 * k, 0, 7);
+            out[31 + 8 * k] = 7;
+        }
+        for (size_t k = 0; k < 3; ++k)
+            for (size_t b = 0; b < 8; ++b)
+                out[40 + 8 * k + b] = (uint8_t)(values[k] >> (56 - 8 * b));
+    }
+
+    for (int config = 0; config < 3; ++config)
+    {
+        for (uint64_t limit = 1; limit <= 25; ++limit)
+        {
+            bool hostProtection = 2 == config;
+            ByteOrder order = 1 == config
+                ? ByteOrder::Native : ByteOrder::BigEndian;
+            auto fused = machine(storeRunProgram(), hostProtection, order);
+            auto plain = machine(storeRunProgram(), hostProtection, order);
+            vector<uint8_t> fill(128, 0xFF);
+            uint8_t a[128], b[128];
+
+            plain->setFusion(false);
+            for (auto* state : { fused.get(), plain.get() })
+            {
+                state->addressSpace().write(
+                    DATA_BASE, fill.data(), fill.size());
+                for (uint8_t r = 0; r < 3; ++r)
+                    state->setReg(r + 1, values[r]);
+                state->setReg(255, DATA_BASE);
+                state->run(limit);
+            }
+
+            fused->addressSpace().read(DATA_BASE, a, sizeof(a));
+            plain->addressSpace().read(DATA_BASE, b, sizeof(b));
+            EXPECT_EQ(0, memcmp(a, b, sizeof(a)));
+            EXPECT_EQ(plain->pc(), fused->pc());
+            EXPECT_EQ(plain->instructionCount(), fused->instructionCount());
+            EXPECT_EQ(plain->reg(255), fused->reg(255));
+
+            if (25 == limit)
+            {
+                EXPECT_TRUE(fused->halted());
+                EXPECT_EQ(0, memcmp(expected, a, sizeof(a)));
+                EXPECT_LT(fused->dispatchCount(), plain->dispatchCount());
+            }
+        }
+    }
+}
+
+/**
+ * Test that a run of stores which leaves its segment stores each octa up to
+ * the fault, and reports the state of the faulting store.
+ */
+TEST(MachineState, store_run_fault)
+{
+    auto state = machine({
+        I(Opcode::OP_STCOI,  5, 255, 0),
+        I(Opcode::OP_STCOI,  5, 255, 8),
+        I(Opcode::OP_STCOI,  5, 255, 16),
+        I(Opcode::OP_STCOI,  5, 255, 24),
+        I(Opcode::OP_POP,    0, 0, 0) });
+    uint8_t out[16];
+
+    state->setReg(255, DATA_BASE + 0x1000 - 16);
+
+    EXPECT_EQ(RunStatus::Faulted, state->run());
+    EXPECT_EQ(fault2code(Fault::MemoryProtection),
+              state->sreg(SReg::SR_RCC));
+    EXPECT_EQ(CODE_BASE + 4 * 2, state->sreg(SReg::SR_RF));
+    EXPECT_EQ(I(Opcode::OP_STCOI, 5, 255, 16), state->sreg(SReg::SR_ROP));
+    EXPECT_EQ(3U, state->instructionCount());
+
+    ASSERT_TRUE(state->addressSpace().read(DATA_BASE + 0x1000 - 16, out, 16));
+    EXPECT_EQ(5, out[7]);
+    EXPECT_EQ(5, out[15]);
+}
+
+/**
+ * Test that a machine whose policy is enforced by the host MMU runs loads,
+ * stores, and superinstructions the same as one which checks in software.
+ */
+TEST(MachineState, host_protection)
+{
+    auto fused = machine(idiomProgram(0), true);
+    if (nullptr == fused->addressSpace().guestView())
+        GTEST_SKIP() << "the host can't provide an arena";
+
+    EXPECT_EQ(RunStatus::Halted, fused->run());
+    EXPECT_EQ(177U, fused->exitCode());
+    EXPECT_EQ(16U, fused->instructionCount());
+
+    //a misaligned load in a superinstruction still faults precisely.
+    auto misaligned = machine(idiomProgram(4), true);
+
+    EXPECT_EQ(RunStatus::Faulted, misaligned->run());
+    EXPECT_EQ(fault2code(Fault::MemoryAlignment),
+              misaligned->sreg(SReg::SR_RCC));
+    EXPECT_EQ(CODE_BASE + 4 * 7, misaligned->sreg(SReg::SR_RF));
+    EXPECT_EQ(8U, misaligned->instructionCount());
+
+    //stopping partway and running again leaves the same state.
+    auto split = machine(idiomProgram(0), true);
+
+    EXPECT_EQ(RunStatus::InstructionLimit, split->run(7));
+    EXPECT_EQ(RunStatus::Halted, split->run());
+    EXPECT_EQ(177U, split->exitCode());
+    EXPECT_EQ(16U, split->instructionCount());
+}
+
+/**
+ * Test that host faults on the arena become precise guest faults.
+ */
+TEST(MachineState, host_protection_faults)
+{
+    vector<uint32_t> program = {
+        I(Opcode::OP_SETL,   1, 0, 42),
+        //stores to the code segment fault.
+        I(Opcode::OP_STOI,   1, 254, 0),
+        I(Opcode::OP_CSWAPI, 1, 254, 0),
+        I(Opcode::OP_LDOI,   2, 255, 0),
+        I(Opcode::OP_POP,    1, 0, 0),
+        //handler: count faults in $3, and resume.
+        I(Opcode::OP_INCL,   3, 0, 1),
+        I(Opcode::OP_RESUME, 0, 0, 0) };
+
+    for (bool hostProtection : { false, true })
+    {
+        auto state = machine(program, hostProtection);
+        if (hostProtection && nullptr == state->addressSpace().guestView())
+            GTEST_SKIP() << "the host can't provide an arena";
+
+        state->setReg(254, CODE_BASE);
+        state->setReg(255, DATA_BASE);
+        state->setSReg(SReg::SR_RFF, CODE_BASE + 20);
+
+        EXPECT_EQ(RunStatus::Halted, state->run());
+        EXPECT_EQ(2U, state->reg(3));
+        EXPECT_EQ(42U, state->reg(1));
+        EXPECT_EQ(fault2code(Fault::MemoryProtection),
+                  state->sreg(SReg::SR_RCC));
+        EXPECT_EQ(CODE_BASE + 8, state->sreg(SReg::SR_RF));
+        EXPECT_EQ(I(Opcode::OP_CSWAPI, 1, 254, 0),
+                  state->sreg(SReg::SR_ROP));
+        EXPECT_EQ(9U, state->instructionCount());
+
+        //the code is unchanged.
+        uint8_t tetra[4];
+        ASSERT_TRUE(state->addressSpace().read(CODE_BASE, tetra, 4));
+        EXPECT_EQ(0xE3U, tetra[0]);
+    }
+
+    //a write-only segment can be stored to but not loaded from.
+    auto writeOnly = machine({
+        I(Opcode::OP_SETL,  1, 0, 42),
+        I(Opcode::OP_STOI,  1, 254, 8),
+        I(Opcode::OP_LDOI,  2, 254, 8) }, true);
+
+    ASSERT_NE(nullptr, writeOnly->addressSpace().map(
+                           0x30000, 0x1000, SEGMENT_WRITE));
+    writeOnly->setReg(254, 0x30000);
+
+    EXPECT_EQ(RunStatus::Faulted, writeOnly->run());
+    EXPECT_EQ(fault2code(Fault::MemoryProtection),
+              writeOnly->sreg(SReg::SR_RCC));
+    EXPECT_EQ(CODE_BASE + 8, writeOnly->sreg(SReg::SR_RF));
+    EXPECT_EQ(0U, writeOnly->reg(2));
+
+    uint8_t octa[8];
+    ASSERT_TRUE(writeOnly->addressSpace().read(0x30008, octa, 8));
+    EXPECT_EQ(42U, octa[7]);
+
+    //a freed segment faults, and its pages are zero when mapped again.
+    auto freed = machine({
+        I(Opcode::OP_SETL,    20, 0, 42),
+        I(Opcode::OP_STOI,    20, 255, 0),
+        I(Opcode::OP_LDOI,    21, 255, 0),
+        I(Opcode::OP_LDOI,    22, 255, 0) }, true);
+
+    freed->setReg(255, DATA_BASE);
+    EXPECT_EQ(RunStatus::InstructionLimit, freed->run(3));
+    EXPECT_EQ(42U, freed->reg(21));
+
+    ASSERT_TRUE(freed->addressSpace().free(DATA_BASE));
+    EXPECT_EQ(RunStatus::Faulted, freed->run());
+    EXPECT_EQ(fault2code(Fault::MemoryProtection),
+              freed->sreg(SReg::SR_RCC));
+    EXPECT_EQ(CODE_BASE + 12, freed->sreg(SReg::SR_RF));
+    EXPECT_EQ(0U, freed->reg(22));
+
+    ASSERT_NE(nullptr, freed->addressSpace().map(
+                           DATA_BASE, 0x1000, SEGMENT_READ));
+    ASSERT_TRUE(freed->addressSpace().read(DATA_BASE, octa, 8));
+    EXPECT_EQ(0U, octa[7]);
+}
+
+/**
+ * Test that loads and stores of every width give the same results whether
+ * memory is big-endian or holds octas in the native byte order, and that the
+ * host sees guest byte order either way.
+ */
+TEST(MachineState, native_byte_order)
+{
+    vector<uint32_t> program = {
+        I(Opcode::OP_LDBI,   1, 255, 3),
+        I(Opcode::OP_LDWUI,  2, 255, 2),
+        I(Opcode::OP_LDTUI,  3, 255, 4),
+        I(Opcode::OP_LDOI,   4, 255, 8),
+        I(Opcode::OP_LDHTI,  5, 255, 0),
+        I(Opcode::OP_LDBI,   6, 255, 16),
+        I(Opcode::OP_LDWI,   7, 255, 16),
+        I(Opcode::OP_LDTI,   8, 255, 16),
+        I(Opcode::OP_LDSFI,  9, 255, 20),
+        I(Opcode::OP_STBI,   1, 255, 32),
+        I(Opcode::OP_STWUI,  2, 255, 34),
+        I(Opcode::OP_STTUI,  3, 255, 36),
+        I(Opcode::OP_STOI,   4, 255, 40),
+        I(Opcode::OP_STHTI,  5, 255, 48),
+        I(Opcode::OP_STSFI,  9, 255, 52),
+        I(Opcode::OP_STCOI,  7, 255, 56),
+        //rP = the octa at 8, so the swap succeeds.
+        I(Opcode::OP_PUT,    0x08, 0, 4),
+        I(Opcode::OP_SETL,   10, 0, 0x99),
+        I(Opcode::OP_CSWAPI, 10, 255, 8),
+        I(Opcode::OP_LDOI,   11, 255, 8),
+        //the image of a SAVE reads back through loads.
+        I(Opcode::OP_SAVE,   12, 254, 0),
+        I(Opcode::OP_UNSAVE,  0, 254, 253),
+        I(Opcode::OP_POP,    0, 0, 0) };
+
+    const uint8_t in[24] = {
+        0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+        0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10,
+        0x80, 0x81, 0x82, 0x83, 0x3F, 0xC0, 0x00, 0x00 };
+    const uint8_t expected[32] = {
+        0x04, 0x00, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+        0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10,
+        0x01, 0x02, 0x03, 0x04, 0x3F, 0xC0, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07 };
+
+    for (ByteOrder order : { ByteOrder::BigEndian, ByteOrder::Native })
+    {
+        auto state = machine(program, false, order);
+        uint8_t out[32];
+
+        ASSERT_TRUE(state->addressSpace().write(DATA_BASE, in, sizeof(in)));
+        state->setSReg(SReg::SR_RG, 16);
+        state->setReg(253, 0);
+        state->setReg(254, DATA_BASE + 0x800);
+        state->setReg(255, DATA_BASE);
+        state->setSReg(SReg::SR_RJ, 0x1234);
+
+        EXPECT_EQ(RunStatus::InstructionLimit, state->run(21));
+        EXPECT_EQ(0x04U, state->reg(1));
+        EXPECT_EQ(0x0304U, state->reg(2));
+        EXPECT_EQ(0x05060708U, state->reg(3));
+        EXPECT_EQ(0x090A0B0C0D0E0F10U, state->reg(4));
+        EXPECT_EQ(0x0102030400000000U, state->reg(5));
+        EXPECT_EQ(0xFFFFFFFFFFFFFF80U, state->reg(6));
+        EXPECT_EQ(0xFFFFFFFFFFFF8081U, state->reg(7));
+        EXPECT_EQ(0xFFFFFFFF80818283U, state->reg(8));
+        EXPECT_EQ(0x3FF8000000000000U, state->reg(9));
+        EXPECT_EQ(1U, state->reg(10));
+        EXPECT_EQ(0x99U, state->reg(11));
+
+        ASSERT_TRUE(state->addressSpace().read(
+                        DATA_BASE + 32, out, sizeof(out)));
+        EXPECT_EQ(0, memcmp(expected, out, sizeof(out)));
+
+        //the image of rJ is an octa in guest byte order to the host.
+        ASSERT_TRUE(state->addressSpace().read(
+                        DATA_BASE + 0x800 + 8 * sreg2offset(SReg::SR_RJ),
+                        out, 8));
+        EXPECT_EQ(0x12, out[6]);
+        EXPECT_EQ(0x34, out[7]);
+
+        state->setSReg(SReg::SR_RJ, 0);
+        EXPECT_EQ(RunStatus::InstructionLimit, state->run(1));
+        EXPECT_EQ(0x1234U, state->sreg(SReg::SR_RJ));
+
+        //native memory holds each octa in host order.
+        if (ByteOrder::Native == order)
+        {
+            uint64_t octa;
+            Segment* seg = state->addressSpace().find(DATA_BASE);
+
+            memcpy(&octa, seg->data() + 16, sizeof(octa));
+            EXPECT_EQ(0x808182833FC00000U, octa);
+        }
+    }
+
+    //superinstructions load in the native byte order too.
+    auto fused = machine(idiomProgram(0), false, ByteOrder::Native);
+
+    fused->setJit(false);
+    EXPECT_EQ(RunStatus::Halted, fused->run());
+    EXPECT_EQ(177U, fused->exitCode());
+    EXPECT_EQ(12U, fused->dispatchCount());
+}
+
+/**
+ * The opcodes which the JIT translates, other than branches and memory
+ * accesses.
+ */
+static const Opcode JIT_ALU_OPCODES[] = {
+    Opcode::OP_ADD, Opcode::OP_ADDI, Opcode::OP_ADDU, Opcode::OP_ADDUI,
+    Opcode::OP_SUB, Opcode::OP_SUBI, Opcode::OP_SUBU, Opcode::OP_SUBUI,
+    Opcode::OP_2ADDU, Opcode::OP_4ADDUI, Opcode::OP_8ADDU, Opcode::OP_16ADDUI,
+    Opcode::OP_CMP, Opcode::OP_CMPI, Opcode::OP_CMPU, Opcode::OP_CMPUI,
+    Opcode::OP_NEG, Opcode::OP_NEGI, Opcode::OP_NEGU, Opcode::OP_NEGUI,
+    Opcode::OP_MUL, Opcode::OP_MULI, Opcode::OP_MULU, Opcode::OP_MULUI,
+    Opcode::OP_OR, Opcode::OP_ORNI, Opcode::OP_NOR, Opcode::OP_XORI,
+    Opcode::OP_AND, Opcode::OP_ANDNI, Opcode::OP_NAND, Opcode::OP_NXOR,
+    Opcode::OP_MUX, Opcode::OP_MUXI, Opcode::OP_SL, Opcode::OP_SLI,
+    Opcode::OP_SLU, Opcode::OP_SLUI, Opcode::OP_SR, Opcode::OP_SRI,
+    Opcode::OP_SRU, Opcode::OP_SRUI, Opcode::OP_CSN, Opcode::OP_CSZI,
+    Opcode::OP_CSP, Opcode::OP_CSODI, Opcode::OP_CSNN, Opcode::OP_CSNZI,
+    Opcode::OP_CSNP, Opcode::OP_CSEVI, Opcode::OP_ZSN, Opcode::OP_ZSZI,
+    Opcode::OP_ZSP, Opcode::OP_ZSODI, Opcode::OP_ZSNN, Opcode::OP_ZSNZI,
+    Opcode::OP_ZSNP, Opcode::OP_ZSEVI, Opcode::OP_SETH, Opcode::OP_SETL,
+    Opcode::OP_INCMH, Opcode::OP_INCL, Opcode::OP_ORML, Opcode::OP_ANDNH,
+    Opcode::OP_GETA, Opcode::OP_SWYM };
+
+/**
+ * The loads and stores which the JIT translates.
+ */
+static const Opcode JIT_MEMORY_OPCODES[] = {
+    Opcode::OP_LDBI, Opcode::OP_LDBUI, Opcode::OP_LDWI, Opcode::OP_LDWUI,
+    Opcode::OP_LDTI, Opcode::OP_LDTUI, Opcode::OP_LDOI, Opcode::OP_LDOUI,
+    Opcode::OP_LDHTI, Opcode::OP_STBI, Opcode::OP_STBUI, Opcode::OP_STWI,
+    Opcode::OP_STWUI, Opcode::OP_STTI, Opcode::OP_STTUI, Opcode::OP_STOI,
+    Opcode::OP_STOUI, Opcode::OP_STHTI, Opcode::OP_STCOI };
+
+/**
+ * A random program which sets up registers $0 through $8, then runs a loop
+ * of instructions which the JIT translates three times, with the odd
+ * conditional branch, and an instruction which it doesn't now and then.
+ * Memory is accessed at $255, which holds DATA_BASE.  Some of these
+ * instructions overflow or access memory out of alignment, and fault.
+ */
+static vector<uint32_t> jitProgram(mt19937& rng)
+{
+    const uint8_t regs[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 248, 249, 250 };
+    const size_t BODY = 24;
+    vector<uint32_t> program;
+
+    auto pick = [&](size_t n) { return rng() % n; };
+    auto anyReg = [&]() { return regs[pick(sizeof(regs))]; };
+
+    //$0 through $3 hold small values, so that comparisons are often equal.
+    for (uint8_t r = 0; r <= 8; ++r)
+    {
+        if (r < 4)
+        {
+            program.push_back(I(Opcode::OP_SETL, r, 0, pick(3)));
+            continue;
+        }
+
+        program.push_back(I(Opcode::OP_SETL, r, pick(256), pick(256)));
+        program.push_back(I(Opcode::OP_ORMH, r, pick(256), pick(256)));
+    }
+
+    program.push_back(I(Opcode::OP_SETL, 9, 0, 3));
+
+    for (size_t i = 0; i < BODY; ++i)
+    {
+        uint8_t x = anyReg();
+        size_t kind = pick(10);
+
+        if (kind < 6)
+        {
+            Opcode op = JIT_ALU_OPCODES[pick(
+                sizeof(JIT_ALU_OPCODES) / sizeof(Opcode))];
+            uint8_t z = opcodeTraits(op).zImmediate ? pick(72) : anyReg();
+
+            program.push_back(I(op, x, anyReg(), z));
+        }
+        else if (kind < 9)
+        {
+            Opcode op = JIT_MEMORY_OPCODES[pick(
+                sizeof(JIT_MEMORY_OPCODES) / sizeof(Opcode))];
+            uint8_t offset = 8 * pick(32) + (pick(32) ? 0 : pick(8));
+
+            program.push_back(I(op, x, 255, offset));
+        }
+        else if (pick(2))
+        {
+            //skip the next instruction on a condition, which ends a block.
+            program.push_back(
+                I(static_cast<Opcode>(0x40 + 2 * pick(8)), x, 0, 2));
+        }
+        else
+        {
+            //an instruction which is interpreted.
+            program.push_back(I(Opcode::OP_DIVU, x, anyReg(), anyReg()));
+        }
+    }
+
+    program.push_back(I(Opcode::OP_SUBI, 9, 9, 1));
+    program.push_back(I(Opcode::OP_BNZB, 9, 0xFF, 0xFF - (BODY + 1) + 1));
+    program.push_back(I(Opcode::OP_POP, 0, 0, 0));
+
+    return program;
+}
+
+/**
+ * Expect two machines to have the same registers, fault state, and data.
+ */
+static void
+expectSameState(MachineState* expected, MachineState* actual)
+{
+    const SReg sregs[] = {
+        SReg::SR_RL, SReg::SR_RH, SReg::SR_RF, SReg::SR_ROP, SReg::SR_RXX,
+        SReg::SR_RYY, SReg::SR_RZZ, SReg::SR_RCC };
+    uint8_t a[0x100], b[0x100];
+
+    EXPECT_EQ(expected->pc(), actual->pc());
+    EXPECT_EQ(expected->instructionCount(), actual->instructionCount());
+    EXPECT_EQ(expected->halted(), actual->halted());
+    for (SReg r : sregs)
+        EXPECT_EQ(expected->sreg(r), actual->sreg(r));
+    for (unsigned r = 0; r < 256; ++r)
+        EXPECT_EQ(expected->reg(r), actual->reg(r)) << "$" << r;
+
+    ASSERT_TRUE(expected->addressSpace().read(DATA_BASE, a, sizeof(a)));
+    ASSERT_TRUE(actual->addressSpace().read(DATA_BASE, b, sizeof(b)));
+    EXPECT_EQ(0, memcmp(a, b, sizeof(a)));
+}
+
+/**
+ * Test that random programs leave the same state when compiled as when they
+ * are interpreted, stopping at every instruction limit, in either byte
+ * order, and with policy enforced by the host MMU.
+ */
+TEST(MachineState, jit_differential)
+{
+    mt19937 rng(2016);
+    uint64_t interpreted = 0;
+    uint64_t dispatches = 0;
+
+    for (int round = 0; round < 64; ++round)
+    {
+        vector<uint32_t> program = jitProgram(rng);
+        ByteOrder order = round & 1 ? ByteOrder::Native : ByteOrder::BigEndian;
+        bool hostProtection = round & 2;
+        uint64_t total;
+
+        //run to completion first, to find every limit worth stopping at.
+        {
+            auto plain = machine(program, hostProtection, order);
+            auto compiled = machine(program, hostProtection, order);
+
+            for (auto* m : { plain.get(), compiled.get() })
+            {
+                m->setSReg(SReg::SR_RG, 8);
+                m->setReg(255, DATA_BASE);
+            }
+
+            plain->setJit(false);
+            compiled->setJit(true);
+            compiled->setJitThresholds(0, 0);
+            plain->run(1000);
+            compiled->run(1000);
+            total = plain->instructionCount();
+            interpreted += plain->dispatchCount();
+            dispatches += compiled->dispatchCount();
+        }
+
+        for (uint64_t limit = 1; limit <= total + 1; ++limit)
+        {
+            auto plain = machine(program, hostProtection, order);
+            auto compiled = machine(program, hostProtection, order);
+
+            for (auto* m : { plain.get(), compiled.get() })
+            {
+                m->setSReg(SReg::SR_RG, 8);
+                m->setReg(255, DATA_BASE);
+            }
+
+            plain->setJit(false);
+            compiled->setJit(true);
+            compiled->setJitThresholds(0, 0);
+            EXPECT_EQ(plain->run(limit), compiled->run(limit));
+
+            SCOPED_TRACE(round);
+            SCOPED_TRACE(limit);
+            expectSameState(plain.get(), compiled.get());
+        }
+    }
+
+#if defined(__GNUC__) && defined(__x86_64__)
+    //the loops run in compiled code, with fewer dispatches.
+    EXPECT_LT(dispatches, interpreted);
+#endif
+}
+
+/**
+ * A loop which stores a counter and adds it to a value just below the
+ * largest octa, which overflows on the third time around.
+ */
+static vector<uint32_t> jitOverflowProgram()
+{
+    return {
+        I(Opcode::OP_SETL,   1, 0x00, 0x00),
+        I(Opcode::OP_SETH,   2, 0x7F, 0xFF),
+        I(Opcode::OP_ORMH,   2, 0xFF, 0xFF),
+        I(Opcode::OP_ORML,   2, 0xFF, 0xFF),
+        I(Opcode::OP_ORL,    2, 0xFF, 0xFD),
+        I(Opcode::OP_SETL,   4, 0x00, 0x00),
+        I(Opcode::OP_SETL,   5, 0x00, 0x00),
+        I(Opcode::OP_ADDUI,  1, 1, 1),
+        I(Opcode::OP_STOI,   1, 255, 0),
+        I(Opcode::OP_ADD,    4, 2, 1),
+        I(Opcode::OP_SETL,   5, 0x00, 0x07),
+        I(Opcode::OP_JMPB,   0xFF, 0xFF, 0xFC) };
+}
+
+/**
+ * Test that a fault in the middle of a compiled block reports exactly the
+ * state of the faulting instruction, and that compiled blocks save
+ * dispatches.
+ */
+TEST(MachineState, jit_fault)
+{
+    auto state = machine(jitOverflowProgram());
+    uint8_t out[8];
+
+    state->setSReg(SReg::SR_RG, 8);
+    state->setReg(255, DATA_BASE);
+    state->setJit(true);
+    state->setJitThresholds(0, 0);
+    EXPECT_TRUE(state->jit());
+
+    EXPECT_EQ(RunStatus::Faulted, state->run());
+    EXPECT_EQ(fault2code(Fault::IntegerOverflow), state->sreg(SReg::SR_RCC));
+    EXPECT_EQ(CODE_BASE + 4 * 9, state->sreg(SReg::SR_RF));
+    EXPECT_EQ(I(Opcode::OP_ADD, 4, 2, 1), state->sreg(SReg::SR_ROP));
+    EXPECT_EQ(0x7FFFFFFFFFFFFFFFU, state->sreg(SReg::SR_RXX));
+    EXPECT_EQ(0x7FFFFFFFFFFFFFFDU, state->sreg(SReg::SR_RYY));
+    EXPECT_EQ(3U, state->sreg(SReg::SR_RZZ));
+    EXPECT_EQ(7U + 2 * 5 + 3, state->instructionCount());
+    EXPECT_EQ(3U, state->reg(1));
+    EXPECT_EQ(0x7FFFFFFFFFFFFFFFU, state->reg(4));
+    EXPECT_EQ(7U, state->reg(5));
+
+    ASSERT_TRUE(state->addressSpace().read(DATA_BASE, out, sizeof(out)));
+    EXPECT_EQ(3, out[7]);
+
+#if defined(__GNUC__) && defined(__x86_64__)
+    EXPECT_LT(state->dispatchCount(), state->instructionCount());
+#endif
+}
+
+/**
+ * Test that a compiled block is not run for a frame which it wasn't compiled
+ * for, and that turning the JIT off runs the same code again.
+ */
+TEST(MachineState, jit_frame_change)
+{
+    auto compiled = machine(jitOverflowProgram());
+    auto plain = machine(jitOverflowProgram());
+
+    for (auto* m : { compiled.get(), plain.get() })
+    {
+        m->setSReg(SReg::SR_RG, 8);
+        m->setReg(255, DATA_BASE);
+    }
+
+    compiled->setJit(true);
+
+    compiled->setJitThresholds(0, 0);
+    plain->setJit(false);
+    EXPECT_EQ(RunStatus::InstructionLimit, compiled->run(12));
+    EXPECT_EQ(RunStatus::InstructionLimit, plain->run(12));
+
+    //$2 becomes a global, so the compiled loop must not run.
+    compiled->setSReg(SReg::SR_RG, 254);
+    plain->setSReg(SReg::SR_RG, 254);
+    EXPECT_EQ(RunStatus::InstructionLimit, compiled->run(10));
+    EXPECT_EQ(RunStatus::InstructionLimit, plain->run(10));
+    expectSameState(plain.get(), compiled.get());
+
+    compiled->setJit(false);
+    EXPECT_FALSE(compiled->jit());
+    EXPECT_EQ(plain->run(10), compiled->run(10));
+    expectSameState(plain.get(), compiled.get());
+}
+
+/**
+ * Test the default JIT thresholds, and that they can be changed.
+ */
+TEST(MachineState, jit_thresholds)
+{
+    //built directly, as machine() may change the thresholds.
+    unique_ptr<MachineState> state(
+        new MachineState(make_shared<AddressSpace>()));
+    JitStatistics stats = state->jitStatistics();
+
+    EXPECT_EQ(256U, state->jitBlockThreshold());
+    EXPECT_EQ(32U, state->jitFunctionThreshold());
+    EXPECT_EQ(0U, stats.hotBlocks);
+    EXPECT_EQ(0U, stats.hotFunctions);
+    EXPECT_EQ(0U, stats.queued);
+    EXPECT_EQ(0U, stats.installed);
+    EXPECT_EQ(0U, stats.rejected);
+
+    state->setJitThresholds(5, 0);
+    EXPECT_EQ(5U, state->jitBlockThreshold());
+    EXPECT_EQ(0U, state->jitFunctionThreshold());
+
+    //waiting with nothing queued does nothing.
+    state->waitForJit();
+    EXPECT_EQ(0U, state->jitStatistics().installed);
+}
+
+/**
+ * A loop which adds to $1 and stores it, 200 times, then halts.
+ */
+static vector<uint32_t> jitLoopProgram()
+{
+    return {
+        I(Opcode::OP_SETL,   1, 0x00, 0x00),
+        I(Opcode::OP_SETL,   2, 0x00, 0xC8),
+        I(Opcode::OP_ADDUI,  1, 1, 3),
+        I(Opcode::OP_STOI,   1, 255, 0),
+        I(Opcode::OP_SUBI,   2, 2, 1),
+        I(Opcode::OP_BNZB,   2, 0xFF, 0xFD),
+        I(Opcode::OP_POP,    0, 0, 0) };
+}
+
+/**
+ * Test that a block is interpreted until it is entered often enough, then
+ * compiled in the background and patched in, with the same results.
+ */
+TEST(MachineState, jit_tiered_block)
+{
+    auto tiered = machine(jitLoopProgram());
+    auto plain = machine(jitLoopProgram());
+
+    for (auto* m : { tiered.get(), plain.get() })
+    {
+        m->setSReg(SReg::SR_RG, 8);
+        m->setReg(255, DATA_BASE);
+    }
+
+    tiered->setJit(true);
+    tiered->setJitThresholds(8, 0);
+    plain->setJit(false);
+
+    //the loop is entered once for every four instructions.
+    EXPECT_EQ(RunStatus::InstructionLimit, tiered->run(24));
+    EXPECT_EQ(0U, tiered->jitStatistics().hotBlocks);
+    EXPECT_EQ(RunStatus::InstructionLimit, tiered->run(12));
+    EXPECT_EQ(1U, tiered->jitStatistics().hotBlocks);
+    EXPECT_EQ(1U, tiered->jitStatistics().queued);
+
+    tiered->waitForJit();
+
+    JitStatistics stats = tiered->jitStatistics();
+#if defined(__GNUC__) && defined(__x86_64__)
+    EXPECT_EQ(1U, stats.installed);
+    EXPECT_EQ(0U, stats.rejected);
+#else
+    EXPECT_EQ(0U, stats.installed);
+    EXPECT_EQ(1U, stats.rejected);
+#endif
+    EXPECT_EQ(0U, stats.hotFunctions);
+
+    uint64_t dispatches = tiered->dispatchCount();
+    EXPECT_EQ(RunStatus::InstructionLimit, tiered->run(400));
+#if defined(__GNUC__) && defined(__x86_64__)
+    EXPECT_LT(tiered->dispatchCount() - dispatches, 200U);
+#endif
+
+    EXPECT_EQ(RunStatus::Halted, tiered->run());
+    EXPECT_EQ(RunStatus::Halted, plain->run());
+    expectSameState(plain.get(), tiered.get());
+    EXPECT_EQ(600U, tiered->reg(1));
+}
+
+/**
+ * A loop which calls a function of two blocks 50 times, passing it 7 in $5,
+ * then halts.
+ */
+static vector<uint32_t> jitCallProgram()
+{
+    return {
+        I(Opcode::OP_SETL,   3, 0x00, 0x32),
+        I(Opcode::OP_SETL,   5, 0x00, 0x07),
+        I(Opcode::OP_PUSHJ,  4, 0x00, 0x04),
+        I(Opcode::OP_SUBI,   3, 3, 1),
+        I(Opcode::OP_BNZB,   3, 0xFF, 0xFD),
+        I(Opcode::OP_POP,    0, 0, 0),
+        I(Opcode::OP_ADDUI,  0, 0, 1),
+        I(Opcode::OP_SLUI,   0, 0, 1),
+        I(Opcode::OP_BZ,     0, 0x00, 0x02),
+        I(Opcode::OP_ADDUI,  0, 0, 3),
+        I(Opcode::OP_SLUI,   0, 0, 1),
+        I(Opcode::OP_POP,    1, 0, 0) };
+}
+
+/**
+ * Test that the blocks of a function which is called often enough are
+ * compiled together, even though none of them is entered often enough by
+ * itself.
+ */
+TEST(MachineState, jit_tiered_function)
+{
+    auto tiered = machine(jitCallProgram());
+    auto plain = machine(jitCallProgram());
+
+    tiered->setJit(true);
+    tiered->setJitThresholds(1000, 4);
+    plain->setJit(false);
+
+    //each call takes ten instructions.
+    EXPECT_EQ(RunStatus::InstructionLimit, tiered->run(31));
+    EXPECT_EQ(0U, tiered->jitStatistics().hotFunctions);
+    EXPECT_EQ(RunStatus::InstructionLimit, tiered->run(10));
+    EXPECT_EQ(1U, tiered->jitStatistics().hotFunctions);
+    EXPECT_EQ(2U, tiered->jitStatistics().queued);
+
+    tiered->waitForJit();
+
+    JitStatistics stats = tiered->jitStatistics();
+#if defined(__GNUC__) && defined(__x86_64__)
+    EXPECT_EQ(2U, stats.installed);
+#else
+    EXPECT_EQ(2U, stats.rejected);
+#endif
+    EXPECT_EQ(0U, stats.hotBlocks);
+
+    EXPECT_EQ(RunStatus::Halted, tiered->run());
+    EXPECT_EQ(RunStatus::Halted, plain->run());
+    expectSameState(plain.get(), tiered.get());
+    EXPECT_EQ(38U, tiered->reg(4));
+#if defined(__GNUC__) && defined(__x86_64__)
+    EXPECT_LT(tiered->dispatchCount(), plain->dispatchCount());
+#endif
+}
+
+/**
+ * Test that random programs leave the same state when their blocks are
+ * compiled in the background and patched in between runs.
+ */
+TEST(MachineState, jit_tiered_differential)
+{
+    mt19937 rng(2017);
+    uint64_t installed = 0;
+
+    for (int round = 0; round < 32; ++round)
+    {
+        vector<uint32_t> program = jitProgram(rng);
+        ByteOrder order = round & 1 ? ByteOrder::Native : ByteOrder::BigEndian;
+        auto plain = machine(program, false, order);
+        auto tiered = machine(program, false, order);
+        const uint64_t limit = 1000;
+        RunStatus status = RunStatus::InstructionLimit;
+
+        for (auto* m : { plain.get(), tiered.get() })
+        {
+            m->setSReg(SReg::SR_RG, 8);
+            m->setReg(255, DATA_BASE);
+        }
+
+        plain->setJit(false);
+        tiered->setJit(true);
+        tiered->setJitThresholds(2, 0);
+
+        while (RunStatus::InstructionLimit == status
+            && tiered->instructionCount() < limit)
+        {
+            status = tiered->run(
+                min<uint64_t>(7, limit - tiered->instructionCount()));
+            tiered->waitForJit();
+        }
+
+        EXPECT_EQ(plain->run(limit), status);
+
+        SCOPED_TRACE(round);
+        expectSameState(plain.get(), tiered.get());
+        installed += tiered->jitStatistics().installed;
+    }
+
+#if defined(__GNUC__) && defined(__x86_64__)
+    EXPECT_LT(0U, installed);
+#endif
+}
+
+/**
+ * Test that machines with different fusion and JIT settings can run the same
+ * code segment of a shared address space at once.  Each machine predecodes
+ * the segment into its own blocks, so this is clean under ThreadSanitizer.
+ */
+TEST(MachineState, shared_space_threads)
+{
+    auto space = programSpace({
+        I(Opcode::OP_SETL,  0, 0, 0),
+        I(Opcode::OP_SETL,  1, 0, 200),
+        I(Opcode::OP_ADD,   0, 0, 1),
+        I(Opcode::OP_SUBI,  1, 1, 1),
+        I(Opcode::OP_BNZB,  1, 0xFF, 0xFE),
+        I(Opcode::OP_POP,   1, 0, 0) });
+    const size_t THREADS = 4;
+    const size_t ROUNDS = 50;
+    vector<thread> threads;
+    size_t halted[THREADS] = { 0 };
+
+    for (size_t t = 0; t < THREADS; ++t)
+    {
+        threads.emplace_back([&, t]() {
+            for (size_t round = 0; round < ROUNDS; ++round)
+            {
+                MachineState state(space);
+
+                state.setPC(CODE_BASE);
+                state.setFusion(0 != (t & 1));
+                state.setJit(0 != (t & 2));
+                if (0 != (t & 2))
+                    state.setJitThresholds(round & 1 ? 0 : 2, 0);
+
+                if (RunStatus::Halted == state.run()
+                 && 200U * 201U / 2U == state.exitCode())
+                {
+                    ++halted[t];
+                }
+            }
+        });
+    }
+
+    for (auto& th : threads)
+        th.join();
+
+    for (size_t t = 0; t < THREADS; ++t)
+        EXPECT_EQ(ROUNDS, halted[t]);
+}
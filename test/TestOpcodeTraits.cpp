@@ -0,0 +1,95 @@
+/**
+ * \file TestOpcodeTraits.cpp
+ *
+ * Test the opcode traits table.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <gtest/gtest.h>
+#include <simex/DecodedInstruction.h>
+#include <simex/OpcodeTraits.h>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Test that loads and stores report their width and signedness.
+ */
+TEST(OpcodeTraits, memory_width)
+{
+    for (int code = 0x80; code <= 0xAF; ++code)
+    {
+        if (code >= 0x90 && code < 0xA0)
+            continue;
+
+        const OpcodeTraits& t = opcodeTraits(static_cast<Opcode>(code));
+        unsigned width = 1 << ((code >> 2) & 3);
+
+        EXPECT_EQ(code < 0xA0 ? MemoryAccess::Load : MemoryAccess::Store,
+                  t.access);
+        EXPECT_EQ(width, t.width);
+        EXPECT_EQ(width < 8 && !(code & 2), t.isSigned);
+        EXPECT_TRUE(t.canFault);
+        EXPECT_EQ(static_cast<bool>(code & 1), t.zImmediate);
+    }
+}
+
+/**
+ * Test that every relative opcode with an odd value is backward, and that no
+ * other opcode is.
+ */
+TEST(OpcodeTraits, backward)
+{
+    for (int code = 0; code < 256; ++code)
+    {
+        const OpcodeTraits& t = opcodeTraits(static_cast<Opcode>(code));
+        bool relative =
+            OperandFormat::WydeRelative == t.format
+         || OperandFormat::TriByteRelative == t.format;
+
+        EXPECT_EQ(relative && (code & 1), t.backward);
+        EXPECT_EQ(relative,
+                  (code >= 0x40 && code < 0x60)
+               || (code >= 0xF0 && code < 0xF6));
+    }
+}
+
+/**
+ * Test that branches and conditional sets share the condition encoding.
+ */
+TEST(OpcodeTraits, condition)
+{
+    for (int code = 0x40; code < 0x80; ++code)
+    {
+        const OpcodeTraits& t = opcodeTraits(static_cast<Opcode>(code));
+
+        EXPECT_TRUE(t.conditional);
+        EXPECT_EQ((code >> 1) & 7, t.condition);
+        EXPECT_EQ(code >= 0x50 && code < 0x60, t.probable);
+    }
+
+    EXPECT_FALSE(opcodeTraits(Opcode::OP_JMP).conditional);
+    EXPECT_FALSE(opcodeTraits(Opcode::OP_LDB).conditional);
+}
+
+/**
+ * Test that compile-time and run-time lookups agree.
+ */
+TEST(OpcodeTraits, compile_time)
+{
+    typedef OpcodeTraitsOf<Opcode::OP_LDWU> ldwu;
+    auto ins = DecodedInstruction::decode(Opcode::OP_LDWU, 1, 2, 3);
+
+    static_assert(2 == ldwu::width, "LDWU is a wyde load");
+    static_assert(!ldwu::isSigned, "LDWU is unsigned");
+
+    EXPECT_EQ(&opcodeTraits(Opcode::OP_LDWU), &ins.traits());
+    EXPECT_EQ(ldwu::width, ins.traits().width);
+    EXPECT_EQ(ldwu::access, ins.traits().access);
+    EXPECT_FALSE(opcodeTraits(Opcode::OP_RESERVED_x98).valid);
+}
@@ -0,0 +1,133 @@
+/**
+ * \file TestPageTable.cpp
+ *
+ * Test the PageTable class.
+ *
+ * Copyright (C) 2016 Justin Handville - All Rights Reserved.
+ *
+ * This file is part of the SIMEX Virtual Machine which is released under the
+ * MIT License.  See LICENSE.txt in the root of this distribution for further
+ * information.
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <simex/AddressSpace.h>
+#include <simex/PageTable.h>
+#include <thread>
+
+using namespace simex;
+using namespace std;
+
+/**
+ * Test that inserted segments are found at every page and nowhere else, and
+ * can be removed.
+ */
+TEST(PageTable, insert_remove)
+{
+    PageTable table;
+    Segment a(0x1000, 0x3000, SEGMENT_READ);
+    Segment b(0x4000, 0x1000, SEGMENT_READ);
+
+    EXPECT_EQ(nullptr, table.find(0x1000));
+
+    //a lone segment needs no nodes.
+    table.insert(&a);
+    EXPECT_EQ(sizeof(PageTable::Node), table.memoryUsage());
+    table.insert(&b);
+
+    EXPECT_EQ(nullptr, table.find(0x0FFF));
+    EXPECT_EQ(&a, table.find(0x1000));
+    EXPECT_EQ(&a, table.find(0x3FFF));
+    EXPECT_EQ(&b, table.find(0x4000));
+    EXPECT_EQ(&b, table.find(0x4FFF));
+    EXPECT_EQ(nullptr, table.find(0x5000));
+
+    table.remove(&a);
+    EXPECT_EQ(nullptr, table.find(0x2000));
+    EXPECT_EQ(&b, table.find(0x4000));
+
+    table.insert(&a);
+    EXPECT_EQ(&a, table.find(0x2000));
+}
+
+/**
+ * Test that segments which cover whole slots above the leaves, and segments
+ * alone in a slot, are split correctly by later segments, including at the
+ * top of the address space.
+ */
+TEST(PageTable, split_slots)
+{
+    PageTable table;
+    const uint64_t big = 0x0000100000000000ULL;
+    const uint64_t top = 0xFFFFFFFFFFFFF000ULL;
+
+    //8MB covers whole 2MB slots, with a page over at each end.
+    Segment a(big - 0x1000, 0x800000, SEGMENT_READ);
+    Segment b(big + 0x7FF000, 0x1000, SEGMENT_READ);
+    Segment c(big + 0x40000000, 0x1000, SEGMENT_READ);
+    Segment d(top, 0x1000, SEGMENT_READ);
+    Segment e(top - 0x100000000ULL, 0x1000, SEGMENT_READ);
+
+    table.insert(&a);
+    EXPECT_EQ(&a, table.find(big - 0x1000));
+    EXPECT_EQ(&a, table.find(big + 0x400000));
+    EXPECT_EQ(&a, table.find(big + 0x7FEFFF));
+    EXPECT_EQ(nullptr, table.find(big + 0x7FF000));
+
+    //neighbours in the same slots as the ends of the first segment.
+    table.insert(&b);
+    table.insert(&c);
+    EXPECT_EQ(&a, table.find(big + 0x7FEFFF));
+    EXPECT_EQ(&b, table.find(big + 0x7FF000));
+    EXPECT_EQ(nullptr, table.find(big + 0x800000));
+    EXPECT_EQ(&c, table.find(big + 0x40000FFF));
+    EXPECT_EQ(&a, table.find(big - 0x1000));
+    EXPECT_EQ(nullptr, table.find(big - 0x1001));
+
+    table.remove(&a);
+    EXPECT_EQ(nullptr, table.find(big + 0x400000));
+    EXPECT_EQ(&b, table.find(big + 0x7FF000));
+
+    table.insert(&d);
+    table.insert(&e);
+    EXPECT_EQ(&d, table.find(~0ULL));
+    EXPECT_EQ(&e, table.find(top - 0x100000000ULL));
+    EXPECT_EQ(nullptr, table.find(top - 1));
+}
+
+/**
+ * Test that readers find every published segment while a writer allocates
+ * more.
+ */
+TEST(PageTable, concurrent_readers)
+{
+    AddressSpace space;
+    const int COUNT = 2000;
+    atomic<int> published(0);
+
+    thread writer([&]() {
+        for (int k = 0; k < COUNT; ++k)
+        {
+            space.map(
+                AddressSpace::ALLOCATION_BASE + 0x200000ULL * k, 0x1000,
+                SEGMENT_READ);
+            published.store(k + 1, memory_order_release);
+        }
+    });
+
+    bool ok = true;
+    for (int seen = 0; seen < COUNT; )
+    {
+        seen = published.load(memory_order_acquire);
+        for (int k = 0; k < seen; ++k)
+        {
+            uint64_t addr = AddressSpace::ALLOCATION_BASE + 0x200000ULL * k;
+            Segment* seg = space.find(addr + 8);
+            ok = ok && seg && seg->base() == addr;
+        }
+    }
+
+    writer.join();
+    EXPECT_TRUE(ok);
+}